@@ -12,6 +12,8 @@ WINDOWS_SKIP_TARGETS = [
     "envoy.tracers.lightstep",
     "envoy.tracers.datadog",
     "envoy.tracers.opencensus",
+    # Maps its cache files into memory, which is not implemented on Windows.
+    "envoy.filters.http.cache.file_system_http_cache",
 ]
 
 # Make all contents of an external repository accessible under a filegroup.  Used for external HTTP
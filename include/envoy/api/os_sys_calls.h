@@ -57,11 +57,27 @@ public:
   virtual SysCallIntResult recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
                                     int flags, struct timespec* timeout) PURE;
 
+  /**
+   * @see sendmmsg (man 2 sendmmsg)
+   */
+  virtual SysCallIntResult sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
   /**
    * return true if the OS supports recvmmsg() and sendmmsg().
    */
   virtual bool supportsMmsg() const PURE;
 
+  /**
+   * return true if the OS supports segmenting UDP payloads with UDP_SEGMENT.
+   */
+  virtual bool supportsUdpGso() const PURE;
+
+  /**
+   * return true if the OS supports coalescing received UDP datagrams with UDP_GRO.
+   */
+  virtual bool supportsUdpGro() const PURE;
+
   /**
    * Release all resources allocated for fd.
    * @return zero on success, -1 returned otherwise.
@@ -79,11 +95,36 @@ public:
   virtual SysCallPtrResult mmap(void* addr, size_t length, int prot, int flags, int fd,
                                 off_t offset) PURE;
 
+  /**
+   * @see man 2 munmap
+   */
+  virtual SysCallIntResult munmap(void* addr, size_t length) PURE;
+
   /**
    * @see man 2 stat
    */
   virtual SysCallIntResult stat(const char* pathname, struct stat* buf) PURE;
 
+  /**
+   * @see man 2 fstat
+   */
+  virtual SysCallIntResult fstat(int fd, struct stat* buf) PURE;
+
+  /**
+   * @see man 2 open
+   */
+  virtual SysCallIntResult open(const char* pathname, int flags) PURE;
+
+  /**
+   * @see man 2 rename
+   */
+  virtual SysCallIntResult rename(const char* oldpath, const char* newpath) PURE;
+
+  /**
+   * @see man 2 unlink
+   */
+  virtual SysCallIntResult unlink(const char* pathname) PURE;
+
   /**
    * @see man 2 setsockopt
    */
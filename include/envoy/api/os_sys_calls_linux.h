@@ -20,6 +20,23 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see pipe2 (man 2 pipe2)
+   */
+  virtual SysCallIntResult pipe2(int pipefd[2], int flags) PURE;
+
+  /**
+   * @see splice (man 2 splice). Both offsets are passed as nullptr.
+   */
+  virtual SysCallSizeResult splice(int fd_in, int fd_out, size_t len, unsigned int flags) PURE;
+
+  /**
+   * Set the capacity of a pipe.
+   * @see fcntl F_SETPIPE_SZ (man 2 fcntl)
+   * @return the actual capacity of the pipe, which may be larger than requested.
+   */
+  virtual SysCallIntResult setPipeSize(int fd, int size) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
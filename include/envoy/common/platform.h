@@ -205,3 +205,15 @@ struct mmsghdr {
   unsigned int msg_len;
 };
 #endif
+
+// UDP generic segmentation offload and generic receive offload, see udp(7). The values are defined
+// here for C libraries which predate them. Older kernels reject the options with ENOPROTOOPT.
+#if defined(__linux__)
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
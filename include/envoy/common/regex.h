@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "envoy/common/matchers.h"
 
@@ -24,5 +25,25 @@ public:
 
 using CompiledMatcherPtr = std::unique_ptr<const CompiledMatcher>;
 
+/**
+ * A set of compiled regex expressions which are matched against a value in a single pass.
+ */
+class CompiledMatcherSet {
+public:
+  virtual ~CompiledMatcherSet() = default;
+
+  /**
+   * Find every expression in the set which matches the entire value.
+   * @param value supplies the value to match.
+   * @param matches receives the positions, in construction order, of the matching expressions.
+   *        The positions are not sorted.
+   * @return false if the regex engine could not complete the match, e.g. because it ran out of
+   *         memory. In that case the caller must match each expression individually.
+   */
+  virtual bool match(absl::string_view value, std::vector<int>& matches) const PURE;
+};
+
+using CompiledMatcherSetPtr = std::unique_ptr<const CompiledMatcherSet>;
+
 } // namespace Regex
 } // namespace Envoy
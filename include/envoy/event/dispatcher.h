@@ -30,8 +30,11 @@ namespace Event {
  * All dispatcher stats. @see stats_macros.h
  */
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(deferred_delete_batch_size, Unspecified)                                               \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
-  HISTOGRAM(poll_delay_us, Microseconds)
+  HISTOGRAM(poll_delay_us, Microseconds)                                                           \
+  HISTOGRAM(poll_ready_events, Unspecified)                                                        \
+  HISTOGRAM(post_wait_us, Microseconds)
 
 /**
  * Struct definition for all dispatcher stats. @see stats_macros.h
@@ -45,6 +45,14 @@ public:
    */
   virtual Api::IoCallSizeResult write(absl::string_view buffer) PURE;
 
+  /**
+   * Write the slices to the file, in order, with as few system calls as the platform allows. The
+   * file must be explicitly opened before writing.
+   *
+   * @return ssize_t number of bytes written, or -1 for failure
+   */
+  virtual Api::IoCallSizeResult writev(const absl::string_view* slices, uint64_t num_slices) PURE;
+
   /**
    * Close the file.
    *
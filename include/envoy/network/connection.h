@@ -301,6 +301,14 @@ public:
    *         occurred an empty string is returned.
    */
   virtual absl::string_view transportFailureReason() const PURE;
+
+  /**
+   * @return the I/O handle of the connection's socket if the transport socket passes bytes through
+   *         unmodified (@see TransportSocket::passthrough()) and neither the read nor the write
+   *         buffer holds any data, nullptr otherwise. While reads are disabled on the connection,
+   *         the caller may move data to and from the handle directly, e.g. with splice(2).
+   */
+  virtual IoHandle* passthroughIoHandle() PURE;
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
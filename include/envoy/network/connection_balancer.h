@@ -32,6 +32,12 @@ public:
    * transfer during the balancing process.
    */
   virtual void post(Network::ConnectionSocketPtr&& socket) PURE;
+
+  /**
+   * @return the socket which the handler accepts connections from. With reuse_port, each handler
+   *         has its own socket.
+   */
+  virtual Network::Socket& listenSocket() PURE;
 };
 
 /**
@@ -87,6 +87,13 @@ public:
    */
   virtual void enableListeners() PURE;
 
+  /**
+   * Set the fraction of the connections accepted by the TCP listeners which are rejected, by
+   * closing them right away. This is used to shed load gradually rather than all at once.
+   * @param reject_fraction supplies the fraction of connections to reject, between 0 and 1.
+   */
+  virtual void setListenerRejectFraction(float reject_fraction) PURE;
+
   /**
    * @return the stat prefix used for per-handler stats.
    */
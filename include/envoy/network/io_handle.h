@@ -3,18 +3,25 @@
 #include <memory>
 
 #include "envoy/api/io_error.h"
+#include "envoy/api/os_sys_calls_common.h"
 #include "envoy/common/platform.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/file_event.h"
 
 #include "absl/container/fixed_array.h"
 
 namespace Envoy {
 namespace Buffer {
 struct RawSlice;
+class Instance;
 } // namespace Buffer
 
 using RawSliceArrays = absl::FixedArray<absl::FixedArray<Buffer::RawSlice>>;
 
+namespace Event {
+class Dispatcher;
+} // namespace Event
+
 namespace Network {
 namespace Address {
 class Instance;
@@ -68,6 +75,24 @@ public:
    */
   virtual Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) PURE;
 
+  /**
+   * Read data into the given buffer for connected handles.
+   * @param buffer supplies the buffer to read into.
+   * @param max_length supplies the maximum length to read.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the bytes read for success.
+   */
+  virtual Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) PURE;
+
+  /**
+   * Write the data in the buffer out for connected handles. The data written is drained from the
+   * buffer.
+   * @param buffer supplies the buffer to write from.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the bytes written for success.
+   */
+  virtual Api::IoCallUint64Result write(Buffer::Instance& buffer) PURE;
+
   /**
    * Send a message to the address.
    * @param slices points to the location of data to be sent.
@@ -82,6 +107,33 @@ public:
                                           int flags, const Address::Ip* self_ip,
                                           const Address::Instance& peer_address) PURE;
 
+  /**
+   * A message sent by sendmmsg().
+   */
+  struct SendMsgInfo {
+    // The payload of the message.
+    const Buffer::RawSlice* slices_{nullptr};
+    uint64_t num_slice_{0};
+    // The source address whose port should be ignored. Nullptr if the kernel should select it.
+    const Address::Ip* self_ip_{nullptr};
+    // The destination address.
+    const Address::Instance* peer_address_{nullptr};
+    // If not 0, the payload is sent as consecutive datagrams of this size, the last of which may
+    // be shorter, using UDP generic segmentation offload. See supportsUdpGso().
+    uint16_t gso_size_{0};
+  };
+
+  /**
+   * Send multiple messages with a single system call if the platform supports it, see
+   * supportsMmsg(). Otherwise only the first message is sent.
+   * @param messages points to the messages to be sent.
+   * @param num_messages indicates the number of messages |messages| contains.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance if the first message
+   * could not be sent, or err_ = nullptr and rc_ = the number of messages sent for success.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const SendMsgInfo* messages, uint64_t num_messages,
+                                           int flags) PURE;
+
   struct RecvMsgPerPacketInfo {
     // The destination address from transport header.
     Address::InstanceConstSharedPtr local_address_;
@@ -89,6 +141,9 @@ public:
     Address::InstanceConstSharedPtr peer_address_;
     // The payload length of this packet.
     unsigned int msg_len_{0};
+    // If not 0, the payload consists of datagrams of this size, the last of which may be shorter,
+    // which the kernel coalesced because UDP_GRO is enabled on the socket.
+    unsigned int gso_size_{0};
   };
 
   /**
@@ -144,6 +199,34 @@ public:
    * return true if the platform supports recvmmsg() and sendmmsg().
    */
   virtual bool supportsMmsg() const PURE;
+
+  /**
+   * return true if the platform supports sending messages with a gso_size_, see sendmmsg().
+   */
+  virtual bool supportsUdpGso() const PURE;
+
+  /**
+   * Shut down part of a full-duplex connection. Writes accepted by writev() before this call are
+   * still delivered to the peer.
+   * @param how supplies the type of shutdown, e.g. ENVOY_SHUT_WR.
+   * @return a Api::SysCallIntResult with rc_ = 0 for success and rc_ = -1 for failure. If the call
+   *   is successful, errno_ shouldn't be used.
+   */
+  virtual Api::SysCallIntResult shutdown(int how) PURE;
+
+  /**
+   * Create a file event which notifies of the readiness of this handle for I/O. Handles which do
+   * not perform I/O directly on the file descriptor deliver the events themselves, so callers
+   * should prefer this to creating a file event for fd() on the dispatcher.
+   * @param dispatcher supplies the dispatcher of the thread using the handle.
+   * @param cb supplies the callback to fire when the handle is ready.
+   * @param trigger supplies whether to fire on edge or level events.
+   * @param events supplies a logical OR of FileReadyType events the file event should initially
+   *        listen on.
+   */
+  virtual Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                              Event::FileTriggerType trigger,
+                                              uint32_t events) PURE;
 };
 
 using IoHandlePtr = std::unique_ptr<IoHandle>;
@@ -202,6 +202,19 @@ struct UdpSendData {
   Buffer::Instance& buffer_;
 };
 
+/**
+ * The outcome of sending the datagrams queued on a UdpListener, see UdpListener::flush().
+ */
+struct UdpFlushResult {
+  // The number of datagrams sent and the number of bytes they contained.
+  uint64_t datagrams_sent_{0};
+  uint64_t bytes_sent_{0};
+  // The number of datagrams which could not be sent and were dropped.
+  uint64_t datagrams_dropped_{0};
+  // The number of send system calls made.
+  uint64_t send_calls_{0};
+};
+
 /**
  * UDP listener callbacks.
  */
@@ -294,6 +307,24 @@ public:
    * sender.
    */
   virtual Api::IoCallUint64Result send(const UdpSendData& data) PURE;
+
+  /**
+   * Queue data to be sent through the underlying udp socket by the next flush(). Datagrams queued
+   * until then are sent with as few system calls as possible: consecutive datagrams of the same
+   * size for the same peer are coalesced using UDP generic segmentation offload if the platform
+   * supports it, and the resulting messages are sent with sendmmsg().
+   *
+   * @param data Supplies the data to send to a target using udp. The buffer is drained. The
+   * addresses must remain valid until flush() is called.
+   */
+  virtual void queueSend(const UdpSendData& data) PURE;
+
+  /**
+   * Send the data queued with queueSend(). Datagrams which cannot be sent, e.g. because the send
+   * buffer of the socket FD is full, are dropped.
+   * @return the number of datagrams sent and dropped.
+   */
+  virtual UdpFlushResult flush() PURE;
 };
 
 using UdpListenerPtr = std::unique_ptr<UdpListener>;
@@ -124,6 +124,13 @@ public:
    */
   virtual bool canFlushClose() PURE;
 
+  /**
+   * @return bool whether the socket moves bytes between the I/O handle and the connection buffers
+   *         without transforming or observing them, i.e. the I/O handle may be read from and
+   *         written to directly.
+   */
+  virtual bool passthrough() const PURE;
+
   /**
    * Closes the transport socket.
    * @param event supplies the connection event that is closing the socket.
@@ -39,6 +39,13 @@ public:
    */
   virtual Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const PURE;
 
+  /**
+   * @return bool whether the handler may keep sending response data through
+   * getDecoderFilterCallbacks() after it returns. This is not the case for requests made through
+   * Admin::request(), which have no stream.
+   */
+  virtual bool streamingSupported() const PURE;
+
   /**
    * @return const Buffer::Instance* the fully buffered admin request if applicable.
    */
@@ -5,6 +5,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/ssl/context_manager.h"
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/store.h"
 #include "envoy/thread/thread.h"
@@ -74,6 +75,13 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  /**
+   * Retrieve the TLS server sessions which our parent process preserves across hot restarts, and
+   * add them to the session caches of context_manager. Does nothing if there is no parent.
+   * @param context_manager the SSL context manager whose session caches will be filled.
+   */
+  virtual void mergeParentTlsSessionsIfAny(Ssl::ContextManager& context_manager) PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
@@ -160,6 +160,11 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint32_t the number of threads which flush log files.
+   */
+  virtual uint32_t fileFlushThreads() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -12,15 +12,35 @@
 namespace Envoy {
 namespace Server {
 
-enum class OverloadActionState {
+/**
+ * The state of an overload action, as a value between 0 and 1. An action is inactive at 0, when
+ * none of its triggers fired, and saturated at 1. Actions whose triggers are all threshold
+ * triggers are only ever inactive or saturated, while scaled triggers let actions take any value
+ * in between, so that they can be applied gradually.
+ */
+class OverloadActionState {
+public:
+  static constexpr OverloadActionState inactive() { return OverloadActionState(0); }
+  static constexpr OverloadActionState saturated() { return OverloadActionState(1); }
+
+  explicit constexpr OverloadActionState(float value)
+      : value_(value < 0 ? 0 : (value > 1 ? 1 : value)) {}
+
   /**
-   * Indicates that an overload action is active because at least one of its triggers has fired.
+   * @return float the value of the action, between 0 and 1.
    */
-  Active,
+  float value() const { return value_; }
+
   /**
-   * Indicates that an overload action is inactive because none of its triggers have fired.
+   * @return bool whether the action is saturated.
    */
-  Inactive
+  bool isSaturated() const { return value_ == 1; }
+
+  bool operator==(const OverloadActionState& other) const { return value_ == other.value_; }
+  bool operator!=(const OverloadActionState& other) const { return value_ != other.value_; }
+
+private:
+  float value_;
 };
 
 /**
@@ -36,7 +56,7 @@ public:
   const OverloadActionState& getState(const std::string& action) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      it = actions_.insert(std::make_pair(action, OverloadActionState::Inactive)).first;
+      it = actions_.insert(std::make_pair(action, OverloadActionState::inactive())).first;
     }
     return it->second;
   }
@@ -44,7 +64,7 @@ public:
   void setState(const std::string& action, OverloadActionState state) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      actions_[action] = state;
+      actions_.insert(std::make_pair(action, state));
     } else {
       it->second = state;
     }
@@ -70,6 +90,13 @@ public:
 
   // Overload action to try to shrink the heap by releasing free memory.
   const std::string ShrinkHeap = "envoy.overload_actions.shrink_heap";
+
+  // Overload action to shrink the idle timeout of HTTP connections in proportion to its value.
+  const std::string ReduceTimeouts = "envoy.overload_actions.reduce_timeouts";
+
+  // Overload action to reject the fraction of new connections given by its value.
+  const std::string RejectIncomingConnections =
+      "envoy.overload_actions.reject_incoming_connections";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
@@ -91,7 +118,8 @@ public:
 
   /**
    * Register a callback to be invoked when the specified overload action changes state
-   * (i.e., becomes activated or inactivated). Must be called before the start method is called.
+   * (i.e., becomes activated, inactivated or changes its value). Must be called before the start
+   * method is called.
    * @param action const std::string& the name of the overload action to register for
    * @param dispatcher Event::Dispatcher& the dispatcher on which callbacks will be posted
    * @param callback OverloadActionCb the callback to post when the overload action
@@ -115,7 +143,7 @@ public:
    * is disabled).
    */
   static const OverloadActionState& getInactiveState() {
-    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::Inactive);
+    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::inactive());
   }
 };
 
@@ -61,6 +61,12 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return true if the keys of established connections should be installed into the kernel, so
+   *         that the kernel encrypts and decrypts the records.
+   */
+  virtual bool enableKernelTls() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
@@ -112,6 +118,13 @@ public:
     std::array<uint8_t, 256 / 8> aes_key_; // AES256 key size, in bytes
   };
 
+  struct SessionCacheConfig {
+    // Maximum number of sessions in the cache.
+    uint32_t max_sessions_;
+    // Whether the sessions are handed over to the new process on a hot restart.
+    bool preserve_across_hot_restart_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -134,6 +147,11 @@ public:
    * @return True if stateless TLS session resumption is disabled, false otherwise.
    */
   virtual bool disableStatelessSessionResumption() const PURE;
+
+  /**
+   * @return the config of the stateful session cache, if the sessions are to be cached.
+   */
+  virtual const absl::optional<SessionCacheConfig>& sessionCache() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "envoy/common/time.h"
 #include "envoy/config/typed_config.h"
@@ -17,6 +20,19 @@ namespace Ssl {
  */
 class ContextManager {
 public:
+  /**
+   * A session of a server session cache, as handed over to a new process on a hot restart.
+   */
+  struct CachedSession {
+    // The session ID context of the server contexts which may resume the session.
+    std::string session_id_context_;
+    std::string session_id_;
+    // The session, as serialized by SSL_SESSION_to_bytes().
+    std::string session_;
+    // The remaining lifetime of the session.
+    std::chrono::seconds ttl_;
+  };
+
   virtual ~ContextManager() = default;
 
   /**
@@ -47,6 +63,18 @@ public:
    * context manager.
    */
   virtual PrivateKeyMethodManager& privateKeyMethodManager() PURE;
+
+  /**
+   * @return the unexpired sessions of the server session caches which are preserved across hot
+   *         restarts, least recently used first.
+   */
+  virtual std::vector<CachedSession> exportSessions() const PURE;
+
+  /**
+   * Add sessions exported by another process to the server session caches of their session ID
+   * contexts. Sessions whose session ID context has no cache are dropped.
+   */
+  virtual void importSessions(const std::vector<CachedSession>& sessions) PURE;
 };
 
 using ContextManagerPtr = std::unique_ptr<ContextManager>;
@@ -58,6 +58,21 @@ public:
   virtual const SymbolTable& constSymbolTable() const PURE;
   virtual SymbolTable& symbolTable() PURE;
 
+  /**
+   * Start tracking which counters and gauges change, so that takeChangedStats() can return them.
+   * All the counters and gauges which exist at this point are considered to have changed.
+   */
+  virtual void trackChangedStats() PURE;
+
+  /**
+   * Take the counters and gauges which changed since they were last taken, or since tracking
+   * started if they were never taken. Must not be called by more than one thread at a time.
+   * @param counters receives the changed counters.
+   * @param gauges receives the changed gauges.
+   */
+  virtual void takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                                std::vector<GaugeSharedPtr>& gauges) PURE;
+
   // TODO(jmarantz): create a parallel mechanism to instantiate histograms. At
   // the moment, histograms don't fit the same pattern of counters and gauges
   // as they are not actually created in the context of a stats allocator.
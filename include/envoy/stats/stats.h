@@ -89,11 +89,14 @@ public:
    * Flags:
    * Used: used by all stats types to figure out whether they have been used.
    * Logic...: used by gauges to cache how they should be combined with a parent's value.
+   * Changed: used by counters and gauges to track whether they changed since they were last
+   *          reported to the allocator's changed stats.
    */
   struct Flags {
     static const uint8_t Used = 0x01;
     static const uint8_t LogicAccumulate = 0x02;
     static const uint8_t NeverImport = 0x04;
+    static const uint8_t Changed = 0x08;
   };
   virtual SymbolTable& symbolTable() PURE;
   virtual const SymbolTable& constSymbolTable() const PURE;
@@ -15,6 +15,10 @@ namespace Event {
 class Dispatcher;
 }
 
+namespace Thread {
+class ThreadFactory;
+}
+
 namespace ThreadLocal {
 class Instance;
 }
@@ -99,6 +103,33 @@ public:
    * method would be asserted.
    */
   virtual void mergeHistograms(PostMergeCb merge_complete_cb) PURE;
+
+  /**
+   * Merge the histograms on a pool of threads rather than on the main thread. The histograms are
+   * merged in parallel, and the main thread only publishes the merged histograms before calling
+   * the callback passed to mergeHistograms(). This must be called at most once, before
+   * initializeThreading().
+   * @param thread_factory supplies the factory used to create the threads.
+   * @param num_threads supplies the number of threads. If 0, histograms are merged on the main
+   *        thread.
+   */
+  virtual void setHistogramMergeThreads(Thread::ThreadFactory& thread_factory,
+                                        uint32_t num_threads) PURE;
+
+  /**
+   * Start tracking which counters and gauges change, so that flushes can only report those. All the
+   * counters and gauges which exist at this point are considered to have changed.
+   */
+  virtual void trackChangedStats() PURE;
+
+  /**
+   * Take the counters and gauges which changed since they were last taken, or since tracking
+   * started if they were never taken. Only used on the main thread, when flushing stats.
+   * @param counters receives the changed counters.
+   * @param gauges receives the changed gauges.
+   */
+  virtual void takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                                std::vector<GaugeSharedPtr>& gauges) PURE;
 };
 
 using StoreRootPtr = std::unique_ptr<StoreRoot>;
@@ -1,10 +1,13 @@
 #include "common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/lock_guard.h"
+#include "common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -43,21 +46,106 @@ AccessLogFileSharedPtr AccessLogManagerImpl::createAccessLog(const std::string&
 
   access_logs_[*file_name] = std::make_shared<AccessLogFileImpl>(
       api_.fileSystem().createFile(*file_name), dispatcher_, lock_, file_stats_,
-      file_flush_interval_msec_, api_.threadFactory());
+      file_flush_interval_msec_, flusher_);
   return access_logs_[*file_name];
 }
 
+AccessLogFlusher::AccessLogFlusher(Api::Api& api, uint32_t num_threads,
+                                   const AccessLogFileStats& stats)
+    : api_(api), num_threads_(std::max(1U, num_threads)), stats_(stats) {}
+
+AccessLogFlusher::~AccessLogFlusher() {
+  std::vector<Thread::ThreadPtr> threads;
+
+  {
+    Thread::LockGuard lock(lock_);
+    ASSERT(queue_.empty());
+    exit_ = true;
+    queue_event_.notifyAll();
+    threads.swap(threads_);
+  }
+
+  for (const Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+}
+
+void AccessLogFlusher::schedule(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  if (threads_.empty()) {
+    for (uint32_t i = 0; i < num_threads_; i++) {
+      threads_.push_back(
+          api_.threadFactory().createThread([this]() -> void { flushThreadFunc(); }));
+    }
+  }
+
+  if (file.flush_queued_) {
+    return;
+  }
+  file.flush_queued_ = true;
+  queue_.push_back(&file);
+  stats_.flush_queue_size_.inc();
+  queue_event_.notifyOne();
+}
+
+void AccessLogFlusher::remove(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  if (file.flush_queued_) {
+    file.flush_queued_ = false;
+    queue_.remove(&file);
+    stats_.flush_queue_size_.dec();
+  }
+
+  while (file.flushing_) {
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    flush_complete_event_.wait(lock_);
+  }
+}
+
+void AccessLogFlusher::flushThreadFunc() {
+  while (true) {
+    AccessLogFileImpl* file;
+
+    {
+      Thread::LockGuard lock(lock_);
+      while (queue_.empty() && !exit_) {
+        queue_event_.wait(lock_);
+      }
+
+      if (exit_) {
+        return;
+      }
+
+      file = queue_.front();
+      queue_.pop_front();
+      stats_.flush_queue_size_.dec();
+      file->flush_queued_ = false;
+      file->flushing_ = true;
+    }
+
+    file->flushPending();
+
+    {
+      Thread::LockGuard lock(lock_);
+      file->flushing_ = false;
+      flush_complete_event_.notifyAll();
+    }
+  }
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
-                                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
+                                     Thread::BasicLockable& lock, const AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
+                                     AccessLogFlusherSharedPtr flusher)
     : file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        if (pending_bytes_ > 0 || reopen_file_) {
+          flusher_->schedule(*this);
+        }
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flush_interval_msec_(flush_interval_msec), stats_(stats), flusher_(std::move(flusher)) {
   open();
 }
 
@@ -80,20 +168,15 @@ void AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
+  flusher_->remove(*this);
 
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  Thread::LockGuard lock(flush_lock_);
+  takePendingWrites();
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    if (about_to_write_.length() > 0) {
+      doWrite();
     }
 
     const Api::IoCallBoolResult result = file_->close();
@@ -102,8 +185,24 @@ AccessLogFileImpl::~AccessLogFileImpl() {
   }
 }
 
-void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
-  Buffer::RawSliceVector slices = buffer.getRawSlices();
+void AccessLogFileImpl::takePendingWrites() {
+  const uint64_t length = about_to_write_.length();
+  {
+    // The slices of flush_buffer_ are moved rather than copied, which keeps the writers waiting
+    // as briefly as possible.
+    Thread::LockGuard lock(write_lock_);
+    about_to_write_.move(flush_buffer_);
+  }
+  pending_bytes_ -= about_to_write_.length() - length;
+}
+
+void AccessLogFileImpl::doWrite() {
+  const Buffer::RawSliceVector raw_slices = about_to_write_.getRawSlices();
+  absl::FixedArray<absl::string_view> slices(raw_slices.size());
+  for (uint64_t i = 0; i < raw_slices.size(); i++) {
+    slices[i] = absl::string_view(static_cast<const char*>(raw_slices[i].mem_), raw_slices[i].len_);
+  }
+  const uint64_t length = about_to_write_.length();
 
   // We must do the actual writes to disk under lock, so that we don't intermix chunks from
   // different AccessLogFileImpl pointing to the same underlying file. This can happen either via
@@ -115,107 +214,79 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   //            process lock or had multiple locks.
   {
     Thread::LockGuard lock(file_lock_);
-    for (const Buffer::RawSlice& slice : slices) {
-      absl::string_view data(static_cast<char*>(slice.mem_), slice.len_);
-      const Api::IoCallSizeResult result = file_->write(data);
-      if (result.ok() && result.rc_ == static_cast<ssize_t>(slice.len_)) {
-        stats_.write_completed_.inc();
-      } else {
-        // Probably disk full.
-        stats_.write_failed_.inc();
-      }
+    const Api::IoCallSizeResult result = file_->writev(slices.begin(), slices.size());
+    if (result.ok() && result.rc_ == static_cast<ssize_t>(length)) {
+      stats_.write_completed_.inc();
+    } else {
+      // Probably disk full.
+      stats_.write_failed_.inc();
     }
   }
 
-  stats_.write_total_buffered_.sub(buffer.length());
-  buffer.drain(buffer.length());
+  stats_.write_total_buffered_.sub(length);
+  about_to_write_.drain(length);
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
+void AccessLogFileImpl::flushPending() {
+  Thread::LockGuard lock(flush_lock_);
 
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
-
-    {
-      Thread::LockGuard write_lock(write_lock_);
-
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
-
-      if (flush_thread_exit_) {
-        return;
-      }
+  // if we failed to open file before, then simply ignore
+  if (!file_->isOpen()) {
+    return;
+  }
 
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+  try {
+    if (reopen_file_) {
+      reopen_file_ = false;
+      const Api::IoCallBoolResult result = file_->close();
+      ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                     result.err_->getErrorDetails()));
+      open();
     }
+  } catch (const EnvoyException&) {
+    stats_.reopen_failed_.inc();
+    return;
+  }
 
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          const Api::IoCallBoolResult result = file_->close();
-          ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                         result.err_->getErrorDetails()));
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
-      }
-    }
+  takePendingWrites();
+  if (about_to_write_.length() > 0) {
+    doWrite();
   }
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-
-    if (flush_buffer_.length() == 0) {
-      return;
-    }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+  Thread::LockGuard lock(flush_lock_);
+  takePendingWrites();
+  if (about_to_write_.length() > 0) {
+    doWrite();
   }
-
-  doWrite(about_to_write_buffer_);
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
-
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+  const uint64_t buffered = pending_bytes_.fetch_add(data.size()) + data.size();
+  if (buffered > MAX_BUFFER_SIZE &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.access_log_write_limit")) {
+    pending_bytes_ -= data.size();
+    stats_.write_dropped_.inc();
+    return;
   }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+
+  {
+    Thread::LockGuard lock(write_lock_);
+    flush_buffer_.add(data);
   }
-}
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
-  flush_timer_->enableTimer(flush_interval_msec_);
+  if (!flush_started_.load(std::memory_order_relaxed) && !flush_started_.exchange(true)) {
+    // The first write is flushed right away, later ones once enough data has been buffered or the
+    // timer fires.
+    flush_timer_->enableTimer(flush_interval_msec_);
+    flusher_->schedule(*this);
+  } else if (buffered > MIN_FLUSH_SIZE && buffered - data.size() <= MIN_FLUSH_SIZE) {
+    flusher_->schedule(*this);
+  }
 }
 
 } // namespace AccessLog
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -21,7 +24,9 @@ namespace Envoy {
   COUNTER(reopen_failed)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
+  GAUGE(flush_queue_size, NeverImport)                                                             \
   GAUGE(write_total_buffered, Accumulate)
 
 struct AccessLogFileStats {
@@ -30,15 +35,57 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * Flushes the buffered data of all of the access log files of a process on a fixed number of
+ * threads. Files which need flushing are queued, and every flush thread takes the next file from
+ * the queue, so that a file is never flushed by two threads at once. The threads are started by
+ * the first flush. The flusher is shared by the manager and its files, any of which may be
+ * destroyed last.
+ */
+class AccessLogFlusher {
+public:
+  AccessLogFlusher(Api::Api& api, uint32_t num_threads, const AccessLogFileStats& stats);
+  ~AccessLogFlusher();
+
+  /**
+   * Queue a file to be flushed, unless it is queued already.
+   */
+  void schedule(AccessLogFileImpl& file);
+
+  /**
+   * Remove a file from the queue, and wait for a flush of it which is in progress to complete.
+   * The flush threads do not access the file afterwards.
+   */
+  void remove(AccessLogFileImpl& file);
+
+private:
+  void flushThreadFunc();
+
+  Api::Api& api_;
+  const uint32_t num_threads_;
+  AccessLogFileStats stats_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar queue_event_;
+  Thread::CondVar flush_complete_event_;
+  std::list<AccessLogFileImpl*> queue_ ABSL_GUARDED_BY(lock_);
+  std::vector<Thread::ThreadPtr> threads_ ABSL_GUARDED_BY(lock_);
+  bool exit_ ABSL_GUARDED_BY(lock_){};
+};
+
+using AccessLogFlusherSharedPtr = std::shared_ptr<AccessLogFlusher>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
-                       Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
+  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec,
+                       uint32_t file_flush_threads, Api::Api& api, Event::Dispatcher& dispatcher,
+                       Thread::BasicLockable& lock, Stats::Store& stats_store)
       : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+        lock_(lock), file_stats_{ACCESS_LOG_FILE_STATS(
+                         POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                         POOL_GAUGE_PREFIX(stats_store, "filesystem."))},
+        flusher_(std::make_shared<AccessLogFlusher>(api, file_flush_threads, file_stats_)) {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -51,22 +98,23 @@ private:
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  const AccessLogFlusherSharedPtr flusher_;
   std::unordered_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore only buffered, in the order in which they arrive, and the buffered data is
+ * written to disk by the threads of an AccessLogFlusher shared by all files, with a single writev()
+ * call per flush.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
-                    Thread::BasicLockable& lock, AccessLogFileStats& stats,
+                    Thread::BasicLockable& lock, const AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlusherSharedPtr flusher);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -81,58 +129,57 @@ public:
   void flush() override;
 
 private:
-  void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  friend class AccessLogFlusher;
+
+  // Called by the flush threads.
+  void flushPending();
+  // Moves the pending writes into about_to_write_.
+  void takePendingWrites() ABSL_EXCLUSIVE_LOCKS_REQUIRED(flush_lock_);
+  void doWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(flush_lock_);
   void open();
-  void createFlushStructures();
 
   // return default flags set which used by open
   static Filesystem::FlagSet defaultFlags();
 
-  // Minimum size before the flush thread will be told to flush.
+  // Minimum size before the flusher will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Maximum size of the data waiting to be flushed. When
+  // envoy.reloadable_features.access_log_write_limit is enabled, writes beyond this are dropped
+  // rather than buffered without bound while the disk is not keeping up.
+  static const uint64_t MAX_BUFFER_SIZE = 1024 * 1024 * 64;
 
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
-  //    3) file_lock_
-  Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
-                                          // to disk. This is used to make sure that file blocks do
-                                          // not get interleaved by multiple processes writing to
-                                          // the same file during hot-restart.
+  //    1) flush_lock_
+  //    2) file_lock_ or write_lock_
+  Thread::BasicLockable& file_lock_;      // This lock is used only when writing to disk. This is
+                                          // used to make sure that file blocks do not get
+                                          // interleaved by multiple processes writing to the same
+                                          // file during hot-restart.
   Thread::MutexBasicLockable flush_lock_; // This lock is used to prevent simultaneous flushes from
-                                          // the flush thread and a synchronous flush. This protects
-                                          // concurrent access to the about_to_write_buffer_, fd_,
-                                          // and all other data used during flushing and file
-                                          // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+                                          // the flush threads and a synchronous flush. This
+                                          // protects about_to_write_, the file, and all other
+                                          // data used during flushing and file re-opening.
+  Thread::MutexBasicLockable write_lock_; // This lock is held by writers only while they append
+                                          // to flush_buffer_, and by flushes while they take it.
+  Buffer::OwnedImpl flush_buffer_ ABSL_GUARDED_BY(write_lock_); // The pending writes, in the order
+                                                                // they arrived.
+  std::atomic<uint64_t> pending_bytes_{}; // The size of the pending writes.
+  std::atomic<bool> flush_started_{};
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
-  // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
-  // through the std::make_unique assignment. I do not believe it's possible to annotate this
-  // properly now due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  Buffer::OwnedImpl about_to_write_ ABSL_GUARDED_BY(flush_lock_); // The writes taken by the
+                                                                   // current flush.
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
-  AccessLogFileStats& stats_;
+  AccessLogFileStats stats_;
+  const AccessLogFlusherSharedPtr flusher_;
+  // Whether the file is in the flusher's queue, and whether a flush thread is flushing it. Both
+  // are guarded by the flusher's lock.
+  bool flush_queued_{};
+  bool flushing_{};
 };
 
 } // namespace AccessLog
@@ -3,6 +3,7 @@
 #include <unistd.h>
 
 #include <cerrno>
+#include <cstdio>
 #include <string>
 
 #include "common/api/os_sys_calls_impl.h"
@@ -65,6 +66,20 @@ SysCallIntResult OsSysCallsImpl::recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec
 #endif
 }
 
+SysCallIntResult OsSysCallsImpl::sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#if ENVOY_MMSG_MORE
+  const int rc = ::sendmmsg(sockfd, msgvec, vlen, flags);
+  return {rc, rc != -1 ? 0 : errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+#endif
+}
+
 bool OsSysCallsImpl::supportsMmsg() const {
 #if ENVOY_MMSG_MORE
   return true;
@@ -73,6 +88,43 @@ bool OsSysCallsImpl::supportsMmsg() const {
 #endif
 }
 
+namespace {
+
+#if defined(__linux__)
+// Kernels which know a UDP socket option accept setting it to 0, which is also its default.
+bool supportsUdpSocketOption(int optname) {
+  const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    return false;
+  }
+  // Unlike setsockopt(), getsockopt() does not know UDP_GRO on all kernels which support it.
+  const int value = 0;
+  const bool supported = ::setsockopt(fd, SOL_UDP, optname, &value, sizeof(value)) == 0;
+  ::close(fd);
+  return supported;
+}
+#endif
+
+} // namespace
+
+bool OsSysCallsImpl::supportsUdpGso() const {
+#if defined(__linux__)
+  static const bool supported = supportsUdpSocketOption(UDP_SEGMENT);
+  return supported;
+#else
+  return false;
+#endif
+}
+
+bool OsSysCallsImpl::supportsUdpGro() const {
+#if defined(__linux__)
+  static const bool supported = supportsUdpSocketOption(UDP_GRO);
+  return supported;
+#else
+  return false;
+#endif
+}
+
 SysCallIntResult OsSysCallsImpl::ftruncate(int fd, off_t length) {
   const int rc = ::ftruncate(fd, length);
   return {rc, rc != -1 ? 0 : errno};
@@ -84,11 +136,36 @@ SysCallPtrResult OsSysCallsImpl::mmap(void* addr, size_t length, int prot, int f
   return {rc, rc != MAP_FAILED ? 0 : errno};
 }
 
+SysCallIntResult OsSysCallsImpl::munmap(void* addr, size_t length) {
+  const int rc = ::munmap(addr, length);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
 SysCallIntResult OsSysCallsImpl::stat(const char* pathname, struct stat* buf) {
   const int rc = ::stat(pathname, buf);
   return {rc, rc != -1 ? 0 : errno};
 }
 
+SysCallIntResult OsSysCallsImpl::fstat(int fd, struct stat* buf) {
+  const int rc = ::fstat(fd, buf);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult OsSysCallsImpl::open(const char* pathname, int flags) {
+  const int rc = ::open(pathname, flags);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult OsSysCallsImpl::rename(const char* oldpath, const char* newpath) {
+  const int rc = ::rename(oldpath, newpath);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult OsSysCallsImpl::unlink(const char* pathname) {
+  const int rc = ::unlink(pathname);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
 SysCallIntResult OsSysCallsImpl::setsockopt(os_fd_t sockfd, int level, int optname,
                                             const void* optval, socklen_t optlen) {
   const int rc = ::setsockopt(sockfd, level, optname, optval, optlen);
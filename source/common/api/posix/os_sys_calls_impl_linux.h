@@ -15,6 +15,9 @@ class LinuxOsSysCallsImpl : public LinuxOsSysCalls {
 public:
   // Api::LinuxOsSysCalls
   SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) override;
+  SysCallIntResult pipe2(int pipefd[2], int flags) override;
+  SysCallSizeResult splice(int fd_in, int fd_out, size_t len, unsigned int flags) override;
+  SysCallIntResult setPipeSize(int fd, int size) override;
 };
 
 using LinuxOsSysCallsSingleton = ThreadSafeSingleton<LinuxOsSysCallsImpl>;
@@ -304,21 +304,7 @@ void OwnedImpl::move(Instance& rhs, uint64_t length) {
 }
 
 Api::IoCallUint64Result OwnedImpl::read(Network::IoHandle& io_handle, uint64_t max_length) {
-  if (max_length == 0) {
-    return Api::ioCallUint64ResultNoError();
-  }
-  constexpr uint64_t MaxSlices = 2;
-  RawSlice slices[MaxSlices];
-  const uint64_t num_slices = reserve(max_length, slices, MaxSlices);
-  Api::IoCallUint64Result result = io_handle.readv(max_length, slices, num_slices);
-  uint64_t bytes_to_commit = result.ok() ? result.rc_ : 0;
-  ASSERT(bytes_to_commit <= max_length);
-  for (uint64_t i = 0; i < num_slices; i++) {
-    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(bytes_to_commit));
-    bytes_to_commit -= slices[i].len_;
-  }
-  commit(slices, num_slices);
-  return result;
+  return io_handle.read(*this, max_length);
 }
 
 uint64_t OwnedImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) {
@@ -475,13 +461,7 @@ bool OwnedImpl::startsWith(absl::string_view data) const {
 }
 
 Api::IoCallUint64Result OwnedImpl::write(Network::IoHandle& io_handle) {
-  constexpr uint64_t MaxSlices = 16;
-  RawSliceVector slices = getRawSlices(MaxSlices);
-  Api::IoCallUint64Result result = io_handle.writev(slices.begin(), slices.size());
-  if (result.ok() && result.rc_ > 0) {
-    drain(static_cast<uint64_t>(result.rc_));
-  }
-  return result;
+  return io_handle.write(*this);
 }
 
 OwnedImpl::OwnedImpl() = default;
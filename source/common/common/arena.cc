@@ -0,0 +1,36 @@
+#include "common/common/arena.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  ASSERT(alignment <= alignof(std::max_align_t));
+
+  allocations_++;
+  bytes_allocated_ += size;
+
+  if (size > block_size_) {
+    // Oversized allocations get their own block, leaving the current block in place for the
+    // following small allocations.
+    blocks_.emplace_back(new char[size]);
+    return blocks_.back().get();
+  }
+
+  size_t padding = (alignment - reinterpret_cast<uintptr_t>(current_) % alignment) % alignment;
+  if (current_ == nullptr || padding + size > remaining_) {
+    // new[] returns memory aligned for any fundamental type, so no padding is needed.
+    blocks_.emplace_back(new char[block_size_]);
+    current_ = blocks_.back().get();
+    remaining_ = block_size_;
+    padding = 0;
+  }
+
+  char* memory = current_ + padding;
+  current_ = memory + size;
+  remaining_ -= padding + size;
+  return memory;
+}
+
+} // namespace Envoy
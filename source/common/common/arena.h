@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Monotonic allocator for objects which all die together, e.g. the per-request objects owned by
+ * an HTTP stream. Memory is carved out of fixed size blocks and individual allocations are never
+ * freed; all blocks are released at once when the arena is destroyed. Objects placed in the arena
+ * must be destroyed (but not deleted) before the arena, see ArenaDeleter.
+ *
+ * The arena is not thread safe.
+ */
+class Arena : NonCopyable {
+public:
+  static constexpr uint32_t DefaultBlockSize = 4096;
+
+  explicit Arena(uint32_t block_size = DefaultBlockSize) : block_size_(block_size) {}
+
+  /**
+   * Allocate memory from the arena. Requests larger than the block size get a dedicated block.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two no larger than
+   *        alignof(std::max_align_t).
+   * @return a pointer to the allocated memory, valid until the arena is destroyed.
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @return the number of allocations served by the arena.
+   */
+  uint64_t allocations() const { return allocations_; }
+
+  /**
+   * @return the number of bytes handed out by the arena, excluding alignment padding.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return the number of blocks the arena obtained from the heap.
+   */
+  uint64_t blocks() const { return blocks_.size(); }
+
+private:
+  const uint32_t block_size_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* current_{};
+  size_t remaining_{};
+  uint64_t allocations_{};
+  uint64_t bytes_allocated_{};
+};
+
+/**
+ * Deleter for objects which may or may not have been placed in an Arena. Arena objects are only
+ * destroyed since their memory belongs to the arena, heap objects are deleted.
+ */
+template <class T> class ArenaDeleter {
+public:
+  ArenaDeleter() = default;
+  explicit ArenaDeleter(bool in_arena) : in_arena_(in_arena) {}
+
+  void operator()(T* object) const {
+    if (in_arena_) {
+      object->~T();
+    } else {
+      delete object;
+    }
+  }
+
+private:
+  bool in_arena_{};
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+/**
+ * Construct an object in an arena, or on the heap if no arena is supplied.
+ * @param arena supplies the arena to use, or nullptr to allocate from the heap.
+ * @param args supplies the constructor arguments.
+ * @return the new object, which must be destroyed before the arena.
+ */
+template <class T, class... Args> ArenaPtr<T> makeArenaPtr(Arena* arena, Args&&... args) {
+  if (arena == nullptr) {
+    return ArenaPtr<T>(new T(std::forward<Args>(args)...), ArenaDeleter<T>(false));
+  }
+  void* memory = arena->allocate(sizeof(T), alignof(T));
+  return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...), ArenaDeleter<T>(true));
+}
+
+} // namespace Envoy
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/common/macros.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Unbounded lock-free multi-producer single-consumer FIFO queue, based on
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/non-intrusive-mpsc-node-based-queue.
+ * push() may be called from any thread and takes a single atomic exchange. pop() must only be
+ * called from one thread at a time.
+ *
+ * Nodes are pooled. The consumer returns the nodes it is done with to a lock-free stack shared by
+ * the queues of the same type, and producers take the whole stack into a per thread cache when
+ * theirs is empty. Producers thus only allocate when no node is left over from earlier pops.
+ */
+template <class T> class MpscQueue : NonCopyable {
+public:
+  MpscQueue() : head_(allocateNode()), tail_(head_.load(std::memory_order_relaxed)) {
+    // The dummy node may come from the pool, and still point to the node which followed it.
+    tail_->next_.store(nullptr, std::memory_order_relaxed);
+  }
+
+  ~MpscQueue() {
+    T value;
+    while (pop(value)) {
+    }
+    releaseNode(tail_);
+  }
+
+  /**
+   * Append a value to the queue. May be called from any thread.
+   * @param value supplies the value to append.
+   */
+  void push(T value) {
+    Node* node = allocateNode();
+    node->value_ = std::move(value);
+    node->next_.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    // Until the node is linked, the consumer sees the queue end at prev.
+    prev->next_.store(node, std::memory_order_release);
+  }
+
+  /**
+   * Remove the value at the front of the queue. Must only be called from the consumer thread. A
+   * value whose push() has not returned yet may not be seen.
+   * @param value receives the value removed from the queue.
+   * @return bool whether a value was removed.
+   */
+  bool pop(T& value) {
+    Node* tail = tail_;
+    Node* next = tail->next_.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    // next becomes the dummy node at the front of the queue, and must not keep the value alive.
+    value = std::move(next->value_);
+    next->value_ = T();
+    tail_ = next;
+    releaseNode(tail);
+    return true;
+  }
+
+private:
+  struct Node {
+    std::atomic<Node*> next_{};
+    T value_{};
+    // Link in the free lists of the pool.
+    Node* free_next_{};
+  };
+
+  // Free nodes which are kept by each thread. Any others are deleted when the cache is refilled.
+  static constexpr uint32_t MaxCachedNodes = 1024;
+
+  struct NodeCache {
+    ~NodeCache() {
+      while (head_ != nullptr) {
+        Node* node = head_;
+        head_ = node->free_next_;
+        delete node;
+      }
+    }
+
+    Node* head_{};
+    uint32_t size_{};
+  };
+
+  // Nodes released by consumers, which have not been taken by a producer yet.
+  static std::atomic<Node*>& freeNodes() {
+    MUTABLE_CONSTRUCT_ON_FIRST_USE(std::atomic<Node*>, nullptr);
+  }
+
+  static NodeCache& nodeCache() {
+    static thread_local NodeCache cache;
+    return cache;
+  }
+
+  static Node* allocateNode() {
+    NodeCache& cache = nodeCache();
+    if (cache.head_ == nullptr) {
+      refillCache(cache);
+      if (cache.head_ == nullptr) {
+        return new Node();
+      }
+    }
+    Node* node = cache.head_;
+    cache.head_ = node->free_next_;
+    cache.size_--;
+    return node;
+  }
+
+  // Moves all the released nodes to the cache. Each node is visited once per use, so this takes
+  // O(1) amortized time per allocation.
+  static void refillCache(NodeCache& cache) {
+    Node* node = freeNodes().exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      Node* next = node->free_next_;
+      if (cache.size_ < MaxCachedNodes) {
+        node->free_next_ = cache.head_;
+        cache.head_ = node;
+        cache.size_++;
+      } else {
+        delete node;
+      }
+      node = next;
+    }
+  }
+
+  // Pushing onto the stack is not subject to ABA, as nodes are only ever taken off it all at once.
+  static void releaseNode(Node* node) {
+    std::atomic<Node*>& free_nodes = freeNodes();
+    node->free_next_ = free_nodes.load(std::memory_order_relaxed);
+    while (!free_nodes.compare_exchange_weak(node->free_next_, node, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+    }
+  }
+
+  // The most recently pushed node, written by producers.
+  std::atomic<Node*> head_;
+  // The dummy node before the front of the queue, only used by the consumer.
+  Node* tail_;
+};
+
+} // namespace Envoy
@@ -8,6 +8,7 @@
 #include "common/protobuf/utility.h"
 
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Regex {
@@ -73,8 +74,43 @@ private:
   const re2::RE2 regex_;
 };
 
+class CompiledGoogleReMatcherSet : public CompiledMatcherSet {
+public:
+  CompiledGoogleReMatcherSet(const std::vector<envoy::type::matcher::v3::RegexMatcher>& config)
+      : set_(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH) {
+    for (const auto& matcher : config) {
+      // Google Re is the only currently supported engine.
+      ASSERT(matcher.has_google_re2());
+      std::string error;
+      if (set_.Add(matcher.regex(), &error) < 0) {
+        throw EnvoyException(fmt::format("invalid regex '{}': {}", matcher.regex(), error));
+      }
+    }
+    if (!set_.Compile()) {
+      throw EnvoyException("unable to compile regex set");
+    }
+  }
+
+  // CompiledMatcherSet
+  bool match(absl::string_view value, std::vector<int>& matches) const override {
+    re2::RE2::Set::ErrorInfo error_info;
+    if (set_.Match(re2::StringPiece(value.data(), value.size()), &matches, &error_info)) {
+      return true;
+    }
+    return error_info.kind == re2::RE2::Set::kNoError;
+  }
+
+private:
+  re2::RE2::Set set_;
+};
+
 } // namespace
 
+CompiledMatcherSetPtr
+Utility::parseRegexSet(const std::vector<envoy::type::matcher::v3::RegexMatcher>& matchers) {
+  return std::make_unique<CompiledGoogleReMatcherSet>(matchers);
+}
+
 CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher) {
   // Google Re is the only currently supported engine.
   ASSERT(matcher.has_google_re2());
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <regex>
+#include <vector>
 
 #include "envoy/common/regex.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
@@ -38,6 +39,14 @@ public:
    * Construct a compiled regex matcher from a match config.
    */
   static CompiledMatcherPtr parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher);
+
+  /**
+   * Construct a compiled regex matcher set from a list of match configs. The expressions are
+   * matched against the entire value, as with parseRegex().
+   * @throw EnvoyException if any of the expressions is invalid or the set fails to compile.
+   */
+  static CompiledMatcherSetPtr
+  parseRegexSet(const std::vector<envoy::type::matcher::v3::RegexMatcher>& matchers);
 };
 
 } // namespace Regex
@@ -11,7 +11,6 @@
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
-#include "common/common/lock_guard.h"
 #include "common/common/thread.h"
 #include "common/event/file_event_impl.h"
 #include "common/event/libevent_scheduler.h"
@@ -67,6 +66,7 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
     stats_ = std::make_unique<DispatcherStats>(
         DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
+    record_post_wait_.store(true, std::memory_order_relaxed);
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
@@ -81,6 +81,9 @@ void DispatcherImpl::clearDeferredDeleteList() {
   }
 
   ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
+  if (stats_ != nullptr) {
+    stats_->deferred_delete_batch_size_.recordValue(num_to_delete);
+  }
 
   // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
   // use the other vector. We will get another callback to delete that vector.
@@ -180,14 +183,14 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+  PostedCallback posted{std::move(callback), MonotonicTime()};
+  if (record_post_wait_.load(std::memory_order_relaxed)) {
+    posted.posted_time_ = api_.timeSource().monotonicTime();
   }
-
-  if (do_post) {
+  post_callbacks_.push(std::move(posted));
+  // This is checked after the callback has been queued, so that either runPostCallbacks() sees the
+  // callback, or it has cleared the flag and the timer is enabled again.
+  if (!post_scheduled_.exchange(true, std::memory_order_acq_rel)) {
     post_timer_->enableTimer(std::chrono::milliseconds(0));
   }
 }
@@ -214,23 +217,22 @@ void DispatcherImpl::updateApproximateMonotonicTimeInternal() {
 }
 
 void DispatcherImpl::runPostCallbacks() {
+  // Callbacks which are posted from now on enable the timer again, as they may not be seen below.
+  post_scheduled_.exchange(false, std::memory_order_acq_rel);
   while (true) {
     // It is important that this declaration is inside the body of the loop so that the callback is
-    // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
-    // for each iteration, the previous iteration's callback is destructed when callback is
-    // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
-    // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
-    // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
-    {
-      Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
-        return;
-      }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
+    // destructed before the next one is popped and run.
+    PostedCallback posted;
+    if (!post_callbacks_.pop(posted)) {
+      return;
+    }
+    // Callbacks posted before the stats were created have no posted time.
+    if (stats_ != nullptr && posted.posted_time_ != MonotonicTime()) {
+      const auto wait = api_.timeSource().monotonicTime() - posted.posted_time_;
+      stats_->post_wait_us_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(wait).count());
     }
-    callback();
+    posted.callback_();
   }
 }
 
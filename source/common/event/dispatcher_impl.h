@@ -1,8 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <vector>
 
@@ -15,6 +15,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/common/mpsc_queue.h"
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
@@ -94,6 +95,12 @@ private:
   void updateApproximateMonotonicTimeInternal();
   void runPostCallbacks();
 
+  struct PostedCallback {
+    std::function<void()> callback_;
+    // When the callback was posted, if post_wait_us is recorded.
+    MonotonicTime posted_time_;
+  };
+
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
   // dispatcher run loop is executing on. We allow run_tid_ to be empty for tests where we don't
   // invoke run().
@@ -114,8 +121,13 @@ private:
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
-  Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ ABSL_GUARDED_BY(post_lock_);
+  MpscQueue<PostedCallback> post_callbacks_;
+  // Whether post() records the time at which callbacks are posted. This is only set once stats_
+  // has been created on the dispatcher thread, and may be read from any thread.
+  std::atomic<bool> record_post_wait_{};
+  // Whether post_timer_ has been enabled since the post callbacks were last run, so that posting
+  // more callbacks does not need to enable it again.
+  std::atomic<bool> post_scheduled_{};
   const ScopeTrackedObject* current_object_{};
   bool deferred_deleting_{};
   MonotonicTime approximate_monotonic_time_;
@@ -99,6 +99,12 @@ void LibeventScheduler::onCheckForStats(evwatch*, const evwatch_check_cb_info*,
   // from above to compute the actual polling duration, and store it for the next iteration of the
   // event loop to compute the loop duration.
   evutil_gettimeofday(&self->check_time_, nullptr);
+
+  // The events which polling found ready have been activated, but not run yet. Expired timers are
+  // only activated after this, and are not included.
+  self->stats_->poll_ready_events_.recordValue(
+      event_base_get_num_events(self->libevent_.get(), EVENT_BASE_COUNT_ACTIVE));
+
   if (self->timeout_set_) {
     timeval delta, delay;
     evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
@@ -25,6 +25,7 @@ protected:
   FlagsAndMode translateFlag(FlagSet in);
   void openFile(FlagSet flags) override;
   ssize_t writeFile(absl::string_view buffer) override;
+  ssize_t writevFile(const absl::string_view* slices, uint64_t num_slices) override;
   bool closeFile() override;
 
 private:
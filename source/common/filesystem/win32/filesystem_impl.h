@@ -23,6 +23,7 @@ protected:
   FlagsAndMode translateFlag(FlagSet in);
   void openFile(FlagSet in) override;
   ssize_t writeFile(absl::string_view buffer) override;
+  ssize_t writevFile(const absl::string_view* slices, uint64_t num_slices) override;
   bool closeFile() override;
 
 private:
@@ -47,6 +47,9 @@ namespace Http {
   COUNTER(downstream_rq_3xx)                                                                       \
   COUNTER(downstream_rq_4xx)                                                                       \
   COUNTER(downstream_rq_5xx)                                                                       \
+  COUNTER(downstream_rq_arena_allocations)                                                         \
+  COUNTER(downstream_rq_arena_blocks)                                                              \
+  COUNTER(downstream_rq_arena_bytes)                                                               \
   COUNTER(downstream_rq_completed)                                                                 \
   COUNTER(downstream_rq_http1_total)                                                               \
   COUNTER(downstream_rq_http2_total)                                                               \
@@ -255,6 +258,12 @@ public:
    */
   virtual absl::optional<std::chrono::milliseconds> idleTimeout() const PURE;
 
+  /**
+   * @return the shortest idle timeout that the reduce timeouts overload action scales the idle
+   * timeout down to.
+   */
+  virtual std::chrono::milliseconds overloadMinIdleTimeout() const PURE;
+
   /**
    * @return if the connection manager does routing base on router config, e.g. a Server::Admin impl
    * has no route config.
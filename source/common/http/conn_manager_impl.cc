@@ -1,5 +1,6 @@
 #include "common/http/conn_manager_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -37,6 +38,7 @@
 #include "common/http/utility.h"
 #include "common/network/utility.h"
 #include "common/router/config_impl.h"
+#include "common/runtime/runtime_features.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/stats/timespan_impl.h"
 
@@ -119,7 +121,13 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_manager ? overload_manager->getThreadLocalOverloadState().getState(
                                  Server::OverloadActionNames::get().DisableHttpKeepAlive)
                            : Server::OverloadManager::getInactiveState()),
-      time_source_(time_source) {}
+      overload_reduce_timeouts_ref_(
+          overload_manager ? overload_manager->getThreadLocalOverloadState().getState(
+                                 Server::OverloadActionNames::get().ReduceTimeouts)
+                           : Server::OverloadManager::getInactiveState()),
+      time_source_(time_source),
+      use_stream_arena_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_stream_arena")) {}
 
 const ResponseHeaderMap& ConnectionManagerImpl::continueHeader() {
   static const auto headers = createHeaderMap<ResponseHeaderMapImpl>(
@@ -141,7 +149,7 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   if (config_.idleTimeout()) {
     connection_idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
         [this]() -> void { onIdleTimeout(); });
-    connection_idle_timer_->enableTimer(config_.idleTimeout().value());
+    connection_idle_timer_->enableTimer(idleTimeout());
   }
 
   if (config_.maxConnectionDuration()) {
@@ -255,10 +263,22 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
   read_callbacks_->connection().dispatcher().deferredDelete(stream.removeFromList(streams_));
 
   if (connection_idle_timer_ && streams_.empty()) {
-    connection_idle_timer_->enableTimer(config_.idleTimeout().value());
+    connection_idle_timer_->enableTimer(idleTimeout());
   }
 }
 
+std::chrono::milliseconds ConnectionManagerImpl::idleTimeout() const {
+  // Idle connections are closed sooner as the reduce timeouts overload action scales up, but not
+  // sooner than the configured minimum, which an idle timeout shorter than it is kept at.
+  const std::chrono::milliseconds idle_timeout = config_.idleTimeout().value();
+  if (overload_reduce_timeouts_ref_ == Server::OverloadActionState::inactive()) {
+    return idle_timeout;
+  }
+  const auto scaled_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+      idle_timeout * (1 - overload_reduce_timeouts_ref_.value()));
+  return std::min(idle_timeout, std::max(scaled_timeout, config_.overloadMinIdleTimeout()));
+}
+
 RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encoder,
                                                  bool is_internally_created) {
   if (connection_idle_timer_) {
@@ -545,6 +565,9 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
       stream_info_(connection_manager_.codec_->protocol(), connection_manager_.timeSource(),
                    connection_manager.filterState()),
       upstream_options_(std::make_shared<Network::Socket::Options>()) {
+  if (connection_manager_.use_stream_arena_) {
+    arena_ = std::make_unique<Arena>();
+  }
   ASSERT(!connection_manager.config_.isRoutable() ||
              ((connection_manager.config_.routeConfigProvider() == nullptr &&
                connection_manager.config_.scopedRouteConfigProvider() != nullptr) ||
@@ -648,6 +671,11 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
   if (state_.successful_upgrade_) {
     connection_manager_.stats_.named_.downstream_cx_upgrades_active_.dec();
   }
+  if (arena_ != nullptr) {
+    connection_manager_.stats_.named_.downstream_rq_arena_allocations_.add(arena_->allocations());
+    connection_manager_.stats_.named_.downstream_rq_arena_blocks_.add(arena_->blocks());
+    connection_manager_.stats_.named_.downstream_rq_arena_bytes_.add(arena_->bytesAllocated());
+  }
 
   ASSERT(state_.filter_call_state_ == 0);
 }
@@ -693,14 +721,16 @@ void ConnectionManagerImpl::ActiveStream::onStreamMaxDurationReached() {
 
 void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
+  ActiveStreamDecoderFilterPtr wrapper =
+      makeArenaPtr<ActiveStreamDecoderFilter>(arena_.get(), *this, filter, dual_filter);
   filter->setDecoderFilterCallbacks(*wrapper);
   wrapper->moveIntoListBack(std::move(wrapper), decoder_filters_);
 }
 
 void ConnectionManagerImpl::ActiveStream::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(*this, filter, dual_filter));
+  ActiveStreamEncoderFilterPtr wrapper =
+      makeArenaPtr<ActiveStreamEncoderFilter>(arena_.get(), *this, filter, dual_filter);
   filter->setEncoderFilterCallbacks(*wrapper);
   wrapper->moveIntoList(std::move(wrapper), encoder_filters_);
 }
@@ -794,8 +824,7 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(RequestHeaderMapPtr&& he
   maybeEndDecode(end_stream);
 
   // Drop new requests when overloaded as soon as we have decoded the headers.
-  if (connection_manager_.overload_stop_accepting_requests_ref_ ==
-      Server::OverloadActionState::Active) {
+  if (connection_manager_.overload_stop_accepting_requests_ref_.isSaturated()) {
     // In this one special case, do not create the filter chain. If there is a risk of memory
     // overload it is more important to avoid unnecessary allocation than to create the filters.
     state_.created_filter_chain_ = true;
@@ -1659,7 +1688,7 @@ void ConnectionManagerImpl::ActiveStream::encodeHeadersInternal(ResponseHeaderMa
   }
 
   if (connection_manager_.drain_state_ == DrainState::NotDraining &&
-      connection_manager_.overload_disable_keepalive_ref_ == Server::OverloadActionState::Active) {
+      connection_manager_.overload_disable_keepalive_ref_.isSaturated()) {
     ENVOY_STREAM_LOG(debug, "disabling keepalive due to envoy overload", *this);
     connection_manager_.drain_state_ = DrainState::Closing;
     connection_manager_.stats_.named_.downstream_cx_overload_disable_keepalive_.inc();
@@ -30,6 +30,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
 #include "common/grpc/common.h"
@@ -221,7 +222,8 @@ private:
    */
   struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
                                      public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+                                     LinkedObject<ActiveStreamDecoderFilter,
+                                                  ArenaDeleter<ActiveStreamDecoderFilter>> {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -334,14 +336,15 @@ private:
     bool is_grpc_request_{};
   };
 
-  using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+  using ActiveStreamDecoderFilterPtr = ArenaPtr<ActiveStreamDecoderFilter>;
 
   /**
    * Wrapper for a stream encoder filter.
    */
   struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
                                      public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+                                     LinkedObject<ActiveStreamEncoderFilter,
+                                                  ArenaDeleter<ActiveStreamEncoderFilter>> {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -410,7 +413,7 @@ private:
     StreamEncoderFilterSharedPtr handle_;
   };
 
-  using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+  using ActiveStreamEncoderFilterPtr = ArenaPtr<ActiveStreamEncoderFilter>;
 
   // Used to abstract making of RouteConfig update request.
   // RdsRouteConfigUpdateRequester is used when an RdsRouteConfigProvider is configured,
@@ -705,6 +708,9 @@ private:
     RequestHeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     RequestTrailerMapPtr request_trailers_;
+    // Backing storage for the filter wrappers. Must be declared before the filter lists so that
+    // the wrappers are destroyed first. Null unless the connection manager uses stream arenas.
+    std::unique_ptr<Arena> arena_;
     std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
     std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
     std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
@@ -753,6 +759,8 @@ private:
   void doEndStream(ActiveStream& stream);
 
   void resetAllStreams(absl::optional<StreamInfo::ResponseFlag> response_flag);
+  // Returns the connection idle timeout, scaled down by the reduce timeouts overload action.
+  std::chrono::milliseconds idleTimeout() const;
   void onIdleTimeout();
   void onConnectionDurationTimeout();
   void onDrainTimeout();
@@ -791,8 +799,11 @@ private:
   // lookup in the hot path of processing each request.
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
+  const Server::OverloadActionState& overload_reduce_timeouts_ref_;
   TimeSource& time_source_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_;
+  // Latched at construction so that all streams on a connection agree on whether to use arenas.
+  const bool use_stream_arena_;
 };
 
 } // namespace Http
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
-#include <list>
+#include <iterator>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
 
 #include "envoy/http/header_map.h"
 
@@ -12,6 +15,8 @@
 #include "common/common/utility.h"
 #include "common/http/headers.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -108,7 +113,9 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    // Neighbours in the order of the HeaderList holding the entry.
+    HeaderEntryImpl* prev_{};
+    HeaderEntryImpl* next_{};
   };
 
   /**
@@ -143,68 +150,116 @@ protected:
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
    * of the list (as required by nghttp2) and otherwise maintains insertion order.
    *
-   * Note: the internal iterators held in fields make this unsafe to copy and move, since the
-   * reference to end() is not preserved across a move (see Notes in
-   * https://en.cppreference.com/w/cpp/container/list/list). The NonCopyable will suppress both copy
-   * and move constructors/assignment.
+   * Entries are constructed in place in a small number of geometrically growing blocks instead of
+   * one heap allocation per header, and are linked in list order through their prev_ and next_
+   * pointers, so erasing an entry is O(1). Blocks are never reallocated, so a pointer to an entry
+   * (such as the O(1) inline header slots) stays valid until that entry is removed. No block is
+   * allocated before the first insert, and slots of removed entries are reused by later inserts.
+   *
+   * Note: the raw entry storage makes this unsafe to copy and move. The NonCopyable will suppress
+   * both copy and move constructors/assignment.
    * TODO(htuch): Maybe we want this to movable one day; for now, our header map moves happen on
    * HeaderMapPtr, so the performance impact should not be evident.
    */
   class HeaderList : NonCopyable {
   public:
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    // Iterates over the entries in list order, or in reverse order.
+    template <bool Reverse> class Iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = HeaderEntryImpl*;
+      using difference_type = std::ptrdiff_t;
+      using pointer = HeaderEntryImpl* const*;
+      using reference = HeaderEntryImpl* const&;
+
+      explicit Iterator(HeaderEntryImpl* entry) : entry_(entry) {}
+
+      reference operator*() const { return entry_; }
+      Iterator& operator++() {
+        entry_ = Reverse ? entry_->prev_ : entry_->next_;
+        return *this;
+      }
+      Iterator operator++(int) {
+        Iterator it = *this;
+        ++*this;
+        return it;
+      }
+      bool operator==(const Iterator& rhs) const { return entry_ == rhs.entry_; }
+      bool operator!=(const Iterator& rhs) const { return entry_ != rhs.entry_; }
+
+    private:
+      HeaderEntryImpl* entry_;
+    };
+    using ConstIterator = Iterator<false>;
+    using ConstReverseIterator = Iterator<true>;
+
+    ~HeaderList() { clear(); }
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
     }
 
-    template <class Key, class... Value>
-    std::list<HeaderEntryImpl>::iterator insert(Key&& key, Value&&... value) {
+    template <class Key, class... Value> HeaderEntryImpl& insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      std::list<HeaderEntryImpl>::iterator i =
-          headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
-                           std::forward<Key>(key), std::forward<Value>(value)...);
-      if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
-        pseudo_headers_end_ = i;
+      HeaderEntryImpl* entry = new (allocateSlot())
+          HeaderEntryImpl(std::forward<Key>(key), std::forward<Value>(value)...);
+      if (is_pseudo_header) {
+        link(entry, pseudo_headers_tail_);
+        pseudo_headers_tail_ = entry;
+      } else {
+        link(entry, tail_);
       }
-      return i;
+      return *entry;
     }
 
-    std::list<HeaderEntryImpl>::iterator erase(std::list<HeaderEntryImpl>::iterator i) {
-      if (pseudo_headers_end_ == i) {
-        pseudo_headers_end_++;
-      }
-      return headers_.erase(i);
-    }
+    void erase(HeaderEntryImpl& entry);
 
     template <class UnaryPredicate> void remove_if(UnaryPredicate p) {
-      headers_.remove_if([&](const HeaderEntryImpl& entry) {
-        const bool to_remove = p(entry);
-        if (to_remove) {
-          if (pseudo_headers_end_ == entry.entry_) {
-            pseudo_headers_end_++;
-          }
+      HeaderEntryImpl* entry = head_;
+      while (entry != nullptr) {
+        HeaderEntryImpl* next = entry->next_;
+        if (p(*entry)) {
+          erase(*entry);
         }
-        return to_remove;
-      });
+        entry = next;
+      }
     }
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
-    size_t size() const { return headers_.size(); }
-    bool empty() const { return headers_.empty(); }
-    void clear() {
-      headers_.clear();
-      pseudo_headers_end_ = headers_.end();
-    }
+    ConstIterator begin() const { return ConstIterator(head_); }
+    ConstIterator end() const { return ConstIterator(nullptr); }
+    ConstReverseIterator rbegin() const { return ConstReverseIterator(tail_); }
+    ConstReverseIterator rend() const { return ConstReverseIterator(nullptr); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
 
   private:
-    std::list<HeaderEntryImpl> headers_;
-    std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+    using Slot = std::aligned_storage_t<sizeof(HeaderEntryImpl), alignof(HeaderEntryImpl)>;
+    // A released slot, which links to the next one.
+    struct FreeSlot {
+      FreeSlot* next_;
+    };
+
+    // The first block only holds a couple of entries, as trailers and many internally built maps
+    // have no more than that. Each following block doubles in size up to MaxBlockSize.
+    static constexpr uint32_t InitialBlockSize = 2;
+    static constexpr uint32_t MaxBlockSize = 64;
+
+    // Links entry after prev, or at the front if prev is nullptr.
+    void link(HeaderEntryImpl* entry, HeaderEntryImpl* prev);
+    void* allocateSlot();
+    void releaseSlot(HeaderEntryImpl* entry);
+
+    HeaderEntryImpl* head_{};
+    HeaderEntryImpl* tail_{};
+    // The last pseudo header, or nullptr if there is none.
+    HeaderEntryImpl* pseudo_headers_tail_{};
+    size_t size_{};
+    // 2 + 4 + 8 + 16 entries cover typical request headers without allocating this vector.
+    absl::InlinedVector<std::unique_ptr<Slot[]>, 4> blocks_;
+    uint32_t block_capacity_{};
+    uint32_t block_used_{};
+    FreeSlot* free_slots_{};
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
@@ -0,0 +1,290 @@
+#include "common/io/io_uring_impl.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Envoy {
+namespace Io {
+
+#if defined(__linux__)
+
+namespace {
+
+int ioUringSetup(uint32_t entries, io_uring_params* params) {
+  return ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+int ioUringEnter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int ioUringRegister(int fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+  return ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+// The ring indices are shared with the kernel, which updates them concurrently.
+uint32_t loadAcquire(const uint32_t* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+void storeRelease(uint32_t* p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+template <class T> T* offset(void* base, uint32_t off) {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + off);
+}
+
+} // namespace
+
+IoUringImpl::IoUringImpl(uint32_t entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = ioUringSetup(entries, &params);
+  if (ring_fd_ < 0) {
+    throw EnvoyException(fmt::format("unable to create io_uring: {}", strerror(errno)));
+  }
+  // Without a single mapping for both rings the kernel predates the features used here.
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+    ::close(ring_fd_);
+    throw EnvoyException("io_uring is not supported by the kernel");
+  }
+
+  rings_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                         params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  rings_ = ::mmap(nullptr, rings_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ring_fd_, IORING_OFF_SQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = rings_ == MAP_FAILED
+              ? MAP_FAILED
+              : ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_SQES);
+  if (rings_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    const int error = errno;
+    if (rings_ != MAP_FAILED) {
+      ::munmap(rings_, rings_size_);
+    }
+    ::close(ring_fd_);
+    throw EnvoyException(fmt::format("unable to map io_uring: {}", strerror(error)));
+  }
+
+  sq_.head_ = offset<uint32_t>(rings_, params.sq_off.head);
+  sq_.tail_ = offset<uint32_t>(rings_, params.sq_off.tail);
+  sq_.mask_ = *offset<uint32_t>(rings_, params.sq_off.ring_mask);
+  sq_.entries_ = *offset<uint32_t>(rings_, params.sq_off.ring_entries);
+  sq_.array_ = offset<uint32_t>(rings_, params.sq_off.array);
+  sq_.flags_ = offset<uint32_t>(rings_, params.sq_off.flags);
+  cq_.head_ = offset<uint32_t>(rings_, params.cq_off.head);
+  cq_.tail_ = offset<uint32_t>(rings_, params.cq_off.tail);
+  cq_.mask_ = *offset<uint32_t>(rings_, params.cq_off.ring_mask);
+  cq_.cqes_ = offset<void>(rings_, params.cq_off.cqes);
+  sqe_tail_ = *sq_.tail_;
+}
+
+IoUringImpl::~IoUringImpl() {
+  // Closing the ring cancels the requests that are still pending.
+  ::close(ring_fd_);
+  ::munmap(sqes_, sqes_size_);
+  ::munmap(rings_, rings_size_);
+  if (SOCKET_VALID(event_fd_)) {
+    ::close(event_fd_);
+  }
+}
+
+bool IoUringImpl::isSupported() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  const int fd = ioUringSetup(2, &params);
+  if (fd < 0) {
+    return false;
+  }
+  ::close(fd);
+  return (params.features & IORING_FEAT_SINGLE_MMAP) && (params.features & IORING_FEAT_NODROP);
+}
+
+os_fd_t IoUringImpl::registerEventfd() {
+  ASSERT(!SOCKET_VALID(event_fd_));
+  event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (!SOCKET_VALID(event_fd_) ||
+      ioUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) != 0) {
+    throw EnvoyException(fmt::format("unable to register io_uring eventfd: {}", strerror(errno)));
+  }
+  return event_fd_;
+}
+
+void IoUringImpl::clearEventfd() {
+  eventfd_t value;
+  ::eventfd_read(event_fd_, &value);
+}
+
+bool IoUringImpl::registerBuffers(const std::vector<iovec>& buffers) {
+  ASSERT(!buffers_registered_);
+  buffers_registered_ =
+      ioUringRegister(ring_fd_, IORING_REGISTER_BUFFERS, buffers.data(), buffers.size()) == 0;
+  return buffers_registered_;
+}
+
+void* IoUringImpl::getSqe() {
+  if (sqe_tail_ - loadAcquire(sq_.head_) >= sq_.entries_) {
+    return nullptr;
+  }
+  io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + (sqe_tail_ & sq_.mask_);
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  return sqe;
+}
+
+IoUringResult IoUringImpl::prepareReadFixed(os_fd_t fd, void* buf, uint32_t len,
+                                            uint16_t buf_index, void* user_data) {
+  ASSERT(buffers_registered_);
+  auto* sqe = static_cast<io_uring_sqe*>(getSqe());
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_READ_FIXED;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = len;
+  sqe->buf_index = buf_index;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  sqe_tail_++;
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareWritev(os_fd_t fd, const iovec* iovecs, uint32_t nr_vecs,
+                                         void* user_data) {
+  auto* sqe = static_cast<io_uring_sqe*>(getSqe());
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = nr_vecs;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  sqe_tail_++;
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::preparePollAdd(os_fd_t fd, uint32_t poll_mask, void* user_data) {
+  auto* sqe = static_cast<io_uring_sqe*>(getSqe());
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll_events = poll_mask;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  sqe_tail_++;
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareCancel(void* target_user_data, void* user_data) {
+  auto* sqe = static_cast<io_uring_sqe*>(getSqe());
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(target_user_data);
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  sqe_tail_++;
+  return IoUringResult::Ok;
+}
+
+uint32_t IoUringImpl::pendingSubmissions() const { return sqe_tail_ - loadAcquire(sq_.head_); }
+
+int IoUringImpl::submit() {
+  const uint32_t to_submit = pendingSubmissions();
+  if (to_submit == 0) {
+    return 0;
+  }
+  // Entries published by an earlier, partially failed, submission are submitted again.
+  for (uint32_t tail = *sq_.tail_; tail != sqe_tail_; tail++) {
+    sq_.array_[tail & sq_.mask_] = tail & sq_.mask_;
+  }
+  storeRelease(sq_.tail_, sqe_tail_);
+
+  int submitted;
+  do {
+    submitted = ioUringEnter(ring_fd_, to_submit, 0, 0);
+  } while (submitted < 0 && errno == EINTR);
+  return submitted < 0 ? -errno : submitted;
+}
+
+bool IoUringImpl::completionQueueOverflowed() const {
+  return loadAcquire(sq_.flags_) & IORING_SQ_CQ_OVERFLOW;
+}
+
+void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
+  while (true) {
+    uint32_t head = *cq_.head_;
+    const uint32_t tail = loadAcquire(cq_.tail_);
+    for (; head != tail; head++) {
+      const io_uring_cqe& cqe = static_cast<const io_uring_cqe*>(cq_.cqes_)[head & cq_.mask_];
+      completion_cb(reinterpret_cast<void*>(cqe.user_data), cqe.res);
+    }
+    storeRelease(cq_.head_, head);
+    if (!completionQueueOverflowed()) {
+      return;
+    }
+    // The completions which did not fit in the queue are kept by the kernel, which only moves them
+    // to the queue when asked for events.
+    int result;
+    do {
+      result = ioUringEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) {
+      return;
+    }
+  }
+}
+
+#else
+
+IoUringImpl::IoUringImpl(uint32_t) { throw EnvoyException("io_uring is only supported on Linux"); }
+
+IoUringImpl::~IoUringImpl() = default;
+
+bool IoUringImpl::isSupported() { return false; }
+
+os_fd_t IoUringImpl::registerEventfd() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+void IoUringImpl::clearEventfd() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool IoUringImpl::registerBuffers(const std::vector<iovec>&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+IoUringResult IoUringImpl::prepareReadFixed(os_fd_t, void*, uint32_t, uint16_t, void*) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+IoUringResult IoUringImpl::prepareWritev(os_fd_t, const iovec*, uint32_t, void*) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+IoUringResult IoUringImpl::preparePollAdd(os_fd_t, uint32_t, void*) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+IoUringResult IoUringImpl::prepareCancel(void*, void*) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+uint32_t IoUringImpl::pendingSubmissions() const { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+int IoUringImpl::submit() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool IoUringImpl::completionQueueOverflowed() const { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+void IoUringImpl::forEveryCompletion(const CompletionCb&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Io
+} // namespace Envoy
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "envoy/common/platform.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Io {
+
+/**
+ * Result of preparing a request on an IoUringImpl.
+ */
+enum class IoUringResult {
+  // The request was added to the submission queue.
+  Ok,
+  // The submission queue is full. The caller should submit() and try again.
+  Busy,
+};
+
+/**
+ * Callback invoked for each completed request.
+ * @param user_data supplies the value passed when the request was prepared.
+ * @param result supplies the result of the operation, i.e. the return value of the equivalent
+ *        system call or the negated errno value on failure.
+ */
+using CompletionCb = std::function<void(void* user_data, int32_t result)>;
+
+/**
+ * A Linux io_uring instance, driven directly through the io_uring_setup(2), io_uring_enter(2) and
+ * io_uring_register(2) system calls. Requests are only queued by the prepare*() methods and handed
+ * to the kernel in one batch by submit(). Not thread safe.
+ */
+class IoUringImpl : NonCopyable {
+public:
+  /**
+   * @param entries supplies the minimum number of submission queue entries.
+   * @throw EnvoyException if the ring cannot be created.
+   */
+  explicit IoUringImpl(uint32_t entries);
+  ~IoUringImpl();
+
+  /**
+   * @return whether the running kernel supports the io_uring features used by this class.
+   */
+  static bool isSupported();
+
+  /**
+   * Create an eventfd which becomes readable whenever requests complete.
+   * @return the eventfd, which is owned by the ring.
+   * @throw EnvoyException on failure.
+   */
+  os_fd_t registerEventfd();
+
+  /**
+   * Drain the counter of the eventfd returned by registerEventfd().
+   */
+  void clearEventfd();
+
+  /**
+   * Register buffers which can then be used by prepareReadFixed(). Can be called at most once.
+   * @return whether the buffers were registered.
+   */
+  bool registerBuffers(const std::vector<iovec>& buffers);
+
+  /**
+   * Prepare a read into a registered buffer.
+   * @param buf supplies the start of the destination, which must lie within the buffer.
+   * @param buf_index supplies the index of the buffer passed to registerBuffers().
+   */
+  IoUringResult prepareReadFixed(os_fd_t fd, void* buf, uint32_t len, uint16_t buf_index,
+                                 void* user_data);
+
+  /**
+   * Prepare a vectored write. The iovecs and the memory they point to must stay valid until the
+   * request completes.
+   */
+  IoUringResult prepareWritev(os_fd_t fd, const iovec* iovecs, uint32_t nr_vecs, void* user_data);
+
+  /**
+   * Prepare a one shot poll for the events in poll_mask, e.g. POLLIN.
+   */
+  IoUringResult preparePollAdd(os_fd_t fd, uint32_t poll_mask, void* user_data);
+
+  /**
+   * Prepare the cancellation of the pending request with user data target_user_data. The
+   * cancelled request completes with -ECANCELED unless it completes first.
+   */
+  IoUringResult prepareCancel(void* target_user_data, void* user_data);
+
+  /**
+   * Hand all prepared requests to the kernel.
+   * @return the number of requests submitted, or the negated errno value on failure.
+   */
+  int submit();
+
+  /**
+   * @return the number of prepared requests which the kernel has not consumed yet.
+   */
+  uint32_t pendingSubmissions() const;
+
+  /**
+   * @return whether completions did not fit in the completion queue, and are kept by the kernel
+   *         until forEveryCompletion() makes room for them.
+   */
+  bool completionQueueOverflowed() const;
+
+  /**
+   * Invoke the callback for every request that completed since the last call.
+   */
+  void forEveryCompletion(const CompletionCb& completion_cb);
+
+private:
+  struct SubmissionQueue {
+    uint32_t* head_{};
+    uint32_t* tail_{};
+    uint32_t mask_{};
+    uint32_t entries_{};
+    uint32_t* array_{};
+    uint32_t* flags_{};
+  };
+
+  struct CompletionQueue {
+    uint32_t* head_{};
+    uint32_t* tail_{};
+    uint32_t mask_{};
+    void* cqes_{};
+  };
+
+  // Returns the next free submission queue entry, cleared, or nullptr if the queue is full.
+  void* getSqe();
+
+  os_fd_t ring_fd_{INVALID_SOCKET};
+  os_fd_t event_fd_{INVALID_SOCKET};
+  // Mapping of both the submission and the completion queue rings.
+  void* rings_{};
+  size_t rings_size_{};
+  void* sqes_{};
+  size_t sqes_size_{};
+  SubmissionQueue sq_;
+  CompletionQueue cq_;
+  // Tail of the prepared, but not necessarily submitted, entries.
+  uint32_t sqe_tail_{};
+  bool buffers_registered_{};
+};
+
+} // namespace Io
+} // namespace Envoy
@@ -0,0 +1,261 @@
+#include "common/io/io_uring_worker.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+#ifndef WIN32
+#include <poll.h>
+#endif
+
+namespace Envoy {
+namespace Io {
+
+namespace {
+constexpr uint32_t DefaultEntries = 4096;
+constexpr uint32_t DefaultReadBuffers = 1024;
+constexpr uint32_t DefaultReadBufferSize = 16384;
+// Shorter data is copied out of registered buffers, so that short reads do not hold on to a whole
+// buffer.
+constexpr uint32_t MinMovedDataLength = 4096;
+} // namespace
+
+IoUringWorker::IoUringWorker(const envoy::config::bootstrap::v3::IoUring& config,
+                             Event::Dispatcher& dispatcher)
+    : dispatcher_(dispatcher),
+      buffer_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, read_buffer_size, DefaultReadBufferSize)),
+      pool_(std::make_shared<BufferPool>()),
+      io_uring_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, entries, DefaultEntries)) {
+  const uint32_t buffer_count =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, read_buffers, DefaultReadBuffers);
+  if (buffer_count > 0) {
+    std::vector<iovec> iovecs;
+    iovecs.reserve(buffer_count);
+    pool_->buffers_.reserve(buffer_count);
+    for (uint32_t i = 0; i < buffer_count; i++) {
+      Buffer::SlicePtr slice = Buffer::OwnedSlice::create(buffer_size_);
+      // The reservation is never committed: the slice only provides the memory.
+      const Buffer::RawSlice reservation = slice->reserve(buffer_size_);
+      ASSERT(reservation.len_ == buffer_size_);
+      iovecs.push_back({reservation.mem_, reservation.len_});
+      pool_->buffers_.push_back({std::move(slice), static_cast<uint8_t*>(reservation.mem_)});
+    }
+    if (io_uring_.registerBuffers(iovecs)) {
+      pool_->free_buffers_.reserve(buffer_count);
+      for (uint32_t i = buffer_count; i > 0; i--) {
+        pool_->free_buffers_.push_back(i - 1);
+      }
+    } else {
+      // Registration counts against RLIMIT_MEMLOCK. All reads then wait for readability instead.
+      ENVOY_LOG(warn, "unable to register {} io_uring read buffers", buffer_count);
+      pool_->buffers_.clear();
+    }
+  }
+
+  eventfd_event_ = dispatcher_.createFileEvent(
+      io_uring_.registerEventfd(), [this](uint32_t) { onEventfdReady(); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+  submit_timer_ = dispatcher_.createTimer([this]() { submit(); });
+}
+
+IoUringWorker::~IoUringWorker() {
+  eventfd_event_.reset();
+  for (const auto& request : pending_requests_) {
+    if (request.second->close_on_completion_) {
+      Api::OsSysCallsSingleton::get().close(request.second->fd_);
+    }
+  }
+}
+
+template <class Prepare> void IoUringWorker::prepare(Prepare prepare_fn) {
+  // Once a preparation overflowed, the later ones wait behind it, so that the requests on a socket
+  // reach the kernel in order.
+  if (overflow_.empty()) {
+    IoUringResult result = prepare_fn();
+    if (result == IoUringResult::Busy) {
+      submit();
+      result = prepare_fn();
+    }
+    if (result == IoUringResult::Ok) {
+      if (!processing_completions_ && !submit_timer_->enabled()) {
+        submit_timer_->enableTimer(std::chrono::milliseconds(0));
+      }
+      return;
+    }
+  }
+  // The kernel does not consume entries while the completion queue is full. The preparation is
+  // retried once the completions have been processed.
+  overflow_.emplace_back(std::move(prepare_fn));
+}
+
+IoUringRequest* IoUringWorker::createRequest(IoUringRequest::Type type, os_fd_t fd,
+                                             IoUringRequestHandler* handler) {
+  const uint64_t id = next_request_id_++;
+  auto request = std::make_unique<IoUringRequest>(type, id, fd, handler);
+  IoUringRequest* raw = request.get();
+  pending_requests_.emplace(id, std::move(request));
+  return raw;
+}
+
+IoUringRequest* IoUringWorker::submitRead(os_fd_t fd, IoUringRequestHandler& handler) {
+  IoUringRequest* request;
+  if (!pool_->free_buffers_.empty()) {
+    request = createRequest(IoUringRequest::Type::Read, fd, &handler);
+    request->buffer_index_ = pool_->free_buffers_.back();
+    pool_->free_buffers_.pop_back();
+    prepare([this, request]() {
+      return io_uring_.prepareReadFixed(
+          request->fd_, pool_->buffers_[request->buffer_index_].iov_base_, buffer_size_,
+          request->buffer_index_, reinterpret_cast<void*>(request->id_));
+    });
+  } else {
+    request = createRequest(IoUringRequest::Type::Poll, fd, &handler);
+    prepare([this, request]() {
+      return io_uring_.preparePollAdd(request->fd_, POLLIN, reinterpret_cast<void*>(request->id_));
+    });
+  }
+  return request;
+}
+
+IoUringRequest* IoUringWorker::submitWrite(os_fd_t fd, Buffer::Instance& data,
+                                           IoUringRequestHandler& handler) {
+  IoUringRequest* request = createRequest(IoUringRequest::Type::Write, fd, &handler);
+  request->data_.move(data);
+  prepareWrite(*request);
+  return request;
+}
+
+void IoUringWorker::prepareWrite(IoUringRequest& request) {
+  const Buffer::RawSliceVector slices = request.data_.getRawSlices();
+  request.iovecs_.clear();
+  request.iovecs_.reserve(slices.size());
+  for (const Buffer::RawSlice& slice : slices) {
+    request.iovecs_.push_back({slice.mem_, slice.len_});
+  }
+  prepare([this, &request]() {
+    return io_uring_.prepareWritev(request.fd_, request.iovecs_.data(), request.iovecs_.size(),
+                                   reinterpret_cast<void*>(request.id_));
+  });
+}
+
+void IoUringWorker::cancel(IoUringRequest& request) {
+  ASSERT(request.type_ == IoUringRequest::Type::Read ||
+         request.type_ == IoUringRequest::Type::Poll);
+  request.handler_ = nullptr;
+  const uint64_t target = request.id_;
+  const uint64_t id = createRequest(IoUringRequest::Type::Cancel, request.fd_, nullptr)->id_;
+  prepare([this, target, id]() {
+    return io_uring_.prepareCancel(reinterpret_cast<void*>(target), reinterpret_cast<void*>(id));
+  });
+}
+
+void IoUringWorker::releaseBuffer(uint16_t index) { pool_->free_buffers_.push_back(index); }
+
+void IoUringWorker::moveBufferData(uint16_t index, uint32_t offset, uint32_t length,
+                                   Buffer::Instance& output) {
+  const uint8_t* data = pool_->buffers_[index].iov_base_ + offset;
+  if (length < MinMovedDataLength) {
+    output.add(data, length);
+    releaseBuffer(index);
+    return;
+  }
+  // The pool is captured rather than the worker, whose thread local slot may be destroyed first.
+  auto* fragment = new Buffer::BufferFragmentImpl(
+      data, length,
+      [pool = pool_, index](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+        pool->free_buffers_.push_back(index);
+        delete fragment;
+      });
+  output.addBufferFragment(*fragment);
+}
+
+void IoUringWorker::submit() {
+  // Completions which do not fit in the completion queue are buffered by the kernel without bound.
+  // Entries stay queued instead until the completions have been processed.
+  if (io_uring_.completionQueueOverflowed()) {
+    return;
+  }
+  const int result = io_uring_.submit();
+  // Failures mean that the completion queue is full. The entries stay queued and are submitted
+  // again after the next completions have been processed.
+  if (result < 0) {
+    ENVOY_LOG(debug, "io_uring submission failed: {}", strerror(-result));
+  }
+}
+
+void IoUringWorker::onEventfdReady() {
+  io_uring_.clearEventfd();
+  processing_completions_ = true;
+  io_uring_.forEveryCompletion(
+      [this](void* user_data, int32_t result) {
+        onCompletion(reinterpret_cast<uint64_t>(user_data), result);
+      });
+  processing_completions_ = false;
+  prepareOverflow();
+  // Submit what the handlers prepared right away, together with anything prepared earlier in this
+  // event loop iteration.
+  submit_timer_->disableTimer();
+  submit();
+}
+
+void IoUringWorker::prepareOverflow() {
+  while (!overflow_.empty()) {
+    if (overflow_.front()() == IoUringResult::Busy) {
+      submit();
+      if (overflow_.front()() == IoUringResult::Busy) {
+        // Still no room. The rest is prepared after the next completions.
+        return;
+      }
+    }
+    overflow_.pop_front();
+  }
+}
+
+void IoUringWorker::onCompletion(uint64_t id, int32_t result) {
+  auto it = pending_requests_.find(id);
+  ASSERT(it != pending_requests_.end());
+  IoUringRequest* request = it->second.get();
+  if (request->type_ == IoUringRequest::Type::Write && result > 0) {
+    request->data_.drain(result);
+    if (request->data_.length() > 0) {
+      // Short write. Keep writing the rest without involving the handler.
+      prepareWrite(*request);
+      return;
+    }
+  }
+
+  const std::unique_ptr<IoUringRequest> owned = std::move(it->second);
+  pending_requests_.erase(it);
+  if (request->handler_ != nullptr) {
+    request->handler_->onRequestCompleted(*request, result);
+  } else if (request->type_ == IoUringRequest::Type::Read) {
+    releaseBuffer(request->buffer_index_);
+  }
+  if (request->close_on_completion_) {
+    Api::OsSysCallsSingleton::get().close(request->fd_);
+  }
+}
+
+IoUringFactory::IoUringFactory(const envoy::config::bootstrap::v3::IoUring& config,
+                               ThreadLocal::SlotAllocator& tls)
+    : slot_(tls.allocateSlot()) {
+  slot_->set([config](Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<IoUringWorker>(config, dispatcher);
+  });
+}
+
+IoUringWorker* IoUringFactory::currentThreadWorker() {
+  if (!slot_->currentThreadRegistered() || slot_->get() == nullptr) {
+    return nullptr;
+  }
+  return &slot_->getTyped<IoUringWorker>();
+}
+
+} // namespace Io
+} // namespace Envoy
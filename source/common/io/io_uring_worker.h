@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/timer.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+#include "common/io/io_uring_impl.h"
+#include "common/singleton/threadsafe_singleton.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Io {
+
+class IoUringRequestHandler;
+
+/**
+ * A request submitted through an IoUringWorker. Owned by the worker.
+ */
+struct IoUringRequest {
+  enum class Type { Read, Poll, Write, Cancel };
+
+  IoUringRequest(Type type, uint64_t id, os_fd_t fd, IoUringRequestHandler* handler)
+      : type_(type), id_(id), fd_(fd), handler_(handler) {}
+
+  const Type type_;
+  // Identifies the request to the kernel. Unlike the address of the request, it is never reused,
+  // so a cancellation cannot hit a later request.
+  const uint64_t id_;
+  const os_fd_t fd_;
+  // Receives the completion. Cleared when the completion is no longer of interest, e.g. once the
+  // socket the request was made for has been closed.
+  IoUringRequestHandler* handler_;
+  // Index of the registered buffer of a Read request.
+  uint16_t buffer_index_{};
+  // The data of a Write request, which the kernel reads until the request completes.
+  Buffer::OwnedImpl data_;
+  std::vector<iovec> iovecs_;
+  // Whether to close fd_ once a Write request completes, for sockets closed while writing.
+  bool close_on_completion_{};
+};
+
+/**
+ * Receives the completions of the requests submitted for a socket.
+ */
+class IoUringRequestHandler {
+public:
+  virtual ~IoUringRequestHandler() = default;
+
+  /**
+   * Called when a request completes.
+   * @param request supplies the request, which is destroyed once this returns. A completed Read
+   *        request leaves its registered buffer to the handler, which must return it with
+   *        IoUringWorker::releaseBuffer().
+   * @param result supplies the result of the operation: the number of bytes read or written, the
+   *        polled events, or the negated errno value on failure. Write requests only complete once
+   *        all of their data was written or writing failed.
+   */
+  virtual void onRequestCompleted(IoUringRequest& request, int32_t result) PURE;
+};
+
+/**
+ * Owns the io_uring instance of a thread. Requests submitted from within a dispatcher callback are
+ * batched and handed to the kernel together, once per event loop iteration, and completions are
+ * delivered from the dispatcher when the ring's eventfd becomes readable.
+ *
+ * Reads go into a pool of buffers, allocated as Buffer::OwnedSlice memory and registered with the
+ * ring so that the kernel does not have to map them for every request. A socket holds a buffer
+ * while its read is pending and, once the data has been moved out without copying it, until the
+ * data has been drained. When the pool is exhausted the socket waits for readability with a poll
+ * request instead.
+ */
+class IoUringWorker : public ThreadLocal::ThreadLocalObject, Logger::Loggable<Logger::Id::io> {
+public:
+  IoUringWorker(const envoy::config::bootstrap::v3::IoUring& config,
+                Event::Dispatcher& dispatcher);
+  ~IoUringWorker() override;
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+
+  /**
+   * Start reading from a socket into a registered buffer or, if none is free, start polling the
+   * socket for readability.
+   */
+  IoUringRequest* submitRead(os_fd_t fd, IoUringRequestHandler& handler);
+
+  /**
+   * Start writing data to a socket.
+   * @param data supplies the data, which is moved into the request.
+   */
+  IoUringRequest* submitWrite(os_fd_t fd, Buffer::Instance& data, IoUringRequestHandler& handler);
+
+  /**
+   * Cancel a pending Read or Poll request. Its handler is not called anymore.
+   */
+  void cancel(IoUringRequest& request);
+
+  /**
+   * @return the start of a registered buffer.
+   */
+  const uint8_t* bufferData(uint16_t index) const { return pool_->buffers_[index].iov_base_; }
+
+  /**
+   * Return a registered buffer to the pool once the data read into it has been consumed.
+   */
+  void releaseBuffer(uint16_t index);
+
+  /**
+   * Move data read into a registered buffer to the end of a Buffer::Instance. Longer data is
+   * referenced rather than copied, in which case the registered buffer only returns to the pool
+   * once the data has been drained from the output, which must happen on this thread. Otherwise
+   * the registered buffer returns to the pool right away.
+   * @param index supplies the registered buffer, which the caller gives up.
+   * @param offset supplies the start of the data in the registered buffer.
+   * @param length supplies the length of the data.
+   * @param output supplies the buffer to move the data to.
+   */
+  void moveBufferData(uint16_t index, uint32_t offset, uint32_t length, Buffer::Instance& output);
+
+  /**
+   * @return the number of registered buffers which are not in use.
+   */
+  size_t freeBuffers() const { return pool_->free_buffers_.size(); }
+
+private:
+  struct RegisteredBuffer {
+    Buffer::SlicePtr slice_;
+    uint8_t* iov_base_;
+  };
+
+  // Shared with the data moved out of the registered buffers, which may outlive the worker.
+  struct BufferPool {
+    std::vector<RegisteredBuffer> buffers_;
+    std::vector<uint16_t> free_buffers_;
+  };
+
+  // Adds a request to the submission queue, making room by submitting if the queue is full. If the
+  // kernel cannot take entries, the preparation is kept in overflow_ instead.
+  template <class Prepare> void prepare(Prepare prepare_fn);
+  // Prepares the requests kept in overflow_, for as long as there is room.
+  void prepareOverflow();
+  IoUringRequest* createRequest(IoUringRequest::Type type, os_fd_t fd,
+                                IoUringRequestHandler* handler);
+  void prepareWrite(IoUringRequest& request);
+  void submit();
+  void onEventfdReady();
+  void onCompletion(uint64_t id, int32_t result);
+
+  Event::Dispatcher& dispatcher_;
+  const uint32_t buffer_size_;
+  const std::shared_ptr<BufferPool> pool_;
+  Event::FileEventPtr eventfd_event_;
+  // Submits the requests prepared during an event loop iteration.
+  Event::TimerPtr submit_timer_;
+  bool processing_completions_{};
+  uint64_t next_request_id_{1};
+  absl::flat_hash_map<uint64_t, std::unique_ptr<IoUringRequest>> pending_requests_;
+  // Preparations which did not fit in the submission queue, oldest first.
+  std::deque<std::function<IoUringResult()>> overflow_;
+  // Declared last so that the ring, whose destruction cancels the pending requests, is destroyed
+  // before the buffers and requests the kernel may still use.
+  IoUringImpl io_uring_;
+};
+
+/**
+ * Creates an IoUringWorker on every thread registered for thread local storage.
+ */
+class IoUringFactory {
+public:
+  IoUringFactory(const envoy::config::bootstrap::v3::IoUring& config,
+                 ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * @return the worker of the calling thread, or nullptr if the thread has none.
+   */
+  IoUringWorker* currentThreadWorker();
+
+  /**
+   * @return whether io_uring can be used on this host.
+   */
+  static bool isSupported() { return IoUringImpl::isSupported(); }
+
+private:
+  ThreadLocal::SlotPtr slot_;
+};
+
+/**
+ * Set when io_uring is enabled in the bootstrap.
+ */
+using IoUringFactorySingleton = InjectableSingleton<IoUringFactory>;
+using ScopedIoUringFactorySingleton = ScopedInjectableLoader<IoUringFactory>;
+
+} // namespace Io
+} // namespace Envoy
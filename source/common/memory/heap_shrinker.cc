@@ -17,7 +17,7 @@ HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManage
   const auto action_name = Server::OverloadActionNames::get().ShrinkHeap;
   if (overload_manager.registerForAction(action_name, dispatcher,
                                          [this](Server::OverloadActionState state) {
-                                           active_ = (state == Server::OverloadActionState::Active);
+                                           active_ = state.isSaturated();
                                          })) {
     Envoy::Stats::StatNameManagedStorage stat_name(
         absl::StrCat("overload.", action_name, ".shrink_count"), stats.symbolTable());
@@ -1,5 +1,9 @@
 #include "common/network/connection_balancer_impl.h"
 
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
 namespace Envoy {
 namespace Network {
 
@@ -34,5 +38,86 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+ReusePortConnectionBalancerImpl::ReusePortConnectionBalancerImpl(uint32_t max_handlers,
+                                                                 Stats::Scope& scope)
+    : stats_({ALL_REUSE_PORT_BALANCER_STATS(POOL_COUNTER_PREFIX(scope, "connection_balancer."),
+                                            POOL_GAUGE_PREFIX(scope, "connection_balancer."))}),
+      handlers_(max_handlers) {
+  try {
+    steering_ = std::make_unique<ReusePortSteering>(max_handlers);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "reuse port connection balancing is disabled: {}", e.what());
+  }
+}
+
+void ReusePortConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  if (steering_ == nullptr) {
+    return;
+  }
+  absl::MutexLock lock(&lock_);
+  auto slot = std::find(handlers_.begin(), handlers_.end(), nullptr);
+  if (slot == handlers_.end()) {
+    ENVOY_LOG(warn, "reuse port connection balancing has no slot left for the handler");
+    stats_.steering_error_.inc();
+    return;
+  }
+  try {
+    steering_->addSocket(slot - handlers_.begin(), handler.listenSocket().ioHandle().fd());
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "reuse port connection balancing does not include the handler: {}", e.what());
+    stats_.steering_error_.inc();
+    return;
+  }
+  *slot = &handler;
+  stats_.steering_handlers_.inc();
+}
+
+void ReusePortConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  if (steering_ == nullptr) {
+    return;
+  }
+  absl::MutexLock lock(&lock_);
+  // Handlers which could not be added are not found.
+  auto slot = std::find(handlers_.begin(), handlers_.end(), &handler);
+  if (slot != handlers_.end()) {
+    steering_->removeSocket(slot - handlers_.begin());
+    *slot = nullptr;
+    stats_.steering_handlers_.dec();
+  }
+}
+
+BalancedConnectionHandler&
+ReusePortConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  // The connection has already been accepted by the kernel on the socket of this handler.
+  current_handler.incNumConnections();
+  if (steering_ == nullptr) {
+    return current_handler;
+  }
+
+  int64_t min_slot = -1;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    uint64_t min_connections = 0;
+    for (uint32_t slot = 0; slot < handlers_.size(); ++slot) {
+      const BalancedConnectionHandler* handler = handlers_[slot];
+      if (handler != nullptr && (min_slot == -1 || handler->numConnections() < min_connections)) {
+        min_slot = slot;
+        min_connections = handler->numConnections();
+      }
+    }
+  }
+
+  // Only one of the handlers accepting concurrently updates the steering for a given change.
+  if (min_slot != -1 && target_slot_.exchange(min_slot) != min_slot) {
+    if (steering_->steerTo(min_slot)) {
+      stats_.steering_update_.inc();
+    } else {
+      stats_.steering_error_.inc();
+      target_slot_ = -1;
+    }
+  }
+  return current_handler;
+}
+
 } // namespace Network
 } // namespace Envoy
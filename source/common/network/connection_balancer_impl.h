@@ -1,6 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "envoy/network/connection_balancer.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+#include "common/network/reuse_port_steering.h"
 
 #include "absl/synchronization/mutex.h"
 
@@ -27,6 +35,57 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ GUARDED_BY(lock_);
 };
 
+/**
+ * All reuse port connection balancer stats. @see stats_macros.h
+ */
+#define ALL_REUSE_PORT_BALANCER_STATS(COUNTER, GAUGE)                                              \
+  COUNTER(steering_error)                                                                          \
+  COUNTER(steering_update)                                                                         \
+  GAUGE(steering_handlers, NeverImport)
+
+/**
+ * Struct definition for all reuse port connection balancer stats. @see stats_macros.h
+ */
+struct ReusePortBalancerStats {
+  ALL_REUSE_PORT_BALANCER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Implementation of connection balancer for listeners with reuse_port, where each handler has its
+ * own listen socket in the SO_REUSEPORT group of the listener. Rather than handing connections
+ * off to other handlers once they have been accepted, the kernel is made to queue new connections
+ * on the socket of the handler with the fewest connections (@see ReusePortSteering). Each accept
+ * re-evaluates which handler that is, and the steering is only updated when it changes, so
+ * connections always stay on the handler which accepted them. Balancing is approximate as
+ * connections which are queued but not yet accepted are not accounted for.
+ *
+ * If the steering program cannot be loaded, connections are spread by the kernel hashing of the
+ * group, as without a balancer.
+ */
+class ReusePortConnectionBalancerImpl : public ConnectionBalancer,
+                                        Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param max_handlers supplies the maximum number of handlers, i.e. the number of workers.
+   * @param scope supplies the scope of the listener.
+   */
+  ReusePortConnectionBalancerImpl(uint32_t max_handlers, Stats::Scope& scope);
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  ReusePortBalancerStats stats_;
+  std::unique_ptr<ReusePortSteering> steering_;
+  absl::Mutex lock_;
+  // Indexed by the slot of the socket of each handler in the steering, nullptr for free slots.
+  std::vector<BalancedConnectionHandler*> handlers_ GUARDED_BY(lock_);
+  // The slot which connections are currently steered to, or -1 before the first accept.
+  std::atomic<int64_t> target_slot_{-1};
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
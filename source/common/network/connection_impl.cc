@@ -70,8 +70,8 @@ ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPt
 #endif
   // We never ask for both early close and read at the same time. If we are reading, we want to
   // consume all available data.
-  file_event_ = dispatcher_.createFileEvent(
-      ioHandle().fd(), [this](uint32_t events) -> void { onFileEvent(events); }, trigger,
+  file_event_ = ioHandle().createFileEvent(
+      dispatcher_, [this](uint32_t events) -> void { onFileEvent(events); }, trigger,
       Event::FileReadyType::Read | Event::FileReadyType::Write);
 
   transport_socket_->setTransportSocketCallbacks(*this);
@@ -674,6 +674,14 @@ absl::string_view ConnectionImpl::transportFailureReason() const {
   return transport_socket_->failureReason();
 }
 
+IoHandle* ConnectionImpl::passthroughIoHandle() {
+  if (state() != State::Open || connecting_ || !transport_socket_->passthrough() ||
+      read_buffer_.length() > 0 || write_buffer_->length() > 0) {
+    return nullptr;
+  }
+  return &ioHandle();
+}
+
 void ConnectionImpl::flushWriteBuffer() {
   if (state() == State::Open && write_buffer_->length() > 0) {
     onWriteReady();
@@ -1,6 +1,9 @@
 #include "common/network/io_socket_handle_impl.h"
 
+#include <algorithm>
+
 #include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/network/address_impl.h"
@@ -64,52 +67,62 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
       Api::OsSysCallsSingleton::get().writev(fd_, iov.begin(), num_slices_to_write));
 }
 
-Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
-                                                    uint64_t num_slice, int flags,
-                                                    const Address::Ip* self_ip,
-                                                    const Address::Instance& peer_address) {
-  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
-  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
-
-  absl::FixedArray<iovec> iov(num_slice);
-  uint64_t num_slices_to_write = 0;
-  for (uint64_t i = 0; i < num_slice; i++) {
-    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
-      iov[num_slices_to_write].iov_base = slices[i].mem_;
-      iov[num_slices_to_write].iov_len = slices[i].len_;
-      num_slices_to_write++;
-    }
-  }
-  if (num_slices_to_write == 0) {
+Api::IoCallUint64Result IoSocketHandleImpl::read(Buffer::Instance& buffer, uint64_t max_length) {
+  if (max_length == 0) {
     return Api::ioCallUint64ResultNoError();
   }
+  constexpr uint64_t MaxSlices = 2;
+  Buffer::RawSlice slices[MaxSlices];
+  const uint64_t num_slices = buffer.reserve(max_length, slices, MaxSlices);
+  Api::IoCallUint64Result result = readv(max_length, slices, num_slices);
+  uint64_t bytes_to_commit = result.ok() ? result.rc_ : 0;
+  ASSERT(bytes_to_commit <= max_length);
+  for (uint64_t i = 0; i < num_slices; i++) {
+    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(bytes_to_commit));
+    bytes_to_commit -= slices[i].len_;
+  }
+  buffer.commit(slices, num_slices);
+  return result;
+}
 
-  msghdr message;
-  message.msg_name = reinterpret_cast<void*>(sock_addr);
-  message.msg_namelen = address_base->sockAddrLen();
-  message.msg_iov = iov.begin();
-  message.msg_iovlen = num_slices_to_write;
-  message.msg_flags = 0;
-  auto& os_syscalls = Api::OsSysCallsSingleton::get();
-  if (self_ip == nullptr) {
+Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
+  constexpr uint64_t MaxSlices = 16;
+  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
+  Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
+  if (result.ok() && result.rc_ > 0) {
+    buffer.drain(static_cast<uint64_t>(result.rc_));
+  }
+  return result;
+}
+
+namespace {
+
+// The space for the control messages which may be attached to a sent message: the source address
+// and the GSO segment size.
+size_t sendCmsgSpace() {
+  const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
+  // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
+  const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
+  return std::max(space_v4, space_v6) + CMSG_SPACE(sizeof(uint16_t));
+}
+
+// Attaches the control messages selecting the source address and the GSO segment size to a message
+// to be sent. |cbuf| must be zeroed and hold sendCmsgSpace() bytes.
+void setSendControlMessages(msghdr& message, char* cbuf, const Address::Ip* self_ip,
+                            uint16_t gso_size) {
+  if (self_ip == nullptr && gso_size == 0) {
     message.msg_control = nullptr;
     message.msg_controllen = 0;
-    const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
-    return sysCallResultToIoCallResult(result);
-  } else {
-    const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
-    // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
-    const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
-    const size_t cmsg_space = (space_v4 < space_v6) ? space_v6 : space_v4;
-    // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
-    absl::FixedArray<char> cbuf(cmsg_space);
-    memset(cbuf.begin(), 0, cmsg_space);
-
-    message.msg_control = cbuf.begin();
-    message.msg_controllen = cmsg_space * sizeof(char);
-    cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
-    RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
-                                                sizeof(cbuf), sizeof(cmsghdr)));
+    return;
+  }
+
+  message.msg_control = cbuf;
+  message.msg_controllen = sendCmsgSpace();
+  size_t controllen = 0;
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
+                                              sendCmsgSpace(), sizeof(cmsghdr)));
+  if (self_ip != nullptr) {
     if (self_ip->version() == Address::IpVersion::v4) {
       cmsg->cmsg_level = IPPROTO_IP;
 #ifndef IP_SENDSRCADDR
@@ -122,10 +135,12 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
 #else
       pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
 #endif
+      controllen += CMSG_SPACE(sizeof(in_pktinfo));
 #else
       cmsg->cmsg_type = IP_SENDSRCADDR;
       cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
       *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip->ipv4()->address();
+      controllen += CMSG_SPACE(sizeof(in_addr));
 #endif
     } else if (self_ip->version() == Address::IpVersion::v6) {
       cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
@@ -134,10 +149,118 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
       auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
       pktinfo->ipi6_ifindex = 0;
       *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
+      controllen += CMSG_SPACE(sizeof(in6_pktinfo));
     }
-    const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
-    return sysCallResultToIoCallResult(result);
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  }
+  if (gso_size != 0) {
+#ifdef UDP_SEGMENT
+    RELEASE_ASSERT(cmsg != nullptr, "no space for the UDP_SEGMENT control message");
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = gso_size;
+    controllen += CMSG_SPACE(sizeof(uint16_t));
+#else
+    NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
   }
+  message.msg_controllen = controllen;
+}
+
+// Fills in |iov| from the non-empty slices and returns the number of entries used.
+uint64_t fillIovecs(const Buffer::RawSlice* slices, uint64_t num_slice, iovec* iov) {
+  uint64_t num_slices_to_write = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      iov[num_slices_to_write].iov_base = slices[i].mem_;
+      iov[num_slices_to_write].iov_len = slices[i].len_;
+      num_slices_to_write++;
+    }
+  }
+  return num_slices_to_write;
+}
+
+} // namespace
+
+Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
+                                                    uint64_t num_slice, int flags,
+                                                    const Address::Ip* self_ip,
+                                                    const Address::Instance& peer_address) {
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
+
+  absl::FixedArray<iovec> iov(num_slice);
+  const uint64_t num_slices_to_write = fillIovecs(slices, num_slice, iov.begin());
+  if (num_slices_to_write == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  msghdr message;
+  message.msg_name = reinterpret_cast<void*>(sock_addr);
+  message.msg_namelen = address_base->sockAddrLen();
+  message.msg_iov = iov.begin();
+  message.msg_iovlen = num_slices_to_write;
+  message.msg_flags = 0;
+  absl::FixedArray<char> cbuf(self_ip != nullptr ? sendCmsgSpace() : 0);
+  memset(cbuf.begin(), 0, cbuf.size());
+  setSendControlMessages(message, cbuf.begin(), self_ip, 0);
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().sendmsg(fd_, &message, flags);
+  return sysCallResultToIoCallResult(result);
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const SendMsgInfo* messages,
+                                                     uint64_t num_messages, int flags) {
+  if (num_messages == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  if (!os_syscalls.supportsMmsg()) {
+    num_messages = 1;
+  }
+
+  uint64_t total_slices = 0;
+  for (uint64_t i = 0; i < num_messages; i++) {
+    total_slices += messages[i].num_slice_;
+  }
+  absl::FixedArray<mmsghdr> mmsg_hdr(num_messages);
+  absl::FixedArray<iovec> iov(total_slices);
+  const size_t cmsg_space = sendCmsgSpace();
+  absl::FixedArray<char> cbufs(num_messages * cmsg_space);
+  memset(cbufs.begin(), 0, cbufs.size());
+
+  iovec* next_iov = iov.begin();
+  for (uint64_t i = 0; i < num_messages; i++) {
+    const SendMsgInfo& info = messages[i];
+    ASSERT(info.gso_size_ == 0 || supportsUdpGso());
+    const auto* address_base = dynamic_cast<const Address::InstanceBase*>(info.peer_address_);
+    msghdr& message = mmsg_hdr[i].msg_hdr;
+    message.msg_name = const_cast<sockaddr*>(address_base->sockAddr());
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = next_iov;
+    message.msg_iovlen = fillIovecs(info.slices_, info.num_slice_, next_iov);
+    message.msg_flags = 0;
+    next_iov += message.msg_iovlen;
+    setSendControlMessages(message, cbufs.begin() + i * cmsg_space, info.self_ip_, info.gso_size_);
+    mmsg_hdr[i].msg_len = 0;
+  }
+
+  Api::SysCallIntResult result;
+  if (num_messages == 1) {
+    const Api::SysCallSizeResult sendmsg_result =
+        os_syscalls.sendmsg(fd_, &mmsg_hdr[0].msg_hdr, flags);
+    result = {sendmsg_result.rc_ < 0 ? -1 : 1, sendmsg_result.errno_};
+  } else {
+    result = os_syscalls.sendmmsg(fd_, mmsg_hdr.begin(), num_messages, flags);
+  }
+  if (result.rc_ < 0 && result.errno_ == EINVAL && messages[0].gso_size_ != 0) {
+    // The kernel rejects segments which exceed the MTU of the route. Unlike other invalid
+    // arguments, the caller can recover by sending the datagrams on their own.
+    return Api::IoCallUint64Result(
+        0, Api::IoErrorPtr(new IoSocketError(EINVAL), IoSocketError::deleteIoError));
+  }
+  return sysCallResultToIoCallResult(result);
 }
 
 Address::InstanceConstSharedPtr getAddressFromSockAddrOrDie(const sockaddr_storage& ss,
@@ -204,6 +327,18 @@ absl::optional<uint32_t> maybeGetPacketsDroppedFromHeader(
   return absl::nullopt;
 }
 
+absl::optional<unsigned int> maybeGetGsoSizeFromHeader(
+#ifdef UDP_GRO
+    const cmsghdr& cmsg) {
+  if (cmsg.cmsg_level == SOL_UDP && cmsg.cmsg_type == UDP_GRO) {
+    return *reinterpret_cast<const int*>(CMSG_DATA(&cmsg));
+  }
+#else
+    const cmsghdr&) {
+#endif
+  return absl::nullopt;
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
                                                     const uint64_t num_slice, uint32_t self_port,
                                                     RecvMsgOutput& output) {
@@ -257,6 +392,11 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
           continue;
         }
       }
+      absl::optional<unsigned int> maybe_gso_size = maybeGetGsoSizeFromHeader(*cmsg);
+      if (maybe_gso_size) {
+        output.msg_[0].gso_size_ = *maybe_gso_size;
+        continue;
+      }
       if (output.dropped_packets_ != nullptr) {
         absl::optional<uint32_t> maybe_dropped = maybeGetPacketsDroppedFromHeader(*cmsg);
         if (maybe_dropped) {
@@ -336,11 +476,18 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmmsg(RawSliceArrays& slices, uin
     if (hdr.msg_controllen > 0) {
       struct cmsghdr* cmsg;
       for (cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
-        Address::InstanceConstSharedPtr addr = maybeGetDstAddressFromHeader(*cmsg, self_port, fd_);
-        if (addr != nullptr) {
-          // This is a IP packet info message.
-          output.msg_[i].local_address_ = std::move(addr);
-          break;
+        if (output.msg_[i].local_address_ == nullptr) {
+          Address::InstanceConstSharedPtr addr =
+              maybeGetDstAddressFromHeader(*cmsg, self_port, fd_);
+          if (addr != nullptr) {
+            // This is a IP packet info message.
+            output.msg_[i].local_address_ = std::move(addr);
+            continue;
+          }
+        }
+        absl::optional<unsigned int> maybe_gso_size = maybeGetGsoSizeFromHeader(*cmsg);
+        if (maybe_gso_size) {
+          output.msg_[i].gso_size_ = *maybe_gso_size;
         }
       }
     }
@@ -365,5 +512,20 @@ bool IoSocketHandleImpl::supportsMmsg() const {
   return Api::OsSysCallsSingleton::get().supportsMmsg();
 }
 
+bool IoSocketHandleImpl::supportsUdpGso() const {
+  return Api::OsSysCallsSingleton::get().supportsUdpGso();
+}
+
+Api::SysCallIntResult IoSocketHandleImpl::shutdown(int how) {
+  return Api::OsSysCallsSingleton::get().shutdown(fd_, how);
+}
+
+Event::FileEventPtr IoSocketHandleImpl::createFileEvent(Event::Dispatcher& dispatcher,
+                                                        Event::FileReadyCb cb,
+                                                        Event::FileTriggerType trigger,
+                                                        uint32_t events) {
+  return dispatcher.createFileEvent(fd_, cb, trigger, events);
+}
+
 } // namespace Network
 } // namespace Envoy
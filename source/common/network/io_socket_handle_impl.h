@@ -33,10 +33,17 @@ public:
 
   Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
 
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Address::Ip* self_ip,
                                   const Address::Instance& peer_address) override;
 
+  Api::IoCallUint64Result sendmmsg(const SendMsgInfo* messages, uint64_t num_messages,
+                                   int flags) override;
+
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override;
 
@@ -45,7 +52,14 @@ public:
 
   bool supportsMmsg() const override;
 
-private:
+  bool supportsUdpGso() const override;
+
+  Api::SysCallIntResult shutdown(int how) override;
+
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override;
+
+protected:
   // Converts a SysCallSizeResult to IoCallUint64Result.
   template <typename T>
   Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallResult<T>& result) {
@@ -66,11 +80,11 @@ private:
 
   os_fd_t fd_;
 
-  // The minimum cmsg buffer size to filled in destination address and packets dropped when
-  // receiving a packet. It is possible for a received packet to contain both IPv4 and IPv6
-  // addresses.
+  // The minimum cmsg buffer size to filled in destination address, packets dropped and the GRO
+  // segment size when receiving a packet. It is possible for a received packet to contain both
+  // IPv4 and IPv6 addresses.
   const size_t cmsg_space_{CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
-                           CMSG_SPACE(sizeof(struct in6_pktinfo))};
+                           CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))};
 };
 
 } // namespace Network
@@ -0,0 +1,265 @@
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+IoUringSocketHandleImpl::FileEventImpl::FileEventImpl(IoUringSocketHandleImpl& parent,
+                                                      Event::Dispatcher& dispatcher,
+                                                      Event::FileReadyCb cb)
+    : parent_(&parent), cb_(cb), activation_timer_(dispatcher.createTimer([this]() {
+        const uint32_t injected = injected_;
+        injected_ = 0;
+        cb_(injected);
+      })) {}
+
+IoUringSocketHandleImpl::FileEventImpl::~FileEventImpl() {
+  if (parent_ != nullptr) {
+    parent_->file_event_ = nullptr;
+  }
+}
+
+void IoUringSocketHandleImpl::FileEventImpl::activate(uint32_t events) {
+  // Like libevent, fire from the event loop rather than from within the caller.
+  injected_ |= events;
+  if (!activation_timer_->enabled()) {
+    activation_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void IoUringSocketHandleImpl::FileEventImpl::setEnabled(uint32_t events) {
+  const uint32_t newly_enabled = events & ~enabled_;
+  enabled_ = events;
+  if (parent_ == nullptr) {
+    return;
+  }
+
+  uint32_t ready = 0;
+  if (newly_enabled & Event::FileReadyType::Read) {
+    if (parent_->readReady()) {
+      ready |= Event::FileReadyType::Read;
+    } else {
+      parent_->submitRead();
+    }
+  }
+  // Sockets are writable unless a write is pending, so mirror an edge triggered file event which
+  // fires once it is enabled on a writable socket.
+  if ((newly_enabled & Event::FileReadyType::Write) && parent_->write_request_ == nullptr) {
+    ready |= Event::FileReadyType::Write;
+  }
+  if (ready != 0) {
+    activate(ready);
+  }
+}
+
+void IoUringSocketHandleImpl::FileEventImpl::notify(uint32_t events) {
+  events &= enabled_;
+  if (events != 0) {
+    cb_(events);
+  }
+}
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(os_fd_t fd, Io::IoUringWorker& worker)
+    : IoSocketHandleImpl(fd), worker_(worker) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (file_event_ != nullptr) {
+    file_event_->detach();
+  }
+  if (SOCKET_VALID(fd_)) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  ASSERT(SOCKET_VALID(fd_));
+  if (read_request_ != nullptr) {
+    worker_.cancel(*read_request_);
+    read_request_ = nullptr;
+  }
+  if (read_buffer_.has_value()) {
+    worker_.releaseBuffer(read_buffer_.value());
+    read_buffer_.reset();
+  }
+  if (write_request_ != nullptr) {
+    // Data reported as written must still reach the peer, so the worker closes the socket once the
+    // pending write completes.
+    write_request_->handler_ = nullptr;
+    write_request_->close_on_completion_ = true;
+    write_request_ = nullptr;
+    SET_SOCKET_INVALID(fd_);
+    return Api::ioCallUint64ResultNoError();
+  }
+  return IoSocketHandleImpl::close();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (read_buffer_.has_value()) {
+    const uint8_t* data = worker_.bufferData(read_buffer_.value()) + read_offset_;
+    uint64_t bytes_read = 0;
+    for (uint64_t i = 0; i < num_slice && bytes_read < max_length && read_offset_ < read_length_;
+         i++) {
+      const uint64_t length = std::min<uint64_t>(
+          {slices[i].len_, max_length - bytes_read, read_length_ - read_offset_});
+      memcpy(slices[i].mem_, data, length);
+      data += length;
+      read_offset_ += length;
+      bytes_read += length;
+    }
+    if (read_offset_ == read_length_) {
+      worker_.releaseBuffer(read_buffer_.value());
+      read_buffer_.reset();
+    }
+    return Api::IoCallUint64Result(bytes_read,
+                                   Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+  }
+  if (read_error_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, read_error_});
+  }
+  if (eof_) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  if (readable_) {
+    Api::IoCallUint64Result result = IoSocketHandleImpl::readv(max_length, slices, num_slice);
+    if (result.ok() || result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+      return result;
+    }
+    readable_ = false;
+  }
+  submitRead();
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, EAGAIN});
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  // The slices only have to stay valid for the duration of the call, so the data is copied, unless
+  // the write is going to fail anyway.
+  Buffer::OwnedImpl data;
+  if (write_error_ == 0 && write_request_ == nullptr) {
+    for (uint64_t i = 0; i < num_slice; i++) {
+      if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+        data.add(slices[i].mem_, slices[i].len_);
+      }
+    }
+  }
+  return IoUringSocketHandleImpl::write(data);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      uint64_t max_length) {
+  if (read_buffer_.has_value() && max_length >= read_length_ - read_offset_) {
+    const uint32_t length = read_length_ - read_offset_;
+    worker_.moveBufferData(read_buffer_.value(), read_offset_, length, buffer);
+    read_buffer_.reset();
+    return Api::IoCallUint64Result(length, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+  }
+  return IoSocketHandleImpl::read(buffer, max_length);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  if (write_error_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, write_error_});
+  }
+  if (write_request_ != nullptr) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, EAGAIN});
+  }
+
+  const uint64_t length = buffer.length();
+  if (length > 0) {
+    write_request_ = worker_.submitWrite(fd_, buffer, *this);
+  }
+  return Api::IoCallUint64Result(length, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (write_request_ != nullptr && how != ENVOY_SHUT_RD) {
+    // Shutting down now would discard the data of the pending write.
+    pending_shutdown_ = how;
+    return Api::SysCallIntResult{0, 0};
+  }
+  return IoSocketHandleImpl::shutdown(how);
+}
+
+Event::FileEventPtr IoUringSocketHandleImpl::createFileEvent(Event::Dispatcher& dispatcher,
+                                                             Event::FileReadyCb cb,
+                                                             Event::FileTriggerType,
+                                                             uint32_t events) {
+  // Events are only delivered on completions, which makes them edge triggered.
+  ASSERT(file_event_ == nullptr);
+  ASSERT(&dispatcher == &worker_.dispatcher());
+  auto file_event = std::make_unique<FileEventImpl>(*this, dispatcher, cb);
+  file_event_ = file_event.get();
+  file_event->setEnabled(events);
+  return file_event;
+}
+
+void IoUringSocketHandleImpl::submitRead() {
+  if (read_request_ == nullptr && SOCKET_VALID(fd_)) {
+    read_request_ = worker_.submitRead(fd_, *this);
+  }
+}
+
+void IoUringSocketHandleImpl::onRequestCompleted(Io::IoUringRequest& request, int32_t result) {
+  uint32_t events = 0;
+  switch (request.type_) {
+  case Io::IoUringRequest::Type::Read:
+    ASSERT(read_request_ == &request);
+    read_request_ = nullptr;
+    if (result > 0) {
+      read_buffer_ = request.buffer_index_;
+      read_offset_ = 0;
+      read_length_ = result;
+    } else {
+      worker_.releaseBuffer(request.buffer_index_);
+      if (result == 0) {
+        eof_ = true;
+      } else {
+        read_error_ = -result;
+      }
+    }
+    events = Event::FileReadyType::Read;
+    break;
+  case Io::IoUringRequest::Type::Poll:
+    ASSERT(read_request_ == &request);
+    read_request_ = nullptr;
+    if (result < 0) {
+      read_error_ = -result;
+    } else {
+      readable_ = true;
+    }
+    events = Event::FileReadyType::Read;
+    break;
+  case Io::IoUringRequest::Type::Write:
+    ASSERT(write_request_ == &request);
+    write_request_ = nullptr;
+    if (result < 0) {
+      write_error_ = -result;
+    }
+    if (pending_shutdown_.has_value()) {
+      IoSocketHandleImpl::shutdown(pending_shutdown_.value());
+      pending_shutdown_.reset();
+    }
+    events = Event::FileReadyType::Write;
+    break;
+  case Io::IoUringRequest::Type::Cancel:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
+  if (file_event_ != nullptr) {
+    // This may close the socket and destroy the file event.
+    file_event_->notify(events);
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/event/file_event.h"
+#include "envoy/event/timer.h"
+
+#include "common/io/io_uring_worker.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * IoHandle for stream sockets which performs reads and writes through the io_uring instance of the
+ * thread which owns the socket, see Io::IoUringWorker.
+ *
+ * Reads complete ahead of read() and readv(): while reading is enabled a read request is kept
+ * pending, its data is handed out and a new request is submitted once it has been consumed. read()
+ * moves the data out of the registered buffer without copying it, while readv() has to copy it.
+ * Writes complete behind write() and writev(): the data is moved into a write request, or copied
+ * in the case of writev(), and reported as written, and further writes return EAGAIN until the
+ * request completes. Readiness is reported through the file event returned by createFileEvent(),
+ * which is driven by these completions rather than by polling the socket.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl, public Io::IoUringRequestHandler {
+public:
+  IoUringSocketHandleImpl(os_fd_t fd, Io::IoUringWorker& worker);
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::SysCallIntResult shutdown(int how) override;
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override;
+
+  // Io::IoUringRequestHandler
+  void onRequestCompleted(Io::IoUringRequest& request, int32_t result) override;
+
+private:
+  class FileEventImpl : public Event::FileEvent {
+  public:
+    FileEventImpl(IoUringSocketHandleImpl& parent, Event::Dispatcher& dispatcher,
+                  Event::FileReadyCb cb);
+    ~FileEventImpl() override;
+
+    // Event::FileEvent
+    void activate(uint32_t events) override;
+    void setEnabled(uint32_t events) override;
+
+    // Invokes the callback for the enabled subset of events.
+    void notify(uint32_t events);
+    void detach() { parent_ = nullptr; }
+
+  private:
+    IoUringSocketHandleImpl* parent_;
+    Event::FileReadyCb cb_;
+    uint32_t enabled_{};
+    uint32_t injected_{};
+    Event::TimerPtr activation_timer_;
+  };
+
+  // Whether a read completed and readv() has something to return.
+  bool readReady() const {
+    return read_buffer_.has_value() || readable_ || eof_ || read_error_ != 0;
+  }
+  void submitRead();
+
+  Io::IoUringWorker& worker_;
+  FileEventImpl* file_event_{};
+  Io::IoUringRequest* read_request_{};
+  Io::IoUringRequest* write_request_{};
+  // Registered buffer holding a completed read, and the part of it not consumed yet.
+  absl::optional<uint16_t> read_buffer_;
+  uint32_t read_offset_{};
+  uint32_t read_length_{};
+  // Set when a poll request reported the socket readable, in which case readv() reads directly.
+  bool readable_{};
+  bool eof_{};
+  int read_error_{};
+  int write_error_{};
+  // Shutdown requested while a write was pending.
+  absl::optional<int> pending_shutdown_;
+};
+
+} // namespace Network
+} // namespace Envoy
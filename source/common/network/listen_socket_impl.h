@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -172,7 +173,23 @@ class AcceptedSocketImpl : public ConnectionSocketImpl {
 public:
   AcceptedSocketImpl(IoHandlePtr&& io_handle, const Address::InstanceConstSharedPtr& local_address,
                      const Address::InstanceConstSharedPtr& remote_address)
-      : ConnectionSocketImpl(std::move(io_handle), local_address, remote_address) {}
+      : ConnectionSocketImpl(std::move(io_handle), local_address, remote_address) {
+    ++global_accepted_socket_count_;
+  }
+
+  ~AcceptedSocketImpl() override {
+    ASSERT(global_accepted_socket_count_.load() > 0);
+    --global_accepted_socket_count_;
+  }
+
+  /**
+   * @return uint64_t the number of accepted sockets which are alive in the process, across all the
+   *         listeners and workers. A socket lives as long as its connection.
+   */
+  static uint64_t acceptedSocketCount() { return global_accepted_socket_count_.load(); }
+
+private:
+  static std::atomic<uint64_t> global_accepted_socket_count_;
 };
 
 // ConnectionSocket used with client connections.
@@ -9,8 +9,10 @@
 #include "common/common/fmt.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/event/file_event_impl.h"
+#include "common/io/io_uring_worker.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 
 #include "event2/listener.h"
 
@@ -21,8 +23,17 @@ void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr*
                                   int remote_addr_len, void* arg) {
   ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
 
-  // Create the IoSocketHandleImpl for the fd here.
-  IoHandlePtr io_handle = std::make_unique<IoSocketHandleImpl>(fd);
+  // Create the IoHandle for the fd here. Sockets go through the io_uring instance of this thread
+  // when io_uring is enabled.
+  IoHandlePtr io_handle;
+  Io::IoUringFactory* io_uring_factory = Io::IoUringFactorySingleton::getExisting();
+  Io::IoUringWorker* io_uring_worker =
+      io_uring_factory != nullptr ? io_uring_factory->currentThreadWorker() : nullptr;
+  if (io_uring_worker != nullptr) {
+    io_handle = std::make_unique<IoUringSocketHandleImpl>(fd, *io_uring_worker);
+  } else {
+    io_handle = std::make_unique<IoSocketHandleImpl>(fd);
+  }
 
   // Get the local address from the new socket if the listener is listening on IP ANY
   // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
@@ -16,6 +16,7 @@ public:
   std::string protocol() const override;
   absl::string_view failureReason() const override;
   bool canFlushClose() override { return true; }
+  bool passthrough() const override { return true; }
   void closeSocket(Network::ConnectionEvent) override {}
   void onConnected() override;
   IoResult doRead(Buffer::Instance& buffer) override;
@@ -0,0 +1,180 @@
+#include "common/network/reuse_port_steering.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+#if defined(__linux__)
+#include <linux/bpf.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SO_ATTACH_REUSEPORT_EBPF
+#define SO_ATTACH_REUSEPORT_EBPF 52
+#endif
+#endif
+
+namespace Envoy {
+namespace Network {
+
+#if defined(__linux__)
+
+namespace {
+
+int bpf(int cmd, bpf_attr& attr) { return ::syscall(__NR_bpf, cmd, &attr, sizeof(attr)); }
+
+bpf_insn insn(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+  bpf_insn result;
+  memset(&result, 0, sizeof(result));
+  result.code = code;
+  result.dst_reg = dst;
+  result.src_reg = src;
+  result.off = off;
+  result.imm = imm;
+  return result;
+}
+
+os_fd_t createMap(uint32_t map_type, uint32_t value_size, uint32_t max_entries) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_type = map_type;
+  attr.key_size = sizeof(uint32_t);
+  attr.value_size = value_size;
+  attr.max_entries = max_entries;
+  return bpf(BPF_MAP_CREATE, attr);
+}
+
+int updateElement(os_fd_t map_fd, uint32_t key, const void* value) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = map_fd;
+  attr.key = reinterpret_cast<uint64_t>(&key);
+  attr.value = reinterpret_cast<uint64_t>(value);
+  attr.flags = BPF_ANY;
+  return bpf(BPF_MAP_UPDATE_ELEM, attr);
+}
+
+} // namespace
+
+ReusePortSteering::ReusePortSteering(uint32_t max_sockets) {
+  ASSERT(max_sockets > 0);
+  // The sockets are stored as 64 bit fds, and the slot to steer to in the only entry of an array.
+  sockets_map_fd_ = createMap(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, sizeof(uint64_t), max_sockets);
+  if (SOCKET_VALID(sockets_map_fd_)) {
+    target_map_fd_ = createMap(BPF_MAP_TYPE_ARRAY, sizeof(uint32_t), 1);
+  }
+  if (SOCKET_INVALID(sockets_map_fd_) || SOCKET_INVALID(target_map_fd_)) {
+    const int error = errno;
+    if (SOCKET_VALID(sockets_map_fd_)) {
+      ::close(sockets_map_fd_);
+    }
+    throw EnvoyException(fmt::format("unable to create reuse port maps: {}", strerror(error)));
+  }
+
+  // r6 = ctx
+  // *(u32 *)(r10 - 4) = 0
+  // r0 = bpf_map_lookup_elem(target_map, r10 - 4)
+  // if (r0 != NULL) {
+  //   *(u32 *)(r10 - 8) = *(u32 *)r0
+  //   bpf_sk_select_reuseport(r6, sockets_map, r10 - 8, 0)
+  // }
+  // return SK_PASS
+  //
+  // When no socket is selected, the kernel picks one of the group by hashing.
+  const bpf_insn program[] = {
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+      insn(BPF_ST | BPF_MEM | BPF_W, BPF_REG_10, 0, -4, 0),
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_10, 0, 0),
+      insn(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_2, 0, 0, -4),
+      insn(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, target_map_fd_),
+      insn(0, 0, 0, 0, 0),
+      insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem),
+      insn(BPF_JMP | BPF_JEQ | BPF_K, BPF_REG_0, 0, 9, 0),
+      insn(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_1, BPF_REG_0, 0, 0),
+      insn(BPF_STX | BPF_MEM | BPF_W, BPF_REG_10, BPF_REG_1, -8, 0),
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0),
+      insn(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_2, BPF_PSEUDO_MAP_FD, 0, sockets_map_fd_),
+      insn(0, 0, 0, 0, 0),
+      insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0),
+      insn(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -8),
+      insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, 0),
+      insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_sk_select_reuseport),
+      insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, SK_PASS),
+      insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+  };
+  const char license[] = "Apache-2.0";
+
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.prog_type = BPF_PROG_TYPE_SK_REUSEPORT;
+  attr.insns = reinterpret_cast<uint64_t>(program);
+  attr.insn_cnt = sizeof(program) / sizeof(program[0]);
+  attr.license = reinterpret_cast<uint64_t>(license);
+  prog_fd_ = bpf(BPF_PROG_LOAD, attr);
+  if (SOCKET_INVALID(prog_fd_)) {
+    const int error = errno;
+    ::close(target_map_fd_);
+    ::close(sockets_map_fd_);
+    throw EnvoyException(fmt::format("unable to load reuse port program: {}", strerror(error)));
+  }
+}
+
+ReusePortSteering::~ReusePortSteering() {
+  // The program stays attached to the SO_REUSEPORT groups, and keeps the maps alive, until the
+  // groups are gone or another program is attached.
+  ::close(prog_fd_);
+  ::close(target_map_fd_);
+  ::close(sockets_map_fd_);
+}
+
+void ReusePortSteering::addSocket(uint32_t slot, os_fd_t fd) {
+  const uint64_t value = fd;
+  if (updateElement(sockets_map_fd_, slot, &value) != 0) {
+    throw EnvoyException(
+        fmt::format("unable to add socket to reuse port map: {}", strerror(errno)));
+  }
+  // Attaching replaces the program of the whole group, which is the same for all its sockets.
+  if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_EBPF, &prog_fd_, sizeof(prog_fd_)) != 0) {
+    const int error = errno;
+    removeSocket(slot);
+    throw EnvoyException(
+        fmt::format("unable to attach reuse port program: {}", strerror(error)));
+  }
+}
+
+void ReusePortSteering::removeSocket(uint32_t slot) {
+  bpf_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.map_fd = sockets_map_fd_;
+  attr.key = reinterpret_cast<uint64_t>(&slot);
+  // This fails with ENOENT when the socket has been closed already, which is fine.
+  bpf(BPF_MAP_DELETE_ELEM, attr);
+}
+
+bool ReusePortSteering::steerTo(uint32_t slot) {
+  return updateElement(target_map_fd_, 0, &slot) == 0;
+}
+
+#else
+
+ReusePortSteering::ReusePortSteering(uint32_t) {
+  throw EnvoyException("reuse port steering is only supported on Linux");
+}
+
+ReusePortSteering::~ReusePortSteering() = default;
+
+void ReusePortSteering::addSocket(uint32_t, os_fd_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+void ReusePortSteering::removeSocket(uint32_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool ReusePortSteering::steerTo(uint32_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/common/platform.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Steers the new connections of a SO_REUSEPORT group of TCP listen sockets to one socket of the
+ * group, chosen by user space. An eBPF program of type BPF_PROG_TYPE_SK_REUSEPORT is attached to
+ * the group. It looks up the slot to steer to in an array map, and selects the socket stored in
+ * that slot of a BPF_MAP_TYPE_REUSEPORT_SOCKARRAY map with bpf_sk_select_reuseport(). When the
+ * slot is empty, the kernel falls back to choosing a socket by hashing. The program and the maps
+ * are created directly through the bpf(2) system call, and are released when this object is
+ * destroyed. Socket slots are written by the bpf(2) map operations, which are atomic, so all the
+ * methods may be called from any thread.
+ */
+class ReusePortSteering : NonCopyable {
+public:
+  /**
+   * @param max_sockets supplies the number of socket slots.
+   * @throw EnvoyException if the maps or the program cannot be created, e.g. if the kernel is
+   *        older than 4.19 or the process lacks the privileges to load eBPF programs.
+   */
+  explicit ReusePortSteering(uint32_t max_sockets);
+  ~ReusePortSteering();
+
+  /**
+   * Store a listen socket in a slot, and attach the program to the SO_REUSEPORT group of the
+   * socket. The socket is removed from its slot by the kernel when it is closed.
+   * @param slot supplies the slot, which must be below max_sockets.
+   * @param fd supplies a listening TCP socket with SO_REUSEPORT set.
+   * @throw EnvoyException on failure.
+   */
+  void addSocket(uint32_t slot, os_fd_t fd);
+
+  /**
+   * Remove the socket of a slot, if any.
+   * @param slot supplies the slot.
+   */
+  void removeSocket(uint32_t slot);
+
+  /**
+   * Steer the connections which are accepted from now on to the socket of a slot.
+   * @param slot supplies the slot.
+   * @return whether the slot to steer to was updated.
+   */
+  bool steerTo(uint32_t slot);
+
+private:
+  os_fd_t sockets_map_fd_{INVALID_SOCKET};
+  os_fd_t target_map_fd_{INVALID_SOCKET};
+  os_fd_t prog_fd_{INVALID_SOCKET};
+};
+
+} // namespace Network
+} // namespace Envoy
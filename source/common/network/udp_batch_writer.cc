@@ -0,0 +1,153 @@
+#include "common/network/udp_batch_writer.h"
+
+#include <algorithm>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/assert.h"
+
+#include "absl/container/fixed_array.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+bool sameIp(const Address::Ip* lhs, const Address::Ip* rhs) {
+  if (lhs == rhs) {
+    return true;
+  }
+  if (lhs == nullptr || rhs == nullptr) {
+    return false;
+  }
+  return lhs->addressAsString() == rhs->addressAsString();
+}
+
+} // namespace
+
+UdpBatchWriter::UdpBatchWriter(IoHandle& io_handle)
+    : io_handle_(io_handle), gso_enabled_(io_handle.supportsUdpGso()) {}
+
+bool UdpBatchWriter::canCoalesce(const Message& message, uint64_t length,
+                                 const Address::Ip* local_ip,
+                                 const Address::Instance& peer_address) const {
+  return gso_enabled_ && !message.closed_ && length <= message.segment_size_ &&
+         message.num_datagrams_ < MaxSegmentsPerMessage &&
+         message.payload_.length() + length <= MaxMessageSize &&
+         (message.peer_address_ == &peer_address || *message.peer_address_ == peer_address) &&
+         sameIp(message.local_ip_, local_ip);
+}
+
+void UdpBatchWriter::write(Buffer::Instance& buffer, const Address::Ip* local_ip,
+                           const Address::Instance& peer_address) {
+  const uint64_t length = buffer.length();
+  pending_datagrams_++;
+  if (!messages_.empty() && canCoalesce(messages_.back(), length, local_ip, peer_address)) {
+    Message& message = messages_.back();
+    message.payload_.move(buffer);
+    message.num_datagrams_++;
+    // Only the last segment of a message may be shorter.
+    message.closed_ = length < message.segment_size_;
+    return;
+  }
+
+  messages_.emplace_back();
+  Message& message = messages_.back();
+  message.payload_.move(buffer);
+  message.local_ip_ = local_ip;
+  message.peer_address_ = &peer_address;
+  message.segment_size_ = length;
+  message.num_datagrams_ = 1;
+  // Empty datagrams cannot be segmented.
+  message.closed_ = length == 0 || length > MaxSegmentSize;
+}
+
+UdpFlushResult UdpBatchWriter::flush() {
+  UdpFlushResult result;
+  while (!messages_.empty()) {
+    const uint64_t num_messages = std::min<uint64_t>(messages_.size(), MaxMessagesPerCall);
+    absl::FixedArray<Buffer::RawSliceVector> slices(num_messages);
+    absl::FixedArray<IoHandle::SendMsgInfo> infos(num_messages);
+    for (uint64_t i = 0; i < num_messages; i++) {
+      const Message& message = messages_[i];
+      slices[i] = message.payload_.getRawSlices();
+      infos[i].slices_ = slices[i].data();
+      infos[i].num_slice_ = slices[i].size();
+      infos[i].self_ip_ = message.local_ip_;
+      infos[i].peer_address_ = message.peer_address_;
+      infos[i].gso_size_ = message.num_datagrams_ > 1 ? message.segment_size_ : 0;
+    }
+
+    result.send_calls_++;
+    const Api::IoCallUint64Result rc = io_handle_.sendmmsg(infos.begin(), num_messages, 0);
+    if (rc.ok()) {
+      ASSERT(rc.rc_ > 0 && rc.rc_ <= num_messages);
+      for (uint64_t i = 0; i < rc.rc_; i++) {
+        const Message& message = messages_.front();
+        result.datagrams_sent_ += message.num_datagrams_;
+        result.bytes_sent_ += message.payload_.length();
+        pending_datagrams_ -= message.num_datagrams_;
+        messages_.pop_front();
+      }
+      continue;
+    }
+
+    const Api::IoError::IoErrorCode error_code = rc.err_->getErrorCode();
+    if (error_code == Api::IoError::IoErrorCode::Interrupt) {
+      continue;
+    }
+    if (error_code == Api::IoError::IoErrorCode::Again) {
+      ENVOY_LOG(trace, "send buffer full, dropping {} datagrams", pending_datagrams_);
+      while (!messages_.empty()) {
+        dropFirstMessage(result);
+      }
+      break;
+    }
+    ENVOY_LOG(debug, "sendmmsg failed with error code {}: {}", static_cast<int>(error_code),
+              rc.err_->getErrorDetails());
+    if (messages_.front().num_datagrams_ > 1) {
+      // The kernel or the device may be unable to segment this message, e.g. because the MTU of
+      // the route is smaller than the segments or the device lacks checksum offload. Send the
+      // datagrams on their own instead, and stop coalescing.
+      gso_enabled_ = false;
+      splitFirstMessage();
+      continue;
+    }
+    dropFirstMessage(result);
+  }
+  return result;
+}
+
+void UdpBatchWriter::splitFirstMessage() {
+  Message& first = messages_.front();
+  Buffer::OwnedImpl payload;
+  payload.move(first.payload_);
+  const Address::Ip* local_ip = first.local_ip_;
+  const Address::Instance* peer_address = first.peer_address_;
+  const uint64_t segment_size = first.segment_size_;
+  const uint32_t num_datagrams = first.num_datagrams_;
+  messages_.pop_front();
+
+  for (uint32_t i = 0; i < num_datagrams; i++) {
+    messages_.emplace_front();
+  }
+  for (uint32_t i = 0; i < num_datagrams; i++) {
+    Message& message = messages_[i];
+    message.payload_.move(payload, std::min(segment_size, payload.length()));
+    message.local_ip_ = local_ip;
+    message.peer_address_ = peer_address;
+    message.segment_size_ = message.payload_.length();
+    message.num_datagrams_ = 1;
+    message.closed_ = true;
+  }
+  ASSERT(payload.length() == 0);
+}
+
+void UdpBatchWriter::dropFirstMessage(UdpFlushResult& result) {
+  result.datagrams_dropped_ += messages_.front().num_datagrams_;
+  pending_datagrams_ -= messages_.front().num_datagrams_;
+  messages_.pop_front();
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+#include "envoy/network/address.h"
+#include "envoy/network/io_handle.h"
+#include "envoy/network/listener.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Queues datagrams to be sent through a UDP socket and sends them together with as few system
+ * calls as possible.
+ *
+ * Consecutive datagrams of the same size for the same peer and source address are coalesced into
+ * a single message which the kernel segments again, using UDP generic segmentation offload
+ * (UDP_SEGMENT) if the platform supports it. A shorter datagram may end such a message. The queued
+ * messages are then sent with sendmmsg(), or one by one with sendmsg() where sendmmsg() is not
+ * available. The payloads are moved into the writer, not copied.
+ */
+class UdpBatchWriter : Logger::Loggable<Logger::Id::udp> {
+public:
+  explicit UdpBatchWriter(IoHandle& io_handle);
+
+  /**
+   * Queue a datagram to be sent by the next flush().
+   * @param buffer supplies the payload, which is moved into the writer.
+   * @param local_ip supplies the source address, or nullptr to let the kernel select it.
+   * @param peer_address supplies the destination address.
+   * The addresses must remain valid until flush() is called.
+   */
+  void write(Buffer::Instance& buffer, const Address::Ip* local_ip,
+             const Address::Instance& peer_address);
+
+  /**
+   * Send the queued datagrams. Datagrams which cannot be sent are dropped, which includes all of
+   * the remaining datagrams once the send buffer of the socket is full.
+   */
+  UdpFlushResult flush();
+
+  /**
+   * @return the number of datagrams queued.
+   */
+  uint64_t pendingDatagrams() const { return pending_datagrams_; }
+
+  /**
+   * @return whether datagrams are coalesced using UDP generic segmentation offload.
+   */
+  bool gsoEnabled() const { return gso_enabled_; }
+
+  // The largest number of segments the kernel accepts in a message, see UDP_MAX_SEGMENTS.
+  static constexpr uint32_t MaxSegmentsPerMessage = 64;
+  // The largest payload of a coalesced message, which must fit in a single IPv4 packet.
+  static constexpr uint64_t MaxMessageSize = 65507;
+  // The largest datagram which is coalesced. The kernel rejects segments which do not fit into
+  // the MTU, so larger datagrams, which would fragment anyway, are sent on their own.
+  static constexpr uint64_t MaxSegmentSize = 1452;
+  // The number of messages handed to a single sendmmsg() call.
+  static constexpr uint32_t MaxMessagesPerCall = 64;
+
+private:
+  struct Message {
+    Buffer::OwnedImpl payload_;
+    const Address::Ip* local_ip_;
+    const Address::Instance* peer_address_;
+    // The size of every datagram in the message, except for the last one.
+    uint64_t segment_size_;
+    uint32_t num_datagrams_;
+    // Whether no more datagrams may be added, e.g. because the last one was shorter.
+    bool closed_;
+  };
+
+  bool canCoalesce(const Message& message, uint64_t length, const Address::Ip* local_ip,
+                   const Address::Instance& peer_address) const;
+  // Replaces the first message, which failed to be sent as a whole, with one message per datagram.
+  void splitFirstMessage();
+  void dropFirstMessage(UdpFlushResult& result);
+
+  IoHandle& io_handle_;
+  bool gso_enabled_;
+  std::deque<Message> messages_;
+  uint64_t pending_datagrams_{0};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -16,6 +16,7 @@
 #include "common/event/dispatcher_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
+#include "common/network/socket_option_impl.h"
 
 #include "absl/container/fixed_array.h"
 #include "event2/listener.h"
@@ -27,9 +28,29 @@
 namespace Envoy {
 namespace Network {
 
+namespace {
+
+bool udpGroEnabled(const Socket& socket) {
+  if (socket.options() == nullptr) {
+    return false;
+  }
+  for (const auto& option : *socket.options()) {
+    const absl::optional<Socket::Option::Details> details =
+        option->getOptionDetails(socket, envoy::config::core::v3::SocketOption::STATE_BOUND);
+    if (details.has_value() && details->name_ == ENVOY_SOCKET_UDP_GRO &&
+        details->value_.find_first_not_of('\0') != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, SocketSharedPtr socket,
                                  UdpListenerCallbacks& cb, TimeSource& time_source)
-    : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb), time_source_(time_source) {
+    : BaseListenerImpl(dispatcher, std::move(socket)), cb_(cb), time_source_(time_source),
+      gro_enabled_(udpGroEnabled(*socket_)), batch_writer_(socket_->ioHandle()) {
   file_event_ = dispatcher_.createFileEvent(
       socket_->ioHandle().fd(), [this](uint32_t events) -> void { onSocketEvent(events); },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
@@ -80,6 +101,10 @@ void UdpListenerImpl::handleReadCallback() {
                   result->getErrorDetails());
     cb_.onReceiveError(result->getErrorCode());
   }
+  // Send what was queued while processing the packets read.
+  if (batch_writer_.pendingDatagrams() > 0) {
+    flush();
+  }
 }
 
 void UdpListenerImpl::processPacket(Address::InstanceConstSharedPtr local_address,
@@ -116,5 +141,17 @@ Api::IoCallUint64Result UdpListenerImpl::send(const UdpSendData& send_data) {
   return send_result;
 }
 
+void UdpListenerImpl::queueSend(const UdpSendData& send_data) {
+  ENVOY_UDP_LOG(trace, "queueSend");
+  batch_writer_.write(send_data.buffer_, send_data.local_ip_, send_data.peer_address_);
+}
+
+UdpFlushResult UdpListenerImpl::flush() {
+  const UdpFlushResult result = batch_writer_.flush();
+  ENVOY_UDP_LOG(trace, "flushed {} datagrams with {} calls, dropped {}", result.datagrams_sent_,
+                result.send_calls_, result.datagrams_dropped_);
+  return result;
+}
+
 } // namespace Network
 } // namespace Envoy
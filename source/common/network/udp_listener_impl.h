@@ -7,6 +7,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/event/event_impl_base.h"
 #include "common/event/file_event_impl.h"
+#include "common/network/udp_batch_writer.h"
 #include "common/network/utility.h"
 
 #include "base_listener_impl.h"
@@ -35,6 +36,8 @@ public:
   Event::Dispatcher& dispatcher() override;
   const Address::InstanceConstSharedPtr& localAddress() const override;
   Api::IoCallUint64Result send(const UdpSendData& data) override;
+  void queueSend(const UdpSendData& data) override;
+  UdpFlushResult flush() override;
 
   void processPacket(Address::InstanceConstSharedPtr local_address,
                      Address::InstanceConstSharedPtr peer_address, Buffer::InstancePtr buffer,
@@ -42,7 +45,7 @@ public:
 
   uint64_t maxPacketSize() const override {
     // TODO(danzh) make this variable configurable to support jumbo frames.
-    return MAX_UDP_PACKET_SIZE;
+    return gro_enabled_ ? MAX_UDP_GRO_PACKET_SIZE : MAX_UDP_PACKET_SIZE;
   }
 
 protected:
@@ -57,6 +60,10 @@ private:
 
   TimeSource& time_source_;
   Event::FileEventPtr file_event_;
+  // Whether the socket is configured to coalesce received datagrams, see
+  // SocketOptionFactory::buildUdpGroOptions().
+  const bool gro_enabled_;
+  UdpBatchWriter batch_writer_;
 };
 
 } // namespace Network
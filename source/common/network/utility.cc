@@ -531,7 +531,7 @@ Api::IoCallUint64Result Utility::writeToSocket(IoHandle& handle, Buffer::RawSlic
   return send_result;
 }
 
-void passPayloadToProcessor(uint64_t bytes_read, Buffer::RawSlice& slice,
+void passPayloadToProcessor(uint64_t bytes_read, uint64_t gso_size, Buffer::RawSlice& slice,
                             Buffer::InstancePtr buffer, Address::InstanceConstSharedPtr peer_addess,
                             Address::InstanceConstSharedPtr local_address,
                             UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time) {
@@ -549,8 +549,29 @@ void passPayloadToProcessor(uint64_t bytes_read, Buffer::RawSlice& slice,
                  fmt::format("Unsupported remote address: {} local address: {}, receive size: "
                              "{}",
                              peer_addess->asString(), local_address->asString(), bytes_read));
-  udp_packet_processor.processPacket(std::move(local_address), std::move(peer_addess),
-                                     std::move(buffer), receive_time);
+  if (gso_size == 0 || buffer->length() <= gso_size) {
+    udp_packet_processor.processPacket(std::move(local_address), std::move(peer_addess),
+                                       std::move(buffer), receive_time);
+    return;
+  }
+
+  // The kernel coalesced datagrams from the same peer. Copy each of them into a buffer of its own
+  // rather than handing out slices of the large receive buffer, which would be kept alive by the
+  // smallest datagram.
+  ENVOY_LOG_MISC(trace, "splitting {} bytes into datagrams of {} bytes", buffer->length(),
+                 gso_size);
+  while (buffer->length() > 0) {
+    const uint64_t length = std::min(gso_size, buffer->length());
+    auto datagram = std::make_unique<Buffer::OwnedImpl>();
+    Buffer::RawSlice datagram_slice;
+    datagram->reserve(length, &datagram_slice, 1);
+    buffer->copyOut(0, length, datagram_slice.mem_);
+    datagram_slice.len_ = length;
+    datagram->commit(&datagram_slice, 1);
+    buffer->drain(length);
+    udp_packet_processor.processPacket(local_address, peer_addess, std::move(datagram),
+                                       receive_time);
+  }
 }
 
 Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
@@ -558,8 +579,10 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
                                                 UdpPacketProcessor& udp_packet_processor,
                                                 MonotonicTime receive_time,
                                                 uint32_t* packets_dropped) {
-  if (handle.supportsMmsg()) {
-    const uint32_t num_packets_per_mmsg_call = 16u;
+  // A payload coalesced by UDP_GRO already holds a batch of datagrams. It is read into a single
+  // large buffer per call rather than reserving one such buffer for every recvmmsg() message.
+  if (handle.supportsMmsg() && udp_packet_processor.maxPacketSize() <= MAX_UDP_PACKET_SIZE) {
+    const uint32_t num_packets_per_mmsg_call = NUM_DATAGRAMS_PER_MMSG_CALL;
     const uint32_t num_slices_per_packet = 1u;
     absl::FixedArray<Buffer::InstancePtr> buffers(num_packets_per_mmsg_call);
     RawSliceArrays slices(num_packets_per_mmsg_call,
@@ -585,8 +608,9 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
       ASSERT(msg_len <= slice->len_);
       ENVOY_LOG_MISC(debug, "Receive a packet with {} bytes from {}", msg_len,
                      output.msg_[i].peer_address_->asString());
-      passPayloadToProcessor(msg_len, *slice, std::move(buffers[i]), output.msg_[i].peer_address_,
-                             output.msg_[i].local_address_, udp_packet_processor, receive_time);
+      passPayloadToProcessor(msg_len, output.msg_[i].gso_size_, *slice, std::move(buffers[i]),
+                             output.msg_[i].peer_address_, output.msg_[i].local_address_,
+                             udp_packet_processor, receive_time);
     }
     return result;
   }
@@ -606,9 +630,10 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
 
   ENVOY_LOG_MISC(trace, "recvmsg bytes {}", result.rc_);
 
-  passPayloadToProcessor(
-      result.rc_, slice, std::move(buffer), std::move(output.msg_[0].peer_address_),
-      std::move(output.msg_[0].local_address_), udp_packet_processor, receive_time);
+  passPayloadToProcessor(result.rc_, output.msg_[0].gso_size_, slice, std::move(buffer),
+                         std::move(output.msg_[0].peer_address_),
+                         std::move(output.msg_[0].local_address_), udp_packet_processor,
+                         receive_time);
   return result;
 }
 
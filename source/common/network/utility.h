@@ -59,6 +59,18 @@ public:
 
 static const uint64_t MAX_UDP_PACKET_SIZE = 1500;
 
+/**
+ * The receive buffer size needed on sockets with UDP_GRO enabled, which may coalesce datagrams
+ * into a single payload of up to 64 KiB.
+ */
+static const uint64_t MAX_UDP_GRO_PACKET_SIZE = 64 * 1024;
+
+/**
+ * The number of datagrams read by each recvmmsg() call, when the packets to read are no larger
+ * than MAX_UDP_PACKET_SIZE.
+ */
+static const uint32_t NUM_DATAGRAMS_PER_MMSG_CALL = 16;
+
 /**
  * Common network utility routines.
  */
@@ -306,6 +318,10 @@ public:
 
   /**
    * Read a packet from a given UDP socket and pass the packet to given UdpPacketProcessor.
+   * Payloads which the kernel coalesced because UDP_GRO is enabled on the socket are split into
+   * the original datagrams, each of which is passed on its own. Batches of datagrams are read
+   * with recvmmsg() only when the processor's maxPacketSize() is at most MAX_UDP_PACKET_SIZE;
+   * larger packets are read one at a time into a single buffer.
    * @param handle is the UDP socket to read from.
    * @param local_address is the socket's local address used to populate port.
    * @param udp_packet_processor is the callback to receive the packet.
@@ -34,6 +34,7 @@
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/router/retry_state_impl.h"
+#include "common/runtime/runtime_features.h"
 #include "common/tracing/http_tracer_impl.h"
 
 #include "extensions/filters/http/common/utility.h"
@@ -1023,6 +1024,10 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
     }
   }
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.compiled_route_matcher")) {
+    buildPathRouteIndex(virtual_host);
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(
         VirtualClusterEntry(virtual_cluster, stat_name_pool_, *vcluster_scope_));
@@ -1064,6 +1069,53 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   }
 }
 
+void VirtualHostImpl::buildPathRouteIndex(
+    const envoy::config::route::v3::VirtualHost& virtual_host) {
+  auto index = std::make_unique<PathRouteIndex>();
+  std::vector<uint32_t> regex_routes;
+  std::vector<envoy::type::matcher::v3::RegexMatcher> regexes;
+  for (uint32_t i = 0; i < routes_.size(); ++i) {
+    const RouteEntryImplBase& route = *routes_[i];
+    // Pathless (e.g. CONNECT) routes cannot be narrowed down by the request path, so they are
+    // evaluated for every request.
+    if (route.supportsPathlessHeaders()) {
+      index->addUnindexed(i);
+      continue;
+    }
+    ASSERT(static_cast<int>(i) < virtual_host.routes_size());
+    const auto& match = virtual_host.routes(i).match();
+    switch (match.path_specifier_case()) {
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+      if (route.caseSensitive()) {
+        index->addPrefix(i, match.prefix());
+      } else {
+        index->addUnindexed(i);
+      }
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+      if (route.caseSensitive()) {
+        index->addExact(i, match.path());
+      } else {
+        index->addUnindexed(i);
+      }
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+      // All safe regex routes are matched in a single pass of a regex set and only the routes
+      // whose regex matched are evaluated in full.
+      regex_routes.push_back(i);
+      regexes.push_back(match.safe_regex());
+      break;
+    default:
+      index->addUnindexed(i);
+      break;
+    }
+  }
+  if (!regex_routes.empty()) {
+    index->addRegexSet(std::move(regex_routes), Regex::Utility::parseRegexSet(regexes));
+  }
+  path_route_index_ = std::move(index);
+}
+
 const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
@@ -1147,6 +1199,22 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::RequestHead
     return SSL_REDIRECT_ROUTE;
   }
 
+  // Use the path index, if any, to only evaluate the routes whose path specifier can match. The
+  // candidates are returned in route table order so the first matching route still wins.
+  if (path_route_index_ != nullptr && headers.Path() != nullptr) {
+    PathRouteIndex::Candidates candidates;
+    path_route_index_->findCandidates(
+        Http::PathUtil::removeQueryAndFragment(headers.Path()->value().getStringView()),
+        candidates);
+    for (const uint32_t index : candidates) {
+      RouteConstSharedPtr route_entry = routes_[index]->matches(headers, stream_info, random_value);
+      if (nullptr != route_entry) {
+        return route_entry;
+      }
+    }
+    return nullptr;
+  }
+
   // Check for a route that matches the request.
   for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
     if (!headers.Path() && !route->supportsPathlessHeaders()) {
@@ -27,6 +27,7 @@
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/path_route_index.h"
 #include "common/router/router_ratelimit.h"
 #include "common/router/tls_context_match_criteria_impl.h"
 #include "common/stats/symbol_table_impl.h"
@@ -219,10 +220,14 @@ private:
 
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
+  void buildPathRouteIndex(const envoy::config::route::v3::VirtualHost& virtual_host);
+
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName stat_name_;
   Stats::ScopePtr vcluster_scope_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Only built when envoy.reloadable_features.compiled_route_matcher is enabled.
+  PathRouteIndexConstPtr path_route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -414,6 +419,7 @@ public:
   bool matchRoute(const Http::RequestHeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
                   uint64_t random_value) const;
   void validateClusters(Upstream::ClusterManager& cm) const;
+  bool caseSensitive() const { return case_sensitive_; }
 
   // Router::RouteEntry
   const std::string& clusterName() const override;
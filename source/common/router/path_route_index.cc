@@ -0,0 +1,120 @@
+#include "common/router/path_route_index.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Router {
+
+PathRouteIndex::PathRouteIndex() {
+  // The root node has an empty label and holds routes with an empty prefix.
+  nodes_.emplace_back("");
+}
+
+void PathRouteIndex::addPrefix(uint32_t route_index, absl::string_view prefix) {
+  nodes_[insert(prefix)].prefix_routes_.push_back(route_index);
+  ++size_;
+}
+
+void PathRouteIndex::addExact(uint32_t route_index, absl::string_view path) {
+  nodes_[insert(path)].exact_routes_.push_back(route_index);
+  ++size_;
+}
+
+void PathRouteIndex::addUnindexed(uint32_t route_index) {
+  unindexed_routes_.push_back(route_index);
+  ++size_;
+}
+
+void PathRouteIndex::addRegexSet(std::vector<uint32_t>&& route_indices,
+                                 Regex::CompiledMatcherSetPtr&& regex_set) {
+  ASSERT(regex_set_ == nullptr);
+  size_ += route_indices.size();
+  regex_routes_ = std::move(route_indices);
+  regex_set_ = std::move(regex_set);
+}
+
+std::vector<uint32_t>::const_iterator PathRouteIndex::findChild(const Node& node, char c) const {
+  return std::lower_bound(
+      node.children_.begin(), node.children_.end(), c,
+      [this](uint32_t child, char value) { return nodes_[child].label_[0] < value; });
+}
+
+uint32_t PathRouteIndex::insert(absl::string_view key) {
+  uint32_t current = 0;
+  while (!key.empty()) {
+    const auto it = findChild(nodes_[current], key[0]);
+    const size_t position = it - nodes_[current].children_.begin();
+    if (it == nodes_[current].children_.end() || nodes_[*it].label_[0] != key[0]) {
+      // No edge shares a first character with the key, so the remainder becomes a new leaf.
+      const uint32_t leaf = nodes_.size();
+      nodes_.emplace_back(key);
+      auto& children = nodes_[current].children_;
+      children.insert(children.begin() + position, leaf);
+      return leaf;
+    }
+
+    const uint32_t child = *it;
+    const std::string& label = nodes_[child].label_;
+    size_t common = 0;
+    while (common < label.size() && common < key.size() && label[common] == key[common]) {
+      ++common;
+    }
+
+    if (common < label.size()) {
+      // The key diverges from (or ends inside) the edge label. Split the edge so that an
+      // intermediate node holds the shared part of the label.
+      std::string shared = label.substr(0, common);
+      nodes_[child].label_.erase(0, common);
+      const uint32_t middle = nodes_.size();
+      nodes_.emplace_back(shared);
+      nodes_[middle].children_.push_back(child);
+      nodes_[current].children_[position] = middle;
+      current = middle;
+    } else {
+      current = child;
+    }
+    key.remove_prefix(common);
+  }
+  return current;
+}
+
+void PathRouteIndex::findCandidates(absl::string_view path, Candidates& candidates) const {
+  const absl::string_view original_path = path;
+  uint32_t current = 0;
+  while (true) {
+    const Node& node = nodes_[current];
+    candidates.insert(candidates.end(), node.prefix_routes_.begin(), node.prefix_routes_.end());
+    if (path.empty()) {
+      candidates.insert(candidates.end(), node.exact_routes_.begin(), node.exact_routes_.end());
+      break;
+    }
+    const auto it = findChild(node, path[0]);
+    if (it == node.children_.end() || !absl::StartsWith(path, nodes_[*it].label_)) {
+      break;
+    }
+    path.remove_prefix(nodes_[*it].label_.size());
+    current = *it;
+  }
+
+  candidates.insert(candidates.end(), unindexed_routes_.begin(), unindexed_routes_.end());
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    if (regex_set_->match(original_path, matches)) {
+      for (const int match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else {
+      // The regex engine gave up, so every regex route has to be evaluated individually.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+  // Routes are collected per tree level, so restore the route table order before returning.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
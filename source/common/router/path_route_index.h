@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/regex.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Radix tree over the prefix and exact path specifiers of a virtual host's route table. The index
+ * only narrows down which routes may match a request path. Callers must still run the full route
+ * match (headers, query parameters, runtime fraction, etc.) on each candidate in the order
+ * returned, which is the original route table order, to preserve first-match-wins semantics.
+ */
+class PathRouteIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+  PathRouteIndex();
+
+  /**
+   * Index a route that matches on a case sensitive path prefix.
+   * @param route_index supplies the position of the route in the route table.
+   * @param prefix supplies the prefix the route matches.
+   */
+  void addPrefix(uint32_t route_index, absl::string_view prefix);
+
+  /**
+   * Index a route that matches on a case sensitive exact path.
+   * @param route_index supplies the position of the route in the route table.
+   * @param path supplies the path the route matches.
+   */
+  void addExact(uint32_t route_index, absl::string_view path);
+
+  /**
+   * Add a route which cannot be indexed by path, e.g. a case insensitive route. These
+   * routes are returned as candidates for every lookup.
+   * @param route_index supplies the position of the route in the route table.
+   */
+  void addUnindexed(uint32_t route_index);
+
+  /**
+   * Index a set of routes which match the request path against a regex. Only the routes whose
+   * regex matches are returned as candidates.
+   * @param route_indices supplies the positions of the routes in the route table.
+   * @param regex_set supplies the route regexes, in the same order as route_indices.
+   */
+  void addRegexSet(std::vector<uint32_t>&& route_indices, Regex::CompiledMatcherSetPtr&& regex_set);
+
+  /**
+   * Find the routes which may match a request path.
+   * @param path supplies the request path with the query string and fragment removed.
+   * @param candidates supplies the vector that receives the candidate route indices, in ascending
+   *        order.
+   */
+  void findCandidates(absl::string_view path, Candidates& candidates) const;
+
+  /**
+   * @return the number of routes added to the index, including unindexed routes.
+   */
+  uint32_t size() const { return size_; }
+
+private:
+  struct Node {
+    Node(absl::string_view label) : label_(label) {}
+
+    // The edge label from the parent node to this node.
+    std::string label_;
+    // Indices into nodes_, kept sorted by the first character of the child's label.
+    std::vector<uint32_t> children_;
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> exact_routes_;
+  };
+
+  uint32_t insert(absl::string_view key);
+  // Returns the position in children_ of the child whose label starts with c, or the position at
+  // which such a child should be inserted.
+  std::vector<uint32_t>::const_iterator findChild(const Node& node, char c) const;
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> unindexed_routes_;
+  std::vector<uint32_t> regex_routes_;
+  Regex::CompiledMatcherSetPtr regex_set_;
+  uint32_t size_{};
+};
+
+using PathRouteIndexConstPtr = std::unique_ptr<const PathRouteIndex>;
+
+} // namespace Router
+} // namespace Envoy
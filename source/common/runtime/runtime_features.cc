@@ -76,6 +76,18 @@ constexpr const char* runtime_features[] = {
 constexpr const char* disabled_runtime_features[] = {
     // Sentinel and test flag.
     "envoy.reloadable_features.test_feature_false",
+    // Route lookup through a per virtual host path index.
+    "envoy.reloadable_features.compiled_route_matcher",
+    // Per-stream arena for HTTP connection manager filter wrappers.
+    "envoy.reloadable_features.http_stream_arena",
+    // Weighted host selection by the random load balancer.
+    "envoy.reloadable_features.weighted_random_lb",
+    // TLS records which start small and grow as the connection writes.
+    "envoy.reloadable_features.tls_dynamic_record_sizing",
+    // Host set changes applied to the existing EDF schedules instead of rebuilding them.
+    "envoy.reloadable_features.incremental_edf_update",
+    // File access log writes dropped while too much data waits to be flushed.
+    "envoy.reloadable_features.access_log_write_limit",
 };
 
 RuntimeFeatures::RuntimeFeatures() {
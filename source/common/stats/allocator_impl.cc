@@ -23,6 +23,16 @@ namespace Stats {
 const char AllocatorImpl::DecrementToZeroSyncPoint[] = "decrement-zero";
 
 AllocatorImpl::~AllocatorImpl() {
+  // The queued stats may hold the last references to their stats, which must be removed from the
+  // sets before checking them.
+  CounterSharedPtr counter;
+  while (changed_counters_.pop(counter)) {
+    counter.reset();
+  }
+  GaugeSharedPtr gauge;
+  while (changed_gauges_.pop(gauge)) {
+    gauge.reset();
+  }
   ASSERT(counters_.empty());
   ASSERT(gauges_.empty());
 }
@@ -91,6 +101,12 @@ public:
   }
   uint32_t use_count() const override { return ref_count_; }
 
+  /**
+   * Clears the changed flag of a stat taken from the allocator's changed stats, so that it is
+   * queued again on its next change.
+   */
+  void clearChanged() { flags_ &= ~Metric::Flags::Changed; }
+
   /**
    * We must atomically remove the counter/gauges from the allocator's sets when
    * our ref-count decrement hits zero. The counters and gauges are held in
@@ -112,7 +128,7 @@ protected:
   // alloc_.gauges_. We leave it atomic to avoid taking the lock on increment.
   std::atomic<uint32_t> ref_count_{0};
 
-  std::atomic<uint16_t> flags_{0};
+  std::atomic<uint16_t> flags_{Metric::Flags::Changed};
 };
 
 class CounterImpl : public StatsSharedImpl<Counter> {
@@ -132,14 +148,24 @@ public:
     // used(). From a system perspective this should be eventually consistent.
     value_ += amount;
     pending_increment_ += amount;
-    flags_ |= Flags::Used;
+    markChanged(Flags::Used);
   }
   void inc() override { add(1); }
   uint64_t latch() override { return pending_increment_.exchange(0); }
-  void reset() override { value_ = 0; }
+  void reset() override {
+    value_ = 0;
+    markChanged(0);
+  }
   uint64_t value() const override { return value_; }
 
 private:
+  // Sets the given flags along with Changed, and queues the counter if it was not changed already.
+  void markChanged(uint16_t flags) {
+    if (!(flags_.fetch_or(flags | Flags::Changed) & Flags::Changed)) {
+      alloc_.changed_counters_.push(CounterSharedPtr(this));
+    }
+  }
+
   std::atomic<uint64_t> value_{0};
   std::atomic<uint64_t> pending_increment_{0};
 };
@@ -173,18 +199,19 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     value_ += amount;
-    flags_ |= Flags::Used;
+    markChanged(Flags::Used);
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     value_ = value;
-    flags_ |= Flags::Used;
+    markChanged(Flags::Used);
   }
   void sub(uint64_t amount) override {
     ASSERT(value_ >= amount);
     ASSERT(used() || amount == 0);
     value_ -= amount;
+    markChanged(0);
   }
   uint64_t value() const override { return value_; }
 
@@ -225,6 +252,13 @@ public:
   }
 
 private:
+  // Sets the given flags along with Changed, and queues the gauge if it was not changed already.
+  void markChanged(uint16_t flags) {
+    if (!(flags_.fetch_or(flags | Flags::Changed) & Flags::Changed)) {
+      alloc_.changed_gauges_.push(GaugeSharedPtr(this));
+    }
+  }
+
   std::atomic<uint64_t> value_{0};
 };
 
@@ -266,6 +300,9 @@ CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracte
   }
   auto counter = CounterSharedPtr(new CounterImpl(name, *this, tag_extracted_name, stat_name_tags));
   counters_.insert(counter.get());
+  if (track_changed_stats_) {
+    changed_counters_.push(counter);
+  }
   return counter;
 }
 
@@ -282,6 +319,9 @@ GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, StatName tag_extracted_na
   auto gauge =
       GaugeSharedPtr(new GaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode));
   gauges_.insert(gauge.get());
+  if (track_changed_stats_) {
+    changed_gauges_.push(gauge);
+  }
   return gauge;
 }
 
@@ -300,6 +340,36 @@ TextReadoutSharedPtr AllocatorImpl::makeTextReadout(StatName name, StatName tag_
   return text_readout;
 }
 
+void AllocatorImpl::trackChangedStats() {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(!track_changed_stats_);
+  track_changed_stats_ = true;
+  // The existing stats all have their Changed flag set, so they can be queued without racing with
+  // their updates.
+  for (Counter* counter : counters_) {
+    changed_counters_.push(CounterSharedPtr(counter));
+  }
+  for (Gauge* gauge : gauges_) {
+    changed_gauges_.push(GaugeSharedPtr(gauge));
+  }
+}
+
+void AllocatorImpl::takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                                     std::vector<GaugeSharedPtr>& gauges) {
+  // The flags are cleared before the values are read by the caller, so a change racing with the
+  // snapshot queues the stat again rather than being lost.
+  CounterSharedPtr counter;
+  while (changed_counters_.pop(counter)) {
+    static_cast<CounterImpl*>(counter.get())->clearChanged();
+    counters.push_back(std::move(counter));
+  }
+  GaugeSharedPtr gauge;
+  while (changed_gauges_.pop(gauge)) {
+    static_cast<GaugeImpl*>(gauge.get())->clearChanged();
+    gauges.push_back(std::move(gauge));
+  }
+}
+
 bool AllocatorImpl::isMutexLockedForTest() {
   bool locked = mutex_.tryLock();
   if (locked) {
@@ -6,6 +6,7 @@
 #include "envoy/stats/stats.h"
 #include "envoy/stats/symbol_table.h"
 
+#include "common/common/mpsc_queue.h"
 #include "common/common/thread_synchronizer.h"
 #include "common/stats/metric_impl.h"
 
@@ -32,6 +33,9 @@ public:
                                        const StatNameTagVector& stat_name_tags) override;
   SymbolTable& symbolTable() override { return symbol_table_; }
   const SymbolTable& constSymbolTable() const override { return symbol_table_; }
+  void trackChangedStats() override;
+  void takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                        std::vector<GaugeSharedPtr>& gauges) override;
 
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint();
@@ -88,6 +92,14 @@ private:
   // protected by locks.
   Thread::MutexBasicLockable mutex_;
 
+  // Counters and gauges which changed since they were last taken by takeChangedStats(). A stat is
+  // only queued when it changes while its Changed flag is clear, so that it is queued at most once
+  // and updates only cost an atomic or on the flags once the stat is queued. Stats are created
+  // with the flag set, so nothing is queued unless tracking is enabled.
+  bool track_changed_stats_ GUARDED_BY(mutex_){};
+  MpscQueue<CounterSharedPtr> changed_counters_;
+  MpscQueue<GaugeSharedPtr> changed_gauges_;
+
   Thread::ThreadSynchronizer sync_;
 };
 
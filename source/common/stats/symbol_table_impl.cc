@@ -9,6 +9,7 @@
 #include "common/common/logger.h"
 #include "common/common/utility.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/str_cat.h"
 
 namespace Envoy {
@@ -406,12 +407,22 @@ void SymbolTableImpl::newSymbol() EXCLUSIVE_LOCKS_REQUIRED(lock_) {
 }
 
 bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
-  // Constructing two temp vectors during lessThan is not strictly necessary.
-  // If this becomes a performance bottleneck (e.g. during sorting), we could
-  // provide an iterator-like interface for incrementally comparing the tokens
-  // without allocating memory.
-  const std::vector<absl::string_view> av = decodeStrings(a.data(), a.dataSize());
-  const std::vector<absl::string_view> bv = decodeStrings(b.data(), b.dataSize());
+  // Stat names are compared many times while the admin handlers sort them, so both are decoded
+  // under a single lock into inline vectors, which only allocate memory for very long names.
+  using TokenVec = absl::InlinedVector<absl::string_view, 16>;
+  auto decode = [this](const StatName& stat_name, TokenVec& tokens) NO_THREAD_SAFETY_ANALYSIS {
+    Encoding::decodeTokens(
+        stat_name.data(), stat_name.dataSize(),
+        [this, &tokens](Symbol symbol)
+            NO_THREAD_SAFETY_ANALYSIS { tokens.push_back(fromSymbol(symbol)); },
+        [&tokens](absl::string_view str) { tokens.push_back(str); });
+  };
+  TokenVec av, bv;
+  {
+    Thread::LockGuard lock(lock_);
+    decode(a, av);
+    decode(b, bv);
+  }
 
   for (uint64_t i = 0, n = std::min(av.size(), bv.size()); i < n; ++i) {
     if (av[i] != bv[i]) {
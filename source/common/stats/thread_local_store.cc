@@ -1,5 +1,6 @@
 #include "common/stats/thread_local_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -32,6 +33,7 @@ ThreadLocalStoreImpl::ThreadLocalStoreImpl(Allocator& alloc)
 
 ThreadLocalStoreImpl::~ThreadLocalStoreImpl() {
   ASSERT(shutting_down_ || !threading_ever_initialized_);
+  stopHistogramMergeThreads();
   default_scope_.reset();
   ASSERT(scopes_.empty());
 }
@@ -105,6 +107,27 @@ std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   return ret;
 }
 
+void ThreadLocalStoreImpl::takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                                            std::vector<GaugeSharedPtr>& gauges) {
+  alloc_.takeChangedStats(counters, gauges);
+  if (stats_matcher_->acceptsAll()) {
+    return;
+  }
+
+  // Stats which were created before the stats matcher was set and then rejected by it can still
+  // change, but are not reported by counters() and gauges() either.
+  counters.erase(std::remove_if(counters.begin(), counters.end(),
+                                [this](const CounterSharedPtr& counter) {
+                                  return rejects(counter->statName());
+                                }),
+                 counters.end());
+  gauges.erase(std::remove_if(gauges.begin(), gauges.end(),
+                              [this](const GaugeSharedPtr& gauge) {
+                                return rejects(gauge->statName());
+                              }),
+               gauges.end());
+}
+
 ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
   auto new_scope = std::make_unique<ScopeImpl>(*this, name);
   Thread::LockGuard lock(lock_);
@@ -177,6 +200,29 @@ void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_di
 void ThreadLocalStoreImpl::shutdownThreading() {
   // This will block both future cache fills as well as cache flushes.
   shutting_down_ = true;
+  // A merge which is in progress is finished, but not published.
+  stopHistogramMergeThreads();
+}
+
+void ThreadLocalStoreImpl::setHistogramMergeThreads(Thread::ThreadFactory& thread_factory,
+                                                    uint32_t num_threads) {
+  ASSERT(merge_threads_.empty());
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    merge_threads_.push_back(
+        thread_factory.createThread([this]() -> void { histogramMergeThreadRoutine(); }));
+  }
+}
+
+void ThreadLocalStoreImpl::stopHistogramMergeThreads() {
+  {
+    Thread::LockGuard lock(merge_threads_lock_);
+    merge_threads_exit_ = true;
+  }
+  merge_threads_cv_.notifyAll();
+  for (Thread::ThreadPtr& thread : merge_threads_) {
+    thread->join();
+  }
+  merge_threads_.clear();
 }
 
 void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
@@ -202,6 +248,10 @@ void ThreadLocalStoreImpl::mergeHistograms(PostMergeCb merge_complete_cb) {
 
 void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   if (!shutting_down_) {
+    if (!merge_threads_.empty()) {
+      startHistogramMerge(merge_complete_cb);
+      return;
+    }
     for (const ParentHistogramSharedPtr& histogram : histograms()) {
       histogram->merge();
     }
@@ -210,6 +260,81 @@ void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   }
 }
 
+std::vector<ParentHistogramImplSharedPtr> ThreadLocalStoreImpl::parentHistograms() const {
+  std::vector<ParentHistogramImplSharedPtr> ret;
+  Thread::LockGuard lock(lock_);
+  for (ScopeImpl* scope : scopes_) {
+    for (const auto& name_histogram_pair : scope->central_cache_->histograms_) {
+      ret.push_back(name_histogram_pair.second);
+    }
+  }
+  return ret;
+}
+
+void ThreadLocalStoreImpl::startHistogramMerge(PostMergeCb merge_complete_cb) {
+  // The histograms are only released on the main thread, once the merge is published.
+  histograms_to_merge_ = parentHistograms();
+  merge_complete_cb_ = merge_complete_cb;
+  next_histogram_to_merge_ = 0;
+  {
+    Thread::LockGuard lock(merge_threads_lock_);
+    merge_threads_running_ = merge_threads_.size();
+    ++merge_generation_;
+  }
+  merge_threads_cv_.notifyAll();
+}
+
+void ThreadLocalStoreImpl::histogramMergeThreadRoutine() {
+  // Histograms are claimed in batches, which keeps the threads busy until the end of the merge
+  // even if some histograms take longer to merge than others.
+  constexpr size_t batch_size = 64;
+  uint64_t generation = 0;
+  while (true) {
+    {
+      Thread::LockGuard lock(merge_threads_lock_);
+      while (!merge_threads_exit_ && merge_generation_ == generation) {
+        merge_threads_cv_.wait(merge_threads_lock_);
+      }
+      if (merge_threads_exit_) {
+        return;
+      }
+      generation = merge_generation_;
+    }
+
+    const size_t num_histograms = histograms_to_merge_.size();
+    for (size_t begin = next_histogram_to_merge_.fetch_add(batch_size); begin < num_histograms;
+         begin = next_histogram_to_merge_.fetch_add(batch_size)) {
+      const size_t end = std::min(begin + batch_size, num_histograms);
+      for (size_t i = begin; i < end; ++i) {
+        histograms_to_merge_[i]->mergeInterval();
+      }
+    }
+
+    bool last;
+    {
+      Thread::LockGuard lock(merge_threads_lock_);
+      last = --merge_threads_running_ == 0;
+    }
+    if (last) {
+      main_thread_dispatcher_->post([this]() -> void { publishHistogramMerge(); });
+    }
+  }
+}
+
+void ThreadLocalStoreImpl::publishHistogramMerge() {
+  const std::vector<ParentHistogramImplSharedPtr> histograms = std::move(histograms_to_merge_);
+  histograms_to_merge_.clear();
+  const PostMergeCb merge_complete_cb = std::move(merge_complete_cb_);
+  merge_complete_cb_ = nullptr;
+  if (!shutting_down_) {
+    for (const ParentHistogramImplSharedPtr& histogram : histograms) {
+      histogram->publishInterval();
+    }
+    merge_complete_cb();
+    merge_in_progress_ = false;
+  }
+}
+
 ThreadLocalStoreImpl::CentralCacheEntry::~CentralCacheEntry() {
   // Assert that the symbol-table is valid, so we get good test coverage of
   // the validity of the symbol table at the time this destructor runs. This
@@ -680,8 +805,12 @@ ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit, St
                                          const StatNameTagVector& stat_name_tags)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, parent.symbolTable()), unit_(unit),
       parent_(parent), tls_scope_(tls_scope), interval_histogram_(hist_alloc()),
-      cumulative_histogram_(hist_alloc()), interval_statistics_(interval_histogram_),
-      cumulative_statistics_(cumulative_histogram_), merged_(false) {}
+      cumulative_histogram_(hist_alloc()), merged_(false) {
+  for (uint32_t i = 0; i < 2; ++i) {
+    interval_statistics_[i].refresh(interval_histogram_);
+    cumulative_statistics_[i].refresh(cumulative_histogram_);
+  }
+}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   MetricImpl::clear(symbolTable());
@@ -703,6 +832,11 @@ bool ParentHistogramImpl::used() const {
 }
 
 void ParentHistogramImpl::merge() {
+  mergeInterval();
+  publishInterval();
+}
+
+void ParentHistogramImpl::mergeInterval() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
     hist_clear(interval_histogram_);
@@ -716,8 +850,16 @@ void ParentHistogramImpl::merge() {
     // Since TLS merge is done, we can release the lock here.
     lock.release();
     hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
+    cumulative_statistics_[1 - published_].refresh(cumulative_histogram_);
+    interval_statistics_[1 - published_].refresh(interval_histogram_);
+    merge_pending_ = true;
+  }
+}
+
+void ParentHistogramImpl::publishInterval() {
+  if (merge_pending_) {
+    published_ = 1 - published_;
+    merge_pending_ = false;
     merged_ = true;
   }
 }
@@ -725,12 +867,12 @@ void ParentHistogramImpl::merge() {
 const std::string ParentHistogramImpl::quantileSummary() const {
   if (used()) {
     std::vector<std::string> summary;
-    const std::vector<double>& supported_quantiles_ref = interval_statistics_.supportedQuantiles();
+    const std::vector<double>& supported_quantiles_ref = intervalStatistics().supportedQuantiles();
     summary.reserve(supported_quantiles_ref.size());
     for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
       summary.push_back(fmt::format("P{:g}({},{})", 100 * supported_quantiles_ref[i],
-                                    interval_statistics_.computedQuantiles()[i],
-                                    cumulative_statistics_.computedQuantiles()[i]));
+                                    intervalStatistics().computedQuantiles()[i],
+                                    cumulativeStatistics().computedQuantiles()[i]));
     }
     return absl::StrJoin(summary, " ");
   } else {
@@ -741,12 +883,12 @@ const std::string ParentHistogramImpl::quantileSummary() const {
 const std::string ParentHistogramImpl::bucketSummary() const {
   if (used()) {
     std::vector<std::string> bucket_summary;
-    const std::vector<double>& supported_buckets = interval_statistics_.supportedBuckets();
+    const std::vector<double>& supported_buckets = intervalStatistics().supportedBuckets();
     bucket_summary.reserve(supported_buckets.size());
     for (size_t i = 0; i < supported_buckets.size(); ++i) {
       bucket_summary.push_back(fmt::format("B{:g}({},{})", supported_buckets[i],
-                                           interval_statistics_.computedBuckets()[i],
-                                           cumulative_statistics_.computedBuckets()[i]));
+                                           intervalStatistics().computedBuckets()[i],
+                                           cumulativeStatistics().computedBuckets()[i]));
     }
     return absl::StrJoin(bucket_summary, " ");
   } else {
@@ -5,11 +5,14 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "envoy/stats/tag.h"
+#include "envoy/thread/thread.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/hash.h"
+#include "common/common/thread.h"
 #include "common/common/thread_synchronizer.h"
 #include "common/stats/allocator_impl.h"
 #include "common/stats/histogram_impl.h"
@@ -98,9 +101,24 @@ public:
    */
   void merge() override;
 
-  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  /**
+   * The first half of merge(), which may be called from any thread: collects the TLS histograms
+   * into the interval histogram and computes the new statistics, without exposing them yet. Calls
+   * for the same histogram must not overlap.
+   */
+  void mergeInterval();
+
+  /**
+   * The second half of merge(), which must be called from the main thread: exposes the statistics
+   * computed by the last mergeInterval().
+   */
+  void publishInterval();
+
+  const HistogramStatistics& intervalStatistics() const override {
+    return interval_statistics_[published_];
+  }
   const HistogramStatistics& cumulativeStatistics() const override {
-    return cumulative_statistics_;
+    return cumulative_statistics_[published_];
   }
   const std::string quantileSummary() const override;
   const std::string bucketSummary() const override;
@@ -122,11 +140,14 @@ private:
   TlsScope& tls_scope_;
   histogram_t* interval_histogram_;
   histogram_t* cumulative_histogram_;
-  HistogramStatisticsImpl interval_statistics_;
-  HistogramStatisticsImpl cumulative_statistics_;
+  // The statistics at index published_ are exposed, while mergeInterval() computes the others.
+  HistogramStatisticsImpl interval_statistics_[2];
+  HistogramStatisticsImpl cumulative_statistics_[2];
+  uint32_t published_{};
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ GUARDED_BY(merge_lock_);
   bool merged_;
+  bool merge_pending_{};
   RefcountHelper refcount_helper_;
 };
 
@@ -257,6 +278,11 @@ public:
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
   void mergeHistograms(PostMergeCb merge_cb) override;
+  void setHistogramMergeThreads(Thread::ThreadFactory& thread_factory,
+                                uint32_t num_threads) override;
+  void trackChangedStats() override { alloc_.trackChangedStats(); }
+  void takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                        std::vector<GaugeSharedPtr>& gauges) override;
 
   /**
    * @return a thread synchronizer object used for controlling thread behavior in tests.
@@ -413,6 +439,11 @@ private:
   void clearScopeFromCaches(uint64_t scope_id, CentralCacheEntrySharedPtr central_cache);
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb merge_cb);
+  std::vector<ParentHistogramImplSharedPtr> parentHistograms() const;
+  void startHistogramMerge(PostMergeCb merge_cb);
+  void histogramMergeThreadRoutine();
+  void publishHistogramMerge();
+  void stopHistogramMergeThreads();
   bool rejects(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
   template <class StatMapClass, class StatListClass>
@@ -434,6 +465,19 @@ private:
   std::atomic<bool> merge_in_progress_{};
   AllocatorImpl heap_allocator_;
 
+  // Threads which merge the histograms off the main thread, if any. The histograms of a merge are
+  // claimed in batches through next_histogram_to_merge_, and the last thread to finish publishes
+  // the merge on the main thread.
+  std::vector<Thread::ThreadPtr> merge_threads_;
+  Thread::MutexBasicLockable merge_threads_lock_;
+  Thread::CondVar merge_threads_cv_;
+  uint64_t merge_generation_ GUARDED_BY(merge_threads_lock_){};
+  uint32_t merge_threads_running_ GUARDED_BY(merge_threads_lock_){};
+  bool merge_threads_exit_ GUARDED_BY(merge_threads_lock_){};
+  std::vector<ParentHistogramImplSharedPtr> histograms_to_merge_;
+  std::atomic<size_t> next_histogram_to_merge_{};
+  PostMergeCb merge_complete_cb_;
+
   NullCounterImpl null_counter_;
   NullGaugeImpl null_gauge_;
   NullHistogramImpl null_histogram_;
@@ -0,0 +1,185 @@
+#include "common/tcp_proxy/splice_forwarder.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace TcpProxy {
+
+#if defined(__linux__)
+
+namespace {
+// Capacity of a pipe when it cannot be sized after the connection buffer limit. This is the Linux
+// default of 16 pages.
+constexpr uint64_t DefaultPipeCapacity = 64 * 1024;
+} // namespace
+
+SpliceForwarder::Direction::Direction(SpliceForwarder& parent, Network::Connection& source,
+                                      Network::Connection& sink, bool from_downstream)
+    : parent_(parent), source_(source), sink_(sink),
+      source_fd_(source.passthroughIoHandle()->fd()), sink_fd_(sink.passthroughIoHandle()->fd()),
+      from_downstream_(from_downstream) {}
+
+SpliceForwarder::Direction::~Direction() {
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  for (int fd : pipe_) {
+    if (fd != -1) {
+      os_syscalls.close(fd);
+    }
+  }
+}
+
+bool SpliceForwarder::Direction::initialize() {
+  auto& os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  const Api::SysCallIntResult result = os_syscalls.pipe2(pipe_, O_NONBLOCK | O_CLOEXEC);
+  if (result.rc_ != 0) {
+    ENVOY_CONN_LOG(debug, "splice: unable to create pipe: {}", source_, strerror(result.errno_));
+    return false;
+  }
+
+  capacity_ = DefaultPipeCapacity;
+  if (sink_.bufferLimit() > 0) {
+    // Growing a pipe beyond /proc/sys/fs/pipe-max-size fails for unprivileged processes, in which
+    // case the default capacity is kept.
+    const Api::SysCallIntResult size = os_syscalls.setPipeSize(pipe_[1], sink_.bufferLimit());
+    if (size.rc_ > 0) {
+      capacity_ = size.rc_;
+    }
+  }
+  return true;
+}
+
+bool SpliceForwarder::Direction::transfer() {
+  auto& os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  bool progress = true;
+  while (progress) {
+    progress = false;
+
+    if (!end_of_stream_ && buffered_ < capacity_) {
+      const Api::SysCallSizeResult result = os_syscalls.splice(
+          source_fd_, pipe_[1], capacity_ - buffered_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (result.rc_ > 0) {
+        buffered_ += result.rc_;
+        progress = true;
+      } else if (result.rc_ == 0) {
+        ENVOY_CONN_LOG(trace, "splice: end of stream", source_);
+        end_of_stream_ = true;
+      } else if (result.errno_ != EAGAIN) {
+        ENVOY_CONN_LOG(debug, "splice: read error: {}", source_, strerror(result.errno_));
+        source_.close(Network::ConnectionCloseType::NoFlush);
+        return false;
+      }
+    }
+
+    if (buffered_ > 0) {
+      const Api::SysCallSizeResult result = os_syscalls.splice(
+          pipe_[0], sink_fd_, buffered_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (result.rc_ > 0) {
+        buffered_ -= result.rc_;
+        progress = true;
+        parent_.callbacks_.onSplicedData(from_downstream_, result.rc_);
+      } else if (result.errno_ != EAGAIN) {
+        ENVOY_CONN_LOG(debug, "splice: write error: {}", sink_, strerror(result.errno_));
+        sink_.close(Network::ConnectionCloseType::NoFlush);
+        return false;
+      }
+    }
+  }
+
+  const bool pipe_full = !end_of_stream_ && buffered_ >= capacity_;
+  if (pipe_full != read_paused_) {
+    read_paused_ = pipe_full;
+    parent_.callbacks_.onSpliceReadPaused(from_downstream_, pipe_full);
+  }
+
+  if (end_of_stream_ && buffered_ == 0 && !end_stream_sent_) {
+    // Half close the sink through the connection so that it shuts down its socket for writing.
+    end_stream_sent_ = true;
+    Buffer::OwnedImpl empty;
+    sink_.write(empty, true);
+    return sink_.state() == Network::Connection::State::Open;
+  }
+  return true;
+}
+
+SpliceForwarder::SpliceForwarder(Network::Connection& downstream, Network::Connection& upstream,
+                                 Callbacks& callbacks)
+    : callbacks_(callbacks), upstream_bound_(*this, downstream, upstream, true),
+      downstream_bound_(*this, upstream, downstream, false) {}
+
+SpliceForwarder::~SpliceForwarder() { disable(); }
+
+std::unique_ptr<SpliceForwarder> SpliceForwarder::create(Event::Dispatcher& dispatcher,
+                                                         Network::Connection& downstream,
+                                                         Network::Connection& upstream,
+                                                         Callbacks& callbacks) {
+  ASSERT(!downstream.readEnabled() && !upstream.readEnabled());
+  std::unique_ptr<SpliceForwarder> forwarder(new SpliceForwarder(downstream, upstream, callbacks));
+  if (!forwarder->upstream_bound_.initialize() || !forwarder->downstream_bound_.initialize()) {
+    return nullptr;
+  }
+
+  SpliceForwarder* raw = forwarder.get();
+  forwarder->downstream_event_ = dispatcher.createFileEvent(
+      downstream.passthroughIoHandle()->fd(),
+      [raw](uint32_t events) -> void { raw->onFileEvent(true, events); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  forwarder->upstream_event_ = dispatcher.createFileEvent(
+      upstream.passthroughIoHandle()->fd(),
+      [raw](uint32_t events) -> void { raw->onFileEvent(false, events); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+
+  // Data may have arrived on either socket while its reads were disabled.
+  forwarder->downstream_event_->activate(Event::FileReadyType::Read);
+  forwarder->upstream_event_->activate(Event::FileReadyType::Read);
+  return forwarder;
+}
+
+void SpliceForwarder::onFileEvent(bool downstream, uint32_t events) {
+  // A socket is the source of one direction and the sink of the other.
+  Direction& reading = downstream ? upstream_bound_ : downstream_bound_;
+  Direction& writing = downstream ? downstream_bound_ : upstream_bound_;
+
+  if ((events & Event::FileReadyType::Read) && !reading.transfer()) {
+    return;
+  }
+  if ((events & Event::FileReadyType::Write) && !writing.transfer()) {
+    return;
+  }
+
+  if (!completed_ && upstream_bound_.complete() && downstream_bound_.complete()) {
+    completed_ = true;
+    callbacks_.onSpliceComplete();
+  }
+}
+
+#else
+
+SpliceForwarder::Direction::~Direction() = default;
+
+SpliceForwarder::~SpliceForwarder() { disable(); }
+
+std::unique_ptr<SpliceForwarder> SpliceForwarder::create(Event::Dispatcher&, Network::Connection&,
+                                                         Network::Connection&, Callbacks&) {
+  return nullptr;
+}
+
+#endif
+
+void SpliceForwarder::disable() {
+  downstream_event_.reset();
+  upstream_event_.reset();
+}
+
+} // namespace TcpProxy
+} // namespace Envoy
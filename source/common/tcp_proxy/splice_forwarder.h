@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/connection.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+/**
+ * Moves data between the downstream and upstream connections of a TCP proxy session with
+ * splice(2), through one kernel pipe per direction, so that the payload is never copied into user
+ * space. Both connections must have reads disabled and expose a passthrough I/O handle (see
+ * Network::Connection::passthroughIoHandle()) for the lifetime of the forwarder.
+ *
+ * Each pipe is sized after the buffer limit of the connection it writes to and takes the place of
+ * that connection's buffers for flow control: once a pipe is full the forwarder stops reading from
+ * the source socket until the destination drains it, leaving the backlog to TCP flow control.
+ */
+class SpliceForwarder : public Event::DeferredDeletable, Logger::Loggable<Logger::Id::filter> {
+public:
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    /**
+     * Called when data was moved from one connection to the other.
+     * @param from_downstream supplies whether the data was read from the downstream connection.
+     * @param bytes supplies the number of bytes written to the destination connection.
+     */
+    virtual void onSplicedData(bool from_downstream, uint64_t bytes) PURE;
+
+    /**
+     * Called when the forwarder stops or resumes reading from a connection because the pipe to
+     * the other connection is full or has drained.
+     * @param downstream supplies whether the paused or resumed connection is the downstream one.
+     * @param paused supplies whether reading was paused or resumed.
+     */
+    virtual void onSpliceReadPaused(bool downstream, bool paused) PURE;
+
+    /**
+     * Called once both connections have reached end of stream and all data was forwarded.
+     */
+    virtual void onSpliceComplete() PURE;
+  };
+
+  /**
+   * Create a forwarder between two connections.
+   * @return the forwarder, or nullptr if splicing is not supported on this platform or the kernel
+   *         resources for it could not be obtained, in which case the caller should proxy the
+   *         connections normally.
+   */
+  static std::unique_ptr<SpliceForwarder> create(Event::Dispatcher& dispatcher,
+                                                 Network::Connection& downstream,
+                                                 Network::Connection& upstream,
+                                                 Callbacks& callbacks);
+
+  ~SpliceForwarder() override;
+
+  /**
+   * Stop moving data. No callbacks are invoked afterwards.
+   */
+  void disable();
+
+private:
+  class Direction {
+  public:
+    Direction(SpliceForwarder& parent, Network::Connection& source, Network::Connection& sink,
+              bool from_downstream);
+    ~Direction();
+
+    bool initialize();
+    // Moves as much data as possible from the source socket to the sink socket. Returns false if
+    // either connection was closed as a result.
+    bool transfer();
+    bool complete() const { return end_stream_sent_; }
+
+  private:
+    SpliceForwarder& parent_;
+    Network::Connection& source_;
+    Network::Connection& sink_;
+    const os_fd_t source_fd_;
+    const os_fd_t sink_fd_;
+    const bool from_downstream_;
+    int pipe_[2]{-1, -1};
+    uint64_t capacity_{};
+    uint64_t buffered_{};
+    bool read_paused_{};
+    bool end_of_stream_{};
+    bool end_stream_sent_{};
+  };
+
+  SpliceForwarder(Network::Connection& downstream, Network::Connection& upstream,
+                  Callbacks& callbacks);
+
+  void onFileEvent(bool downstream, uint32_t events);
+
+  Callbacks& callbacks_;
+  // Data read from the downstream connection and written to the upstream connection.
+  Direction upstream_bound_;
+  // Data read from the upstream connection and written to the downstream connection.
+  Direction downstream_bound_;
+  Event::FileEventPtr downstream_event_;
+  Event::FileEventPtr upstream_event_;
+  bool completed_{};
+};
+
+using SpliceForwarderPtr = std::unique_ptr<SpliceForwarder>;
+
+} // namespace TcpProxy
+} // namespace Envoy
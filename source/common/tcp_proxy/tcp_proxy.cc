@@ -21,6 +21,7 @@
 #include "common/common/macros.h"
 #include "common/common/utility.h"
 #include "common/config/well_known_names.h"
+#include "common/io/io_uring_worker.h"
 #include "common/network/application_protocol.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
@@ -115,6 +116,8 @@ Config::SharedConfig::SharedConfig(
 Config::Config(const envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy& config,
                Server::Configuration::FactoryContext& context)
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
+      // Sockets read through io_uring always have a read in flight, which splicing would race with.
+      use_splice_(config.use_splice() && Io::IoUringFactorySingleton::getExisting() == nullptr),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
       random_generator_(context.random()) {
@@ -221,6 +224,7 @@ Filter::~Filter() {
 
   ASSERT(upstream_handle_ == nullptr);
   ASSERT(upstream_ == nullptr);
+  ASSERT(splice_forwarder_ == nullptr);
 }
 
 TcpProxyStats Config::SharedConfig::generateStats(Stats::Scope& scope) {
@@ -541,6 +545,9 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::Connected) {
+    stopSplicing();
+  }
   if (upstream_) {
     Tcp::ConnectionPool::ConnectionDataPtr conn_data(upstream_->onDownstreamEvent(event));
     if (conn_data != nullptr &&
@@ -580,6 +587,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    stopSplicing();
     upstream_.reset();
     disableIdleTimer();
 
@@ -598,8 +606,10 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
     }
   } else if (event == Network::ConnectionEvent::Connected) {
     // Re-enable downstream reads now that the upstream connection is established
-    // so we have a place to send downstream data to.
-    read_callbacks_->connection().readDisable(false);
+    // so we have a place to send downstream data to, unless the kernel moves the data.
+    if (!startSplicing()) {
+      read_callbacks_->connection().readDisable(false);
+    }
 
     read_callbacks_->upstreamHost()->outlierDetector().putResult(
         Upstream::Outlier::Result::LocalOriginConnectSuccessFinal);
@@ -625,6 +635,80 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
   }
 }
 
+bool Filter::startSplicing() {
+  if (!config_->useSplice() || upstream_ == nullptr ||
+      read_callbacks_->connection().passthroughIoHandle() == nullptr) {
+    return false;
+  }
+  Network::Connection* upstream_connection = upstream_->passthroughConnection();
+  if (upstream_connection == nullptr) {
+    return false;
+  }
+
+  // Downstream reads are still disabled at this point. Upstream reads are disabled for as long as
+  // the forwarder lives, which lasts until one of the connections closes.
+  upstream_->readDisable(true);
+  splice_forwarder_ =
+      SpliceForwarder::create(read_callbacks_->connection().dispatcher(),
+                              read_callbacks_->connection(), *upstream_connection, *this);
+  if (splice_forwarder_ == nullptr) {
+    upstream_->readDisable(false);
+    return false;
+  }
+  ENVOY_CONN_LOG(debug, "splicing data to upstream connection", read_callbacks_->connection());
+  return true;
+}
+
+void Filter::stopSplicing() {
+  if (splice_forwarder_ != nullptr) {
+    // This may run from within a forwarder callback, so defer the deletion.
+    splice_forwarder_->disable();
+    read_callbacks_->connection().dispatcher().deferredDelete(std::move(splice_forwarder_));
+    // The upstream connection may still be drained after the downstream connection closes.
+    if (upstream_ != nullptr) {
+      upstream_->readDisable(false);
+    }
+  }
+}
+
+void Filter::onSplicedData(bool from_downstream, uint64_t bytes) {
+  // Account for the data as if it had gone through the connection buffers.
+  Upstream::ClusterStats& cluster_stats = read_callbacks_->upstreamHost()->cluster().stats();
+  if (from_downstream) {
+    config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+    getStreamInfo().addBytesReceived(bytes);
+    cluster_stats.upstream_cx_tx_bytes_total_.add(bytes);
+  } else {
+    cluster_stats.upstream_cx_rx_bytes_total_.add(bytes);
+    config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+    getStreamInfo().addBytesSent(bytes);
+  }
+  resetIdleTimer();
+}
+
+void Filter::onSpliceReadPaused(bool downstream, bool paused) {
+  if (downstream) {
+    if (paused) {
+      config_->stats().downstream_flow_control_paused_reading_total_.inc();
+    } else {
+      config_->stats().downstream_flow_control_resumed_reading_total_.inc();
+    }
+  } else {
+    Upstream::ClusterStats& cluster_stats = read_callbacks_->upstreamHost()->cluster().stats();
+    if (paused) {
+      cluster_stats.upstream_flow_control_paused_reading_total_.inc();
+    } else {
+      cluster_stats.upstream_flow_control_resumed_reading_total_.inc();
+    }
+  }
+}
+
+void Filter::onSpliceComplete() {
+  // Both sides half closed. The downstream connection never sees its end of stream since it does
+  // not read, so close it here, which also closes the upstream connection.
+  read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
+}
+
 void Filter::onIdleTimeout() {
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
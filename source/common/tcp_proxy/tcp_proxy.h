@@ -26,6 +26,7 @@
 #include "common/network/hash_policy.h"
 #include "common/network/utility.h"
 #include "common/stream_info/stream_info_impl.h"
+#include "common/tcp_proxy/splice_forwarder.h"
 #include "common/tcp_proxy/upstream.h"
 #include "common/upstream/load_balancer_impl.h"
 
@@ -137,6 +138,7 @@ public:
   const TcpProxyStats& stats() { return shared_config_->stats(); }
   const std::vector<AccessLog::InstanceSharedPtr>& accessLogs() { return access_logs_; }
   uint32_t maxConnectAttempts() const { return max_connect_attempts_; }
+  bool useSplice() const { return use_splice_; }
   const absl::optional<std::chrono::milliseconds>& idleTimeout() {
     return shared_config_->idleTimeout();
   }
@@ -203,6 +205,7 @@ private:
   uint64_t total_cluster_weight_;
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
   const uint32_t max_connect_attempts_;
+  const bool use_splice_;
   ThreadLocal::SlotPtr upstream_drain_manager_slot_;
   SharedConfigSharedPtr shared_config_;
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
@@ -234,6 +237,7 @@ class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                Tcp::ConnectionPool::Callbacks,
                public Http::ConnectionPool::Callbacks,
+               SpliceForwarder::Callbacks,
                protected Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager);
@@ -360,6 +364,13 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  bool startSplicing();
+  void stopSplicing();
+
+  // SpliceForwarder::Callbacks
+  void onSplicedData(bool from_downstream, uint64_t bytes) override;
+  void onSpliceReadPaused(bool downstream, bool paused) override;
+  void onSpliceComplete() override;
 
   const ConfigSharedPtr config_;
   Upstream::ClusterManager& cluster_manager_;
@@ -372,6 +383,9 @@ protected:
   std::shared_ptr<UpstreamCallbacks> upstream_callbacks_; // shared_ptr required for passing as a
                                                           // read filter.
   std::unique_ptr<GenericUpstream> upstream_;
+  // Set while data is moved between the connections by the kernel. The forwarder refers to both
+  // connections, so it is released as soon as either of them closes.
+  SpliceForwarderPtr splice_forwarder_;
   RouteConstSharedPtr route_;
   Network::TransportSocketOptionsSharedPtr transport_socket_options_;
   uint32_t connect_attempts_{};
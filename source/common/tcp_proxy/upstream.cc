@@ -36,6 +36,14 @@ void TcpUpstream::addBytesSentCallback(Network::Connection::BytesSentCb cb) {
   upstream_conn_data_->connection().addBytesSentCallback(cb);
 }
 
+Network::Connection* TcpUpstream::passthroughConnection() {
+  if (upstream_conn_data_ == nullptr ||
+      upstream_conn_data_->connection().passthroughIoHandle() == nullptr) {
+    return nullptr;
+  }
+  return &upstream_conn_data_->connection();
+}
+
 Tcp::ConnectionPool::ConnectionData*
 TcpUpstream::onDownstreamEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose) {
@@ -55,6 +55,9 @@ public:
   // upstream to do any cleanup.
   virtual Tcp::ConnectionPool::ConnectionData*
   onDownstreamEvent(Network::ConnectionEvent event) PURE;
+  // Returns the upstream connection if data can be moved to and from its socket directly (see
+  // Network::Connection::passthroughIoHandle()), nullptr otherwise.
+  virtual Network::Connection* passthroughConnection() PURE;
 };
 
 class TcpUpstream : public GenericUpstream {
@@ -67,6 +70,7 @@ public:
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void addBytesSentCallback(Network::Connection::BytesSentCb cb) override;
   Tcp::ConnectionPool::ConnectionData* onDownstreamEvent(Network::ConnectionEvent event) override;
+  Network::Connection* passthroughConnection() override;
 
 private:
   Tcp::ConnectionPool::ConnectionDataPtr upstream_conn_data_;
@@ -87,6 +91,7 @@ public:
   void encodeData(Buffer::Instance& data, bool end_stream) override;
   void addBytesSentCallback(Network::Connection::BytesSentCb cb) override;
   Tcp::ConnectionPool::ConnectionData* onDownstreamEvent(Network::ConnectionEvent event) override;
+  Network::Connection* passthroughConnection() override { return nullptr; }
 
   // Http::StreamCallbacks
   void onResetStream(Http::StreamResetReason reason,
@@ -0,0 +1,58 @@
+#include "common/upstream/alias_table.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+namespace {
+constexpr uint64_t ThresholdScale = 1ULL << 32;
+} // namespace
+
+AliasTable::AliasTable(const std::vector<double>& weights) : entries_(weights.size()) {
+  ASSERT(!weights.empty());
+  double sum = 0;
+  for (const double weight : weights) {
+    ASSERT(weight >= 0);
+    sum += weight;
+  }
+  ASSERT(sum > 0);
+
+  // Scale the weights so that their mean is 1, and split the indices into those whose probability
+  // is below the one of a column and those whose probability is at or above it.
+  std::vector<double> scaled(weights.size());
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (uint32_t i = 0; i < weights.size(); ++i) {
+    scaled[i] = weights[i] * weights.size() / sum;
+    (scaled[i] < 1.0 ? small : large).push_back(i);
+  }
+
+  // Each small index fills the rest of its column with a large one, whose remaining probability
+  // may then become small.
+  while (!small.empty() && !large.empty()) {
+    const uint32_t less = small.back();
+    small.pop_back();
+    const uint32_t more = large.back();
+    large.pop_back();
+
+    entries_[less] = {std::min(static_cast<uint64_t>(scaled[less] * ThresholdScale),
+                               ThresholdScale),
+                      more};
+    scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+    (scaled[more] < 1.0 ? small : large).push_back(more);
+  }
+
+  // Whatever is left has a probability of 1 up to rounding errors, and fills its own column.
+  for (const uint32_t index : large) {
+    entries_[index] = {ThresholdScale, index};
+  }
+  for (const uint32_t index : small) {
+    entries_[index] = {ThresholdScale, index};
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
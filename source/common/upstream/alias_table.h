@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Envoy {
+namespace Upstream {
+
+// Alias table (https://en.wikipedia.org/wiki/Alias_method) built with Vose's algorithm, used for
+// weighted random selection. Building the table takes O(n) time, and each pick takes O(1) time and
+// a single random value, regardless of the number and the distribution of the weights.
+class AliasTable {
+public:
+  /**
+   * @param weights the weights of the indices to choose from. Weights must not be negative and
+   *        at least one of them must be positive.
+   */
+  explicit AliasTable(const std::vector<double>& weights);
+
+  /**
+   * Pick an index with a probability proportional to its weight.
+   * @param random a uniformly distributed random value. The low 32 bits select a column of the
+   *        table and the high 32 bits choose between the column and its alias.
+   * @return uint32_t the picked index.
+   */
+  uint32_t pick(uint64_t random) const {
+    const uint32_t index = static_cast<uint32_t>(random) % entries_.size();
+    const Entry& entry = entries_[index];
+    return (random >> 32) < entry.threshold_ ? index : entry.alias_;
+  }
+
+  /**
+   * @return size_t the number of indices of the table.
+   */
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    // The column's own index is picked if the high 32 bits of the random value are below this,
+    // which is its probability scaled to 2^32.
+    uint64_t threshold_;
+    uint32_t alias_;
+  };
+
+  std::vector<Entry> entries_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
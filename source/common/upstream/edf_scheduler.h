@@ -1,10 +1,13 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <queue>
 
 #include "common/common/assert.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -38,7 +41,13 @@ public:
         return nullptr;
       }
       const EdfEntry& edf_entry = queue_.top();
-      // Entry has been removed, let's see if there's another one.
+      // Entry has been removed with remove(), let's see if there's another one.
+      if (!removed_.empty() && discardRemoved(edf_entry)) {
+        EDF_TRACE("Entry has been removed, repick.");
+        queue_.pop();
+        continue;
+      }
+      // Entry has been destroyed, let's see if there's another one.
       if (edf_entry.entry_.expired()) {
         EDF_TRACE("Entry has expired, repick.");
         queue_.pop();
@@ -60,13 +69,35 @@ public:
    */
   void add(double weight, std::shared_ptr<C> entry) {
     ASSERT(weight > 0);
+    if (!removed_.empty()) {
+      const auto it = removed_.find(entry.get());
+      if (it != removed_.end() && sameEntry(it->second, entry)) {
+        // The entry is still queued, so cancelling its removal is enough.
+        EDF_TRACE("Cancel removal of {}.", static_cast<const void*>(entry.get()));
+        removed_.erase(it);
+        return;
+      }
+    }
     const double deadline = current_time_ + 1.0 / weight;
     EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
               static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
+    queue_.push({deadline, order_offset_++, entry, entry.get()});
     ASSERT(queue_.top().deadline_ >= current_time_);
   }
 
+  /**
+   * Remove a queued entry. Removal is lazy: the entry is discarded once it reaches the top of the
+   * queue, so this takes O(1) time. Entries which are no longer referenced elsewhere do not need
+   * to be removed, as they are discarded once expired anyway.
+   * @param entry shared pointer to an entry which has been added and not removed since.
+   */
+  void remove(const std::shared_ptr<C>& entry) {
+    EDF_TRACE("Removal of {}.", static_cast<const void*>(entry.get()));
+    // Another entry may have been allocated at the address of an entry which expired while its
+    // removal was pending, and be removed in turn. Discarding the expired entry is enough then.
+    removed_[entry.get()] = entry;
+  }
+
   /**
    * Implements empty() on the internal queue. Does not attempt to discard expired elements.
    * @return bool whether or not the internal queue is empty.
@@ -78,9 +109,11 @@ private:
     double deadline_;
     // Tie breaker for entries with the same deadline. This is used to provide FIFO behavior.
     uint64_t order_offset_;
-    // We only hold a weak pointer, since we don't support a remove operator. This allows entries to
-    // be lazily unloaded from the queue.
+    // We only hold a weak pointer, so that entries which are destroyed are lazily unloaded from the
+    // queue without having to be removed.
     std::weak_ptr<C> entry_;
+    // The address of the entry, which identifies it in removed_ even once it has expired.
+    const C* ptr_;
 
     // Flip < direction to make this a min queue.
     bool operator<(const EdfEntry& other) const {
@@ -89,6 +122,21 @@ private:
     }
   };
 
+  // Whether a and b refer to the same object, even if it has been destroyed.
+  static bool sameEntry(const std::weak_ptr<C>& a, const std::weak_ptr<C>& b) {
+    return !a.owner_before(b) && !b.owner_before(a);
+  }
+
+  // Returns whether edf_entry has been removed, and forgets about the removal if so.
+  bool discardRemoved(const EdfEntry& edf_entry) {
+    const auto it = removed_.find(edf_entry.ptr_);
+    if (it == removed_.end() || !sameEntry(it->second, edf_entry.entry_)) {
+      return false;
+    }
+    removed_.erase(it);
+    return true;
+  }
+
   // Current time in EDF scheduler.
   // TODO(htuch): Is it worth the small extra complexity to use integer time for performance
   // reasons?
@@ -98,6 +146,8 @@ private:
   uint64_t order_offset_{};
   // Min priority queue for EDF.
   std::priority_queue<EdfEntry> queue_;
+  // Entries which have been removed but are still queued, by address.
+  absl::flat_hash_map<const C*, std::weak_ptr<C>> removed_;
 };
 
 #undef EDF_DEBUG
@@ -11,6 +11,7 @@
 
 #include "common/common/assert.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -66,6 +67,20 @@ bool hostWeightsAreEqual(const HostVector& hosts) {
   return true;
 }
 
+// Whether a and b refer to the same host, even if it has been destroyed.
+template <class A, class B> bool sameHost(const A& a, const B& b) {
+  return !a.owner_before(b) && !b.owner_before(a);
+}
+
+std::vector<uint32_t> hostWeights(const HostVector& hosts) {
+  std::vector<uint32_t> weights;
+  weights.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    weights.push_back(host->weight());
+  }
+  return weights;
+}
+
 } // namespace
 
 std::pair<uint32_t, LoadBalancerBase::HostAvailability>
@@ -691,6 +706,25 @@ const HostVector& ZoneAwareLoadBalancerBase::hostSourceToHosts(HostsSource hosts
   }
 }
 
+void ZoneAwareLoadBalancerBase::forEachHostsSource(
+    const HostSet& host_set,
+    const std::function<void(const HostsSource&, const HostVector&)>& cb) {
+  const uint32_t priority = host_set.priority();
+  cb(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set.hosts());
+  cb(HostsSource(priority, HostsSource::SourceType::HealthyHosts), host_set.healthyHosts());
+  cb(HostsSource(priority, HostsSource::SourceType::DegradedHosts), host_set.degradedHosts());
+  for (uint32_t locality_index = 0;
+       locality_index < host_set.healthyHostsPerLocality().get().size(); ++locality_index) {
+    cb(HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
+       host_set.healthyHostsPerLocality().get()[locality_index]);
+  }
+  for (uint32_t locality_index = 0;
+       locality_index < host_set.degradedHostsPerLocality().get().size(); ++locality_index) {
+    cb(HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
+       host_set.degradedHostsPerLocality().get()[locality_index]);
+  }
+}
+
 EdfLoadBalancerBase::EdfLoadBalancerBase(
     const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
     Runtime::Loader& runtime, Runtime::RandomGenerator& random,
@@ -698,11 +732,10 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
     : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                 common_config),
       seed_(random_.random()) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
-  // consistent with what other LB implementations do (e.g. thread aware).
-  // The downside of a full recompute is that time complexity is O(n * log n),
-  // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+  // We recompute the schedulers for a given host set here on membership change. When
+  // envoy.reloadable_features.incremental_edf_update is enabled, existing schedulers are updated
+  // with the hosts which were added and removed in O(n) time rather than rebuilt in O(n * log n)
+  // time (see https://github.com/envoyproxy/envoy/issues/2874).
   priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
 }
@@ -714,19 +747,32 @@ void EdfLoadBalancerBase::initialize() {
 }
 
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
-    // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
+  const bool incremental =
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.incremental_edf_update");
+  const auto add_hosts_source = [this, incremental](const HostsSource& source,
+                                                    const HostVector& hosts) {
+    auto& scheduler = scheduler_[source];
     refreshHostSource(source);
 
     // Check if the original host weights are equal and skip EDF creation if they are. When all
     // original weights are equal we can rely on unweighted host pick to do optimal round robin and
     // least-loaded host selection with lower memory and CPU overhead.
     if (hostWeightsAreEqual(hosts)) {
-      // Skip edf creation.
+      // Skip edf creation, and nuke the existing scheduler if it exists.
+      scheduler = Scheduler{};
       return;
     }
 
+    // If the hosts of the existing schedule are known, apply the membership change to it, which
+    // takes O(n) time instead of O(n * log n) for the rebuild and the cycling below. Hosts which
+    // remain keep their position in the schedule.
+    if (incremental && scheduler.edf_ != nullptr && !scheduler.members_.empty()) {
+      updateScheduler(scheduler, hosts);
+      return;
+    }
+
+    // Nuke existing scheduler if it exists.
+    scheduler = Scheduler{};
     scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
 
     // Populate scheduler with host list.
@@ -740,6 +786,9 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
       // at which point it is reinserted into the EdfScheduler with its new
       // weight in chooseHost().
       scheduler.edf_->add(hostWeight(*host), host);
+      if (incremental) {
+        scheduler.members_.emplace(host.get(), host);
+      }
     }
 
     // Cycle through hosts to achieve the intended offset behavior.
@@ -754,24 +803,31 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
   };
 
   // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
-  const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
-                   host_set->healthyHosts());
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
-                   host_set->degradedHosts());
-  for (uint32_t locality_index = 0;
-       locality_index < host_set->healthyHostsPerLocality().get().size(); ++locality_index) {
-    add_hosts_source(
-        HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
-        host_set->healthyHostsPerLocality().get()[locality_index]);
-  }
-  for (uint32_t locality_index = 0;
-       locality_index < host_set->degradedHostsPerLocality().get().size(); ++locality_index) {
-    add_hosts_source(
-        HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
-        host_set->degradedHostsPerLocality().get()[locality_index]);
+  forEachHostsSource(*priority_set_.hostSetsPerPriority()[priority], add_hosts_source);
+}
+
+void EdfLoadBalancerBase::updateScheduler(Scheduler& scheduler, const HostVector& hosts) {
+  HostMembers members;
+  members.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    const auto it = scheduler.members_.find(host.get());
+    if (it == scheduler.members_.end() || !sameHost(it->second, host)) {
+      // New hosts are scheduled from the current time of the scheduler, as if they had just
+      // been picked.
+      scheduler.edf_->add(hostWeight(*host), host);
+    }
+    members.emplace(host.get(), host);
+  }
+  for (const auto& member : scheduler.members_) {
+    const auto it = members.find(member.first);
+    if (it == members.end() || !sameHost(member.second, it->second)) {
+      // Hosts which have been destroyed are discarded by the scheduler without being removed.
+      if (HostConstSharedPtr host = member.second.lock()) {
+        scheduler.edf_->remove(host);
+      }
+    }
   }
+  scheduler.members_ = std::move(members);
 }
 
 HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* context) {
@@ -827,6 +883,40 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
+RandomLoadBalancer::RandomLoadBalancer(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
+    Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+    const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+    : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                common_config) {
+  // Like the EDF schedulers, the alias tables are fully recomputed for a host set on membership
+  // change, which takes O(n) time.
+  priority_set.addPriorityUpdateCb(
+      [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
+  for (uint32_t priority = 0; priority < priority_set.hostSetsPerPriority().size(); ++priority) {
+    refresh(priority);
+  }
+}
+
+RandomLoadBalancer::WeightedHosts::WeightedHosts(const HostVector& hosts)
+    : weights_(hostWeights(hosts)), table_(std::vector<double>(weights_.begin(), weights_.end())) {}
+
+RandomLoadBalancer::WeightedHostsPtr
+RandomLoadBalancer::buildWeightedHosts(const HostVector& hosts) {
+  if (hostWeightsAreEqual(hosts) ||
+      !Runtime::runtimeFeatureEnabled("envoy.reloadable_features.weighted_random_lb")) {
+    return nullptr;
+  }
+  return std::make_unique<WeightedHosts>(hosts);
+}
+
+void RandomLoadBalancer::refresh(uint32_t priority) {
+  forEachHostsSource(*priority_set_.hostSetsPerPriority()[priority],
+                     [this](const HostsSource& source, const HostVector& hosts) {
+                       weighted_hosts_[source] = buildWeightedHosts(hosts);
+                     });
+}
+
 HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context);
   if (!hosts_source) {
@@ -838,7 +928,19 @@ HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* conte
     return nullptr;
   }
 
-  return hosts_to_use[random_.random() % hosts_to_use.size()];
+  const auto weighted_hosts_it = weighted_hosts_.find(*hosts_source);
+  if (weighted_hosts_it == weighted_hosts_.end() || weighted_hosts_it->second == nullptr) {
+    return hosts_to_use[random_.random() % hosts_to_use.size()];
+  }
+
+  WeightedHostsPtr& weighted_hosts = weighted_hosts_it->second;
+  ASSERT(weighted_hosts->table_.size() == hosts_to_use.size());
+  const uint32_t index = weighted_hosts->table_.pick(random_.random());
+  HostConstSharedPtr host = hosts_to_use[index];
+  if (host->weight() != weighted_hosts->weights_[index]) {
+    weighted_hosts = buildWeightedHosts(hosts_to_use);
+  }
+  return host;
 }
 
 SubsetSelectorImpl::SubsetSelectorImpl(
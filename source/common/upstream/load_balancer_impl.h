@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <queue>
 #include <set>
 #include <vector>
@@ -11,8 +12,11 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/protobuf/utility.h"
+#include "common/upstream/alias_table.h"
 #include "common/upstream/edf_scheduler.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -243,6 +247,13 @@ protected:
    */
   const HostVector& hostSourceToHosts(HostsSource hosts_source);
 
+  /**
+   * Invoke cb with every hosts source of host_set, along with its hosts.
+   */
+  static void
+  forEachHostsSource(const HostSet& host_set,
+                     const std::function<void(const HostsSource&, const HostVector&)>& cb);
+
 private:
   enum class LocalityRoutingState {
     // Locality based routing is off.
@@ -358,11 +369,16 @@ public:
   HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
 
 protected:
+  using HostMembers = absl::flat_hash_map<const Host*, std::weak_ptr<const Host>>;
+
   struct Scheduler {
     // EdfScheduler for weighted LB. The edf_ is only created when the original
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<const Host>> edf_;
+    // The hosts scheduled by edf_, used to apply membership changes to it. Only tracked when
+    // envoy.reloadable_features.incremental_edf_update is enabled.
+    HostMembers members_;
   };
 
   void initialize();
@@ -376,6 +392,8 @@ protected:
 
 private:
   void refresh(uint32_t priority);
+  // Adds the hosts which are new to the schedule of scheduler and removes the ones which are gone.
+  void updateScheduler(Scheduler& scheduler, const HostVector& hosts);
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
@@ -473,19 +491,39 @@ private:
 };
 
 /**
- * Random load balancer that picks a random host out of all hosts.
+ * Random load balancer that picks a random host out of all hosts. When
+ * envoy.reloadable_features.weighted_random_lb is enabled and the weights of the hosts differ,
+ * hosts are picked with a probability proportional to their weight using an alias table, which
+ * takes O(1) time per pick and is only rebuilt when the hosts change.
  */
 class RandomLoadBalancer : public ZoneAwareLoadBalancerBase {
 public:
   RandomLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                      ClusterStats& stats, Runtime::Loader& runtime,
                      Runtime::RandomGenerator& random,
-                     const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
-      : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
-                                  common_config) {}
+                     const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config);
 
   // Upstream::LoadBalancerBase
   HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+
+private:
+  struct WeightedHosts {
+    explicit WeightedHosts(const HostVector& hosts);
+
+    // The weights the table was built with, indexed like the hosts of the source. Host weights may
+    // change without a host set update, in which case the table is rebuilt once a host whose
+    // weight changed is picked.
+    std::vector<uint32_t> weights_;
+    AliasTable table_;
+  };
+  using WeightedHostsPtr = std::unique_ptr<WeightedHosts>;
+
+  void refresh(uint32_t priority);
+  // Returns nullptr if the weights of all hosts are equal or weighting is disabled.
+  static WeightedHostsPtr buildWeightedHosts(const HostVector& hosts);
+
+  // Weighted hosts for each valid HostsSource, or nullptr for uniform selection.
+  std::unordered_map<HostsSource, WeightedHostsPtr, HostsSourceHash> weighted_hosts_;
 };
 
 /**
@@ -1,5 +1,6 @@
 #include "common/upstream/thread_aware_lb_impl.h"
 
+#include <cmath>
 #include <memory>
 
 namespace Envoy {
@@ -123,6 +124,10 @@ void ThreadAwareLoadBalancerBase::refresh() {
                      min_normalized_weight, max_normalized_weight);
     per_priority_state->current_lb_ =
         createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+    if (hash_balance_factor_ > 0) {
+      per_priority_state->current_lb_ = std::make_shared<BoundedLoadHashingLoadBalancer>(
+          per_priority_state->current_lb_, normalized_host_weights, hash_balance_factor_, stats_);
+    }
   }
 
   {
@@ -172,6 +177,47 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   return host;
 }
 
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::BoundedLoadHashingLoadBalancer(
+    HashingLoadBalancerSharedPtr hashing_lb,
+    const NormalizedHostWeightVector& normalized_host_weights, uint32_t hash_balance_factor,
+    ClusterStats& stats)
+    : hashing_lb_(std::move(hashing_lb)), hash_balance_factor_(hash_balance_factor),
+      max_probes_(std::max<uint32_t>(2 * normalized_host_weights.size(), 1)), stats_(stats) {
+  ASSERT(hash_balance_factor_ >= 100);
+  for (const auto& host_weight : normalized_host_weights) {
+    normalized_host_weights_[host_weight.first.get()] = host_weight.second;
+  }
+}
+
+HostConstSharedPtr
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t hash,
+                                                                       uint32_t attempt) const {
+  // The request being load balanced counts towards the load of the cluster, so that every host
+  // may take at least one request.
+  const double total_active = stats_.upstream_rq_active_.value() + 1;
+  HostConstSharedPtr least_loaded_host;
+  double least_load = std::numeric_limits<double>::max();
+  for (uint32_t probe = 0; probe < max_probes_; ++probe) {
+    HostConstSharedPtr host = hashing_lb_->chooseHost(hash, attempt + probe);
+    if (host == nullptr) {
+      return nullptr;
+    }
+    const auto it = normalized_host_weights_.find(host.get());
+    ASSERT(it != normalized_host_weights_.end());
+    const double bound = std::ceil(total_active * it->second * hash_balance_factor_ / 100);
+    const double active = host->stats().rq_active_.value();
+    if (active < bound) {
+      return host;
+    }
+    const double load = active / bound;
+    if (least_loaded_host == nullptr || load < least_load) {
+      least_loaded_host = std::move(host);
+      least_load = load;
+    }
+  }
+  return least_loaded_host;
+}
+
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
   auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
 
@@ -4,6 +4,7 @@
 
 #include "common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
@@ -28,6 +29,31 @@ public:
   };
   using HashingLoadBalancerSharedPtr = std::shared_ptr<HashingLoadBalancer>;
 
+  /**
+   * Wraps a hashing load balancer to implement consistent hashing with bounded loads
+   * (https://arxiv.org/abs/1608.01350). A host whose active requests are at the bound given by
+   * hash_balance_factor is skipped, and the following attempts of the wrapped load balancer are
+   * tried instead, i.e. the next ring entries or other table entries. If every host tried is at
+   * its bound, the least loaded one is chosen.
+   */
+  class BoundedLoadHashingLoadBalancer : public HashingLoadBalancer {
+  public:
+    BoundedLoadHashingLoadBalancer(HashingLoadBalancerSharedPtr hashing_lb,
+                                   const NormalizedHostWeightVector& normalized_host_weights,
+                                   uint32_t hash_balance_factor, ClusterStats& stats);
+
+    // ThreadAwareLoadBalancerBase::HashingLoadBalancer
+    HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
+
+  private:
+    const HashingLoadBalancerSharedPtr hashing_lb_;
+    absl::flat_hash_map<const Host*, double> normalized_host_weights_;
+    const uint32_t hash_balance_factor_;
+    // The number of hosts tried before giving up and choosing the least loaded one.
+    const uint32_t max_probes_;
+    ClusterStats& stats_;
+  };
+
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   void initialize() override;
@@ -43,7 +69,9 @@ protected:
       Runtime::RandomGenerator& random,
       const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
-        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+        factory_(new LoadBalancerFactoryImpl(stats, random)),
+        hash_balance_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+            common_config.consistent_hashing_lb_config(), hash_balance_factor, 0)) {}
 
 private:
   struct PerPriorityState {
@@ -88,6 +116,9 @@ private:
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  // The bound of the load of a host as a percentage of its share of the load, or 0 if the load is
+  // not bounded.
+  const uint32_t hash_balance_factor_;
 };
 
 } // namespace Upstream
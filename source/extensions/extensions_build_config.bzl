@@ -114,6 +114,8 @@ EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.cgroup_memory":            "//source/extensions/resource_monitors/cgroup_memory:config",
+    "envoy.resource_monitors.downstream_connections":   "//source/extensions/resource_monitors/downstream_connections:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
@@ -153,6 +155,12 @@ EXTENSIONS = {
     "envoy.transport_sockets.raw_buffer":               "//source/extensions/transport_sockets/raw_buffer:config",
     "envoy.transport_sockets.tap":                      "//source/extensions/transport_sockets/tap:config",
 
+    #
+    # TLS private key providers
+    #
+
+    "envoy.tls.key_providers.thread_pool":              "//source/extensions/private_key_providers/thread_pool:config",
+
     #
     # Retry host predicates
     #
@@ -171,5 +179,6 @@ EXTENSIONS = {
     # CacheFilter plugins
     #
 
+    "envoy.filters.http.cache.file_system_http_cache":  "//source/extensions/filters/http/cache/file_system_http_cache:file_system_http_cache_lib",
     "envoy.filters.http.cache.simple_http_cache":       "//source/extensions/filters/http/cache/simple_http_cache:simple_http_cache_lib",
 }
@@ -0,0 +1,701 @@
+#include "extensions/filters/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/filesystem/directory.h"
+#include "common/http/header_map_impl.h"
+#include "common/protobuf/protobuf.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr char Magic[8] = {'E', 'N', 'V', 'O', 'Y', 'C', 'F', '2'};
+constexpr absl::string_view TempSuffix = ".tmp";
+#ifdef MAP_POPULATE
+constexpr int MapFlags = MAP_SHARED | MAP_POPULATE;
+#else
+constexpr int MapFlags = MAP_SHARED;
+#endif
+
+// The fixed size header of a cache file. The cache is local to the host, so the byte order is that
+// of the host.
+struct FileHeader {
+  char magic_[sizeof(Magic)];
+  uint32_t key_size_;
+  uint32_t headers_size_;
+  // Whether the response has trailers, even if there are none in them.
+  uint32_t has_trailers_;
+  uint32_t trailers_size_;
+  uint64_t body_size_;
+};
+
+// The response headers and trailers are stored as sequences of length prefixed names and values.
+void appendString(std::string& out, absl::string_view value) {
+  const uint32_t size = value.size();
+  out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.append(value.data(), value.size());
+}
+
+bool readString(absl::string_view& in, absl::string_view& value) {
+  uint32_t size;
+  if (in.size() < sizeof(size)) {
+    return false;
+  }
+  memcpy(&size, in.data(), sizeof(size));
+  in.remove_prefix(sizeof(size));
+  if (in.size() < size) {
+    return false;
+  }
+  value = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+std::string serializeHeaders(const Http::HeaderMap& headers) {
+  std::string out;
+  headers.iterate(
+      [](const Http::HeaderEntry& header, void* context) -> Http::HeaderMap::Iterate {
+        std::string* out = static_cast<std::string*>(context);
+        appendString(*out, header.key().getStringView());
+        appendString(*out, header.value().getStringView());
+        return Http::HeaderMap::Iterate::Continue;
+      },
+      &out);
+  return out;
+}
+
+bool validHeaders(absl::string_view headers) {
+  absl::string_view name;
+  absl::string_view value;
+  while (!headers.empty()) {
+    if (!readString(headers, name) || !readString(headers, value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Adds the headers, which have been validated by validHeaders(), to header_map.
+void readHeaders(absl::string_view headers, Http::HeaderMap& header_map) {
+  absl::string_view name;
+  absl::string_view value;
+  while (readString(headers, name) && readString(headers, value)) {
+    header_map.addCopy(Http::LowerCaseString(std::string(name)), value);
+  }
+}
+
+// Returns a buffer fragment for length bytes of the body of file, starting at begin. The fragment
+// keeps the file mapped, even if its entry is evicted before the fragment has been released.
+Buffer::BufferFragmentImpl* bodyFragment(const CacheFileConstSharedPtr& file, uint64_t begin,
+                                         uint64_t length) {
+  return new Buffer::BufferFragmentImpl(
+      file->body().data() + begin, length,
+      [file](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) { delete fragment; });
+}
+
+// Parses the names of cache files, which are the hashes of their keys.
+bool parseFileName(absl::string_view name, uint64_t& hash) {
+  if (name.size() != 16 || !std::all_of(name.begin(), name.end(), absl::ascii_isxdigit)) {
+    return false;
+  }
+  hash = std::stoull(std::string(name), nullptr, 16);
+  return true;
+}
+
+class FileSystemLookupContext : public LookupContext {
+public:
+  FileSystemLookupContext(FileSystemHttpCache& cache, LookupRequest&& request,
+                          Event::Dispatcher& dispatcher)
+      : cache_(cache), request_(std::move(request)), dispatcher_(dispatcher) {}
+
+  ~FileSystemLookupContext() override {
+    if (pending_lookup_ != nullptr) {
+      pending_lookup_->cancel();
+    }
+  }
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    pending_lookup_ = cache_.lookup(
+        request_, dispatcher_, [this, cb = std::move(cb)](CacheFileConstSharedPtr&& file) {
+          pending_lookup_ = nullptr;
+          file_ = std::move(file);
+          if (file_ == nullptr) {
+            cb(LookupResult{});
+            return;
+          }
+          LookupResult result =
+              request_.makeLookupResult(file_->responseHeaders(), file_->body().size());
+          result.has_trailers_ = file_->hasTrailers();
+          cb(std::move(result));
+        });
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(file_ != nullptr);
+    ASSERT(range.end() <= file_->body().length(), "Attempt to read past end of body.");
+    auto body = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      body->addBufferFragment(*bodyFragment(file_, range.begin(), range.length()));
+    }
+    cb(std::move(body));
+  }
+
+  void getTrailers(LookupTrailersCallback&& cb) override {
+    ASSERT(file_ != nullptr);
+    ASSERT(file_->hasTrailers());
+    cb(file_->responseTrailers());
+  }
+
+  const LookupRequest& request() const { return request_; }
+  // The file found by getHeaders(), or nullptr.
+  const CacheFileConstSharedPtr& file() const { return file_; }
+
+private:
+  FileSystemHttpCache& cache_;
+  const LookupRequest request_;
+  Event::Dispatcher& dispatcher_;
+  FileSystemHttpCache::PendingLookupSharedPtr pending_lookup_;
+  CacheFileConstSharedPtr file_;
+};
+
+class FileSystemInsertContext : public InsertContext {
+public:
+  FileSystemInsertContext(LookupContext& lookup_context, FileSystemHttpCache& cache)
+      : key_(dynamic_cast<FileSystemLookupContext&>(lookup_context).request().key()),
+        cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers, bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    body_.add(chunk);
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap& response_trailers) override {
+    ASSERT(!committed_);
+    response_trailers_ = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(response_trailers);
+    commit();
+  }
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.insert(key_, std::move(response_headers_), body_, std::move(response_trailers_));
+  }
+
+  Key key_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  FileSystemHttpCache& cache_;
+  Buffer::OwnedImpl body_;
+  Http::ResponseTrailerMapPtr response_trailers_;
+  bool committed_ = false;
+};
+} // namespace
+
+CacheFile::~CacheFile() { Api::OsSysCallsSingleton::get().munmap(data_, size_); }
+
+CacheFileConstSharedPtr CacheFile::map(const std::string& path) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult fd = os_sys_calls.open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd.rc_ < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (os_sys_calls.fstat(fd.rc_, &file_stat).rc_ != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(FileHeader)) {
+    os_sys_calls.close(fd.rc_);
+    return nullptr;
+  }
+  const size_t size = file_stat.st_size;
+  const Api::SysCallPtrResult data =
+      os_sys_calls.mmap(nullptr, size, PROT_READ, MapFlags, fd.rc_, 0);
+  // The mapping stays valid after the file is closed, or unlinked.
+  os_sys_calls.close(fd.rc_);
+  if (data.rc_ == MAP_FAILED) {
+    return nullptr;
+  }
+  std::shared_ptr<CacheFile> file(new CacheFile(data.rc_, size));
+  if (!file->parse()) {
+    return nullptr;
+  }
+  return file;
+}
+
+std::string CacheFile::serializePrefix(const Key& key,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap* response_trailers,
+                                       uint64_t body_size) {
+  const std::string serialized_key = key.SerializeAsString();
+  const std::string headers = serializeHeaders(response_headers);
+  const std::string trailers =
+      response_trailers != nullptr ? serializeHeaders(*response_trailers) : "";
+
+  FileHeader file_header;
+  memcpy(file_header.magic_, Magic, sizeof(Magic));
+  file_header.key_size_ = serialized_key.size();
+  file_header.headers_size_ = headers.size();
+  file_header.has_trailers_ = response_trailers != nullptr;
+  file_header.trailers_size_ = trailers.size();
+  file_header.body_size_ = body_size;
+  return absl::StrCat(
+      absl::string_view(reinterpret_cast<const char*>(&file_header), sizeof(file_header)),
+      serialized_key, headers, trailers);
+}
+
+bool CacheFile::parse() {
+  absl::string_view data(static_cast<const char*>(data_), size_);
+  FileHeader file_header;
+  memcpy(&file_header, data.data(), sizeof(file_header));
+  data.remove_prefix(sizeof(file_header));
+  if (memcmp(file_header.magic_, Magic, sizeof(Magic)) != 0 ||
+      data.size() != static_cast<uint64_t>(file_header.key_size_) + file_header.headers_size_ +
+                         file_header.trailers_size_ + file_header.body_size_) {
+    return false;
+  }
+  if (!key_.ParseFromArray(data.data(), file_header.key_size_)) {
+    return false;
+  }
+  data.remove_prefix(file_header.key_size_);
+  headers_ = data.substr(0, file_header.headers_size_);
+  data.remove_prefix(file_header.headers_size_);
+  has_trailers_ = file_header.has_trailers_ != 0;
+  trailers_ = data.substr(0, file_header.trailers_size_);
+  body_ = data.substr(file_header.trailers_size_);
+  return validHeaders(headers_) && validHeaders(trailers_);
+}
+
+Http::ResponseHeaderMapPtr CacheFile::responseHeaders() const {
+  auto response_headers = std::make_unique<Http::ResponseHeaderMapImpl>();
+  readHeaders(headers_, *response_headers);
+  return response_headers;
+}
+
+Http::ResponseTrailerMapPtr CacheFile::responseTrailers() const {
+  auto response_trailers = std::make_unique<Http::ResponseTrailerMapImpl>();
+  readHeaders(trailers_, *response_trailers);
+  return response_trailers;
+}
+
+FileSystemHttpCache::FileSystemHttpCache(
+    const envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig& config,
+    Api::Api& api, Stats::Scope& scope, Singleton::InstanceSharedPtr owner)
+    : owner_(std::move(owner)), api_(api), cache_path_(config.cache_path()),
+      max_size_bytes_(config.max_cache_size_bytes()),
+      stats_{ALL_FILE_SYSTEM_HTTP_CACHE_STATS(
+          POOL_COUNTER_PREFIX(scope, "cache.file_system_http_cache."),
+          POOL_GAUGE_PREFIX(scope, "cache.file_system_http_cache."))} {
+  if (!api_.fileSystem().directoryExists(cache_path_)) {
+    throw EnvoyException(fmt::format("cache directory '{}' does not exist", cache_path_));
+  }
+  writer_thread_ = api_.threadFactory().createThread([this]() -> void { writerThreadFunc(); });
+  loader_thread_ = api_.threadFactory().createThread([this]() -> void { loaderThreadFunc(); });
+}
+
+FileSystemHttpCache::~FileSystemHttpCache() {
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    exit_ = true;
+    queue_event_.Signal();
+    lookup_event_.Signal();
+  }
+  writer_thread_->join();
+  loader_thread_->join();
+  // The entries stay on disk, but are no longer served by this instance. The stats may be shared
+  // with the caches of other directories.
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    stats_.insert_queue_size_.sub(queue_.size());
+  }
+  absl::MutexLock lock(&index_mutex_);
+  stats_.entries_.sub(index_.size());
+  stats_.size_bytes_.sub(size_bytes_);
+}
+
+LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& request,
+                                                        Event::Dispatcher& dispatcher) {
+  return std::make_unique<FileSystemLookupContext>(*this, std::move(request), dispatcher);
+}
+
+InsertContextPtr FileSystemHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<FileSystemInsertContext>(*lookup_context, *this);
+}
+
+void FileSystemHttpCache::updateHeaders(LookupContextPtr&& lookup_context,
+                                        Http::ResponseHeaderMapPtr&& response_headers) {
+  ASSERT(lookup_context);
+  ASSERT(response_headers);
+  const auto& context = dynamic_cast<FileSystemLookupContext&>(*lookup_context);
+  const CacheFileConstSharedPtr& file = context.file();
+  if (file == nullptr) {
+    return;
+  }
+  // The entry is rewritten with the new headers. Its body is written from the old file, which
+  // stays mapped until then.
+  Buffer::OwnedImpl body;
+  if (!file->body().empty()) {
+    body.addBufferFragment(*bodyFragment(file, 0, file->body().size()));
+  }
+  insert(context.request().key(), std::move(response_headers), body,
+         file->hasTrailers() ? file->responseTrailers() : nullptr);
+}
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.file_system";
+
+CacheInfo FileSystemHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  cache_info.supports_range_requests_ = true;
+  return cache_info;
+}
+
+FileSystemHttpCache::PendingLookupSharedPtr
+FileSystemHttpCache::lookup(const LookupRequest& request, Event::Dispatcher& dispatcher,
+                            LookupCallback&& cb) {
+  const uint64_t hash = stableHashKey(request.key());
+  CacheFileConstSharedPtr file;
+  absl::optional<uint64_t> version;
+  {
+    absl::MutexLock lock(&index_mutex_);
+    auto iter = index_.find(hash);
+    if (iter != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, iter->second);
+      file = iter->second->file_;
+      version = iter->second->version_;
+    }
+  }
+
+  if (version.has_value() && file == nullptr) {
+    // Opening and reading the file could block the worker on the disk.
+    auto pending = std::make_shared<PendingLookup>(request.key(), hash, version.value(), dispatcher,
+                                                   std::move(cb));
+    absl::MutexLock lock(&queue_mutex_);
+    lookup_queue_.push_back(pending);
+    lookup_event_.Signal();
+    return pending;
+  }
+  cb(checkKey(std::move(file), request.key()));
+  return nullptr;
+}
+
+void FileSystemHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+                                 Buffer::Instance& body,
+                                 Http::ResponseTrailerMapPtr&& response_trailers) {
+  ASSERT(response_headers);
+  auto pending = std::make_unique<PendingInsert>();
+  pending->key_ = key;
+  pending->response_headers_ = std::move(response_headers);
+  pending->body_.move(body);
+  pending->response_trailers_ = std::move(response_trailers);
+  pending->size_ = pending->response_headers_->byteSize() + pending->body_.length() +
+                   (pending->response_trailers_ ? pending->response_trailers_->byteSize() : 0);
+
+  absl::MutexLock lock(&queue_mutex_);
+  if ((max_size_bytes_ != 0 && pending->size_ > max_size_bytes_) ||
+      queued_bytes_ + pending->size_ > MaxQueuedBytes) {
+    stats_.insert_dropped_.inc();
+    return;
+  }
+  queued_bytes_ += pending->size_;
+  queue_.push_back(std::move(pending));
+  stats_.insert_queue_size_.inc();
+  queue_event_.Signal();
+}
+
+void FileSystemHttpCache::waitForWritesForTest() {
+  absl::MutexLock lock(&queue_mutex_);
+  while (!index_loaded_ || writing_ || !queue_.empty()) {
+    idle_event_.Wait(&queue_mutex_);
+  }
+}
+
+std::string FileSystemHttpCache::filePath(uint64_t hash) const {
+  return absl::StrCat(cache_path_, "/", absl::Hex(hash, absl::kZeroPad16));
+}
+
+CacheFileConstSharedPtr FileSystemHttpCache::checkKey(CacheFileConstSharedPtr&& file,
+                                                      const Key& key) {
+  if (file == nullptr || !Protobuf::util::MessageDifferencer::Equals(file->key(), key)) {
+    stats_.miss_.inc();
+    return nullptr;
+  }
+  stats_.hit_.inc();
+  return std::move(file);
+}
+
+CacheFileConstSharedPtr FileSystemHttpCache::mapFile(uint64_t hash, uint64_t version) {
+  {
+    // An earlier lookup of the entry may have mapped the file already.
+    absl::MutexLock lock(&index_mutex_);
+    auto iter = index_.find(hash);
+    if (iter != index_.end() && iter->second->version_ == version &&
+        iter->second->file_ != nullptr) {
+      return iter->second->file_;
+    }
+  }
+
+  // The file is mapped without holding the lock. The mapping is kept unless the entry has been
+  // replaced in the meantime, in which case the file may have been mapped before the replacement.
+  CacheFileConstSharedPtr file = CacheFile::map(filePath(hash));
+  if (file != nullptr) {
+    absl::MutexLock lock(&index_mutex_);
+    auto iter = index_.find(hash);
+    if (iter != index_.end() && iter->second->version_ == version &&
+        iter->second->file_ == nullptr) {
+      iter->second->file_ = file;
+    }
+  }
+  return file;
+}
+
+void FileSystemHttpCache::loaderThreadFunc() {
+  while (true) {
+    PendingLookupSharedPtr pending;
+    {
+      absl::MutexLock lock(&queue_mutex_);
+      while (lookup_queue_.empty() && !exit_) {
+        lookup_event_.Wait(&queue_mutex_);
+      }
+      if (exit_) {
+        return;
+      }
+      pending = std::move(lookup_queue_.front());
+      lookup_queue_.pop_front();
+    }
+
+    CacheFileConstSharedPtr file =
+        checkKey(mapFile(pending->hash_, pending->version_), pending->key_);
+    // The posted callback does not refer to the cache, which may be gone by the time it runs.
+    pending->dispatcher_.post([pending, file]() mutable {
+      if (pending->cb_ != nullptr) {
+        LookupCallback cb = std::move(pending->cb_);
+        pending->cb_ = nullptr;
+        cb(std::move(file));
+      }
+    });
+  }
+}
+
+void FileSystemHttpCache::writerThreadFunc() {
+  loadIndex();
+  {
+    absl::MutexLock lock(&queue_mutex_);
+    index_loaded_ = true;
+    idle_event_.SignalAll();
+  }
+
+  while (true) {
+    PendingInsertPtr pending;
+    {
+      absl::MutexLock lock(&queue_mutex_);
+      while (queue_.empty() && !exit_) {
+        queue_event_.Wait(&queue_mutex_);
+      }
+      if (exit_) {
+        return;
+      }
+      pending = std::move(queue_.front());
+      queue_.pop_front();
+      writing_ = true;
+    }
+
+    write(*pending);
+
+    absl::MutexLock lock(&queue_mutex_);
+    queued_bytes_ -= pending->size_;
+    writing_ = false;
+    stats_.insert_queue_size_.dec();
+    idle_event_.SignalAll();
+  }
+}
+
+void FileSystemHttpCache::loadIndex() {
+  try {
+    for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(cache_path_)) {
+      if (entry.type_ != Filesystem::FileType::Regular) {
+        continue;
+      }
+      const std::string path = absl::StrCat(cache_path_, "/", entry.name_);
+      if (absl::EndsWith(entry.name_, TempSuffix)) {
+        // Left behind by an interrupted write.
+        Api::OsSysCallsSingleton::get().unlink(path.c_str());
+        continue;
+      }
+      uint64_t hash;
+      const ssize_t size = api_.fileSystem().fileSize(path);
+      if (parseFileName(entry.name_, hash) && size >= 0) {
+        addToIndex(hash, size);
+      }
+    }
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "unable to index cache directory {}: {}", cache_path_, e.what());
+  }
+}
+
+void FileSystemHttpCache::write(PendingInsert& pending) {
+  const uint64_t hash = stableHashKey(pending.key_);
+  const std::string path = filePath(hash);
+  const std::string temp_path = absl::StrCat(path, TempSuffix);
+  const std::string prefix =
+      CacheFile::serializePrefix(pending.key_, *pending.response_headers_,
+                                 pending.response_trailers_.get(), pending.body_.length());
+
+  std::vector<absl::string_view> slices{prefix};
+  for (const Buffer::RawSlice& slice : pending.body_.getRawSlices()) {
+    slices.emplace_back(static_cast<const char*>(slice.mem_), slice.len_);
+  }
+  const uint64_t size = prefix.size() + pending.body_.length();
+  if (max_size_bytes_ != 0 && size > max_size_bytes_) {
+    stats_.insert_dropped_.inc();
+    return;
+  }
+
+  // The entry is written to a temporary file first, so that lookups never see a partial entry.
+  Filesystem::FilePtr file = api_.fileSystem().createFile(temp_path);
+  bool written =
+      file->open(1 << Filesystem::File::Operation::Write | 1 << Filesystem::File::Operation::Create)
+          .rc_;
+  if (written) {
+    written = file->writev(slices.data(), slices.size()).rc_ == static_cast<ssize_t>(size);
+    written = file->close().rc_ && written;
+  }
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  if (!written || os_sys_calls.rename(temp_path.c_str(), path.c_str()).rc_ != 0) {
+    ENVOY_LOG(debug, "unable to write cache file {}", path);
+    stats_.insert_failed_.inc();
+    os_sys_calls.unlink(temp_path.c_str());
+    return;
+  }
+  stats_.insert_.inc();
+  addToIndex(hash, size);
+}
+
+void FileSystemHttpCache::addToIndex(uint64_t hash, uint64_t size) {
+  // Files are unmapped and unlinked after the lock has been released.
+  std::vector<CacheFileConstSharedPtr> removed;
+  std::vector<uint64_t> evicted;
+  {
+    absl::MutexLock lock(&index_mutex_);
+    auto iter = index_.find(hash);
+    if (iter != index_.end()) {
+      removed.push_back(remove(iter->second));
+    }
+    lru_.push_front(IndexEntry{hash, size, next_version_++, nullptr});
+    index_.emplace(hash, lru_.begin());
+    size_bytes_ += size;
+    stats_.entries_.inc();
+    stats_.size_bytes_.add(size);
+
+    while (max_size_bytes_ != 0 && size_bytes_ > max_size_bytes_) {
+      stats_.eviction_.inc();
+      evicted.push_back(lru_.back().hash_);
+      removed.push_back(remove(std::prev(lru_.end())));
+    }
+  }
+  for (const uint64_t evicted_hash : evicted) {
+    Api::OsSysCallsSingleton::get().unlink(filePath(evicted_hash).c_str());
+  }
+}
+
+CacheFileConstSharedPtr FileSystemHttpCache::remove(LruList::iterator it) {
+  CacheFileConstSharedPtr file = std::move(it->file_);
+  size_bytes_ -= it->size_;
+  stats_.entries_.dec();
+  stats_.size_bytes_.sub(it->size_);
+  index_.erase(it->hash_);
+  lru_.erase(it);
+  return file;
+}
+
+FileSystemHttpCacheSharedPtr FileSystemHttpCacheRegistry::getCache(
+    const envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig& config) {
+  for (auto it = caches_.begin(); it != caches_.end();) {
+    if (it->second.cache_.expired()) {
+      caches_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+
+  auto it = caches_.find(config.cache_path());
+  if (it != caches_.end()) {
+    if (!Protobuf::util::MessageDifferencer::Equals(it->second.config_, config)) {
+      throw EnvoyException(
+          fmt::format("cache directory '{}' is used by a cache with a different configuration",
+                      config.cache_path()));
+    }
+    return it->second.cache_.lock();
+  }
+
+  auto cache = std::make_shared<FileSystemHttpCache>(config, api_, scope_, shared_from_this());
+  caches_.emplace(config.cache_path(), CacheEntry{config, cache});
+  return cache;
+}
+
+SINGLETON_MANAGER_REGISTRATION(file_system_http_cache_singleton);
+
+class FileSystemHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    const auto file_system_config = MessageUtil::anyConvert<
+        envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig>(
+        config.typed_config());
+    return context.singletonManager()
+        .getTyped<FileSystemHttpCacheRegistry>(
+            SINGLETON_MANAGER_REGISTERED_NAME(file_system_http_cache_singleton),
+            [&context] {
+              return std::make_shared<FileSystemHttpCacheRegistry>(
+                  context.api(), context.getServerFactoryContext().scope());
+            })
+        ->getCache(file_system_config);
+  }
+};
+
+static Registry::RegisterFactory<FileSystemHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "source/extensions/filters/http/cache/file_system_http_cache/config.pb.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All FileSystemHttpCache stats. @see stats_macros.h
+ */
+#define ALL_FILE_SYSTEM_HTTP_CACHE_STATS(COUNTER, GAUGE)                                           \
+  COUNTER(eviction)                                                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_dropped)                                                                          \
+  COUNTER(insert_failed)                                                                           \
+  COUNTER(miss)                                                                                    \
+  GAUGE(entries, NeverImport)                                                                      \
+  GAUGE(insert_queue_size, NeverImport)                                                            \
+  GAUGE(size_bytes, NeverImport)
+
+/**
+ * Struct definition for all FileSystemHttpCache stats. @see stats_macros.h
+ */
+struct FileSystemHttpCacheStats {
+  ALL_FILE_SYSTEM_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// A file holding a cache entry, mapped into memory. The file starts with a fixed size header,
+// which is followed by the key, the response headers, the response trailers and the body.
+class CacheFile {
+public:
+  ~CacheFile();
+
+  // Maps the file at path, and reads it into memory as far as the platform supports it, so that
+  // serving it does not fault on the disk. Returns nullptr if it cannot be mapped or is not a valid
+  // cache file.
+  static std::shared_ptr<const CacheFile> map(const std::string& path);
+
+  // Returns everything of a cache file for key, response_headers and response_trailers which
+  // precedes a body of body_size bytes. response_trailers is nullptr for a response without
+  // trailers.
+  static std::string serializePrefix(const Key& key,
+                                     const Http::ResponseHeaderMap& response_headers,
+                                     const Http::ResponseTrailerMap* response_trailers,
+                                     uint64_t body_size);
+
+  const Key& key() const { return key_; }
+  Http::ResponseHeaderMapPtr responseHeaders() const;
+  bool hasTrailers() const { return has_trailers_; }
+  Http::ResponseTrailerMapPtr responseTrailers() const;
+  absl::string_view body() const { return body_; }
+
+private:
+  CacheFile(void* data, size_t size) : data_(data), size_(size) {}
+
+  bool parse();
+
+  void* const data_;
+  const size_t size_;
+  Key key_;
+  absl::string_view headers_;
+  bool has_trailers_{};
+  absl::string_view trailers_;
+  absl::string_view body_;
+};
+using CacheFileConstSharedPtr = std::shared_ptr<const CacheFile>;
+
+// Cache backend which stores every entry in a file of its own, and indexes them in memory. Bodies
+// are served from the mapped files without being copied. Entries are written by a background
+// thread, and the least recently used ones are evicted once the files exceed the size limit.
+// Workers do not touch the disk: files are mapped by a loader thread on their first lookup, and
+// the lookup completes on the dispatcher of the worker once the file has been read in.
+class FileSystemHttpCache : public HttpCache, Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  using LookupCallback = std::function<void(CacheFileConstSharedPtr&& file)>;
+
+  // A lookup which waits for the loader thread to map the file of its entry.
+  class PendingLookup {
+  public:
+    PendingLookup(const Key& key, uint64_t hash, uint64_t version, Event::Dispatcher& dispatcher,
+                  LookupCallback&& cb)
+        : key_(key), hash_(hash), version_(version), dispatcher_(dispatcher), cb_(std::move(cb)) {}
+
+    // Prevents the callback from being called. Must be called on the thread of the dispatcher.
+    void cancel() { cb_ = nullptr; }
+
+  private:
+    friend class FileSystemHttpCache;
+
+    const Key key_;
+    const uint64_t hash_;
+    const uint64_t version_;
+    Event::Dispatcher& dispatcher_;
+    // Only accessed on the thread of the dispatcher.
+    LookupCallback cb_;
+  };
+  using PendingLookupSharedPtr = std::shared_ptr<PendingLookup>;
+
+  // owner is kept alive as long as the cache.
+  FileSystemHttpCache(
+      const envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig& config,
+      Api::Api& api, Stats::Scope& scope, Singleton::InstanceSharedPtr owner = nullptr);
+  ~FileSystemHttpCache() override;
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Event::Dispatcher& dispatcher) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(LookupContextPtr&& lookup_context,
+                     Http::ResponseHeaderMapPtr&& response_headers) override;
+  CacheInfo cacheInfo() const override;
+
+  // Looks up the file of the entry for the key of request, which is nullptr if there is none. The
+  // entry becomes the most recently used one. cb is called before returning unless the file has
+  // to be mapped first, in which case the returned lookup is pending and cb is called from
+  // dispatcher once the loader thread has mapped the file, unless the lookup is cancelled before.
+  PendingLookupSharedPtr lookup(const LookupRequest& request, Event::Dispatcher& dispatcher,
+                                LookupCallback&& cb);
+
+  // Queues an entry to be written. The body is moved out of body. response_trailers is nullptr for
+  // a response without trailers. Entries are dropped if too many bytes are waiting to be written
+  // already.
+  void insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
+              Buffer::Instance& body, Http::ResponseTrailerMapPtr&& response_trailers);
+
+  // Blocks until the entries found at startup have been indexed and the queued entries have been
+  // written.
+  void waitForWritesForTest();
+
+  const FileSystemHttpCacheStats& stats() const { return stats_; }
+
+  // The number of bytes which may wait to be written before further inserts are dropped.
+  static constexpr uint64_t MaxQueuedBytes = 64 * 1024 * 1024;
+
+private:
+  struct PendingInsert {
+    Key key_;
+    Http::ResponseHeaderMapPtr response_headers_;
+    Buffer::OwnedImpl body_;
+    Http::ResponseTrailerMapPtr response_trailers_;
+    uint64_t size_;
+  };
+  using PendingInsertPtr = std::unique_ptr<PendingInsert>;
+
+  struct IndexEntry {
+    uint64_t hash_;
+    uint64_t size_;
+    // Tells apart the entries which successively occupy the same file.
+    uint64_t version_;
+    // Mapped by the first lookup.
+    CacheFileConstSharedPtr file_;
+  };
+  using LruList = std::list<IndexEntry>;
+
+  std::string filePath(uint64_t hash) const;
+  // Returns file if it holds the entry for key, or nullptr if it is missing, damaged or belongs to
+  // another key with the same hash.
+  CacheFileConstSharedPtr checkKey(CacheFileConstSharedPtr&& file, const Key& key);
+  // Maps the file of the entry for hash, and keeps the mapping in the index unless the entry has
+  // been replaced since the lookup found version.
+  CacheFileConstSharedPtr mapFile(uint64_t hash, uint64_t version);
+  void loaderThreadFunc();
+  void writerThreadFunc();
+  void loadIndex();
+  void write(PendingInsert& insert);
+  // Adds the entry for the file of hash, replacing the previous one, and evicts the least recently
+  // used entries beyond the size limit.
+  void addToIndex(uint64_t hash, uint64_t size);
+  // Removes the entry at it from the index, and returns its file.
+  CacheFileConstSharedPtr remove(LruList::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(index_mutex_);
+
+  const Singleton::InstanceSharedPtr owner_;
+  Api::Api& api_;
+  const std::string cache_path_;
+  // The size limit of the cache, or 0 if it is unlimited.
+  const uint64_t max_size_bytes_;
+  FileSystemHttpCacheStats stats_;
+
+  absl::Mutex index_mutex_;
+  // Entries are indexed by the hash of their key, which names their file. The most recently used
+  // entry comes first.
+  LruList lru_ ABSL_GUARDED_BY(index_mutex_);
+  absl::flat_hash_map<uint64_t, LruList::iterator> index_ ABSL_GUARDED_BY(index_mutex_);
+  uint64_t size_bytes_ ABSL_GUARDED_BY(index_mutex_){};
+  uint64_t next_version_ ABSL_GUARDED_BY(index_mutex_){};
+
+  absl::Mutex queue_mutex_;
+  absl::CondVar queue_event_;
+  absl::CondVar idle_event_;
+  std::list<PendingInsertPtr> queue_ ABSL_GUARDED_BY(queue_mutex_);
+  uint64_t queued_bytes_ ABSL_GUARDED_BY(queue_mutex_){};
+  bool index_loaded_ ABSL_GUARDED_BY(queue_mutex_){};
+  bool writing_ ABSL_GUARDED_BY(queue_mutex_){};
+  bool exit_ ABSL_GUARDED_BY(queue_mutex_){};
+  Thread::ThreadPtr writer_thread_;
+  absl::CondVar lookup_event_;
+  std::list<PendingLookupSharedPtr> lookup_queue_ ABSL_GUARDED_BY(queue_mutex_);
+  Thread::ThreadPtr loader_thread_;
+};
+
+using FileSystemHttpCacheSharedPtr = std::shared_ptr<FileSystemHttpCache>;
+
+// The FileSystemHttpCaches of a server, one for each cache directory, which are shared by the
+// cache filters using that directory. The caches share their stats, which are created in the
+// server's scope, as the caches may outlive the listener which created them.
+class FileSystemHttpCacheRegistry
+    : public Singleton::Instance,
+      public std::enable_shared_from_this<FileSystemHttpCacheRegistry> {
+public:
+  FileSystemHttpCacheRegistry(Api::Api& api, Stats::Scope& scope) : api_(api), scope_(scope) {}
+
+  // Returns the cache with config, which is created unless a cache filter uses its directory
+  // already. Throws EnvoyException if the directory is used with a different configuration.
+  FileSystemHttpCacheSharedPtr getCache(
+      const envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig& config);
+
+private:
+  struct CacheEntry {
+    envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig config_;
+    std::weak_ptr<FileSystemHttpCache> cache_;
+  };
+
+  Api::Api& api_;
+  Stats::Scope& scope_;
+  // The caches by their directory. A cache is destroyed once no filter uses it.
+  absl::flat_hash_map<std::string, CacheEntry> caches_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
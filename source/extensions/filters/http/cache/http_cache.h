@@ -7,8 +7,10 @@
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/time.h"
 #include "envoy/config/typed_config.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/extensions/filters/http/cache/v3alpha/cache.pb.h"
 #include "envoy/http/header_map.h"
+#include "envoy/server/filter_config.h"
 
 #include "common/common/assert.h"
 
@@ -277,7 +279,10 @@ class HttpCache {
 public:
   // Returns a LookupContextPtr to manage the state of a cache lookup. On a cache
   // miss, the returned LookupContext will be given to the insert call (if any).
-  virtual LookupContextPtr makeLookupContext(LookupRequest&& request) PURE;
+  // dispatcher runs on the thread of the calling filter; caches which complete
+  // lookups asynchronously call the LookupContext callbacks from it.
+  virtual LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                             Event::Dispatcher& dispatcher) PURE;
 
   // Returns an InsertContextPtr to manage the state of a cache insertion.
   // Responses with a chunked transfer-encoding must be dechunked before
@@ -300,6 +305,7 @@ public:
 
   virtual ~HttpCache() = default;
 };
+using HttpCacheSharedPtr = std::shared_ptr<HttpCache>;
 
 // Factory interface for cache implementations to implement and register.
 class HttpCacheFactory : public Config::TypedFactory {
@@ -307,10 +313,12 @@ public:
   // From UntypedFactory
   std::string category() const override { return "http_cache_factory"; }
 
-  // Returns an HttpCache that will remain valid indefinitely (at least as long
-  // as the calling CacheFilter).
-  virtual HttpCache&
-  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config) PURE;
+  // Returns an HttpCache for config. Implementations may share one cache among
+  // all callers, e.g. via context.singletonManager(). The caller keeps the
+  // cache alive for as long as it holds the returned pointer.
+  virtual HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) PURE;
   ~HttpCacheFactory() override = default;
 
 private:
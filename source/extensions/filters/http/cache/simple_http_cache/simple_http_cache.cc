@@ -1,12 +1,14 @@
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/http/header_map_impl.h"
 
-#include "source/extensions/filters/http/cache/simple_http_cache/config.pb.h"
-
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -19,16 +21,27 @@ public:
       : cache_(cache), request_(std::move(request)) {}
 
   void getHeaders(LookupHeadersCallback&& cb) override {
-    auto entry = cache_.lookup(request_);
-    body_ = std::move(entry.body_);
-    cb(entry.response_headers_
-           ? request_.makeLookupResult(std::move(entry.response_headers_), body_.size())
-           : LookupResult{});
+    entry_ = cache_.lookup(request_);
+    cb(entry_ ? request_.makeLookupResult(Http::createHeaderMap<Http::ResponseHeaderMapImpl>(
+                                              *entry_->response_headers_),
+                                          entry_->body_.size())
+              : LookupResult{});
   }
 
   void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
-    ASSERT(range.end() <= body_.length(), "Attempt to read past end of body.");
-    cb(std::make_unique<Buffer::OwnedImpl>(&body_[range.begin()], range.length()));
+    ASSERT(entry_ != nullptr);
+    ASSERT(range.end() <= entry_->body_.length(), "Attempt to read past end of body.");
+    auto body = std::make_unique<Buffer::OwnedImpl>();
+    if (range.length() > 0) {
+      // The fragment keeps the entry alive, even if it is evicted before the body has been sent.
+      auto* fragment = new Buffer::BufferFragmentImpl(
+          &entry_->body_[range.begin()], range.length(),
+          [entry = entry_](const void*, size_t, const Buffer::BufferFragmentImpl* fragment) {
+            delete fragment;
+          });
+      body->addBufferFragment(*fragment);
+    }
+    cb(std::move(body));
   }
 
   void getTrailers(LookupTrailersCallback&&) override {
@@ -41,7 +54,7 @@ public:
 private:
   SimpleHttpCache& cache_;
   const LookupRequest request_;
-  std::string body_;
+  SimpleHttpCache::EntryConstSharedPtr entry_;
 };
 
 class SimpleInsertContext : public InsertContext {
@@ -86,9 +99,35 @@ private:
   Buffer::OwnedImpl body_;
   bool committed_ = false;
 };
+
+uint32_t shardCount(
+    const envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig& config) {
+  return config.shards() > 0 ? config.shards() : SimpleHttpCache::DefaultShards;
+}
 } // namespace
 
-LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request) {
+SimpleHttpCache::SimpleHttpCache(
+    const envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig& config,
+    Stats::Scope& scope, Singleton::InstanceSharedPtr owner)
+    : owner_(std::move(owner)),
+      stats_{ALL_SIMPLE_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "cache.simple_http_cache."),
+                                         POOL_GAUGE_PREFIX(scope, "cache.simple_http_cache."))},
+      max_shard_bytes_(config.max_total_bytes() == 0
+                           ? 0
+                           : std::max<uint64_t>(1, config.max_total_bytes() / shardCount(config))),
+      shards_(shardCount(config)) {}
+
+SimpleHttpCache::~SimpleHttpCache() {
+  // The stats may be shared with the caches of other configurations.
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    stats_.entries_.sub(shard.map_.size());
+    stats_.size_bytes_.sub(shard.size_bytes_);
+  }
+}
+
+// Entries are in memory, so lookups complete before returning.
+LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request, Event::Dispatcher&) {
   return std::make_unique<SimpleLookupContext>(*this, std::move(request));
 }
 
@@ -100,22 +139,61 @@ void SimpleHttpCache::updateHeaders(LookupContextPtr&& lookup_context,
   NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
 }
 
-SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
-    return Entry{};
+SimpleHttpCache::EntryConstSharedPtr SimpleHttpCache::lookup(const LookupRequest& request) {
+  Shard& shard = shardFor(request.key());
+  absl::MutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(request.key());
+  if (iter == shard.map_.end()) {
+    stats_.miss_.inc();
+    return nullptr;
   }
-  ASSERT(iter->second.response_headers_);
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.body_};
+  stats_.hit_.inc();
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, iter->second);
+  return iter->second->entry_;
 }
 
 void SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
                              std::string&& body) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] = SimpleHttpCache::Entry{std::move(response_headers), std::move(body)};
+  ASSERT(response_headers);
+  const uint64_t size = response_headers->byteSize() + body.size();
+  if (max_shard_bytes_ != 0 && size > max_shard_bytes_) {
+    stats_.insert_rejected_.inc();
+    return;
+  }
+  auto entry = std::make_shared<const Entry>(Entry{std::move(response_headers), std::move(body)});
+  // The replaced and evicted entries are destroyed after the lock has been released.
+  std::vector<EntryConstSharedPtr> removed;
+
+  Shard& shard = shardFor(key);
+  absl::MutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter != shard.map_.end()) {
+    removed.push_back(remove(shard, iter->second));
+  }
+  while (max_shard_bytes_ != 0 && shard.size_bytes_ + size > max_shard_bytes_) {
+    stats_.eviction_.inc();
+    removed.push_back(remove(shard, std::prev(shard.lru_.end())));
+  }
+  shard.lru_.push_front(LruEntry{key, std::move(entry), size});
+  shard.map_.emplace(key, shard.lru_.begin());
+  shard.size_bytes_ += size;
+  stats_.insert_.inc();
+  stats_.entries_.inc();
+  stats_.size_bytes_.add(size);
+}
+
+SimpleHttpCache::Shard& SimpleHttpCache::shardFor(const Key& key) {
+  return shards_[stableHashKey(key) % shards_.size()];
+}
+
+SimpleHttpCache::EntryConstSharedPtr SimpleHttpCache::remove(Shard& shard, LruList::iterator it) {
+  EntryConstSharedPtr entry = std::move(it->entry_);
+  shard.size_bytes_ -= it->size_;
+  stats_.entries_.dec();
+  stats_.size_bytes_.sub(it->size_);
+  shard.map_.erase(it->key_);
+  shard.lru_.erase(it);
+  return entry;
 }
 
 InsertContextPtr SimpleHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
@@ -131,6 +209,27 @@ CacheInfo SimpleHttpCache::cacheInfo() const {
   return cache_info;
 }
 
+SimpleHttpCacheSharedPtr SimpleHttpCacheRegistry::getCache(
+    const envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig& config) {
+  for (auto it = caches_.begin(); it != caches_.end();) {
+    if (it->second.expired()) {
+      caches_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+
+  std::weak_ptr<SimpleHttpCache>& cache = caches_[config];
+  SimpleHttpCacheSharedPtr shared_cache = cache.lock();
+  if (shared_cache == nullptr) {
+    shared_cache = std::make_shared<SimpleHttpCache>(config, scope_, shared_from_this());
+    cache = shared_cache;
+  }
+  return shared_cache;
+}
+
+SINGLETON_MANAGER_REGISTRATION(simple_http_cache_singleton);
+
 class SimpleHttpCacheFactory : public HttpCacheFactory {
 public:
   // From UntypedFactory
@@ -141,13 +240,21 @@ public:
         envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig>();
   }
   // From HttpCacheFactory
-  HttpCache&
-  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig&) override {
-    return cache_;
+  HttpCacheSharedPtr
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext& context) override {
+    const auto simple_config = MessageUtil::anyConvert<
+        envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig>(
+        config.typed_config());
+    return context.singletonManager()
+        .getTyped<SimpleHttpCacheRegistry>(
+            SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton),
+            [&context] {
+              return std::make_shared<SimpleHttpCacheRegistry>(
+                  context.getServerFactoryContext().scope());
+            })
+        ->getCache(simple_config);
   }
-
-private:
-  SimpleHttpCache cache_;
 };
 
 static Registry::RegisterFactory<SimpleHttpCacheFactory, HttpCacheFactory> register_;
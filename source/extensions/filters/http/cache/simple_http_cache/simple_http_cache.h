@@ -1,10 +1,20 @@
 #pragma once
 
+#include <list>
+#include <memory>
+
+#include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
 #include "common/protobuf/utility.h"
 
+#include "source/extensions/filters/http/cache/simple_http_cache/config.pb.h"
+
 #include "extensions/filters/http/cache/http_cache.h"
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
@@ -13,7 +23,28 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
+/**
+ * All SimpleHttpCache stats. @see stats_macros.h
+ */
+#define ALL_SIMPLE_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(eviction)                                                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_rejected)                                                                         \
+  COUNTER(miss)                                                                                    \
+  GAUGE(entries, NeverImport)                                                                      \
+  GAUGE(size_bytes, NeverImport)
+
+/**
+ * Struct definition for all SimpleHttpCache stats. @see stats_macros.h
+ */
+struct SimpleHttpCacheStats {
+  ALL_SIMPLE_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// In-memory cache backend. The entries are spread over shards by the hash of their key, and each
+// shard evicts its least recently used entries once it holds more than its share of the byte
+// budget. Bodies are served from the cached entry without being copied.
 class SimpleHttpCache : public HttpCache {
 private:
   struct Entry {
@@ -22,18 +53,80 @@ private:
   };
 
 public:
+  using EntryConstSharedPtr = std::shared_ptr<const Entry>;
+
+  // owner is kept alive as long as the cache.
+  SimpleHttpCache(
+      const envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig& config,
+      Stats::Scope& scope, Singleton::InstanceSharedPtr owner = nullptr);
+  ~SimpleHttpCache() override;
+
   // HttpCache
-  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Event::Dispatcher& dispatcher) override;
   InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
   void updateHeaders(LookupContextPtr&& lookup_context,
                      Http::ResponseHeaderMapPtr&& response_headers) override;
   CacheInfo cacheInfo() const override;
 
-  Entry lookup(const LookupRequest& request);
+  // Returns the entry for the key of request, or nullptr if there is none. The entry becomes the
+  // most recently used one of its shard.
+  EntryConstSharedPtr lookup(const LookupRequest& request);
   void insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers, std::string&& body);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ GUARDED_BY(mutex_);
+  const SimpleHttpCacheStats& stats() const { return stats_; }
+
+  static constexpr uint32_t DefaultShards = 16;
+
+private:
+  struct LruEntry {
+    Key key_;
+    EntryConstSharedPtr entry_;
+    uint64_t size_;
+  };
+  using LruList = std::list<LruEntry>;
+
+  struct Shard {
+    absl::Mutex mutex_;
+    // The most recently used entry comes first.
+    LruList lru_ ABSL_GUARDED_BY(mutex_);
+    absl::flat_hash_map<Key, LruList::iterator, MessageUtil, MessageUtil>
+        map_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){};
+  };
+
+  Shard& shardFor(const Key& key);
+  // Removes the entry at it from shard, and returns it.
+  EntryConstSharedPtr remove(Shard& shard, LruList::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  const Singleton::InstanceSharedPtr owner_;
+  SimpleHttpCacheStats stats_;
+  // The byte budget of every shard, or 0 if it is unlimited.
+  const uint64_t max_shard_bytes_;
+  absl::FixedArray<Shard> shards_;
+};
+
+using SimpleHttpCacheSharedPtr = std::shared_ptr<SimpleHttpCache>;
+
+// The SimpleHttpCaches of a server, one for each configuration, which are shared by the cache
+// filters with that configuration. The caches share their stats, which are created in the server's
+// scope, as the caches may outlive the listener which created them.
+class SimpleHttpCacheRegistry : public Singleton::Instance,
+                                public std::enable_shared_from_this<SimpleHttpCacheRegistry> {
+public:
+  explicit SimpleHttpCacheRegistry(Stats::Scope& scope) : scope_(scope) {}
+
+  // Returns the cache with config, which is created unless a cache filter uses it already.
+  SimpleHttpCacheSharedPtr
+  getCache(const envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig& config);
+
+private:
+  Stats::Scope& scope_;
+  // The caches by their configuration. A cache is destroyed once no filter uses it.
+  absl::flat_hash_map<envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig,
+                      std::weak_ptr<SimpleHttpCache>, MessageUtil, MessageUtil>
+      caches_;
 };
 
 } // namespace Cache
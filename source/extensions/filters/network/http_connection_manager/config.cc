@@ -186,6 +186,8 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
           context.runtime().snapshot().getInteger(Http::MaxRequestHeadersCountOverrideKey,
                                                   Http::DEFAULT_MAX_HEADERS_COUNT))),
       idle_timeout_(PROTOBUF_GET_OPTIONAL_MS(config.common_http_protocol_options(), idle_timeout)),
+      overload_min_idle_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, overload_min_idle_timeout, OverloadMinIdleTimeoutMs)),
       max_connection_duration_(
           PROTOBUF_GET_OPTIONAL_MS(config.common_http_protocol_options(), max_connection_duration)),
       max_stream_duration_(
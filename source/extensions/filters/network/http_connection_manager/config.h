@@ -113,6 +113,9 @@ public:
   uint32_t maxRequestHeadersKb() const override { return max_request_headers_kb_; }
   uint32_t maxRequestHeadersCount() const override { return max_request_headers_count_; }
   absl::optional<std::chrono::milliseconds> idleTimeout() const override { return idle_timeout_; }
+  std::chrono::milliseconds overloadMinIdleTimeout() const override {
+    return overload_min_idle_timeout_;
+  }
   bool isRoutable() const override { return true; }
   absl::optional<std::chrono::milliseconds> maxConnectionDuration() const override {
     return max_connection_duration_;
@@ -208,6 +211,7 @@ private:
   const uint32_t max_request_headers_kb_;
   const uint32_t max_request_headers_count_;
   absl::optional<std::chrono::milliseconds> idle_timeout_;
+  const std::chrono::milliseconds overload_min_idle_timeout_;
   absl::optional<std::chrono::milliseconds> max_connection_duration_;
   absl::optional<std::chrono::milliseconds> max_stream_duration_;
   std::chrono::milliseconds stream_idle_timeout_;
@@ -231,6 +235,9 @@ private:
   static const uint64_t StreamIdleTimeoutMs = 5 * 60 * 1000;
   // request timeout is disabled by default
   static const uint64_t RequestTimeoutMs = 0;
+  // The reduce timeouts overload action does not shorten the idle timeout below 1 second by
+  // default.
+  static const uint64_t OverloadMinIdleTimeoutMs = 1000;
 };
 
 /**
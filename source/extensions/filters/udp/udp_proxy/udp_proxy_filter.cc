@@ -69,7 +69,12 @@ UdpProxyFilter::ClusterInfo::ClusterInfo(UdpProxyFilter& filter,
                 host_to_sessions_.erase(host_sessions_it);
               }
             }
-          })) {}
+          })) {
+  if (filter_.config_->batchWrites()) {
+    flush_timer_ = filter_.read_callbacks_->udpListener().dispatcher().createTimer(
+        [this] { flushSessions(); });
+  }
+}
 
 UdpProxyFilter::ClusterInfo::~ClusterInfo() {
   member_update_cb_handle_->remove();
@@ -125,6 +130,20 @@ void UdpProxyFilter::ClusterInfo::onData(Network::UdpRecvData& data) {
   active_session->write(*data.buffer_);
 }
 
+void UdpProxyFilter::ClusterInfo::scheduleFlush(ActiveSession& session) {
+  sessions_pending_flush_.insert(&session);
+  if (!flush_timer_->enabled()) {
+    flush_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void UdpProxyFilter::ClusterInfo::flushSessions() {
+  for (ActiveSession* session : sessions_pending_flush_) {
+    session->flush();
+  }
+  sessions_pending_flush_.clear();
+}
+
 UdpProxyFilter::ActiveSession*
 UdpProxyFilter::ClusterInfo::createSession(Network::UdpRecvData::LocalPeerAddresses&& addresses,
                                            const Upstream::HostConstSharedPtr& host) {
@@ -160,7 +179,10 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
       io_handle_(cluster.filter_.createIoHandle(host)),
       socket_event_(cluster.filter_.read_callbacks_->udpListener().dispatcher().createFileEvent(
           io_handle_->fd(), [this](uint32_t) { onReadReady(); }, Event::FileTriggerType::Edge,
-          Event::FileReadyType::Read)) {
+          Event::FileReadyType::Read)),
+      batch_writer_(cluster.filter_.config_->batchWrites()
+                        ? std::make_unique<Network::UdpBatchWriter>(*io_handle_)
+                        : nullptr) {
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -179,6 +201,12 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
 }
 
 UdpProxyFilter::ActiveSession::~ActiveSession() {
+  if (batch_writer_ != nullptr) {
+    if (batch_writer_->pendingDatagrams() > 0) {
+      flush();
+    }
+    cluster_.cancelFlush(*this);
+  }
   cluster_.filter_.config_->stats().downstream_sess_active_.dec();
   cluster_.cluster_.info()
       ->resourceManager(Upstream::ResourcePriority::Default)
@@ -199,6 +227,7 @@ void UdpProxyFilter::ActiveSession::onReadReady() {
   // TODO(mattklein123): We should not be passing *addresses_.local_ to this function as we are
   //                     not trying to populate the local address for received packets.
   uint32_t packets_dropped = 0;
+  rx_batch_size_ = 0;
   const Api::IoErrorPtr result = Network::Utility::readPacketsFromSocket(
       *io_handle_, *addresses_.local_, *this, cluster_.filter_.config_->timeSource(),
       packets_dropped);
@@ -206,9 +235,42 @@ void UdpProxyFilter::ActiveSession::onReadReady() {
   if (result->getErrorCode() != Api::IoError::IoErrorCode::Again) {
     cluster_.cluster_stats_.sess_rx_errors_.inc();
   }
+  if (rx_batch_size_ > 0) {
+    cluster_.cluster_stats_.sess_rx_batch_size_.recordValue(rx_batch_size_);
+  }
+  if (batch_writer_ != nullptr) {
+    flushDownstream();
+  }
 }
 
-void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
+void UdpProxyFilter::ActiveSession::flushDownstream() {
+  const Network::UdpFlushResult result = cluster_.filter_.read_callbacks_->udpListener().flush();
+  if (result.send_calls_ == 0) {
+    return;
+  }
+  UdpProxyDownstreamStats& stats = cluster_.filter_.config_->stats();
+  stats.downstream_sess_tx_bytes_.add(result.bytes_sent_);
+  stats.downstream_sess_tx_datagrams_.add(result.datagrams_sent_);
+  stats.downstream_sess_tx_errors_.add(result.datagrams_dropped_);
+  stats.downstream_sess_tx_syscalls_.add(result.send_calls_);
+  stats.downstream_sess_tx_batch_size_.recordValue(result.datagrams_sent_ +
+                                                   result.datagrams_dropped_);
+}
+
+void UdpProxyFilter::ActiveSession::flush() {
+  const Network::UdpFlushResult result = batch_writer_->flush();
+  if (result.send_calls_ == 0) {
+    return;
+  }
+  cluster_.cluster_stats_.sess_tx_datagrams_.add(result.datagrams_sent_);
+  cluster_.cluster_stats_.sess_tx_errors_.add(result.datagrams_dropped_);
+  cluster_.cluster_stats_.sess_tx_syscalls_.add(result.send_calls_);
+  cluster_.cluster_stats_.sess_tx_batch_size_.recordValue(result.datagrams_sent_ +
+                                                          result.datagrams_dropped_);
+  cluster_.cluster_.info()->stats().upstream_cx_tx_bytes_total_.add(result.bytes_sent_);
+}
+
+void UdpProxyFilter::ActiveSession::write(Buffer::Instance& buffer) {
   ENVOY_LOG(trace, "writing {} byte datagram upstream: downstream={} local={} upstream={}",
             buffer.length(), addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
@@ -218,6 +280,12 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
 
   idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
 
+  if (batch_writer_ != nullptr) {
+    batch_writer_->write(buffer, nullptr, *host_->address());
+    cluster_.scheduleFlush(*this);
+    return;
+  }
+
   // NOTE: On the first write, a local ephemeral port is bound, and thus this write can fail due to
   //       port exhaustion.
   // NOTE: We do not specify the local IP to use for the sendmsg call. We allow the OS to select
@@ -242,8 +310,14 @@ void UdpProxyFilter::ActiveSession::processPacket(Network::Address::InstanceCons
 
   cluster_.cluster_stats_.sess_rx_datagrams_.inc();
   cluster_.cluster_.info()->stats().upstream_cx_rx_bytes_total_.add(buffer_length);
+  rx_batch_size_++;
 
   Network::UdpSendData data{addresses_.local_->ip(), *addresses_.peer_, *buffer};
+  if (batch_writer_ != nullptr) {
+    // Sent by flushDownstream() once all of the datagrams of this read event have been read.
+    cluster_.filter_.read_callbacks_->udpListener().queueSend(data);
+    return;
+  }
   const Api::IoCallUint64Result rc = cluster_.filter_.read_callbacks_->udpListener().send(data);
   if (!rc.ok()) {
     cluster_.filter_.config_->stats().downstream_sess_tx_errors_.inc();
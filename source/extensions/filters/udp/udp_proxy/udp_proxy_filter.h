@@ -6,6 +6,7 @@
 #include "envoy/network/filter.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/network/udp_batch_writer.h"
 #include "common/network/utility.h"
 
 #include "absl/container/flat_hash_set.h"
@@ -20,7 +21,7 @@ namespace UdpProxy {
 /**
  * All UDP proxy downstream stats. @see stats_macros.h
  */
-#define ALL_UDP_PROXY_DOWNSTREAM_STATS(COUNTER, GAUGE)                                             \
+#define ALL_UDP_PROXY_DOWNSTREAM_STATS(COUNTER, GAUGE, HISTOGRAM)                                  \
   COUNTER(downstream_sess_no_route)                                                                \
   COUNTER(downstream_sess_rx_bytes)                                                                \
   COUNTER(downstream_sess_rx_datagrams)                                                            \
@@ -29,30 +30,36 @@ namespace UdpProxy {
   COUNTER(downstream_sess_tx_bytes)                                                                \
   COUNTER(downstream_sess_tx_datagrams)                                                            \
   COUNTER(downstream_sess_tx_errors)                                                               \
+  COUNTER(downstream_sess_tx_syscalls)                                                             \
   COUNTER(idle_timeout)                                                                            \
-  GAUGE(downstream_sess_active, Accumulate)
+  GAUGE(downstream_sess_active, Accumulate)                                                        \
+  HISTOGRAM(downstream_sess_tx_batch_size, Unspecified)
 
 /**
  * Struct definition for all UDP proxy downstream stats. @see stats_macros.h
  */
 struct UdpProxyDownstreamStats {
-  ALL_UDP_PROXY_DOWNSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_UDP_PROXY_DOWNSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                 GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
  * All UDP proxy upstream cluster stats. @see stats_macros.h
  */
-#define ALL_UDP_PROXY_UPSTREAM_STATS(COUNTER)                                                      \
+#define ALL_UDP_PROXY_UPSTREAM_STATS(COUNTER, HISTOGRAM)                                           \
   COUNTER(sess_rx_datagrams)                                                                       \
   COUNTER(sess_rx_errors)                                                                          \
   COUNTER(sess_tx_datagrams)                                                                       \
-  COUNTER(sess_tx_errors)
+  COUNTER(sess_tx_errors)                                                                          \
+  COUNTER(sess_tx_syscalls)                                                                        \
+  HISTOGRAM(sess_rx_batch_size, Unspecified)                                                       \
+  HISTOGRAM(sess_tx_batch_size, Unspecified)
 
 /**
  * Struct definition for all UDP proxy upstream stats. @see stats_macros.h
  */
 struct UdpProxyUpstreamStats {
-  ALL_UDP_PROXY_UPSTREAM_STATS(GENERATE_COUNTER_STRUCT)
+  ALL_UDP_PROXY_UPSTREAM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 class UdpProxyFilterConfig {
@@ -62,11 +69,13 @@ public:
                        const envoy::config::filter::udp::udp_proxy::v2alpha::UdpProxyConfig& config)
       : cluster_manager_(cluster_manager), time_source_(time_source), cluster_(config.cluster()),
         session_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, idle_timeout, 60 * 1000)),
+        batch_writes_(config.batch_writes()),
         stats_(generateStats(config.stat_prefix(), root_scope)) {}
 
   const std::string& cluster() const { return cluster_; }
   Upstream::ClusterManager& clusterManager() const { return cluster_manager_; }
   std::chrono::milliseconds sessionTimeout() const { return session_timeout_; }
+  bool batchWrites() const { return batch_writes_; }
   UdpProxyDownstreamStats& stats() const { return stats_; }
   TimeSource& timeSource() const { return time_source_; }
 
@@ -75,13 +84,15 @@ private:
                                                Stats::Scope& scope) {
     const auto final_prefix = absl::StrCat("udp.", stat_prefix);
     return {ALL_UDP_PROXY_DOWNSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                           POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                           POOL_GAUGE_PREFIX(scope, final_prefix),
+                                           POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
   }
 
   Upstream::ClusterManager& cluster_manager_;
   TimeSource& time_source_;
   const std::string cluster_;
   const std::chrono::milliseconds session_timeout_;
+  const bool batch_writes_;
   mutable UdpProxyDownstreamStats stats_;
 };
 
@@ -116,11 +127,14 @@ private:
     ~ActiveSession() override;
     const Network::UdpRecvData::LocalPeerAddresses& addresses() const { return addresses_; }
     const Upstream::Host& host() const { return *host_; }
-    void write(const Buffer::Instance& buffer);
+    void write(Buffer::Instance& buffer);
+    // Sends the datagrams queued for the upstream host when batching writes.
+    void flush();
 
   private:
     void onIdleTimer();
     void onReadReady();
+    void flushDownstream();
 
     // Network::UdpPacketProcessor
     void processPacket(Network::Address::InstanceConstSharedPtr local_address,
@@ -147,6 +161,10 @@ private:
     // write to the upstream host.
     const Network::IoHandlePtr io_handle_;
     const Event::FileEventPtr socket_event_;
+    // Queues the datagrams for the upstream host when batching writes, nullptr otherwise.
+    const std::unique_ptr<Network::UdpBatchWriter> batch_writer_;
+    // The number of datagrams received from the upstream host in the current read event.
+    uint64_t rx_batch_size_{0};
   };
 
   using ActiveSessionPtr = std::unique_ptr<ActiveSession>;
@@ -198,6 +216,10 @@ private:
     ~ClusterInfo();
     void onData(Network::UdpRecvData& data);
     void removeSession(const ActiveSession* session);
+    // Schedules the flush of a session's queued upstream datagrams at the end of the event loop
+    // iteration.
+    void scheduleFlush(ActiveSession& session);
+    void cancelFlush(ActiveSession& session) { sessions_pending_flush_.erase(&session); }
 
     UdpProxyFilter& filter_;
     Upstream::ThreadLocalCluster& cluster_;
@@ -208,10 +230,15 @@ private:
                                  const Upstream::HostConstSharedPtr& host);
     static UdpProxyUpstreamStats generateStats(Stats::Scope& scope) {
       const auto final_prefix = "udp";
-      return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
+      return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
+                                           POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
     }
+    void flushSessions();
 
     Envoy::Common::CallbackHandle* member_update_cb_handle_;
+    // Declared before the sessions, which remove themselves on destruction.
+    Event::TimerPtr flush_timer_;
+    absl::flat_hash_set<ActiveSession*> sessions_pending_flush_;
     absl::flat_hash_set<ActiveSessionPtr, HeterogeneousActiveSessionHash,
                         HeterogeneousActiveSessionEqual>
         sessions_;
@@ -0,0 +1,371 @@
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
+
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+namespace {
+
+constexpr uint32_t DefaultMaxQueueDepth = 1024;
+
+ThreadPoolPrivateKeyConnection* getConnection(SSL* ssl) {
+  return static_cast<ThreadPoolPrivateKeyConnection*>(
+      SSL_get_ex_data(ssl, ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  auto it = connection->providers_.find(SSL_get_signature_algorithm_key_type(signature_algorithm));
+  if (it == connection->providers_.end()) {
+    return ssl_private_key_failure;
+  }
+  return it->second->startOperation(*connection, PrivateKeyOperation::Type::Sign,
+                                    signature_algorithm, in, in_len, out, out_len, max_out);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out, const uint8_t* in, size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  auto it = connection->providers_.find(EVP_PKEY_RSA);
+  if (it == connection->providers_.end()) {
+    return ssl_private_key_failure;
+  }
+  return it->second->startOperation(*connection, PrivateKeyOperation::Type::Decrypt, 0, in, in_len,
+                                    out, out_len, max_out);
+}
+
+ssl_private_key_result_t copyResult(const PrivateKeyOperation& operation, uint8_t* out,
+                                    size_t* out_len, size_t max_out) {
+  if (!operation.success_ || operation.output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(operation.output_.begin(), operation.output_.end(), out);
+  *out_len = operation.output_.size();
+  return ssl_private_key_success;
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr || connection->operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!connection->operation_->completed_) {
+    // The operation is still queued or in progress.
+    return ssl_private_key_retry;
+  }
+  const PrivateKeyOperationSharedPtr operation = std::move(connection->operation_);
+  return copyResult(*operation, out, out_len, max_out);
+}
+
+bool sign(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::vector<uint8_t>& in,
+          std::vector<uint8_t>& out) {
+  if (SSL_get_signature_algorithm_key_type(signature_algorithm) != EVP_PKEY_id(pkey)) {
+    return false;
+  }
+  // The digest is null for Ed25519, which signs the whole input.
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm);
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pkey_ctx, md, nullptr, pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1 /* salt length of the digest */))) {
+    return false;
+  }
+  size_t length;
+  if (!EVP_DigestSign(ctx.get(), nullptr, &length, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(length);
+  if (!EVP_DigestSign(ctx.get(), out.data(), &length, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(length);
+  return true;
+}
+
+bool decrypt(EVP_PKEY* pkey, const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+  if (rsa == nullptr) {
+    return false;
+  }
+  size_t length;
+  out.resize(RSA_size(rsa));
+  // BoringSSL checks the padding of the premaster secret itself.
+  if (!RSA_decrypt(rsa, &length, out.data(), out.size(), in.data(), in.size(), RSA_NO_PADDING)) {
+    return false;
+  }
+  out.resize(length);
+  return true;
+}
+
+} // namespace
+
+PrivateKeyOperation::PrivateKeyOperation(ThreadPoolPrivateKeyMethodProvider& provider,
+                                         Ssl::PrivateKeyConnectionCallbacks& cb,
+                                         Event::Dispatcher& dispatcher, Type type,
+                                         uint16_t signature_algorithm, const uint8_t* in,
+                                         size_t in_len)
+    : provider_(provider), cb_(cb), dispatcher_(dispatcher), type_(type),
+      signature_algorithm_(signature_algorithm), input_(in, in + in_len),
+      queued_time_(provider.timeSource().monotonicTime()) {}
+
+void PrivateKeyOperation::run() {
+  start_time_ = provider_.timeSource().monotonicTime();
+  success_ = type_ == Type::Sign
+                 ? sign(provider_.privateKey(), signature_algorithm_, input_, output_)
+                 : decrypt(provider_.privateKey(), input_, output_);
+  end_time_ = provider_.timeSource().monotonicTime();
+}
+
+void PrivateKeyOperation::postCompletion() {
+  Thread::LockGuard lock(lock_);
+  // Once cancelled, the connection and possibly its dispatcher may be gone.
+  if (cancelled_) {
+    return;
+  }
+  // The completion holds the operation until it has run, or been dropped with the dispatcher.
+  dispatcher_.post([operation = shared_from_this()]() -> void {
+    if (operation->cancelled()) {
+      return;
+    }
+    operation->completed_ = true;
+    operation->provider_.onOperationComplete(*operation);
+    operation->cb_.onPrivateKeyMethodComplete();
+  });
+}
+
+void PrivateKeyOperation::cancel() {
+  Thread::LockGuard lock(lock_);
+  cancelled_ = true;
+}
+
+bool PrivateKeyOperation::cancelled() {
+  Thread::LockGuard lock(lock_);
+  return cancelled_;
+}
+
+CryptoThreadPool::CryptoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                                   uint32_t max_queue_depth, Stats::Gauge& queue_depth)
+    : max_queue_depth_(max_queue_depth), queue_depth_(queue_depth) {
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() -> void { threadRoutine(); }));
+  }
+}
+
+CryptoThreadPool::~CryptoThreadPool() {
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+    // The connections of the queued operations are all closed by now.
+    queue_depth_.sub(queue_.size());
+    queue_.clear();
+  }
+  cv_.notifyAll();
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+bool CryptoThreadPool::enqueue(PrivateKeyOperationSharedPtr operation) {
+  {
+    Thread::LockGuard lock(lock_);
+    if (queue_.size() >= max_queue_depth_) {
+      return false;
+    }
+    queue_.push_back(std::move(operation));
+    queue_depth_.inc();
+  }
+  cv_.notifyOne();
+  return true;
+}
+
+void CryptoThreadPool::threadRoutine() {
+  while (true) {
+    PrivateKeyOperationSharedPtr operation;
+    {
+      Thread::LockGuard lock(lock_);
+      while (!exit_ && queue_.empty()) {
+        cv_.wait(lock_);
+      }
+      if (exit_) {
+        return;
+      }
+      operation = std::move(queue_.front());
+      queue_.pop_front();
+      queue_depth_.dec();
+    }
+    // The operations of connections closed while they were queued are skipped.
+    if (!operation->cancelled()) {
+      operation->run();
+      operation->postCompletion();
+    }
+  }
+}
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : time_source_(factory_context.api().timeSource()),
+      stats_(generateStats(factory_context.scope())) {
+  const std::string private_key =
+      Config::DataSource::read(config.private_key(), false, factory_context.api());
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  pkey_.reset(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey_ == nullptr) {
+    throw EnvoyException("Failed to load the private key of the thread pool private key provider");
+  }
+  const int type = EVP_PKEY_id(pkey_.get());
+  if (type != EVP_PKEY_RSA && type != EVP_PKEY_EC && type != EVP_PKEY_ED25519) {
+    throw EnvoyException("The thread pool private key provider only supports RSA, ECDSA and "
+                         "Ed25519 private keys");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  const uint32_t num_threads = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, num_threads, std::max(std::thread::hardware_concurrency(), 1U));
+  pool_ = std::make_unique<CryptoThreadPool>(
+      factory_context.api().threadFactory(), num_threads,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_queue_depth, DefaultMaxQueueDepth),
+      stats_.queue_depth_);
+}
+
+ThreadPoolPrivateKeyStats ThreadPoolPrivateKeyMethodProvider::generateStats(Stats::Scope& scope) {
+  const std::string prefix = "thread_pool_private_key.";
+  return {ALL_THREAD_POOL_PRIVATE_KEY_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                            POOL_GAUGE_PREFIX(scope, prefix),
+                                            POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    connection = new ThreadPoolPrivateKeyConnection(cb, dispatcher);
+    SSL_set_ex_data(ssl, connectionIndex(), connection);
+  }
+  if (!connection->providers_.emplace(EVP_PKEY_id(pkey_.get()), this).second) {
+    throw EnvoyException("Can't distinguish between two thread pool private key providers of the "
+                         "same key type for the same SSL object.");
+  }
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  ThreadPoolPrivateKeyConnection* connection = getConnection(ssl);
+  if (connection == nullptr) {
+    return;
+  }
+  // The connection is closing, so any operation in progress is not needed anymore.
+  if (connection->operation_ != nullptr) {
+    connection->operation_->cancel();
+    connection->operation_.reset();
+  }
+  auto it = connection->providers_.find(EVP_PKEY_id(pkey_.get()));
+  if (it != connection->providers_.end() && it->second == this) {
+    connection->providers_.erase(it);
+  }
+  if (connection->providers_.empty()) {
+    SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+    delete connection;
+  }
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() {
+  switch (EVP_PKEY_id(pkey_.get())) {
+  case EVP_PKEY_RSA: {
+    RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa_private_key != nullptr && RSA_check_fips(rsa_private_key);
+  }
+  case EVP_PKEY_EC: {
+    const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+    return ecdsa_private_key != nullptr && EC_KEY_check_fips(ecdsa_private_key);
+  }
+  default:
+    return false;
+  }
+}
+
+Ssl::BoringSslPrivateKeyMethodSharedPtr
+ThreadPoolPrivateKeyMethodProvider::getBoringSslPrivateKeyMethod() {
+  return method_;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::startOperation(
+    ThreadPoolPrivateKeyConnection& connection, PrivateKeyOperation::Type type,
+    uint16_t signature_algorithm, const uint8_t* in, size_t in_len, uint8_t* out,
+    size_t* out_len, size_t max_out) {
+  if (type == PrivateKeyOperation::Type::Sign) {
+    stats_.sign_.inc();
+  } else {
+    stats_.decrypt_.inc();
+  }
+  auto operation = std::make_shared<PrivateKeyOperation>(
+      *this, connection.cb_, connection.dispatcher_, type, signature_algorithm, in, in_len);
+  if (pool_->enqueue(operation)) {
+    connection.operation_ = std::move(operation);
+    return ssl_private_key_retry;
+  }
+
+  // The pool is overloaded, the operation is performed on the worker thread instead.
+  stats_.queue_full_.inc();
+  operation->run();
+  onOperationComplete(*operation);
+  return copyResult(*operation, out, out_len, max_out);
+}
+
+void ThreadPoolPrivateKeyMethodProvider::onOperationComplete(const PrivateKeyOperation& operation) {
+  if (!operation.success_) {
+    stats_.failed_.inc();
+  }
+  stats_.queue_time_us_.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        operation.start_time_ - operation.queued_time_)
+                                        .count());
+  stats_.operation_time_us_.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                            operation.end_time_ - operation.start_time_)
+                                            .count());
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+    return index;
+  }());
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
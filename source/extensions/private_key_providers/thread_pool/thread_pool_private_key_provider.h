@@ -0,0 +1,197 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+/**
+ * All thread pool private key provider stats. @see stats_macros.h
+ */
+#define ALL_THREAD_POOL_PRIVATE_KEY_STATS(COUNTER, GAUGE, HISTOGRAM)                               \
+  COUNTER(decrypt)                                                                                 \
+  COUNTER(failed)                                                                                  \
+  COUNTER(queue_full)                                                                              \
+  COUNTER(sign)                                                                                    \
+  GAUGE(queue_depth, Accumulate)                                                                   \
+  HISTOGRAM(operation_time_us, Microseconds)                                                       \
+  HISTOGRAM(queue_time_us, Microseconds)
+
+/**
+ * Struct definition for all thread pool private key provider stats. @see stats_macros.h
+ */
+struct ThreadPoolPrivateKeyStats {
+  ALL_THREAD_POOL_PRIVATE_KEY_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                    GENERATE_HISTOGRAM_STRUCT)
+};
+
+class ThreadPoolPrivateKeyMethodProvider;
+
+/**
+ * A private key operation of a connection. It is created on the worker thread of the connection,
+ * performed on a thread of the pool, and completed back on the worker thread.
+ */
+class PrivateKeyOperation : public std::enable_shared_from_this<PrivateKeyOperation> {
+public:
+  enum class Type { Sign, Decrypt };
+
+  PrivateKeyOperation(ThreadPoolPrivateKeyMethodProvider& provider,
+                      Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher,
+                      Type type, uint16_t signature_algorithm, const uint8_t* in, size_t in_len);
+
+  /**
+   * Perform the operation with the key of the provider, on the calling thread.
+   */
+  void run();
+
+  /**
+   * Hand the result over to the worker thread of the connection, unless it was cancelled.
+   */
+  void postCompletion();
+
+  /**
+   * Cancel the operation, as its connection is closed. Must be called on the worker thread.
+   */
+  void cancel();
+
+  /**
+   * @return bool whether the operation was cancelled, in which case it need not be performed.
+   */
+  bool cancelled();
+
+  ThreadPoolPrivateKeyMethodProvider& provider_;
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  const Type type_;
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  std::vector<uint8_t> output_;
+  bool success_{};
+  // Only accessed on the worker thread, once the completion is posted.
+  bool completed_{};
+  MonotonicTime queued_time_;
+  MonotonicTime start_time_;
+  MonotonicTime end_time_;
+
+private:
+  Thread::MutexBasicLockable lock_;
+  bool cancelled_ GUARDED_BY(lock_){};
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+/**
+ * A pool of threads which perform private key operations, first in first out.
+ */
+class CryptoThreadPool {
+public:
+  CryptoThreadPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                   uint32_t max_queue_depth, Stats::Gauge& queue_depth);
+  ~CryptoThreadPool();
+
+  /**
+   * Queue an operation, unless the queue is full.
+   * @return bool whether the operation was queued.
+   */
+  bool enqueue(PrivateKeyOperationSharedPtr operation);
+
+private:
+  void threadRoutine();
+
+  const uint32_t max_queue_depth_;
+  Stats::Gauge& queue_depth_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar cv_;
+  std::deque<PrivateKeyOperationSharedPtr> queue_ GUARDED_BY(lock_);
+  bool exit_ GUARDED_BY(lock_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+/**
+ * The private key operations state of a connection. A connection may be registered with several
+ * providers, one for each certificate of its context, whose keys have different types. BoringSSL
+ * only signs with a key of the type of the signature algorithm, so the provider of an operation is
+ * found from the type of its key.
+ */
+class ThreadPoolPrivateKeyConnection {
+public:
+  ThreadPoolPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& cb,
+                                 Event::Dispatcher& dispatcher)
+      : cb_(cb), dispatcher_(dispatcher) {}
+
+  Ssl::PrivateKeyConnectionCallbacks& cb_;
+  Event::Dispatcher& dispatcher_;
+  // Providers by the EVP_PKEY type of their key.
+  absl::flat_hash_map<int, ThreadPoolPrivateKeyMethodProvider*> providers_;
+  // There is at most one operation in progress during a handshake.
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+          ThreadPoolPrivateKeyMethodConfig& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override;
+
+  /**
+   * Start an operation, on a thread of the pool if the queue is not full, on the calling thread
+   * otherwise.
+   * @return ssl_private_key_retry if the operation was queued, or the result of the operation.
+   */
+  ssl_private_key_result_t startOperation(ThreadPoolPrivateKeyConnection& connection,
+                                          PrivateKeyOperation::Type type,
+                                          uint16_t signature_algorithm, const uint8_t* in,
+                                          size_t in_len, uint8_t* out, size_t* out_len,
+                                          size_t max_out);
+
+  /**
+   * Record the stats of a completed operation. Must be called on a worker thread.
+   */
+  void onOperationComplete(const PrivateKeyOperation& operation);
+
+  EVP_PKEY* privateKey() const { return pkey_.get(); }
+  TimeSource& timeSource() { return time_source_; }
+
+  static int connectionIndex();
+
+private:
+  static ThreadPoolPrivateKeyStats generateStats(Stats::Scope& scope);
+
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  TimeSource& time_source_;
+  ThreadPoolPrivateKeyStats stats_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  std::unique_ptr<CryptoThreadPool> pool_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -35,6 +35,20 @@ public:
     }
     return io_handle_.writev(slices, num_slice);
   }
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.read(buffer, max_length);
+  }
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.write(buffer);
+  }
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Envoy::Network::Address::Ip* self_ip,
                                   const Network::Address::Instance& peer_address) override {
@@ -44,6 +58,14 @@ public:
     }
     return io_handle_.sendmsg(slices, num_slice, flags, self_ip, peer_address);
   }
+  Api::IoCallUint64Result sendmmsg(const SendMsgInfo* messages, uint64_t num_messages,
+                                   int flags) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.sendmmsg(messages, num_messages, flags);
+  }
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override {
     if (closed_) {
@@ -63,6 +85,17 @@ public:
     return io_handle_.recvmmsg(slices, self_port, output);
   }
   bool supportsMmsg() const override { return io_handle_.supportsMmsg(); }
+  bool supportsUdpGso() const override { return io_handle_.supportsUdpGso(); }
+  Api::SysCallIntResult shutdown(int how) override {
+    if (closed_) {
+      return Api::SysCallIntResult{-1, EBADF};
+    }
+    return io_handle_.shutdown(how);
+  }
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override {
+    return io_handle_.createFileEvent(dispatcher, cb, trigger, events);
+  }
 
 private:
   Network::IoHandle& io_handle_;
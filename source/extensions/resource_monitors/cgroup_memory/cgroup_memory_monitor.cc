@@ -0,0 +1,76 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "envoy/common/exception.h"
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+namespace {
+// cgroup v1 reports the absence of a limit as the largest page counter value in bytes, which is
+// just below 2^63 and depends on the page size. Anything this large is not a real limit.
+constexpr uint64_t UnlimitedThreshold = 1ULL << 62;
+} // namespace
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+    Filesystem::Instance& file_system, const std::string& cgroup_root)
+    : max_memory_(config.max_memory_bytes()), file_system_(file_system),
+      cgroup_root_(cgroup_root) {}
+
+uint64_t CgroupMemoryMonitor::readBytes(const std::string& path) {
+  const std::string contents(absl::StripAsciiWhitespace(file_system_.fileReadToEnd(path)));
+  // cgroup v2 reports the absence of a limit as "max".
+  if (contents == "max") {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  uint64_t bytes;
+  if (!absl::SimpleAtoi(contents, &bytes)) {
+    throw EnvoyException(absl::StrCat("failed to parse cgroup memory file ", path));
+  }
+  return bytes;
+}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  try {
+    uint64_t usage;
+    uint64_t limit;
+    const std::string v2_usage_path = absl::StrCat(cgroup_root_, "/memory.current");
+    if (file_system_.fileExists(v2_usage_path)) {
+      usage = readBytes(v2_usage_path);
+      limit = readBytes(absl::StrCat(cgroup_root_, "/memory.max"));
+    } else {
+      usage = readBytes(absl::StrCat(cgroup_root_, "/memory/memory.usage_in_bytes"));
+      limit = readBytes(absl::StrCat(cgroup_root_, "/memory/memory.limit_in_bytes"));
+    }
+    if (max_memory_ > 0) {
+      limit = std::min(limit, max_memory_);
+    }
+    if (limit >= UnlimitedThreshold) {
+      throw EnvoyException("cgroup has no memory limit");
+    }
+    if (limit == 0) {
+      throw EnvoyException("cgroup memory limit is 0");
+    }
+
+    Server::ResourceUsage usage_result;
+    usage_result.resource_pressure_ = usage / static_cast<double>(limit);
+    callbacks.onSuccess(usage_result);
+  } catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+  }
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Memory monitor for the cgroup of the process. The usage and the limit are read from the memory
+ * controller files of the cgroup v2 hierarchy if it is mounted at the cgroup root, or else of the
+ * cgroup v1 memory hierarchy mounted below it. In a container, the cgroup root is the one of the
+ * container.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+      Filesystem::Instance& file_system, const std::string& cgroup_root = "/sys/fs/cgroup");
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  uint64_t readBytes(const std::string& path);
+
+  const uint64_t max_memory_;
+  Filesystem::Instance& file_system_;
+  const std::string cgroup_root_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,36 @@
+#include "extensions/resource_monitors/downstream_connections/downstream_connections_monitor.h"
+
+#include "envoy/extensions/resource_monitors/downstream_connections/v3/downstream_connections.pb.h"
+
+#include "common/common/assert.h"
+#include "common/network/listen_socket_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace DownstreamConnectionsMonitor {
+
+uint64_t ConnectionStatsReader::activeConnections() {
+  return Network::AcceptedSocketImpl::acceptedSocketCount();
+}
+
+DownstreamConnectionsMonitor::DownstreamConnectionsMonitor(
+    const envoy::extensions::resource_monitors::downstream_connections::v3::
+        DownstreamConnectionsConfig& config,
+    std::unique_ptr<ConnectionStatsReader> stats)
+    : max_connections_(config.max_active_downstream_connections()), stats_(std::move(stats)) {
+  ASSERT(max_connections_ > 0);
+}
+
+void DownstreamConnectionsMonitor::updateResourceUsage(
+    Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = stats_->activeConnections() / static_cast<double>(max_connections_);
+
+  callbacks.onSuccess(usage);
+}
+
+} // namespace DownstreamConnectionsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/downstream_connections/v3/downstream_connections.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace DownstreamConnectionsMonitor {
+
+/**
+ * Helper class for getting the number of active downstream connections.
+ */
+class ConnectionStatsReader {
+public:
+  ConnectionStatsReader() = default;
+  virtual ~ConnectionStatsReader() = default;
+
+  // Downstream connections accepted by any listener which are not closed yet.
+  virtual uint64_t activeConnections();
+};
+
+/**
+ * Downstream connections monitor with a statically configured maximum.
+ */
+class DownstreamConnectionsMonitor : public Server::ResourceMonitor {
+public:
+  DownstreamConnectionsMonitor(
+      const envoy::extensions::resource_monitors::downstream_connections::v3::
+          DownstreamConnectionsConfig& config,
+      std::unique_ptr<ConnectionStatsReader> stats = std::make_unique<ConnectionStatsReader>());
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_connections_;
+  std::unique_ptr<ConnectionStatsReader> stats_;
+};
+
+} // namespace DownstreamConnectionsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -18,6 +18,12 @@ public:
 
   // File-based injected resource monitor.
   const std::string InjectedResource = "envoy.resource_monitors.injected_resource";
+
+  // Active downstream connections monitor with statically configured max.
+  const std::string DownstreamConnections = "envoy.resource_monitors.downstream_connections";
+
+  // Memory monitor for the cgroup of the process.
+  const std::string CgroupMemory = "envoy.resource_monitors.cgroup_memory";
 };
 
 using ResourceMonitorNames = ConstSingleton<ResourceMonitorNameValues>;
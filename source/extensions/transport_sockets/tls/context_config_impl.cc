@@ -178,7 +178,8 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      enable_kernel_tls_(config.enable_kernel_tls()) {
   if (certificate_validation_context_provider_ != nullptr) {
     if (default_cvc_) {
       // We need to validate combined certificate validation context.
@@ -385,6 +386,9 @@ const std::string ServerContextConfigImpl::DEFAULT_CURVES =
 #endif
     "P-256";
 
+// The default size of the BoringSSL internal session cache.
+const uint32_t ServerContextConfigImpl::DEFAULT_MAX_CACHED_SESSIONS = 20480;
+
 ServerContextConfigImpl::ServerContextConfigImpl(
     const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext& config,
     Server::Configuration::TransportSocketFactoryContext& factory_context)
@@ -419,6 +423,13 @@ ServerContextConfigImpl::ServerContextConfigImpl(
     session_timeout_ =
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
+
+  if (config.has_session_cache()) {
+    session_cache_ = SessionCacheConfig{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.session_cache(), max_sessions,
+                                        DEFAULT_MAX_CACHED_SESSIONS),
+        config.session_cache().preserve_across_hot_restart()};
+  }
 }
 
 ServerContextConfigImpl::~ServerContextConfigImpl() {
@@ -43,6 +43,7 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool enableKernelTls() const override { return enable_kernel_tls_; }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -94,6 +95,7 @@ private:
   Envoy::Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool enable_kernel_tls_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -150,12 +152,16 @@ public:
   bool disableStatelessSessionResumption() const override {
     return disable_stateless_session_resumption_;
   }
+  const absl::optional<SessionCacheConfig>& sessionCache() const override {
+    return session_cache_;
+  }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
   static const unsigned DEFAULT_MAX_VERSION;
   static const std::string DEFAULT_CIPHER_SUITES;
   static const std::string DEFAULT_CURVES;
+  static const uint32_t DEFAULT_MAX_CACHED_SESSIONS;
 
   const bool require_client_certificate_;
   std::vector<SessionTicketKey> session_ticket_keys_;
@@ -169,6 +175,7 @@ private:
 
   absl::optional<std::chrono::seconds> session_timeout_;
   const bool disable_stateless_session_resumption_;
+  absl::optional<SessionCacheConfig> session_cache_;
 };
 
 } // namespace Tls
@@ -21,6 +21,7 @@
 #include "common/protobuf/utility.h"
 #include "common/stats/utility.h"
 
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/str_join.h"
@@ -62,7 +63,7 @@ int ContextImpl::sslExtendedSocketInfoIndex() {
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
                          TimeSource& time_source)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
-      tls_max_version_(config.maxProtocolVersion()),
+      tls_max_version_(config.maxProtocolVersion()), enable_kernel_tls_(config.enableKernelTls()),
       stat_name_set_(scope.symbolTable().makeSet("TransportSockets::Tls")),
       unknown_ssl_cipher_(stat_name_set_->add("unknown_ssl_cipher")),
       unknown_ssl_curve_(stat_name_set_->add("unknown_ssl_curve")),
@@ -105,6 +106,11 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     if (!SSL_CTX_set1_curves_list(ctx.ssl_ctx_.get(), config.ecdhCurves().c_str())) {
       throw EnvoyException(absl::StrCat("Failed to initialize ECDH curves ", config.ecdhCurves()));
     }
+
+    if (enable_kernel_tls_) {
+      // The TLS 1.3 traffic secrets handed over to the kernel are only exposed to the key log.
+      SSL_CTX_set_keylog_callback(ctx.ssl_ctx_.get(), KernelTls::keylogCallback);
+    }
   }
 
   int verify_mode = SSL_VERIFY_NONE;
@@ -941,7 +947,8 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
+                                     TimeSource& time_source,
+                                     ServerSessionCacheRegistry& session_caches)
     : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()) {
   if (config.tlsCertificates().empty()) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
@@ -952,6 +959,13 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // is used. We do this early because it can throw an EnvoyException.
   const SessionContextID session_id = generateHashForSessionContextId(server_names);
 
+  // Contexts which may resume each other's sessions share a session cache.
+  if (config.sessionCache()) {
+    session_cache_ = session_caches.getOrCreate(
+        absl::string_view(reinterpret_cast<const char*>(session_id.data()), session_id.size()),
+        config.sessionCache().value());
+  }
+
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
   // BoringSSL.
@@ -1001,6 +1015,27 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
       SSL_CTX_set_timeout(ctx.ssl_ctx_.get(), uint32_t(timeout));
     }
 
+    if (session_cache_ != nullptr) {
+      // BoringSSL looks sessions up with the callbacks of the initial SSL_CTX of a connection, but
+      // they are set on all the contexts, for consistency.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+            ->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+            *out_copy = 0;
+            return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+                ->getSession(ssl, absl::string_view(reinterpret_cast<const char*>(id), id_len));
+          });
+      SSL_CTX_sess_set_remove_cb(ctx.ssl_ctx_.get(), [](SSL_CTX* ssl_ctx, SSL_SESSION* session) {
+        static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(ssl_ctx))->removeSession(session);
+      });
+    }
+
     int rc =
         SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
@@ -1141,6 +1176,47 @@ ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string
   return session_id;
 }
 
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  unsigned int id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  uint8_t* data;
+  size_t length;
+  if (!SSL_SESSION_to_bytes(session, &data, &length)) {
+    return 0;
+  }
+  std::string serialized(reinterpret_cast<const char*>(data), length);
+  OPENSSL_free(data);
+
+  if (session_cache_->insert(absl::string_view(reinterpret_cast<const char*>(id), id_length),
+                             std::move(serialized),
+                             std::chrono::seconds(SSL_SESSION_get_timeout(session)))) {
+    stats_.session_cache_eviction_.inc();
+  }
+  // The cache keeps a copy of the session, rather than the reference BoringSSL hands over.
+  return 0;
+}
+
+SSL_SESSION* ServerContextImpl::getSession(SSL* ssl, absl::string_view id) {
+  const absl::optional<std::string> serialized = session_cache_->lookup(id);
+  SSL_SESSION* session =
+      serialized.has_value()
+          ? SSL_SESSION_from_bytes(reinterpret_cast<const uint8_t*>(serialized->data()),
+                                   serialized->size(), SSL_get_SSL_CTX(ssl))
+          : nullptr;
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session;
+}
+
+void ServerContextImpl::removeSession(SSL_SESSION* session) {
+  unsigned int id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  session_cache_->remove(absl::string_view(reinterpret_cast<const char*>(id), id_length));
+}
+
 int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv,
                                             EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx, int encrypt) {
   const EVP_MD* hmac = EVP_sha256();
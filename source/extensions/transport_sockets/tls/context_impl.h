@@ -18,6 +18,7 @@
 #include "common/stats/symbol_table_impl.h"
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
 
 #include "absl/synchronization/mutex.h"
 #include "openssl/ssl.h"
@@ -40,7 +41,12 @@ namespace Tls {
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  COUNTER(kernel_tls)                                                                              \
+  COUNTER(kernel_tls_fallback)                                                                     \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(session_cache_eviction)
 
 /**
  * Wrapper struct for SSL stats. @see stats_macros.h
@@ -101,6 +107,11 @@ public:
 
   std::vector<Ssl::PrivateKeyMethodProviderSharedPtr> getPrivateKeyMethodProviders();
 
+  /**
+   * @return bool whether the record layer of established connections is offloaded to the kernel.
+   */
+  bool enableKernelTls() const { return enable_kernel_tls_; }
+
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
               TimeSource& time_source);
@@ -192,6 +203,7 @@ protected:
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const bool enable_kernel_tls_;
   mutable Stats::StatNameSetPtr stat_name_set_;
   const Stats::StatName unknown_ssl_cipher_;
   const Stats::StatName unknown_ssl_curve_;
@@ -227,7 +239,8 @@ private:
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    ServerSessionCacheRegistry& session_caches);
 
 private:
   using SessionContextID = std::array<uint8_t, SSL_MAX_SSL_SESSION_ID_LENGTH>;
@@ -236,6 +249,10 @@ private:
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  // Session cache callbacks, @see SSL_CTX_sess_set_new_cb() and the like.
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(SSL* ssl, absl::string_view id);
+  void removeSession(SSL_SESSION* session);
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   // Select the TLS certificate context in SSL_CTX_set_select_certificate_cb() callback with
   // ClientHello details.
@@ -244,6 +261,7 @@ private:
   SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names);
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  ServerSessionCacheSharedPtr session_cache_;
 };
 
 } // namespace Tls
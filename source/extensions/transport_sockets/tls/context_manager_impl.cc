@@ -20,6 +20,7 @@ ContextManagerImpl::~ContextManagerImpl() {
 
 void ContextManagerImpl::removeEmptyContexts() {
   contexts_.remove_if([](const std::weak_ptr<Envoy::Ssl::Context>& n) { return n.expired(); });
+  session_caches_.removeUnused();
 }
 
 Envoy::Ssl::ClientContextSharedPtr
@@ -44,8 +45,8 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+  Envoy::Ssl::ServerContextSharedPtr context = std::make_shared<ServerContextImpl>(
+      scope, config, server_names, time_source_, session_caches_);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
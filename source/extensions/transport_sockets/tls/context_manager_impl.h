@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 
 #include "extensions/transport_sockets/tls/private_key/private_key_manager_impl.h"
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -24,7 +25,8 @@ namespace Tls {
  */
 class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
 public:
-  ContextManagerImpl(TimeSource& time_source) : time_source_(time_source) {}
+  ContextManagerImpl(TimeSource& time_source)
+      : time_source_(time_source), session_caches_(time_source) {}
   ~ContextManagerImpl() override;
 
   // Ssl::ContextManager
@@ -39,12 +41,19 @@ public:
   Ssl::PrivateKeyMethodManager& privateKeyMethodManager() override {
     return private_key_method_manager_;
   };
+  std::vector<CachedSession> exportSessions() const override {
+    return session_caches_.exportSessions();
+  }
+  void importSessions(const std::vector<CachedSession>& sessions) override {
+    session_caches_.importSessions(sessions);
+  }
 
 private:
   void removeEmptyContexts();
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
+  ServerSessionCacheRegistry session_caches_;
 };
 
 } // namespace Tls
@@ -0,0 +1,92 @@
+#include "extensions/transport_sockets/tls/io_handle_bio.h"
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+Network::IoHandle& ioHandle(BIO* bio) {
+  return *static_cast<Network::IoHandle*>(BIO_get_data(bio));
+}
+
+// Sets the retry flag for errors after which the operation can be retried, like the socket BIO
+// does for EAGAIN.
+void setRetryFlag(BIO* bio, const Api::IoCallUint64Result& result, bool read) {
+  const Api::IoError::IoErrorCode code = result.err_->getErrorCode();
+  if (code == Api::IoError::IoErrorCode::Again || code == Api::IoError::IoErrorCode::Interrupt) {
+    if (read) {
+      BIO_set_retry_read(bio);
+    } else {
+      BIO_set_retry_write(bio);
+    }
+  }
+}
+
+int ioHandleRead(BIO* bio, char* out, int out_length) {
+  if (out == nullptr || out_length <= 0) {
+    return 0;
+  }
+  Buffer::RawSlice slice{out, static_cast<size_t>(out_length)};
+  const Api::IoCallUint64Result result =
+      ioHandle(bio).readv(static_cast<uint64_t>(out_length), &slice, 1);
+  BIO_clear_retry_flags(bio);
+  if (!result.ok()) {
+    setRetryFlag(bio, result, true);
+    return -1;
+  }
+  return static_cast<int>(result.rc_);
+}
+
+int ioHandleWrite(BIO* bio, const char* in, int in_length) {
+  if (in_length <= 0) {
+    return 0;
+  }
+  Buffer::RawSlice slice{const_cast<char*>(in), static_cast<size_t>(in_length)};
+  const Api::IoCallUint64Result result = ioHandle(bio).writev(&slice, 1);
+  BIO_clear_retry_flags(bio);
+  if (!result.ok()) {
+    setRetryFlag(bio, result, false);
+    return -1;
+  }
+  return static_cast<int>(result.rc_);
+}
+
+long ioHandleCtrl(BIO*, int cmd, long, void*) {
+  // Writes are not buffered by the BIO, so there is nothing to flush. Everything else, e.g.
+  // querying the file descriptor, is not supported.
+  return cmd == BIO_CTRL_FLUSH ? 1 : 0;
+}
+
+const BIO_METHOD* ioHandleMethod() {
+  static const BIO_METHOD* method = []() {
+    BIO_METHOD* method = BIO_meth_new(BIO_TYPE_SOCKET, "io_handle");
+    RELEASE_ASSERT(method != nullptr, "");
+    BIO_meth_set_read(method, ioHandleRead);
+    BIO_meth_set_write(method, ioHandleWrite);
+    BIO_meth_set_ctrl(method, ioHandleCtrl);
+    return method;
+  }();
+  return method;
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+BIO* BIO_new_io_handle(Network::IoHandle& io_handle) {
+  BIO* bio = BIO_new(ioHandleMethod());
+  RELEASE_ASSERT(bio != nullptr, "");
+  BIO_set_data(bio, &io_handle);
+  BIO_set_init(bio, 1);
+  return bio;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "envoy/network/io_handle.h"
+
+#include "openssl/bio.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Creates a BIO which reads and writes through an IoHandle instead of through the socket of its
+ * file descriptor. This keeps the TLS data in the IoHandle's order for handles which do not read
+ * from and write to the socket directly, e.g. Network::IoUringSocketHandleImpl.
+ * @param io_handle supplies the handle, which must outlive the BIO. The BIO does not close it.
+ * @return BIO* the new BIO.
+ */
+// NOLINTNEXTLINE(readability-identifier-naming)
+BIO* BIO_new_io_handle(Network::IoHandle& io_handle);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,587 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+#include "common/io/io_uring_worker.h"
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "openssl/hkdf.h"
+#include "openssl/mem.h"
+#include "openssl/nid.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+constexpr absl::string_view ClientTrafficSecretLabel = "CLIENT_TRAFFIC_SECRET_0";
+constexpr absl::string_view ServerTrafficSecretLabel = "SERVER_TRAFFIC_SECRET_0";
+
+// HKDF-Expand-Label with an empty context (RFC 8446 section 7.1).
+bool hkdfExpandLabel(const EVP_MD* digest, absl::Span<const uint8_t> secret,
+                     absl::string_view label, absl::Span<uint8_t> out) {
+  const std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> info;
+  info.reserve(4 + full_label.size());
+  info.push_back(out.size() >> 8);
+  info.push_back(out.size() & 0xff);
+  info.push_back(full_label.size());
+  info.insert(info.end(), full_label.begin(), full_label.end());
+  info.push_back(0);
+  return HKDF_expand(out.data(), out.size(), digest, secret.data(), secret.size(), info.data(),
+                     info.size()) == 1;
+}
+
+void cleanse(std::vector<uint8_t>& secret) {
+  OPENSSL_cleanse(secret.data(), secret.size());
+  secret.clear();
+}
+
+} // namespace
+
+KernelTls::Secrets::~Secrets() {
+  cleanse(client_traffic_secret_);
+  cleanse(server_traffic_secret_);
+}
+
+int KernelTls::secretsIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int ssl_secrets_index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(ssl_secrets_index >= 0, "");
+    return ssl_secrets_index;
+  }());
+}
+
+void KernelTls::keylogCallback(const SSL* ssl, const char* line) {
+  auto* secrets = static_cast<Secrets*>(SSL_get_ex_data(ssl, secretsIndex()));
+  if (secrets == nullptr) {
+    return;
+  }
+
+  // Lines are "<label> <client random> <secret>", with the last two hex encoded.
+  const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ');
+  if (fields.size() != 3) {
+    return;
+  }
+  std::vector<uint8_t>* secret;
+  if (fields[0] == ClientTrafficSecretLabel) {
+    secret = &secrets->client_traffic_secret_;
+  } else if (fields[0] == ServerTrafficSecretLabel) {
+    secret = &secrets->server_traffic_secret_;
+  } else {
+    return;
+  }
+  std::string bytes = absl::HexStringToBytes(fields[2]);
+  secret->assign(bytes.begin(), bytes.end());
+  OPENSSL_cleanse(bytes.data(), bytes.size());
+}
+
+bool KernelTls::deriveTrafficKeys(const EVP_MD* digest, absl::Span<const uint8_t> secret,
+                                  absl::Span<uint8_t> key, absl::Span<uint8_t> iv) {
+  return hkdfExpandLabel(digest, secret, "key", key) && hkdfExpandLabel(digest, secret, "iv", iv);
+}
+
+bool KernelTls::nextTrafficSecret(const EVP_MD* digest, std::vector<uint8_t>& secret) {
+  std::vector<uint8_t> next(EVP_MD_size(digest));
+  if (!hkdfExpandLabel(digest, secret, "traffic upd", absl::MakeSpan(next))) {
+    cleanse(next);
+    return false;
+  }
+  cleanse(secret);
+  secret = std::move(next);
+  return true;
+}
+
+KernelTls::KernelTls(SSL* ssl, os_fd_t fd, uint16_t version, int cipher_nid)
+    : ssl_(ssl), fd_(fd), version_(version), cipher_nid_(cipher_nid),
+      digest_(EVP_get_digestbynid(SSL_CIPHER_get_prf_nid(SSL_get_current_cipher(ssl)))) {}
+
+KernelTls::~KernelTls() {
+  cleanse(read_secret_);
+  cleanse(write_secret_);
+}
+
+#if defined(__linux__)
+
+namespace {
+
+// TLS record content types (RFC 8446 section 5.1).
+constexpr uint8_t RecordTypeAlert = 21;
+constexpr uint8_t RecordTypeHandshake = 22;
+constexpr uint8_t RecordTypeApplicationData = 23;
+
+// TLS alert descriptions and handshake message types (RFC 8446 sections 4 and 6).
+constexpr uint8_t AlertLevelWarning = 1;
+constexpr uint8_t AlertCloseNotify = 0;
+constexpr uint8_t HandshakeNewSessionTicket = 4;
+constexpr uint8_t HandshakeKeyUpdate = 24;
+constexpr uint8_t KeyUpdateNotRequested = 0;
+constexpr uint8_t KeyUpdateRequested = 1;
+
+// Largest plaintext of a record, and thus of a single read of a non application data record.
+constexpr uint64_t MaxRecordSize = 16384;
+// Bound on the handshake messages which are buffered across records.
+constexpr uint64_t MaxHandshakeMessageSize = 4 * MaxRecordSize;
+
+// Sizes of the AES-GCM record nonce. The kernel takes the first 4 bytes as the salt, and the last 8
+// as the explicit part of the nonce, which is advanced with the record sequence number.
+constexpr size_t SaltSize = 4;
+constexpr size_t NonceSize = 12;
+
+size_t keySize(int cipher_nid) { return cipher_nid == NID_aes_128_gcm ? 16 : 32; }
+
+template <class CryptoInfo>
+Api::SysCallIntResult setCryptoInfo(os_fd_t fd, int direction, uint16_t version,
+                                    uint16_t cipher_type, absl::Span<const uint8_t> key,
+                                    absl::Span<const uint8_t> salt, absl::Span<const uint8_t> iv,
+                                    uint64_t sequence) {
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = version == TLS1_3_VERSION ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  ASSERT(key.size() == sizeof(info.key) && salt.size() == sizeof(info.salt) &&
+         iv.size() == sizeof(info.iv));
+  memcpy(info.key, key.data(), sizeof(info.key));
+  memcpy(info.salt, salt.data(), sizeof(info.salt));
+  memcpy(info.iv, iv.data(), sizeof(info.iv));
+  for (size_t i = 0; i < sizeof(info.rec_seq); ++i) {
+    info.rec_seq[i] = sequence >> (8 * (sizeof(info.rec_seq) - 1 - i));
+  }
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TLS, direction, &info, sizeof(info));
+  OPENSSL_cleanse(&info, sizeof(info));
+  return result;
+}
+
+} // namespace
+
+std::unique_ptr<KernelTls> KernelTls::install(SSL* ssl, os_fd_t fd, std::string& failure_reason) {
+  // io_uring reads from and writes to the socket on its own, without the record types.
+  if (Io::IoUringFactorySingleton::getExisting() != nullptr) {
+    return nullptr;
+  }
+
+  const uint16_t version = SSL_version(ssl);
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  const int cipher_nid = cipher != nullptr ? SSL_CIPHER_get_cipher_nid(cipher) : NID_undef;
+  // Plaintext which BoringSSL already decrypted would be skipped by the kernel.
+  if ((version != TLS1_2_VERSION && version != TLS1_3_VERSION) ||
+      (cipher_nid != NID_aes_128_gcm && cipher_nid != NID_aes_256_gcm) || SSL_has_pending(ssl)) {
+    return nullptr;
+  }
+
+  auto* secrets = static_cast<Secrets*>(SSL_get_ex_data(ssl, secretsIndex()));
+  if (version == TLS1_3_VERSION &&
+      (secrets == nullptr || secrets->client_traffic_secret_.empty() ||
+       secrets->server_traffic_secret_.empty())) {
+    return nullptr;
+  }
+
+  std::unique_ptr<KernelTls> kernel_tls(new KernelTls(ssl, fd, version, cipher_nid));
+  if (version == TLS1_3_VERSION) {
+    // The secrets are taken from the connection, and kept for key updates.
+    const bool is_server = SSL_is_server(ssl);
+    kernel_tls->read_secret_ = std::move(is_server ? secrets->client_traffic_secret_
+                                                   : secrets->server_traffic_secret_);
+    kernel_tls->write_secret_ = std::move(is_server ? secrets->server_traffic_secret_
+                                                    : secrets->client_traffic_secret_);
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  static const char ulp_name[] = "tls";
+  const Api::SysCallIntResult result =
+      os_sys_calls.setsockopt(fd, SOL_TCP, TCP_ULP, ulp_name, sizeof(ulp_name));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(debug, "kernel TLS is not available: {}", strerror(result.errno_));
+    return nullptr;
+  }
+
+  // Until a key is set, the socket keeps behaving as a plain TCP socket, and BoringSSL can keep
+  // going. Once the read key is set, the kernel decrypts what follows, and the write key must be
+  // set as well.
+  if (!kernel_tls->setKey(TLS_RX, SSL_get_read_sequence(ssl))) {
+    return nullptr;
+  }
+  if (!kernel_tls->setKey(TLS_TX, SSL_get_write_sequence(ssl))) {
+    failure_reason = "kernel TLS: unable to set the write key";
+    return nullptr;
+  }
+  return kernel_tls;
+}
+
+bool KernelTls::setKey(int direction, uint64_t sequence) {
+  const size_t key_size = keySize(cipher_nid_);
+  uint8_t key[32];
+  uint8_t iv[NonceSize];
+  bool derived;
+  if (version_ == TLS1_3_VERSION) {
+    derived = deriveTrafficKeys(digest_, direction == TLS_RX ? read_secret_ : write_secret_,
+                                absl::MakeSpan(key, key_size), absl::MakeSpan(iv));
+  } else {
+    // The TLS 1.2 AES-GCM key block holds the client write key, the server write key, and the
+    // client and server implicit nonces (RFC 5246 section 6.3, RFC 5288 section 3). The explicit
+    // part of the nonce is the record sequence number, as BoringSSL does.
+    std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl_));
+    derived = key_block.size() == 2 * (key_size + SaltSize) &&
+              SSL_generate_key_block(ssl_, key_block.data(), key_block.size()) == 1;
+    if (derived) {
+      const bool client_keys = (direction == TLS_RX) == static_cast<bool>(SSL_is_server(ssl_));
+      memcpy(key, key_block.data() + (client_keys ? 0 : key_size), key_size);
+      memcpy(iv, key_block.data() + 2 * key_size + (client_keys ? 0 : SaltSize), SaltSize);
+      for (size_t i = 0; i < NonceSize - SaltSize; ++i) {
+        iv[SaltSize + i] = sequence >> (8 * (NonceSize - SaltSize - 1 - i));
+      }
+    }
+    OPENSSL_cleanse(key_block.data(), key_block.size());
+  }
+
+  const bool set = derived && setKey(direction, absl::MakeConstSpan(key, key_size),
+                                     absl::MakeConstSpan(iv, SaltSize),
+                                     absl::MakeConstSpan(iv + SaltSize, NonceSize - SaltSize),
+                                     sequence);
+  OPENSSL_cleanse(key, sizeof(key));
+  OPENSSL_cleanse(iv, sizeof(iv));
+  return set;
+}
+
+bool KernelTls::setKey(int direction, absl::Span<const uint8_t> key,
+                       absl::Span<const uint8_t> salt, absl::Span<const uint8_t> iv,
+                       uint64_t sequence) {
+  const Api::SysCallIntResult result =
+      cipher_nid_ == NID_aes_128_gcm
+          ? setCryptoInfo<tls12_crypto_info_aes_gcm_128>(fd_, direction, version_,
+                                                         TLS_CIPHER_AES_GCM_128, key, salt, iv,
+                                                         sequence)
+          : setCryptoInfo<tls12_crypto_info_aes_gcm_256>(fd_, direction, version_,
+                                                         TLS_CIPHER_AES_GCM_256, key, salt, iv,
+                                                         sequence);
+  if (result.rc_ != 0) {
+    ENVOY_LOG(debug, "unable to set the kernel TLS {} key: {}",
+              direction == TLS_RX ? "read" : "write", strerror(result.errno_));
+    return false;
+  }
+  return true;
+}
+
+Network::IoResult KernelTls::doRead(Buffer::Instance& buffer,
+                                    Network::TransportSocketCallbacks& callbacks) {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Network::PostIoAction action = Network::PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  while (action == Network::PostIoAction::KeepOpen && !end_stream) {
+    // Reading stops at the end of a record whose type differs from the type of the first one, so
+    // that a record which is not application data is read alone, and fits in the reservation.
+    Buffer::RawSlice slices[2];
+    const uint64_t num_slices = buffer.reserve(MaxRecordSize, slices, 2);
+    iovec iov[2];
+    for (uint64_t i = 0; i < num_slices; i++) {
+      iov[i].iov_base = slices[i].mem_;
+      iov[i].iov_len = slices[i].len_;
+    }
+    alignas(cmsghdr) uint8_t control[CMSG_SPACE(sizeof(uint8_t))];
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = iov;
+    message.msg_iovlen = num_slices;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    const Api::SysCallSizeResult result = os_sys_calls.recvmsg(fd_, &message, 0);
+    ENVOY_CONN_LOG(trace, "kernel TLS read returns: {}", callbacks.connection(), result.rc_);
+    if (result.rc_ < 0) {
+      if (result.errno_ != EAGAIN) {
+        failure_reason_ = absl::StrCat("kernel TLS: read error: ", strerror(result.errno_));
+        action = Network::PostIoAction::Close;
+      }
+      break;
+    }
+    if (result.rc_ == 0) {
+      // The peer closed the connection without a close_notify alert, which BoringSSL reports as
+      // an error as well.
+      failure_reason_ = "kernel TLS: unexpected end of stream";
+      action = Network::PostIoAction::Close;
+      break;
+    }
+
+    uint8_t record_type = RecordTypeApplicationData;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+        record_type = *CMSG_DATA(cmsg);
+      }
+    }
+
+    uint64_t remaining = result.rc_;
+    if (record_type == RecordTypeApplicationData) {
+      uint64_t slices_to_commit = 0;
+      while (remaining > 0) {
+        slices[slices_to_commit].len_ = std::min(slices[slices_to_commit].len_, remaining);
+        remaining -= slices[slices_to_commit].len_;
+        slices_to_commit++;
+      }
+      buffer.commit(slices, slices_to_commit);
+      bytes_read += result.rc_;
+      if (callbacks.shouldDrainReadBuffer()) {
+        callbacks.setReadBufferReady();
+        break;
+      }
+      continue;
+    }
+
+    // Other records are handled here, and never committed to the buffer.
+    std::vector<uint8_t> record;
+    record.reserve(result.rc_);
+    for (uint64_t i = 0; remaining > 0; i++) {
+      const uint64_t length = std::min(slices[i].len_, remaining);
+      const uint8_t* mem = static_cast<const uint8_t*>(slices[i].mem_);
+      record.insert(record.end(), mem, mem + length);
+      remaining -= length;
+    }
+    bool handled;
+    switch (record_type) {
+    case RecordTypeAlert:
+      handled = handleAlert(record, end_stream);
+      break;
+    case RecordTypeHandshake:
+      handled = handleHandshake(record);
+      break;
+    default:
+      failure_reason_ = absl::StrCat("kernel TLS: unexpected record type ", record_type);
+      handled = false;
+      break;
+    }
+    if (!handled) {
+      action = Network::PostIoAction::Close;
+    }
+  }
+
+  if (action == Network::PostIoAction::Close) {
+    ENVOY_CONN_LOG(debug, "{}", callbacks.connection(), failure_reason_);
+  }
+  ENVOY_CONN_LOG(trace, "kernel TLS read {} bytes", callbacks.connection(), bytes_read);
+  return {action, bytes_read, end_stream};
+}
+
+bool KernelTls::handleAlert(absl::Span<const uint8_t> record, bool& end_stream) {
+  if (record.size() != 2) {
+    failure_reason_ = "kernel TLS: malformed alert";
+    return false;
+  }
+  if (record[1] == AlertCloseNotify) {
+    end_stream = true;
+    return true;
+  }
+  failure_reason_ =
+      absl::StrCat("kernel TLS: received alert ", SSL_alert_desc_string_long(record[1]));
+  return false;
+}
+
+bool KernelTls::handleHandshake(absl::Span<const uint8_t> record) {
+  if (version_ != TLS1_3_VERSION) {
+    // Renegotiation is not supported, as with BoringSSL.
+    failure_reason_ = "kernel TLS: unexpected handshake message";
+    return false;
+  }
+
+  handshake_buffer_.insert(handshake_buffer_.end(), record.begin(), record.end());
+  while (handshake_buffer_.size() >= 4) {
+    const uint8_t type = handshake_buffer_[0];
+    const uint64_t length =
+        (handshake_buffer_[1] << 16) | (handshake_buffer_[2] << 8) | handshake_buffer_[3];
+    if (length > MaxHandshakeMessageSize) {
+      failure_reason_ = "kernel TLS: handshake message too large";
+      return false;
+    }
+    if (handshake_buffer_.size() < 4 + length) {
+      break;
+    }
+
+    switch (type) {
+    case HandshakeNewSessionTicket:
+      // The kernel only carries established connections, whose tickets are of no use to BoringSSL.
+      ENVOY_LOG(trace, "kernel TLS: ignoring session ticket");
+      break;
+    case HandshakeKeyUpdate:
+      // The new key applies from the next record on, so nothing may follow in this record.
+      if (length != 1 || handshake_buffer_.size() != 5 ||
+          handshake_buffer_[4] > KeyUpdateRequested) {
+        failure_reason_ = "kernel TLS: malformed key update";
+        return false;
+      }
+      if (!updateReadKey(handshake_buffer_[4] == KeyUpdateRequested)) {
+        return false;
+      }
+      break;
+    default:
+      failure_reason_ = absl::StrCat("kernel TLS: unexpected handshake message ", type);
+      return false;
+    }
+    handshake_buffer_.erase(handshake_buffer_.begin(), handshake_buffer_.begin() + 4 + length);
+  }
+  return true;
+}
+
+bool KernelTls::updateReadKey(bool update_requested) {
+  // Kernels which do not support replacing a key keep decrypting with the old one, and fail.
+  if (!nextTrafficSecret(digest_, read_secret_) || !setKey(TLS_RX, 0)) {
+    failure_reason_ = "kernel TLS: unable to update the read key";
+    return false;
+  }
+  if (update_requested && !key_update_pending_) {
+    key_update_pending_ = true;
+    bool blocked;
+    return flushKeyUpdate(blocked);
+  }
+  return true;
+}
+
+bool KernelTls::flushKeyUpdate(bool& blocked) {
+  blocked = false;
+  if (!key_update_pending_) {
+    return true;
+  }
+  const uint8_t key_update[] = {HandshakeKeyUpdate, 0, 0, 1, KeyUpdateNotRequested};
+  const int sent = sendRecord(RecordTypeHandshake, key_update);
+  if (sent == 0) {
+    blocked = true;
+    return true;
+  }
+  key_update_pending_ = false;
+  if (sent < 0 || !nextTrafficSecret(digest_, write_secret_) || !setKey(TLS_TX, 0)) {
+    failure_reason_ = "kernel TLS: unable to update the write key";
+    return false;
+  }
+  return true;
+}
+
+Network::IoResult KernelTls::doWrite(Buffer::Instance& buffer,
+                                     Network::TransportSocketCallbacks& callbacks) {
+  bool blocked;
+  if (!flushKeyUpdate(blocked)) {
+    ENVOY_CONN_LOG(debug, "{}", callbacks.connection(), failure_reason_);
+    return {Network::PostIoAction::Close, 0, false};
+  }
+  if (blocked) {
+    return {Network::PostIoAction::KeepOpen, 0, false};
+  }
+
+  uint64_t bytes_written = 0;
+  while (buffer.length() > 0) {
+    // The kernel splits what is written into records, so the buffer is written without copies.
+    Api::IoCallUint64Result result = buffer.write(callbacks.ioHandle());
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel TLS write error: {}", callbacks.connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        break;
+      }
+      failure_reason_ = absl::StrCat("kernel TLS: write error: ", result.err_->getErrorDetails());
+      return {Network::PostIoAction::Close, bytes_written, false};
+    }
+    ENVOY_CONN_LOG(trace, "kernel TLS write returns: {}", callbacks.connection(), result.rc_);
+    bytes_written += result.rc_;
+  }
+  return {Network::PostIoAction::KeepOpen, bytes_written, false};
+}
+
+void KernelTls::shutdown() {
+  if (close_notify_sent_) {
+    return;
+  }
+  // As with SSL_shutdown(), a failure is ignored, and detected on the next read if the connection
+  // failed.
+  const uint8_t close_notify[] = {AlertLevelWarning, AlertCloseNotify};
+  sendRecord(RecordTypeAlert, close_notify);
+  close_notify_sent_ = true;
+}
+
+int KernelTls::sendRecord(uint8_t record_type, absl::Span<const uint8_t> data) {
+  iovec iov;
+  iov.iov_base = const_cast<uint8_t*>(data.data());
+  iov.iov_len = data.size();
+  alignas(cmsghdr) uint8_t control[CMSG_SPACE(sizeof(record_type))];
+  memset(control, 0, sizeof(control));
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(record_type));
+  *CMSG_DATA(cmsg) = record_type;
+
+  const Api::SysCallSizeResult result = Api::OsSysCallsSingleton::get().sendmsg(fd_, &message, 0);
+  if (result.rc_ == static_cast<ssize_t>(data.size())) {
+    return 1;
+  }
+  if (result.rc_ < 0 && result.errno_ == EAGAIN) {
+    return 0;
+  }
+  ENVOY_LOG(debug, "unable to send a kernel TLS record of type {}: {}", record_type,
+            result.rc_ < 0 ? strerror(result.errno_) : "short write");
+  return -1;
+}
+
+#else
+
+std::unique_ptr<KernelTls> KernelTls::install(SSL*, os_fd_t, std::string&) { return nullptr; }
+
+bool KernelTls::setKey(int, uint64_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool KernelTls::setKey(int, absl::Span<const uint8_t>, absl::Span<const uint8_t>,
+                       absl::Span<const uint8_t>, uint64_t) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+Network::IoResult KernelTls::doRead(Buffer::Instance&, Network::TransportSocketCallbacks&) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+bool KernelTls::handleAlert(absl::Span<const uint8_t>, bool&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool KernelTls::handleHandshake(absl::Span<const uint8_t>) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool KernelTls::updateReadKey(bool) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+bool KernelTls::flushKeyUpdate(bool&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+Network::IoResult KernelTls::doWrite(Buffer::Instance&, Network::TransportSocketCallbacks&) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+void KernelTls::shutdown() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+int KernelTls::sendRecord(uint8_t, absl::Span<const uint8_t>) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
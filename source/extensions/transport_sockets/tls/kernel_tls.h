@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+#include "envoy/network/connection.h"
+#include "envoy/network/transport_socket.h"
+
+#include "common/common/logger.h"
+
+#include "absl/types/span.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Record layer of an established TLS connection offloaded to the Linux kernel (kTLS). Once
+ * installed, the kernel encrypts what is written to the socket and decrypts what is read from it,
+ * so application data moves through the socket as plaintext. Records of other types are read and
+ * written as plaintext with their record type attached as a control message.
+ *
+ * Only TLS 1.2 and TLS 1.3 connections using AES-GCM are offloaded. The handshake always runs in
+ * BoringSSL.
+ */
+class KernelTls : Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * TLS 1.3 application traffic secrets of a connection. BoringSSL does not export them, so they
+   * are captured through the key log callback while the handshake runs.
+   */
+  struct Secrets {
+    ~Secrets();
+
+    std::vector<uint8_t> client_traffic_secret_;
+    std::vector<uint8_t> server_traffic_secret_;
+  };
+
+  /**
+   * @return int the SSL ex_data index at which the Secrets of a connection are stored.
+   */
+  static int secretsIndex();
+
+  /**
+   * SSL_CTX key log callback which stores the TLS 1.3 application traffic secrets in the Secrets
+   * of the connection, if any.
+   */
+  static void keylogCallback(const SSL* ssl, const char* line);
+
+  /**
+   * Hand the record layer of a connection whose handshake just completed over to the kernel.
+   * @param ssl the connection.
+   * @param fd the socket of the connection.
+   * @param failure_reason receives why the connection must be closed.
+   * @return the kernel record layer, or nullptr if it was not installed. The connection must then
+   *         keep using BoringSSL if failure_reason is empty, and be closed otherwise.
+   */
+  static std::unique_ptr<KernelTls> install(SSL* ssl, os_fd_t fd, std::string& failure_reason);
+
+  /**
+   * Derive the key and the IV of a TLS 1.3 traffic secret (RFC 8446 section 7.3).
+   * @return bool whether the derivation succeeded.
+   */
+  static bool deriveTrafficKeys(const EVP_MD* digest, absl::Span<const uint8_t> secret,
+                                absl::Span<uint8_t> key, absl::Span<uint8_t> iv);
+
+  /**
+   * Derive the TLS 1.3 traffic secret which follows a key update (RFC 8446 section 7.2).
+   * @return bool whether the derivation succeeded.
+   */
+  static bool nextTrafficSecret(const EVP_MD* digest, std::vector<uint8_t>& secret);
+
+  ~KernelTls();
+
+  /**
+   * Read application data, handling the alerts and the post-handshake messages of the peer.
+   * @see Network::TransportSocket::doRead().
+   */
+  Network::IoResult doRead(Buffer::Instance& buffer, Network::TransportSocketCallbacks& callbacks);
+
+  /**
+   * Write application data, after the key update requested by the peer if it is still pending.
+   * @see Network::TransportSocket::doWrite().
+   */
+  Network::IoResult doWrite(Buffer::Instance& buffer, Network::TransportSocketCallbacks& callbacks);
+
+  /**
+   * Send a close_notify alert, if none was sent yet.
+   */
+  void shutdown();
+
+  /**
+   * @return const std::string& why the connection was closed, if it was closed by this.
+   */
+  const std::string& failureReason() const { return failure_reason_; }
+
+private:
+  KernelTls(SSL* ssl, os_fd_t fd, uint16_t version, int cipher_nid);
+
+  // The direction is either TLS_RX or TLS_TX.
+  bool setKey(int direction, uint64_t sequence);
+  bool setKey(int direction, absl::Span<const uint8_t> key, absl::Span<const uint8_t> salt,
+              absl::Span<const uint8_t> iv, uint64_t sequence);
+  bool handleAlert(absl::Span<const uint8_t> record, bool& end_stream);
+  bool handleHandshake(absl::Span<const uint8_t> record);
+  bool updateReadKey(bool update_requested);
+  bool flushKeyUpdate(bool& blocked);
+  // Returns 1 if the record was sent, 0 if the socket is not writable, and -1 on error.
+  int sendRecord(uint8_t record_type, absl::Span<const uint8_t> data);
+
+  SSL* const ssl_;
+  const os_fd_t fd_;
+  const uint16_t version_;
+  const int cipher_nid_;
+  const EVP_MD* const digest_;
+  std::vector<uint8_t> read_secret_;
+  std::vector<uint8_t> write_secret_;
+  // Handshake messages of the peer which span several records.
+  std::vector<uint8_t> handshake_buffer_;
+  bool key_update_pending_{};
+  bool close_notify_sent_{};
+  std::string failure_reason_;
+};
+
+using KernelTlsPtr = std::unique_ptr<KernelTls>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
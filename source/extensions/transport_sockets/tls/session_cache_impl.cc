@@ -0,0 +1,139 @@
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+#include <algorithm>
+
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+ServerSessionCache::ServerSessionCache(
+    const Envoy::Ssl::ServerContextConfig::SessionCacheConfig& config, TimeSource& time_source)
+    : shard_capacity_(std::max<uint64_t>((config.max_sessions_ + NumShards - 1) / NumShards, 1)),
+      preserve_across_hot_restart_(config.preserve_across_hot_restart_),
+      time_source_(time_source) {}
+
+ServerSessionCache::Shard& ServerSessionCache::shard(absl::string_view id) {
+  return shards_[absl::Hash<absl::string_view>()(id) % NumShards];
+}
+
+void ServerSessionCache::erase(Shard& shard, std::list<Entry>::iterator entry) {
+  shard.index_.erase(entry->id_);
+  shard.entries_.erase(entry);
+}
+
+bool ServerSessionCache::insert(absl::string_view id, std::string session,
+                                std::chrono::seconds ttl) {
+  const MonotonicTime expiry = time_source_.monotonicTime() + ttl;
+  Shard& shard = this->shard(id);
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.index_.find(id);
+  if (it != shard.index_.end()) {
+    erase(shard, it->second);
+  }
+
+  bool evicted = false;
+  if (shard.entries_.size() >= shard_capacity_) {
+    erase(shard, std::prev(shard.entries_.end()));
+    evicted = true;
+  }
+  shard.entries_.push_front(Entry{std::string(id), std::move(session), expiry});
+  shard.index_.emplace(shard.entries_.front().id_, shard.entries_.begin());
+  return evicted;
+}
+
+absl::optional<std::string> ServerSessionCache::lookup(absl::string_view id) {
+  Shard& shard = this->shard(id);
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.index_.find(id);
+  if (it == shard.index_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second->expiry_ <= time_source_.monotonicTime()) {
+    erase(shard, it->second);
+    return absl::nullopt;
+  }
+  shard.entries_.splice(shard.entries_.begin(), shard.entries_, it->second);
+  return it->second->session_;
+}
+
+void ServerSessionCache::remove(absl::string_view id) {
+  Shard& shard = this->shard(id);
+  absl::MutexLock lock(&shard.mutex_);
+  auto it = shard.index_.find(id);
+  if (it != shard.index_.end()) {
+    erase(shard, it->second);
+  }
+}
+
+void ServerSessionCache::exportSessions(
+    absl::string_view session_id_context,
+    std::vector<Envoy::Ssl::ContextManager::CachedSession>& sessions) const {
+  const MonotonicTime now = time_source_.monotonicTime();
+  for (const Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    for (auto it = shard.entries_.rbegin(); it != shard.entries_.rend(); ++it) {
+      const auto ttl = std::chrono::duration_cast<std::chrono::seconds>(it->expiry_ - now);
+      if (ttl.count() > 0) {
+        sessions.push_back({std::string(session_id_context), it->id_, it->session_, ttl});
+      }
+    }
+  }
+}
+
+uint64_t ServerSessionCache::size() const {
+  uint64_t size = 0;
+  for (const Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    size += shard.entries_.size();
+  }
+  return size;
+}
+
+ServerSessionCacheSharedPtr ServerSessionCacheRegistry::getOrCreate(
+    absl::string_view session_id_context,
+    const Envoy::Ssl::ServerContextConfig::SessionCacheConfig& config) {
+  ServerSessionCacheSharedPtr& cache = caches_[session_id_context];
+  if (cache == nullptr) {
+    cache = std::make_shared<ServerSessionCache>(config, time_source_);
+  }
+  return cache;
+}
+
+void ServerSessionCacheRegistry::removeUnused() {
+  for (auto it = caches_.begin(); it != caches_.end();) {
+    if (it->second.use_count() == 1) {
+      caches_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::vector<Envoy::Ssl::ContextManager::CachedSession>
+ServerSessionCacheRegistry::exportSessions() const {
+  std::vector<Envoy::Ssl::ContextManager::CachedSession> sessions;
+  for (const auto& cache : caches_) {
+    if (cache.second->preserveAcrossHotRestart()) {
+      cache.second->exportSessions(cache.first, sessions);
+    }
+  }
+  return sessions;
+}
+
+void ServerSessionCacheRegistry::importSessions(
+    const std::vector<Envoy::Ssl::ContextManager::CachedSession>& sessions) {
+  for (const auto& session : sessions) {
+    auto it = caches_.find(session.session_id_context_);
+    if (it != caches_.end()) {
+      it->second->insert(session.session_id_, session.session_, session.ttl_);
+    }
+  }
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/ssl/context_config.h"
+#include "envoy/ssl/context_manager.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Stateful cache of the sessions of TLS servers, by session ID. The sessions are kept serialized,
+ * so that they can be handed over to a new process on a hot restart. The cache is split into
+ * shards by session ID, each with its own lock and least recently used list, so that the workers
+ * seldom contend on it.
+ */
+class ServerSessionCache {
+public:
+  ServerSessionCache(const Envoy::Ssl::ServerContextConfig::SessionCacheConfig& config,
+                     TimeSource& time_source);
+
+  /**
+   * Add a session, replacing any session with the same ID. The least recently used session of
+   * the shard is evicted if the shard is full.
+   * @param id the session ID.
+   * @param session the serialized session.
+   * @param ttl the lifetime of the session.
+   * @return bool whether a session was evicted.
+   */
+  bool insert(absl::string_view id, std::string session, std::chrono::seconds ttl);
+
+  /**
+   * @return the serialized session, or absl::nullopt if it is not in the cache or has expired.
+   */
+  absl::optional<std::string> lookup(absl::string_view id);
+
+  /**
+   * Remove a session, if it is in the cache.
+   */
+  void remove(absl::string_view id);
+
+  /**
+   * Append the unexpired sessions to sessions, least recently used first.
+   * @param session_id_context the session ID context which the cache is for.
+   */
+  void exportSessions(absl::string_view session_id_context,
+                      std::vector<Envoy::Ssl::ContextManager::CachedSession>& sessions) const;
+
+  /**
+   * @return uint64_t the number of sessions in the cache, including the expired ones.
+   */
+  uint64_t size() const;
+
+  bool preserveAcrossHotRestart() const { return preserve_across_hot_restart_; }
+
+private:
+  static constexpr size_t NumShards = 16;
+
+  struct Entry {
+    std::string id_;
+    std::string session_;
+    MonotonicTime expiry_;
+  };
+
+  struct Shard {
+    mutable absl::Mutex mutex_;
+    // Most recently used first.
+    std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+    // Keys point into the IDs of the entries.
+    absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator>
+        index_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& shard(absl::string_view id);
+  static void erase(Shard& shard, std::list<Entry>::iterator entry)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
+  const uint64_t shard_capacity_;
+  const bool preserve_across_hot_restart_;
+  TimeSource& time_source_;
+  std::array<Shard, NumShards> shards_;
+};
+
+using ServerSessionCacheSharedPtr = std::shared_ptr<ServerSessionCache>;
+
+/**
+ * The server session caches of a process, by session ID context. The server contexts which may
+ * resume each other's sessions share a session ID context, and so a cache. A cache outlives the
+ * contexts using it until the next cleanup, so that a context replacing another one, after a
+ * listener or certificate update, resumes the sessions of the context it replaces.
+ */
+class ServerSessionCacheRegistry {
+public:
+  explicit ServerSessionCacheRegistry(TimeSource& time_source) : time_source_(time_source) {}
+
+  /**
+   * @return the cache of the session ID context, which is created with config if there is none.
+   */
+  ServerSessionCacheSharedPtr
+  getOrCreate(absl::string_view session_id_context,
+              const Envoy::Ssl::ServerContextConfig::SessionCacheConfig& config);
+
+  /**
+   * Release the caches which no context uses anymore.
+   */
+  void removeUnused();
+
+  /**
+   * @see Ssl::ContextManager::exportSessions().
+   */
+  std::vector<Envoy::Ssl::ContextManager::CachedSession> exportSessions() const;
+
+  /**
+   * @see Ssl::ContextManager::importSessions().
+   */
+  void importSessions(const std::vector<Envoy::Ssl::ContextManager::CachedSession>& sessions);
+
+private:
+  TimeSource& time_source_;
+  absl::flat_hash_map<std::string, ServerSessionCacheSharedPtr> caches_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -6,7 +6,9 @@
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
 #include "common/http/headers.h"
+#include "common/runtime/runtime_features.h"
 
+#include "extensions/transport_sockets/tls/io_handle_bio.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -24,6 +26,23 @@ namespace {
 
 constexpr absl::string_view NotReadyReason{"TLS error: Secret is not supplied by SDS"};
 
+// The largest plaintext a TLS record can carry.
+constexpr uint64_t MaxRecordSize = 16384;
+// With dynamic record sizing, the first records fit in a single TCP segment on a 1500 byte MTU path
+// once the TLS, TCP and IP overheads are added.
+constexpr uint64_t InitialRecordSize = 1400;
+// The record size doubles every time this many bytes are written at the current size, which is
+// about what a TCP initial congestion window carries.
+constexpr uint64_t RecordSizeStepBytes = 16384;
+// The record size restarts from InitialRecordSize once the connection has not written for this
+// long, as the congestion window of an idle TCP connection does.
+constexpr std::chrono::seconds RecordSizeIdleTimeout{1};
+// Slices shorter than this are coalesced into a record with the slices which follow them. Longer
+// slices are written from the buffer without being copied.
+constexpr uint64_t MinUncoalescedSliceSize = 1024;
+// At most this many slices are coalesced into a record, which keeps them in an inline slice vector.
+constexpr uint64_t MaxCoalescedSlices = 16;
+
 // This SslSocket will be used when SSL secret is not fetched from SDS server.
 class NotReadySslSocket : public Network::TransportSocket {
 public:
@@ -32,6 +51,7 @@ public:
   std::string protocol() const override { return EMPTY_STRING; }
   absl::string_view failureReason() const override { return NotReadyReason; }
   bool canFlushClose() override { return true; }
+  bool passthrough() const override { return false; }
   void closeSocket(Network::ConnectionEvent) override {}
   Network::IoResult doRead(Buffer::Instance&) override { return {PostIoAction::Close, 0, false}; }
   Network::IoResult doWrite(Buffer::Instance&, bool) override {
@@ -45,7 +65,11 @@ public:
 SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
                      const Network::TransportSocketOptionsSharedPtr& transport_socket_options)
     : transport_socket_options_(transport_socket_options),
-      ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)), state_(SocketState::PreHandshake) {
+      ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)),
+      dynamic_record_sizing_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_dynamic_record_sizing")),
+      record_size_(dynamic_record_sizing_ ? InitialRecordSize : MaxRecordSize),
+      state_(SocketState::PreHandshake) {
   bssl::UniquePtr<SSL> ssl = ctx_->newSsl(transport_socket_options_.get());
   ssl_ = ssl.get();
   info_ = std::make_shared<SslSocketInfo>(std::move(ssl), ctx_);
@@ -56,6 +80,11 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
     ASSERT(state == InitialState::Server);
     SSL_set_accept_state(ssl_);
   }
+
+  if (ctx_->enableKernelTls()) {
+    kernel_tls_secrets_ = std::make_unique<KernelTls::Secrets>();
+    SSL_set_ex_data(ssl_, KernelTls::secretsIndex(), kernel_tls_secrets_.get());
+  }
 }
 
 void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& callbacks) {
@@ -68,7 +97,8 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
     provider->registerPrivateKeyMethod(ssl_, *this, callbacks_->connection().dispatcher());
   }
 
-  BIO* bio = BIO_new_socket(callbacks_->ioHandle().fd(), 0);
+  // Go through the IoHandle rather than its socket, which it may not read from directly.
+  BIO* bio = BIO_new_io_handle(callbacks_->ioHandle());
   SSL_set_bio(ssl_, bio, bio);
 }
 
@@ -106,6 +136,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (kernel_tls_ != nullptr) {
+    return kernel_tls_->doRead(read_buffer, *callbacks_);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -176,6 +210,9 @@ PostIoAction SslSocket::doHandshake() {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     state_ = SocketState::HandshakeComplete;
     ctx_->logHandshake(ssl_);
+    if (kernel_tls_secrets_ != nullptr && !installKernelTls()) {
+      return PostIoAction::Close;
+    }
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -202,6 +239,28 @@ PostIoAction SslSocket::doHandshake() {
   }
 }
 
+bool SslSocket::installKernelTls() {
+  std::string failure_reason;
+  kernel_tls_ = KernelTls::install(ssl_, callbacks_->ioHandle().fd(), failure_reason);
+  SSL_set_ex_data(ssl_, KernelTls::secretsIndex(), nullptr);
+  kernel_tls_secrets_.reset();
+
+  if (kernel_tls_ != nullptr) {
+    ENVOY_CONN_LOG(debug, "kernel TLS installed", callbacks_->connection());
+    ctx_->stats().kernel_tls_.inc();
+    return true;
+  }
+  if (!failure_reason.empty()) {
+    ENVOY_CONN_LOG(debug, "{}", callbacks_->connection(), failure_reason);
+    failure_reason_ = std::move(failure_reason);
+    ctx_->stats().connection_error_.inc();
+    return false;
+  }
+  ENVOY_CONN_LOG(debug, "kernel TLS not installed", callbacks_->connection());
+  ctx_->stats().kernel_tls_fallback_.inc();
+  return true;
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -238,12 +297,28 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_ != nullptr) {
+    Network::IoResult result = kernel_tls_->doWrite(write_buffer, *callbacks_);
+    if (result.action_ == PostIoAction::KeepOpen && write_buffer.length() == 0 && end_stream) {
+      shutdownSsl();
+    }
+    return result;
+  }
+
+  if (dynamic_record_sizing_) {
+    const MonotonicTime now = callbacks_->connection().dispatcher().approximateMonotonicTime();
+    if (now - last_write_time_ >= RecordSizeIdleTimeout) {
+      record_size_ = InitialRecordSize;
+      bytes_at_record_size_ = 0;
+    }
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = nextWriteSize(write_buffer);
   }
 
   uint64_t total_bytes_written = 0;
@@ -253,15 +328,20 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
 
     // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
     // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
+    // data, since the undrained data is the same anyway. It is either entirely in the first slice,
+    // or linearized into the first slice.
     ASSERT(bytes_to_write <= write_buffer.length());
-    int rc = SSL_write(ssl_, write_buffer.linearize(bytes_to_write), bytes_to_write);
+    const Buffer::RawSliceVector slices = write_buffer.getRawSlices(1);
+    const void* data =
+        slices[0].len_ >= bytes_to_write ? slices[0].mem_ : write_buffer.linearize(bytes_to_write);
+    int rc = SSL_write(ssl_, data, bytes_to_write);
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
     if (rc > 0) {
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      onRecordWritten(rc);
+      bytes_to_write = nextWriteSize(write_buffer);
     } else {
       int err = SSL_get_error(ssl_, rc);
       switch (err) {
@@ -286,6 +366,38 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::nextWriteSize(const Buffer::Instance& write_buffer) const {
+  const uint64_t max_size = std::min(write_buffer.length(), record_size_);
+  uint64_t size = 0;
+  for (const Buffer::RawSlice& slice : write_buffer.getRawSlices(MaxCoalescedSlices)) {
+    if (slice.len_ >= MinUncoalescedSliceSize) {
+      // The short slices coalesced so far make up a record of their own, so that this slice is
+      // not copied.
+      if (size == 0) {
+        size = slice.len_;
+      }
+      break;
+    }
+    size += slice.len_;
+    if (size >= max_size) {
+      break;
+    }
+  }
+  return std::min(size, max_size);
+}
+
+void SslSocket::onRecordWritten(uint64_t bytes) {
+  if (!dynamic_record_sizing_) {
+    return;
+  }
+  last_write_time_ = callbacks_->connection().dispatcher().approximateMonotonicTime();
+  bytes_at_record_size_ += bytes;
+  if (record_size_ < MaxRecordSize && bytes_at_record_size_ >= RecordSizeStepBytes) {
+    record_size_ = std::min(record_size_ * 2, MaxRecordSize);
+    bytes_at_record_size_ = 0;
+  }
+}
+
 void SslSocket::onConnected() { ASSERT(state_ == SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -294,9 +406,14 @@ void SslSocket::shutdownSsl() {
   ASSERT(state_ != SocketState::PreHandshake);
   if (state_ != SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(ssl_);
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
+    if (kernel_tls_ != nullptr) {
+      kernel_tls_->shutdown();
+      ENVOY_CONN_LOG(debug, "kernel TLS shutdown", callbacks_->connection());
+    } else {
+      int rc = SSL_shutdown(ssl_);
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
+    }
     state_ = SocketState::ShutdownSent;
   }
 }
@@ -510,7 +627,12 @@ absl::optional<std::string> SslSocketInfo::x509Extension(absl::string_view exten
   return Utility::getX509ExtensionValue(*cert, extension_name);
 }
 
-absl::string_view SslSocket::failureReason() const { return failure_reason_; }
+absl::string_view SslSocket::failureReason() const {
+  if (kernel_tls_ != nullptr && !kernel_tls_->failureReason().empty()) {
+    return kernel_tls_->failureReason();
+  }
+  return failure_reason_;
+}
 
 const std::string& SslSocketInfo::serialNumberPeerCertificate() const {
   if (!cached_serial_number_peer_certificate_.empty()) {
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_callbacks.h"
@@ -14,6 +15,7 @@
 #include "common/common/logger.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/container/node_hash_map.h"
@@ -110,6 +112,9 @@ public:
   std::string protocol() const override;
   absl::string_view failureReason() const override;
   bool canFlushClose() override { return state_ == SocketState::HandshakeComplete; }
+  // Even once the kernel holds the record layer, the socket carries alerts and post-handshake
+  // messages along with the plaintext, which KernelTls::doRead() must handle, so it is not spliced.
+  bool passthrough() const override { return false; }
   void closeSocket(Network::ConnectionEvent close_type) override;
   Network::IoResult doRead(Buffer::Instance& read_buffer) override;
   Network::IoResult doWrite(Buffer::Instance& write_buffer, bool end_stream) override;
@@ -128,6 +133,9 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  bool installKernelTls();
+  uint64_t nextWriteSize(const Buffer::Instance& write_buffer) const;
+  void onRecordWritten(uint64_t bytes);
   void drainErrorQueue();
   void shutdownSsl();
   bool isThreadSafe() const {
@@ -138,11 +146,20 @@ private:
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
+  // Dynamic record sizing: records start small enough to fit a TCP segment, so that the peer can
+  // decrypt them as they arrive, and grow as the connection keeps writing.
+  const bool dynamic_record_sizing_;
+  uint64_t record_size_;
+  uint64_t bytes_at_record_size_{};
+  MonotonicTime last_write_time_;
   std::string failure_reason_;
   SocketState state_;
 
   SSL* ssl_;
   Ssl::ConnectionInfoConstSharedPtr info_;
+  // Set while the handshake runs if the record layer is to be offloaded to the kernel.
+  std::unique_ptr<KernelTls::Secrets> kernel_tls_secrets_;
+  KernelTlsPtr kernel_tls_;
 };
 
 class ClientSslSocketFactory : public Network::TransportSocketFactory,
@@ -132,6 +132,7 @@ protected:
       const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
       void setDelayedCloseTimeout(std::chrono::milliseconds) override {}
       absl::string_view transportFailureReason() const override { return EMPTY_STRING; }
+      Network::IoHandle* passthroughIoHandle() override { return nullptr; }
 
       SyntheticReadCallbacks& parent_;
       StreamInfo::StreamInfoImpl stream_info_;
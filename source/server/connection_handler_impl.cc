@@ -106,6 +106,12 @@ void ConnectionHandlerImpl::enableListeners() {
   }
 }
 
+bool ConnectionHandlerImpl::rejectConnection() {
+  // The fraction is applied in millionths, as for runtime fractional percents.
+  return listener_reject_fraction_ > 0 &&
+         random_.random() % 1000000 < listener_reject_fraction_ * 1000000;
+}
+
 void ConnectionHandlerImpl::ActiveTcpListener::removeConnection(ActiveTcpConnection& connection) {
   ENVOY_CONN_LOG(debug, "adding to cleanup list", *connection.connection_);
   ActiveConnections& active_connections = connection.active_connections_;
@@ -137,17 +143,16 @@ ConnectionHandlerImpl::ActiveListenerImplBase::ActiveListenerImplBase(
 
 ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerConfig& config)
-    : ActiveTcpListener(
-          parent,
-          parent.dispatcher_.createListener(config.listenSocketFactory().getListenSocket(), *this,
-                                            config.bindToPort()),
-          config) {}
+    : ActiveTcpListener(parent, config.listenSocketFactory().getListenSocket(), config) {}
 
-ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
-                                                            Network::ListenerPtr&& listener,
-                                                            Network::ListenerConfig& config)
+ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(
+    ConnectionHandlerImpl& parent, Network::SocketSharedPtr&& listen_socket,
+    Network::ListenerConfig& config)
     : ConnectionHandlerImpl::ActiveListenerImplBase(parent, &config), parent_(parent),
-      listener_(std::move(listener)), listener_filters_timeout_(config.listenerFiltersTimeout()),
+      listen_socket_(listen_socket),
+      listener_(parent.dispatcher_.createListener(std::move(listen_socket), *this,
+                                                  config.bindToPort())),
+      listener_filters_timeout_(config.listenerFiltersTimeout()),
       continue_on_listener_filters_timeout_(config.continueOnListenerFiltersTimeout()) {
   config.connectionBalancer().registerHandler(*this);
 }
@@ -155,7 +160,11 @@ ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImp
 void ConnectionHandlerImpl::ActiveTcpListener::updateListenerConfig(
     Network::ListenerConfig& config) {
   ENVOY_LOG(trace, "replacing listener ", config_->listenerTag(), " by ", config.listenerTag());
+  // The new config has its own balancer, which must know about this handler to balance the
+  // connections accepted from now on.
+  config_->connectionBalancer().unregisterHandler(*this);
   config_ = &config;
+  config_->connectionBalancer().registerHandler(*this);
 }
 
 ConnectionHandlerImpl::ActiveTcpListener::~ActiveTcpListener() {
@@ -322,6 +331,11 @@ void ConnectionHandlerImpl::ActiveTcpSocket::newConnection() {
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onAccept(Network::ConnectionSocketPtr&& socket) {
+  if (parent_.rejectConnection()) {
+    stats_.downstream_cx_overload_reject_.inc();
+    socket->close();
+    return;
+  }
   onAcceptWorker(std::move(socket), config_->handOffRestoredDestinationConnections(), false);
 }
 
@@ -332,6 +346,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
     Network::BalancedConnectionHandler& target_handler =
         config_->connectionBalancer().pickTargetHandler(*this);
     if (&target_handler != this) {
+      per_worker_stats_.downstream_cx_rebalanced_.inc();
       target_handler.post(std::move(socket));
       return;
     }
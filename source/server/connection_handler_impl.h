@@ -20,6 +20,7 @@
 
 #include "common/common/linked_object.h"
 #include "common/common/non_copyable.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "spdlog/spdlog.h"
 
@@ -28,6 +29,7 @@ namespace Server {
 
 #define ALL_LISTENER_STATS(COUNTER, GAUGE, HISTOGRAM)                                              \
   COUNTER(downstream_cx_destroy)                                                                   \
+  COUNTER(downstream_cx_overload_reject)                                                           \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_pre_cx_timeout)                                                               \
   COUNTER(no_filter_chain_match)                                                                   \
@@ -43,6 +45,7 @@ struct ListenerStats {
 };
 
 #define ALL_PER_HANDLER_LISTENER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(downstream_cx_rebalanced)                                                                \
   COUNTER(downstream_cx_total)                                                                     \
   GAUGE(downstream_cx_active, Accumulate)
 
@@ -77,6 +80,9 @@ public:
   void stopListeners() override;
   void disableListeners() override;
   void enableListeners() override;
+  void setListenerRejectFraction(float reject_fraction) override {
+    listener_reject_fraction_ = reject_fraction;
+  }
   const std::string& statPrefix() const override { return per_handler_stat_prefix_; }
 
   /**
@@ -110,7 +116,7 @@ private:
                             public Network::BalancedConnectionHandler {
   public:
     ActiveTcpListener(ConnectionHandlerImpl& parent, Network::ListenerConfig& config);
-    ActiveTcpListener(ConnectionHandlerImpl& parent, Network::ListenerPtr&& listener,
+    ActiveTcpListener(ConnectionHandlerImpl& parent, Network::SocketSharedPtr&& listen_socket,
                       Network::ListenerConfig& config);
     ~ActiveTcpListener() override;
     void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
@@ -133,6 +139,7 @@ private:
     uint64_t numConnections() const override { return num_listener_connections_; }
     void incNumConnections() override { ++num_listener_connections_; }
     void post(Network::ConnectionSocketPtr&& socket) override;
+    Network::Socket& listenSocket() override { return *listen_socket_; }
 
     /**
      * Remove and destroy an active connection.
@@ -164,6 +171,7 @@ private:
     void updateListenerConfig(Network::ListenerConfig& config);
 
     ConnectionHandlerImpl& parent_;
+    const Network::SocketSharedPtr listen_socket_;
     Network::ListenerPtr listener_;
     const std::chrono::milliseconds listener_filters_timeout_;
     const bool continue_on_listener_filters_timeout_;
@@ -314,11 +322,16 @@ private:
 
   ActiveTcpListenerOptRef findActiveTcpListenerByAddress(const Network::Address::Instance& address);
 
+  // Returns whether a newly accepted connection should be rejected to shed load.
+  bool rejectConnection();
+
   Event::Dispatcher& dispatcher_;
   const std::string per_handler_stat_prefix_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerDetails>> listeners_;
   std::atomic<uint64_t> num_handler_connections_{};
   bool disable_listeners_;
+  float listener_reject_fraction_{};
+  Runtime::RandomGeneratorImpl random_;
 };
 
 /**
@@ -135,6 +135,14 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   return response;
 }
 
+void HotRestartImpl::mergeParentTlsSessionsIfAny(Ssl::ContextManager& context_manager) {
+  std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentTlsSessions();
+  // getParentTlsSessions() returns nullptr if we have no parent, or if it does not export sessions.
+  if (wrapper_msg) {
+    as_child_.mergeParentTlsSessions(context_manager, wrapper_msg->reply().tls_sessions());
+  }
+}
+
 void HotRestartImpl::shutdown() { as_parent_.shutdown(); }
 
 std::string HotRestartImpl::version() { return hotRestartVersion(); }
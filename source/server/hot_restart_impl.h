@@ -104,6 +104,7 @@ public:
   void sendParentAdminShutdownRequest(time_t& original_start_time) override;
   void sendParentTerminateRequest() override;
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) override;
+  void mergeParentTlsSessionsIfAny(Ssl::ContextManager& context_manager) override;
   void shutdown() override;
   std::string version() override;
   Thread::BasicLockable& logLock() override { return log_lock_; }
@@ -47,6 +47,24 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   return wrapped_reply;
 }
 
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentTlsSessions() {
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return nullptr;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_tls_sessions();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  // A parent which predates TLS session handover does not recognize the request.
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kTlsSessions)) {
+    ENVOY_LOG(warn, "hot restart parent did not send its TLS sessions");
+    return nullptr;
+  }
+  return wrapped_reply;
+}
+
 void HotRestartingChild::drainParentListeners() {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return;
@@ -108,5 +126,18 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+void HotRestartingChild::mergeParentTlsSessions(
+    Ssl::ContextManager& context_manager,
+    const HotRestartMessage::Reply::TlsSessions& sessions_proto) {
+  std::vector<Ssl::ContextManager::CachedSession> sessions;
+  sessions.reserve(sessions_proto.sessions_size());
+  for (const auto& session : sessions_proto.sessions()) {
+    sessions.push_back({session.session_id_context(), session.session_id(), session.session(),
+                        std::chrono::seconds(session.ttl_seconds())});
+  }
+  context_manager.importSessions(sessions);
+  ENVOY_LOG(info, "took over {} TLS sessions from the hot restart parent", sessions.size());
+}
+
 } // namespace Server
 } // namespace Envoy
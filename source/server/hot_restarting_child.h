@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/ssl/context_manager.h"
+
 #include "common/stats/stat_merger.h"
 
 #include "server/hot_restarting_base.h"
@@ -16,11 +18,14 @@ public:
 
   int duplicateParentListenSocket(const std::string& address);
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  std::unique_ptr<envoy::HotRestartMessage> getParentTlsSessions();
   void drainParentListeners();
   void sendParentAdminShutdownRequest(time_t& original_start_time);
   void sendParentTerminateRequest();
   void mergeParentStats(Stats::Store& stats_store,
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
+  void mergeParentTlsSessions(Ssl::ContextManager& context_manager,
+                              const envoy::HotRestartMessage::Reply::TlsSessions& sessions_proto);
 
 private:
   const int restart_epoch_;
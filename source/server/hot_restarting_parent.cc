@@ -60,6 +60,13 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kTlsSessions: {
+      HotRestartMessage wrapped_reply;
+      internal_->exportTlsSessionsToChild(wrapped_reply.mutable_reply()->mutable_tls_sessions());
+      sendHotRestartMessage(child_address_, wrapped_reply);
+      break;
+    }
+
     case HotRestartMessage::Request::kDrainListeners: {
       internal_->drainListeners();
       break;
@@ -178,6 +185,17 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
   }
 }
 
+void HotRestartingParent::Internal::exportTlsSessionsToChild(
+    HotRestartMessage::Reply::TlsSessions* sessions) {
+  for (const auto& session : server_->sslContextManager().exportSessions()) {
+    HotRestartMessage::Reply::TlsSessions::Session* session_proto = sessions->add_sessions();
+    session_proto->set_session_id_context(session.session_id_context_);
+    session_proto->set_session_id(session.session_id_);
+    session_proto->set_session(session.session_);
+    session_proto->set_ttl_seconds(session.ttl_.count());
+  }
+}
+
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
 } // namespace Server
@@ -32,6 +32,9 @@ public:
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
+    // 'sessions' is a field in the reply protobuf to be sent to the child, which we should
+    // populate.
+    void exportTlsSessionsToChild(envoy::HotRestartMessage::Reply::TlsSessions* sessions);
     void drainListeners();
 
   private:
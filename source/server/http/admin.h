@@ -117,6 +117,9 @@ public:
   bool preserveExternalRequestId() const override { return false; }
   bool alwaysSetRequestIdInResponse() const override { return false; }
   absl::optional<std::chrono::milliseconds> idleTimeout() const override { return idle_timeout_; }
+  std::chrono::milliseconds overloadMinIdleTimeout() const override {
+    return std::chrono::milliseconds(0);
+  }
   bool isRoutable() const override { return false; }
   absl::optional<std::chrono::milliseconds> maxConnectionDuration() const override {
     return max_connection_duration_;
@@ -47,6 +47,7 @@ public:
   void setEndStreamOnComplete(bool end_stream) override { end_stream_on_complete_ = end_stream; }
   void addOnDestroyCallback(std::function<void()> cb) override;
   Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const override;
+  bool streamingSupported() const override { return decoder_callbacks_ != nullptr; }
   const Buffer::Instance* getRequestBody() const override;
   const Http::RequestHeaderMap& getRequestHeaders() const override;
   Http::Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override {
@@ -1,5 +1,8 @@
 #include "server/http/prometheus_stats.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "common/common/empty_string.h"
 #include "common/stats/histogram_impl.h"
 
@@ -38,57 +41,22 @@ static bool shouldShowMetric(const StatType& metric, const bool used_only,
 }
 
 /*
- * Comparator for Stats::Metric that does not require a string representation
- * to make the comparison, for memory efficiency.
- */
-struct MetricLessThan {
-  bool operator()(const Stats::Metric* a, const Stats::Metric* b) const {
-    ASSERT(&a->constSymbolTable() == &b->constSymbolTable());
-    return a->constSymbolTable().lessThan(a->statName(), b->statName());
-  }
-};
-
-/**
- * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
- * them by tag-extracted metric name, and then outputting them in the correct sorted order into
- * response.
+ * Sorts metrics by their tag-extracted names, and the metrics of each metric type by their names.
+ * The names are compared by their symbols rather than by their string representations, for memory
+ * efficiency.
  *
- * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
- * @param metrics The metrics to output stats for. This must contain all stats of the given type
- *        to be included in the same output.
- * @param generate_output A function which returns the output text for this metric.
- * @param type The name of the prometheus metric type for used in TYPE annotations.
+ * From
+ * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
+ *
+ * All lines for a given metric must be provided as one single group, with the optional HELP and
+ * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+ * expositions is preferred but not required, i.e. do not sort if the computational cost is
+ * prohibitive.
  */
-template <class StatType>
-uint64_t outputStatType(
-    Buffer::Instance& response, const bool used_only, const absl::optional<std::regex>& regex,
-    const std::vector<Stats::RefcountPtr<StatType>>& metrics,
-    const std::function<std::string(
-        const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
-    absl::string_view type) {
-
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
+template <class StatType> void sortMetrics(std::vector<Stats::RefcountPtr<StatType>>& metrics) {
   // Return early to avoid crashing when getting the symbol table from the first metric.
   if (metrics.empty()) {
-    return 0;
+    return;
   }
 
   // There should only be one symbol table for all of the stats in the admin
@@ -96,38 +64,22 @@ uint64_t outputStatType(
   // will have to change to compare to convert all StatNames to strings before
   // comparison.
   const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
-
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
-  for (const auto& metric : metrics) {
-    ASSERT(&global_symbol_table == &metric->constSymbolTable());
-
-    if (!shouldShowMetric(*metric, used_only, regex)) {
-      continue;
-    }
-
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
-  }
-
-  for (auto& group : groups) {
-    const std::string prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first));
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type));
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name));
-    }
-    response.add("\n");
-  }
-  return groups.size();
+  std::sort(metrics.begin(), metrics.end(),
+            [&global_symbol_table](const Stats::RefcountPtr<StatType>& a,
+                                   const Stats::RefcountPtr<StatType>& b) {
+              ASSERT(&global_symbol_table == &a->constSymbolTable());
+              const Stats::StatName a_name = a->tagExtractedStatName();
+              const Stats::StatName b_name = b->tagExtractedStatName();
+              if (a_name != b_name) {
+                if (global_symbol_table.lessThan(a_name, b_name)) {
+                  return true;
+                }
+                if (global_symbol_table.lessThan(b_name, a_name)) {
+                  return false;
+                }
+              }
+              return global_symbol_table.lessThan(a->statName(), b->statName());
+            });
 }
 
 /*
@@ -176,6 +128,21 @@ std::string generateHistogramOutput(const Stats::ParentHistogram& histogram,
   return output;
 };
 
+std::string generateOutput(const Stats::Counter& counter,
+                           const std::string& prefixed_tag_extracted_name) {
+  return generateNumericOutput(counter, prefixed_tag_extracted_name);
+}
+
+std::string generateOutput(const Stats::Gauge& gauge,
+                           const std::string& prefixed_tag_extracted_name) {
+  return generateNumericOutput(gauge, prefixed_tag_extracted_name);
+}
+
+std::string generateOutput(const Stats::ParentHistogram& histogram,
+                           const std::string& prefixed_tag_extracted_name) {
+  return generateHistogramOutput(histogram, prefixed_tag_extracted_name);
+}
+
 } // namespace
 
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
@@ -200,18 +167,76 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only, const absl::optional<std::regex>& regex) {
+  PrometheusStatsRenderer renderer(counters, gauges, histograms, used_only, regex,
+                                   std::numeric_limits<uint64_t>::max());
+  while (renderer.nextChunk(response)) {
+  }
+  return renderer.metricNameCount();
+}
+
+template <class StatType>
+PrometheusStatsRenderer::SortedMetrics<StatType>::SortedMetrics(
+    std::vector<Stats::RefcountPtr<StatType>>&& metrics, const bool used_only,
+    const absl::optional<std::regex>& regex)
+    : metrics_(std::move(metrics)) {
+  metrics_.erase(std::remove_if(metrics_.begin(), metrics_.end(),
+                                [used_only, &regex](const Stats::RefcountPtr<StatType>& metric) {
+                                  return !shouldShowMetric(*metric, used_only, regex);
+                                }),
+                 metrics_.end());
+  sortMetrics(metrics_);
+}
 
-  uint64_t metric_name_count = 0;
-  metric_name_count += outputStatType<Stats::Counter>(
-      response, used_only, regex, counters, generateNumericOutput<Stats::Counter>, "counter");
+template <class StatType>
+bool PrometheusStatsRenderer::SortedMetrics<StatType>::renderNext(std::string& output,
+                                                                  absl::string_view type,
+                                                                  uint64_t& metric_name_count) {
+  if (next_ == metrics_.size()) {
+    return false;
+  }
+
+  const StatType& metric = *metrics_[next_];
+  const Stats::SymbolTable& symbol_table = metric.constSymbolTable();
+  // The metrics are sorted, so a metric starts a new metric type if its tag-extracted name sorts
+  // after the one of the previous metric.
+  if (next_ == 0 || symbol_table.lessThan(metrics_[next_ - 1]->tagExtractedStatName(),
+                                          metric.tagExtractedStatName())) {
+    if (next_ != 0) {
+      output.append("\n");
+    }
+    prefixed_tag_extracted_name_ =
+        PrometheusStatsFormatter::metricName(symbol_table.toString(metric.tagExtractedStatName()));
+    output.append(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name_, type));
+    ++metric_name_count;
+  }
+  output.append(generateOutput(metric, prefixed_tag_extracted_name_));
 
-  metric_name_count += outputStatType<Stats::Gauge>(response, used_only, regex, gauges,
-                                                    generateNumericOutput<Stats::Gauge>, "gauge");
+  if (++next_ == metrics_.size()) {
+    output.append("\n");
+  }
+  return true;
+}
 
-  metric_name_count += outputStatType<Stats::ParentHistogram>(
-      response, used_only, regex, histograms, generateHistogramOutput, "histogram");
+PrometheusStatsRenderer::PrometheusStatsRenderer(
+    std::vector<Stats::CounterSharedPtr> counters, std::vector<Stats::GaugeSharedPtr> gauges,
+    std::vector<Stats::ParentHistogramSharedPtr> histograms, const bool used_only,
+    const absl::optional<std::regex>& regex, const uint64_t chunk_size)
+    : counters_(std::move(counters), used_only, regex),
+      gauges_(std::move(gauges), used_only, regex),
+      histograms_(std::move(histograms), used_only, regex), chunk_size_(chunk_size) {}
 
-  return metric_name_count;
+bool PrometheusStatsRenderer::nextChunk(Buffer::Instance& response) {
+  std::string output;
+  while (output.size() < chunk_size_) {
+    if (!counters_.renderNext(output, "counter", metric_name_count_) &&
+        !gauges_.renderNext(output, "gauge", metric_name_count_) &&
+        !histograms_.renderNext(output, "histogram", metric_name_count_)) {
+      response.add(output);
+      return false;
+    }
+  }
+  response.add(output);
+  return true;
 }
 
 } // namespace Server
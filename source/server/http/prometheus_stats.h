@@ -7,6 +7,8 @@
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/stats.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 /**
@@ -37,5 +39,52 @@ public:
   static std::string metricName(const std::string& extracted_name);
 };
 
+/**
+ * Renders the prometheus output of a set of stats in chunks of bounded size. The stats are sorted
+ * by their tag-extracted names, and then by their names, when the renderer is created. Only
+ * references to them are kept, and their output is generated as the chunks are requested.
+ */
+class PrometheusStatsRenderer {
+public:
+  PrometheusStatsRenderer(std::vector<Stats::CounterSharedPtr> counters,
+                          std::vector<Stats::GaugeSharedPtr> gauges,
+                          std::vector<Stats::ParentHistogramSharedPtr> histograms,
+                          bool used_only, const absl::optional<std::regex>& regex,
+                          uint64_t chunk_size);
+
+  /**
+   * Appends the next chunk of output to response. A chunk is closed once it holds at least
+   * chunk_size bytes, so it may exceed that by the output of a single metric.
+   * @return bool whether there is output left to render.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+  /**
+   * @return uint64_t the number of metric types rendered so far.
+   */
+  uint64_t metricNameCount() const { return metric_name_count_; }
+
+private:
+  // The sorted metrics of one stat type, and the position of the next one to render.
+  template <class StatType> struct SortedMetrics {
+    SortedMetrics(std::vector<Stats::RefcountPtr<StatType>>&& metrics, bool used_only,
+                  const absl::optional<std::regex>& regex);
+
+    // Renders the next metric into output, preceded by the TYPE annotation if it starts a new
+    // metric type. Returns false if all of the metrics have been rendered.
+    bool renderNext(std::string& output, absl::string_view type, uint64_t& metric_name_count);
+
+    std::vector<Stats::RefcountPtr<StatType>> metrics_;
+    size_t next_{};
+    std::string prefixed_tag_extracted_name_;
+  };
+
+  SortedMetrics<Stats::Counter> counters_;
+  SortedMetrics<Stats::Gauge> gauges_;
+  SortedMetrics<Stats::ParentHistogram> histograms_;
+  const uint64_t chunk_size_;
+  uint64_t metric_name_count_{};
+};
+
 } // namespace Server
 } // namespace Envoy
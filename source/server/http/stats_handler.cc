@@ -1,5 +1,12 @@
 #include "server/http/stats_handler.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "envoy/http/filter.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/html/utility.h"
 #include "common/http/headers.h"
@@ -8,11 +15,156 @@
 #include "server/http/prometheus_stats.h"
 #include "server/http/utils.h"
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
 namespace Envoy {
 namespace Server {
 
 const uint64_t RecentLookupsCapacity = 100;
 
+namespace {
+
+/*
+ * Determine whether a metric has never been emitted and choose to
+ * not show it if we only wanted used metrics.
+ */
+template <class StatType>
+bool shouldShowMetric(const StatType& metric, const bool used_only,
+                      const absl::optional<std::regex>& regex) {
+  return ((!used_only || metric.used()) &&
+          (!regex.has_value() || std::regex_search(metric.name(), regex.value())));
+}
+
+/**
+ * Removes the metrics which are not to be shown, and sorts the rest by their names.
+ */
+template <class StatType>
+void filterAndSort(std::vector<Stats::RefcountPtr<StatType>>& metrics,
+                   const Stats::SymbolTable& symbol_table, const bool used_only,
+                   const absl::optional<std::regex>& regex) {
+  metrics.erase(std::remove_if(metrics.begin(), metrics.end(),
+                               [used_only, &regex](const Stats::RefcountPtr<StatType>& metric) {
+                                 return !shouldShowMetric(*metric, used_only, regex);
+                               }),
+                metrics.end());
+  std::sort(metrics.begin(), metrics.end(),
+            [&symbol_table](const Stats::RefcountPtr<StatType>& a,
+                            const Stats::RefcountPtr<StatType>& b) {
+              return symbol_table.lessThan(a->statName(), b->statName());
+            });
+}
+
+/**
+ * Appends str to output as a JSON string.
+ */
+void appendJsonString(absl::string_view str, std::string& output) {
+  output.push_back('"');
+  for (const char c : str) {
+    switch (c) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        output.append(fmt::format("\\u{:04x}", static_cast<unsigned char>(c)));
+      } else {
+        output.push_back(c);
+      }
+    }
+  }
+  output.push_back('"');
+}
+
+/**
+ * Returns value as a JSON number, or null if it has no JSON representation.
+ */
+std::string jsonNumber(double value) {
+  return std::isfinite(value) ? fmt::format("{}", value) : "null";
+}
+
+/**
+ * Sends the remaining chunks of a response after its first chunk. A chunk is only rendered once
+ * the previous one has been handed to the connection, and rendering pauses while the downstream
+ * connection is backed up.
+ */
+class ChunkedResponse : public Http::DownstreamWatermarkCallbacks,
+                        public std::enable_shared_from_this<ChunkedResponse> {
+public:
+  ChunkedResponse(StatsHandler::ChunkRenderer render_next_chunk,
+                  Http::StreamDecoderFilterCallbacks& callbacks)
+      : render_next_chunk_(std::move(render_next_chunk)), callbacks_(callbacks) {}
+
+  void start() {
+    callbacks_.addDownstreamWatermarkCallbacks(*this);
+    scheduleNextChunk();
+  }
+
+  void onDestroy() {
+    destroyed_ = true;
+    callbacks_.removeDownstreamWatermarkCallbacks(*this);
+  }
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override { ++high_watermark_count_; }
+  void onBelowWriteBufferLowWatermark() override {
+    ASSERT(high_watermark_count_ > 0);
+    if (--high_watermark_count_ == 0) {
+      scheduleNextChunk();
+    }
+  }
+
+private:
+  // The chunk is rendered from the dispatcher, so that the first chunk has been sent by the time
+  // the second one is.
+  void scheduleNextChunk() {
+    if (scheduled_ || done_ || destroyed_) {
+      return;
+    }
+    scheduled_ = true;
+    std::weak_ptr<ChunkedResponse> weak_this = shared_from_this();
+    callbacks_.dispatcher().post([weak_this]() {
+      if (std::shared_ptr<ChunkedResponse> chunked_response = weak_this.lock()) {
+        chunked_response->sendNextChunk();
+      }
+    });
+  }
+
+  void sendNextChunk() {
+    scheduled_ = false;
+    if (destroyed_ || high_watermark_count_ > 0) {
+      return;
+    }
+    Buffer::OwnedImpl chunk;
+    done_ = !render_next_chunk_(chunk);
+    callbacks_.encodeData(chunk, done_);
+    if (high_watermark_count_ == 0) {
+      scheduleNextChunk();
+    }
+  }
+
+  const StatsHandler::ChunkRenderer render_next_chunk_;
+  Http::StreamDecoderFilterCallbacks& callbacks_;
+  uint32_t high_watermark_count_{};
+  bool scheduled_{};
+  bool done_{};
+  bool destroyed_{};
+};
+
+} // namespace
+
 Http::Code StatsHandler::handlerResetCounters(absl::string_view, Http::ResponseHeaderMap&,
                                               Buffer::Instance& response, AdminStream&,
                                               Server::Instance& server) {
@@ -81,66 +233,31 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
     return Http::Code::BadRequest;
   }
 
-  std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server.stats().counters()) {
-    if (shouldShowMetric(*counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
-    }
+  const absl::optional<std::string> format_value = Utility::formatParam(params);
+  if (format_value.has_value() && format_value.value() == "prometheus") {
+    return handlerPrometheusStats(url, response_headers, response, admin_stream, server);
   }
-
-  for (const Stats::GaugeSharedPtr& gauge : server.stats().gauges()) {
-    if (shouldShowMetric(*gauge, used_only, regex)) {
-      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-      all_stats.emplace(gauge->name(), gauge->value());
-    }
-  }
-
-  std::map<std::string, std::string> text_readouts;
-  for (const auto& text_readout : server.stats().textReadouts()) {
-    if (shouldShowMetric(*text_readout, used_only, regex)) {
-      text_readouts.emplace(text_readout->name(), text_readout->value());
-    }
+  if (format_value.has_value() && format_value.value() != "json") {
+    response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
+    response.add("\n");
+    return Http::Code::NotFound;
   }
 
-  if (const auto format_value = Utility::formatParam(params)) {
-    if (format_value.value() == "json") {
-      response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-      response.add(
-          statsAsJson(all_stats, text_readouts, server.stats().histograms(), used_only, regex));
-    } else if (format_value.value() == "prometheus") {
-      return handlerPrometheusStats(url, response_headers, response, admin_stream, server);
-    } else {
-      response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
-      response.add("\n");
-      rc = Http::Code::NotFound;
-    }
-  } else { // Display plain stats if format query param is not there.
-    for (const auto& text_readout : text_readouts) {
-      response.add(fmt::format("{}: \"{}\"\n", text_readout.first,
-                               Html::Utility::sanitize(text_readout.second)));
-    }
-    for (const auto& stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
-    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
-    // multimap here. This makes sure that duplicate histograms get output. When shared storage is
-    // implemented this can be switched back to a normal map.
-    std::multimap<std::string, std::string> all_histograms;
-    for (const Stats::ParentHistogramSharedPtr& histogram : server.stats().histograms()) {
-      if (shouldShowMetric(*histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
-      }
-    }
-    for (const auto& histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
-    }
+  StatsRenderer::Format format = StatsRenderer::Format::Text;
+  if (format_value.has_value()) {
+    response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+    format = StatsRenderer::Format::Json;
   }
-  return rc;
+  auto renderer = std::make_shared<StatsRenderer>(server.stats(), format, used_only, regex);
+  streamChunks([renderer](Buffer::Instance& chunk) { return renderer->nextChunk(chunk); },
+               response, admin_stream);
+  return Http::Code::OK;
 }
 
 Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query,
                                                 Http::ResponseHeaderMap&,
-                                                Buffer::Instance& response, AdminStream&,
+                                                Buffer::Instance& response,
+                                                AdminStream& admin_stream,
                                                 Server::Instance& server) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
@@ -148,91 +265,169 @@ Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query
   if (!Utility::filterParam(params, response, regex)) {
     return Http::Code::BadRequest;
   }
-  PrometheusStatsFormatter::statsAsPrometheus(server.stats().counters(), server.stats().gauges(),
-                                              server.stats().histograms(), response, used_only,
-                                              regex);
+  auto renderer = std::make_shared<PrometheusStatsRenderer>(
+      server.stats().counters(), server.stats().gauges(), server.stats().histograms(), used_only,
+      regex, ChunkSize);
+  streamChunks([renderer](Buffer::Instance& chunk) { return renderer->nextChunk(chunk); },
+               response, admin_stream);
   return Http::Code::OK;
 }
 
-std::string
-StatsHandler::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
-                          const std::map<std::string, std::string>& text_readouts,
-                          const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                          const bool used_only, const absl::optional<std::regex> regex,
-                          const bool pretty_print) {
-
-  ProtobufWkt::Struct document;
-  std::vector<ProtobufWkt::Value> stats_array;
-  for (const auto& text_readout : text_readouts) {
-    ProtobufWkt::Struct stat_obj;
-    auto* stat_obj_fields = stat_obj.mutable_fields();
-    (*stat_obj_fields)["name"] = ValueUtil::stringValue(text_readout.first);
-    (*stat_obj_fields)["value"] = ValueUtil::stringValue(text_readout.second);
-    stats_array.push_back(ValueUtil::structValue(stat_obj));
-  }
-  for (const auto& stat : all_stats) {
-    ProtobufWkt::Struct stat_obj;
-    auto* stat_obj_fields = stat_obj.mutable_fields();
-    (*stat_obj_fields)["name"] = ValueUtil::stringValue(stat.first);
-    (*stat_obj_fields)["value"] = ValueUtil::numberValue(stat.second);
-    stats_array.push_back(ValueUtil::structValue(stat_obj));
-  }
-
-  ProtobufWkt::Struct histograms_obj;
-  auto* histograms_obj_fields = histograms_obj.mutable_fields();
-
-  ProtobufWkt::Struct histograms_obj_container;
-  auto* histograms_obj_container_fields = histograms_obj_container.mutable_fields();
-  std::vector<ProtobufWkt::Value> computed_quantile_array;
-
-  bool found_used_histogram = false;
-  for (const Stats::ParentHistogramSharedPtr& histogram : all_histograms) {
-    if (shouldShowMetric(*histogram, used_only, regex)) {
-      if (!found_used_histogram) {
-        // It is not possible for the supported quantiles to differ across histograms, so it is ok
-        // to send them once.
+void StatsHandler::streamChunks(ChunkRenderer render_next_chunk, Buffer::Instance& response,
+                                AdminStream& admin_stream) {
+  if (!render_next_chunk(response)) {
+    return;
+  }
+  if (!admin_stream.streamingSupported()) {
+    while (render_next_chunk(response)) {
+    }
+    return;
+  }
+
+  admin_stream.setEndStreamOnComplete(false);
+  auto chunked_response = std::make_shared<ChunkedResponse>(
+      std::move(render_next_chunk), admin_stream.getDecoderFilterCallbacks());
+  // The stream holds on to the chunked response until it is destroyed.
+  admin_stream.addOnDestroyCallback([chunked_response]() { chunked_response->onDestroy(); });
+  chunked_response->start();
+}
+
+StatsRenderer::StatsRenderer(const Stats::Store& store, const Format format,
+                             const bool used_only, const absl::optional<std::regex>& regex,
+                             const uint64_t chunk_size)
+    : symbol_table_(store.constSymbolTable()), format_(format), chunk_size_(chunk_size),
+      text_readouts_(store.textReadouts()), counters_(store.counters()), gauges_(store.gauges()),
+      histograms_(store.histograms()) {
+  filterAndSort(text_readouts_, symbol_table_, used_only, regex);
+  filterAndSort(counters_, symbol_table_, used_only, regex);
+  filterAndSort(gauges_, symbol_table_, used_only, regex);
+  // See the comment in ThreadLocalStoreImpl::histograms() for why there may be histograms with
+  // the same name. All of them are rendered.
+  filterAndSort(histograms_, symbol_table_, used_only, regex);
+}
+
+bool StatsRenderer::nextChunk(Buffer::Instance& response) {
+  std::string output;
+  while (output.size() < chunk_size_ && phase_ != Phase::Done) {
+    renderNext(output);
+  }
+  response.add(output);
+  return phase_ != Phase::Done;
+}
+
+void StatsRenderer::renderNext(std::string& output) {
+  switch (phase_) {
+  case Phase::Start:
+    if (format_ == Format::Json) {
+      output.append("{\"stats\":[");
+    }
+    phase_ = Phase::TextReadouts;
+    break;
+  case Phase::TextReadouts:
+    if (next_text_readout_ < text_readouts_.size()) {
+      renderTextReadout(*text_readouts_[next_text_readout_++], output);
+    } else {
+      phase_ = Phase::CountersAndGauges;
+    }
+    break;
+  case Phase::CountersAndGauges:
+    // Counters and gauges are rendered together, in the order of their names.
+    if (next_counter_ < counters_.size() &&
+        (next_gauge_ == gauges_.size() ||
+         !symbol_table_.lessThan(gauges_[next_gauge_]->statName(),
+                                 counters_[next_counter_]->statName()))) {
+      renderNumeric(*counters_[next_counter_++], output);
+    } else if (next_gauge_ < gauges_.size()) {
+      ASSERT(gauges_[next_gauge_]->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+      renderNumeric(*gauges_[next_gauge_++], output);
+    } else {
+      if (format_ == Format::Json && !histograms_.empty()) {
+        if (json_stats_started_) {
+          output.push_back(',');
+        }
+        // It is not possible for the supported quantiles to differ across histograms, so it is
+        // ok to send them once.
         Stats::HistogramStatisticsImpl empty_statistics;
-        std::vector<ProtobufWkt::Value> supported_quantile_array;
+        std::vector<std::string> supported_quantiles;
         for (double quantile : empty_statistics.supportedQuantiles()) {
-          supported_quantile_array.push_back(ValueUtil::numberValue(quantile * 100));
+          supported_quantiles.push_back(jsonNumber(quantile * 100));
         }
-        (*histograms_obj_fields)["supported_quantiles"] =
-            ValueUtil::listValue(supported_quantile_array);
-        found_used_histogram = true;
+        output.append(absl::StrCat("{\"histograms\":{\"supported_quantiles\":[",
+                                   absl::StrJoin(supported_quantiles, ","),
+                                   "],\"computed_quantiles\":["));
       }
-
-      ProtobufWkt::Struct computed_quantile;
-      auto* computed_quantile_fields = computed_quantile.mutable_fields();
-      (*computed_quantile_fields)["name"] = ValueUtil::stringValue(histogram->name());
-
-      std::vector<ProtobufWkt::Value> computed_quantile_value_array;
-      for (size_t i = 0; i < histogram->intervalStatistics().supportedQuantiles().size(); ++i) {
-        ProtobufWkt::Struct computed_quantile_value;
-        auto* computed_quantile_value_fields = computed_quantile_value.mutable_fields();
-        const auto& interval = histogram->intervalStatistics().computedQuantiles()[i];
-        const auto& cumulative = histogram->cumulativeStatistics().computedQuantiles()[i];
-        (*computed_quantile_value_fields)["interval"] =
-            std::isnan(interval) ? ValueUtil::nullValue() : ValueUtil::numberValue(interval);
-        (*computed_quantile_value_fields)["cumulative"] =
-            std::isnan(cumulative) ? ValueUtil::nullValue() : ValueUtil::numberValue(cumulative);
-
-        computed_quantile_value_array.push_back(ValueUtil::structValue(computed_quantile_value));
+      phase_ = Phase::Histograms;
+    }
+    break;
+  case Phase::Histograms:
+    if (next_histogram_ < histograms_.size()) {
+      renderHistogram(*histograms_[next_histogram_], output);
+      ++next_histogram_;
+    } else {
+      if (format_ == Format::Json && !histograms_.empty()) {
+        output.append("]}}");
       }
-      (*computed_quantile_fields)["values"] = ValueUtil::listValue(computed_quantile_value_array);
-      computed_quantile_array.push_back(ValueUtil::structValue(computed_quantile));
+      phase_ = Phase::End;
     }
+    break;
+  case Phase::End:
+    if (format_ == Format::Json) {
+      output.append("]}");
+    }
+    phase_ = Phase::Done;
+    break;
+  case Phase::Done:
+    NOT_REACHED_GCOVR_EXCL_LINE;
   }
+}
 
-  if (found_used_histogram) {
-    (*histograms_obj_fields)["computed_quantiles"] = ValueUtil::listValue(computed_quantile_array);
-    (*histograms_obj_container_fields)["histograms"] = ValueUtil::structValue(histograms_obj);
-    stats_array.push_back(ValueUtil::structValue(histograms_obj_container));
+void StatsRenderer::renderTextReadout(const Stats::TextReadout& text_readout,
+                                      std::string& output) {
+  if (format_ == Format::Json) {
+    output.append(json_stats_started_ ? ",{\"name\":" : "{\"name\":");
+    json_stats_started_ = true;
+    appendJsonString(text_readout.name(), output);
+    output.append(",\"value\":");
+    appendJsonString(text_readout.value(), output);
+    output.push_back('}');
+  } else {
+    output.append(fmt::format("{}: \"{}\"\n", text_readout.name(),
+                              Html::Utility::sanitize(text_readout.value())));
   }
+}
 
-  auto* document_fields = document.mutable_fields();
-  (*document_fields)["stats"] = ValueUtil::listValue(stats_array);
+template <class StatType>
+void StatsRenderer::renderNumeric(const StatType& metric, std::string& output) {
+  if (format_ == Format::Json) {
+    output.append(json_stats_started_ ? ",{\"name\":" : "{\"name\":");
+    json_stats_started_ = true;
+    appendJsonString(metric.name(), output);
+    output.append(absl::StrCat(",\"value\":", metric.value(), "}"));
+  } else {
+    output.append(fmt::format("{}: {}\n", metric.name(), metric.value()));
+  }
+}
 
-  return MessageUtil::getJsonStringFromMessage(document, pretty_print, true);
+void StatsRenderer::renderHistogram(const Stats::ParentHistogram& histogram,
+                                    std::string& output) {
+  if (format_ == Format::Text) {
+    output.append(fmt::format("{}: {}\n", histogram.name(), histogram.quantileSummary()));
+    return;
+  }
+
+  if (next_histogram_ > 0) {
+    output.push_back(',');
+  }
+  output.append("{\"name\":");
+  appendJsonString(histogram.name(), output);
+  output.append(",\"values\":[");
+  const std::vector<double>& interval = histogram.intervalStatistics().computedQuantiles();
+  const std::vector<double>& cumulative = histogram.cumulativeStatistics().computedQuantiles();
+  for (size_t i = 0; i < histogram.intervalStatistics().supportedQuantiles().size(); ++i) {
+    output.append(absl::StrCat(i == 0 ? "" : ",", "{\"interval\":", jsonNumber(interval[i]),
+                               ",\"cumulative\":", jsonNumber(cumulative[i]), "}"));
+  }
+  output.append("]}");
 }
 
 } // namespace Server
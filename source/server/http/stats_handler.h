@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <regex>
 #include <string>
 
@@ -8,10 +9,12 @@
 #include "envoy/http/header_map.h"
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
+#include "envoy/stats/store.h"
 
 #include "common/stats/histogram_impl.h"
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Server {
@@ -48,22 +51,72 @@ public:
                                            Buffer::Instance& response, AdminStream&,
                                            Server::Instance& server);
 
+  /**
+   * Renders the next chunk of a response into the buffer passed to it, and returns whether there
+   * is output left to render.
+   */
+  using ChunkRenderer = std::function<bool(Buffer::Instance& response)>;
+
+  /**
+   * The size of the chunks in which the stats are rendered.
+   */
+  static constexpr uint64_t ChunkSize = 64 * 1024;
+
 private:
-  template <class StatType>
-  static bool shouldShowMetric(const StatType& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric.used()) &&
-            (!regex.has_value() || std::regex_search(metric.name(), regex.value())));
-  }
-
-  friend class AdminStatsTest;
-
-  static std::string statsAsJson(const std::map<std::string, uint64_t>& all_stats,
-                                 const std::map<std::string, std::string>& text_readouts,
-                                 const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                                 bool used_only,
-                                 const absl::optional<std::regex> regex = absl::nullopt,
-                                 bool pretty_print = false);
+  /**
+   * Renders the first chunk of a response into response. If there is more output, the remaining
+   * chunks are sent once the admin filter has sent the first one, each after the previous one has
+   * been written out, so that no more than about a chunk of output is buffered at a time. If the
+   * admin stream cannot be streamed, all of the output is rendered into response.
+   */
+  static void streamChunks(ChunkRenderer render_next_chunk, Buffer::Instance& response,
+                           AdminStream& admin_stream);
+};
+
+/**
+ * Renders the output of /stats in the plain text or JSON format in chunks of bounded size. The
+ * stats are sorted by their names when the renderer is created, comparing the names by their
+ * symbols rather than by their string representations. Only references to the stats are kept, and
+ * their output is generated as the chunks are requested.
+ */
+class StatsRenderer {
+public:
+  enum class Format { Text, Json };
+
+  StatsRenderer(const Stats::Store& store, Format format, bool used_only,
+                const absl::optional<std::regex>& regex,
+                uint64_t chunk_size = StatsHandler::ChunkSize);
+
+  /**
+   * Appends the next chunk of output to response. A chunk is closed once it holds at least
+   * chunk_size bytes, so it may exceed that by the output of a single stat.
+   * @return bool whether there is output left to render.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+private:
+  enum class Phase { Start, TextReadouts, CountersAndGauges, Histograms, End, Done };
+
+  // Renders the next stat, or the output which separates two phases, into output.
+  void renderNext(std::string& output);
+  void renderTextReadout(const Stats::TextReadout& text_readout, std::string& output);
+  template <class StatType> void renderNumeric(const StatType& metric, std::string& output);
+  void renderHistogram(const Stats::ParentHistogram& histogram, std::string& output);
+
+  const Stats::SymbolTable& symbol_table_;
+  const Format format_;
+  const uint64_t chunk_size_;
+  std::vector<Stats::TextReadoutSharedPtr> text_readouts_;
+  std::vector<Stats::CounterSharedPtr> counters_;
+  std::vector<Stats::GaugeSharedPtr> gauges_;
+  std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  Phase phase_{Phase::Start};
+  size_t next_text_readout_{};
+  size_t next_counter_{};
+  size_t next_gauge_{};
+  size_t next_histogram_{};
+  // Whether an element has been added to the JSON stats array.
+  bool json_stats_started_{};
 };
 
 } // namespace Server
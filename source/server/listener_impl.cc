@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/access_log/access_log_impl.h"
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/config/utility.h"
 #include "common/network/connection_balancer_impl.h"
@@ -263,7 +264,7 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
   if (socket_type == Network::Address::SocketType::Datagram) {
     return;
   }
-  buildSocketOptions();
+  buildSocketOptions(concurrency);
   buildOriginalDstListenerFilter();
   buildProxyProtocolListenerFilter();
   buildTlsInspectorListenerFilter();
@@ -316,7 +317,7 @@ ListenerImpl::ListenerImpl(const ListenerImpl& origin,
   validateFilterChains(socket_type);
   buildFilterChains();
   // In place update is tcp only so it's safe to apply below tcp only initialization.
-  buildSocketOptions();
+  buildSocketOptions(concurrency);
   buildOriginalDstListenerFilter();
   buildProxyProtocolListenerFilter();
   buildTlsInspectorListenerFilter();
@@ -369,6 +370,15 @@ void ListenerImpl::buildListenSocketOptions(Network::Address::SocketType socket_
     addListenSocketOptions(Network::SocketOptionFactory::buildIpPacketInfoOptions());
     // Needed to return receive buffer overflown indicator.
     addListenSocketOptions(Network::SocketOptionFactory::buildRxQueueOverFlowOptions());
+    if (config_.udp_listener_config().enable_udp_gro()) {
+      if (Api::OsSysCallsSingleton::get().supportsUdpGro()) {
+        addListenSocketOptions(Network::SocketOptionFactory::buildUdpGroOptions());
+      } else {
+        ENVOY_LOG(warn, "UDP_GRO is not supported by the kernel, listener {} receives datagrams "
+                        "one by one",
+                  name_);
+      }
+    }
   }
 }
 
@@ -429,14 +439,26 @@ void ListenerImpl::buildFilterChains() {
   filter_chain_manager_.addFilterChain(config_.filter_chains(), builder, filter_chain_manager_);
 }
 
-void ListenerImpl::buildSocketOptions() {
+void ListenerImpl::buildSocketOptions(uint32_t concurrency) {
   // TCP specific setup.
-  if (config_.has_connection_balance_config()) {
-    // Currently exact balance is the only supported type and there are no options.
-    ASSERT(config_.connection_balance_config().has_exact_balance());
+  switch (config_.connection_balance_config().balance_type_case()) {
+  case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kExactBalance:
     connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
-  } else {
+    break;
+  case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kReusePortBalance:
+    if (!config_.reuse_port()) {
+      throw EnvoyException(fmt::format("error adding listener '{}': reuse_port_balance requires "
+                                       "reuse_port to be set",
+                                       address_->asString()));
+    }
+    connection_balancer_ =
+        std::make_unique<Network::ReusePortConnectionBalancerImpl>(concurrency, listenerScope());
+    break;
+  case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::BALANCE_TYPE_NOT_SET:
     connection_balancer_ = std::make_unique<Network::NopConnectionBalancerImpl>();
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
   if (config_.has_tcp_fast_open_queue_length()) {
@@ -342,7 +342,7 @@ private:
   void createListenerFilterFactories(Network::Address::SocketType socket_type);
   void validateFilterChains(Network::Address::SocketType socket_type);
   void buildFilterChains();
-  void buildSocketOptions();
+  void buildSocketOptions(uint32_t concurrency);
   void buildOriginalDstListenerFilter();
   void buildProxyProtocolListenerFilter();
   void buildTlsInspectorListenerFilter();
@@ -118,6 +118,9 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<uint32_t> file_flush_threads("", "file-flush-threads",
+                                               "Number of threads which flush log files", false, 1,
+                                               "uint32_t", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s",
                                          "Hot restart and LDS removal drain time in seconds", false,
                                          600, "uint32_t", cmd);
@@ -242,6 +245,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  file_flush_threads_ = std::max(1U, file_flush_threads.getValue());
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
 
@@ -365,7 +369,8 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       local_address_ip_version_(Network::Address::IpVersion::v4), log_level_(log_level),
       log_format_(Logger::Logger::DEFAULT_LOG_FORMAT), log_format_escaped_(false),
       restart_epoch_(0u), service_cluster_(service_cluster), service_node_(service_node),
-      service_zone_(service_zone), file_flush_interval_msec_(10000), drain_time_(600),
+      service_zone_(service_zone), file_flush_interval_msec_(10000), file_flush_threads_(1u),
+      drain_time_(600),
       parent_shutdown_time_(900), mode_(Server::Mode::Serve), hot_restart_disabled_(false),
       signal_handling_enabled_(true), mutex_tracing_enabled_(false), cpuset_threads_(false),
       fake_symbol_table_enabled_(false) {}
@@ -1,5 +1,7 @@
 #include "server/overload_manager_impl.h"
 
+#include <algorithm>
+
 #include "envoy/config/overload/v3/overload.pb.h"
 #include "envoy/stats/scope.h"
 
@@ -28,13 +30,45 @@ public:
     return fired != isFired();
   }
 
-  bool isFired() const override { return value_.has_value() && value_ >= threshold_; }
+  double actionValue() const override { return isFired() ? 1 : 0; }
 
 private:
+  bool isFired() const { return value_.has_value() && value_ >= threshold_; }
+
   const double threshold_;
   absl::optional<double> value_;
 };
 
+class ScaledTriggerImpl : public OverloadAction::Trigger {
+public:
+  ScaledTriggerImpl(const envoy::config::overload::v3::ScaledTrigger& config)
+      : scaling_threshold_(config.scaling_threshold()),
+        saturation_threshold_(config.saturation_threshold()) {
+    if (scaling_threshold_ >= saturation_threshold_) {
+      throw EnvoyException("scaling_threshold must be less than saturation_threshold");
+    }
+  }
+
+  bool updateValue(double value) override {
+    const double action_value = action_value_;
+    if (value < scaling_threshold_) {
+      action_value_ = 0;
+    } else if (value >= saturation_threshold_) {
+      action_value_ = 1;
+    } else {
+      action_value_ = (value - scaling_threshold_) / (saturation_threshold_ - scaling_threshold_);
+    }
+    return action_value != action_value_;
+  }
+
+  double actionValue() const override { return action_value_; }
+
+private:
+  const double scaling_threshold_;
+  const double saturation_threshold_;
+  double action_value_{};
+};
+
 Stats::Counter& makeCounter(Stats::Scope& scope, absl::string_view a, absl::string_view b) {
   Stats::StatNameManagedStorage stat_name(absl::StrCat("overload.", a, ".", b),
                                           scope.symbolTable());
@@ -52,8 +86,11 @@ Stats::Gauge& makeGauge(Stats::Scope& scope, absl::string_view a, absl::string_v
 
 OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction& config,
                                Stats::Scope& stats_scope)
-    : active_gauge_(
-          makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)) {
+    : state_(OverloadActionState::inactive()),
+      active_gauge_(
+          makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)),
+      scale_percent_gauge_(makeGauge(stats_scope, config.name(), "scale_percent",
+                                     Stats::Gauge::ImportMode::NeverImport)) {
   for (const auto& trigger_config : config.triggers()) {
     TriggerPtr trigger;
 
@@ -61,6 +98,9 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction
     case envoy::config::overload::v3::Trigger::TriggerOneofCase::kThreshold:
       trigger = std::make_unique<ThresholdTriggerImpl>(trigger_config.threshold());
       break;
+    case envoy::config::overload::v3::Trigger::TriggerOneofCase::kScaled:
+      trigger = std::make_unique<ScaledTriggerImpl>(trigger_config.scaled());
+      break;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
@@ -72,30 +112,30 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction
   }
 
   active_gauge_.set(0);
+  scale_percent_gauge_.set(0);
 }
 
 bool OverloadAction::updateResourcePressure(const std::string& name, double pressure) {
-  const bool active = isActive();
-
   auto it = triggers_.find(name);
   ASSERT(it != triggers_.end());
-  if (it->second->updateValue(pressure)) {
-    if (it->second->isFired()) {
-      active_gauge_.set(1);
-      const auto result = fired_triggers_.insert(name);
-      ASSERT(result.second);
-    } else {
-      active_gauge_.set(0);
-      const auto result = fired_triggers_.erase(name);
-      ASSERT(result == 1);
-    }
+  if (!it->second->updateValue(pressure)) {
+    return false;
   }
 
-  return active != isActive();
+  double value = 0;
+  for (const auto& trigger : triggers_) {
+    value = std::max(value, trigger.second->actionValue());
+  }
+  const OverloadActionState state(value);
+  if (state == state_) {
+    return false;
+  }
+  state_ = state;
+  active_gauge_.set(state_.isSaturated() ? 1 : 0);
+  scale_percent_gauge_.set(state_.value() * 100);
+  return true;
 }
 
-bool OverloadAction::isActive() const { return !fired_triggers_.empty(); }
-
 OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::Scope& stats_scope,
                                          ThreadLocal::SlotAllocator& slot_allocator,
                                          const envoy::config::overload::v3::OverloadManager& config,
@@ -201,12 +241,15 @@ void OverloadManagerImpl::updateResourcePressure(const std::string& resource, do
                   const std::string& action = entry.second;
                   auto action_it = actions_.find(action);
                   ASSERT(action_it != actions_.end());
+                  const bool was_saturated = action_it->second.getState().isSaturated();
                   if (action_it->second.updateResourcePressure(resource, pressure)) {
-                    const bool is_active = action_it->second.isActive();
-                    const auto state =
-                        is_active ? OverloadActionState::Active : OverloadActionState::Inactive;
-                    ENVOY_LOG(info, "Overload action {} became {}", action,
-                              is_active ? "active" : "inactive");
+                    const auto state = action_it->second.getState();
+                    if (state.isSaturated() != was_saturated) {
+                      ENVOY_LOG(info, "Overload action {} became {}", action,
+                                state.isSaturated() ? "active" : "inactive");
+                    } else {
+                      ENVOY_LOG(debug, "Overload action {} scaled to {}", action, state.value());
+                    }
                     tls_->runOnAllThreads([this, action, state] {
                       tls_->getTyped<ThreadLocalOverloadState>().setState(action, state);
                     });
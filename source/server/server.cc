@@ -30,6 +30,7 @@
 #include "common/config/utility.h"
 #include "common/config/version_converter.h"
 #include "common/http/codes.h"
+#include "common/io/io_uring_worker.h"
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
@@ -71,8 +72,8 @@ InstanceImpl::InstanceImpl(
       handler_(new ConnectionHandlerImpl(*dispatcher_)),
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
       worker_factory_(thread_local_, *api_, hooks),
-      access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+      access_log_manager_(options.fileFlushIntervalMsec(), options.fileFlushThreads(), *api_,
+                          *dispatcher_, access_log_lock, store),
       terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
@@ -143,14 +144,18 @@ void InstanceImpl::failHealthcheck(bool fail) {
   server_stats_->live_.set(live_.load());
 }
 
-MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
-  snapped_counters_ = store.counters();
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store)
+    : MetricSnapshotImpl(store, store.counters(), store.gauges()) {}
+
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store,
+                                       std::vector<Stats::CounterSharedPtr>&& counters,
+                                       std::vector<Stats::GaugeSharedPtr>&& gauges)
+    : snapped_counters_(std::move(counters)), snapped_gauges_(std::move(gauges)) {
   counters_.reserve(snapped_counters_.size());
   for (const auto& counter : snapped_counters_) {
     counters_.push_back({counter->latch(), *counter});
   }
 
-  snapped_gauges_ = store.gauges();
   gauges_.reserve(snapped_gauges_.size());
   for (const auto& gauge : snapped_gauges_) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
@@ -182,6 +187,19 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
   }
 }
 
+void InstanceUtil::flushChangedMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
+                                              Stats::StoreRoot& store) {
+  // Counters only have a pending increment to latch once they changed, so latching the changed
+  // counters latches all of them, as needed by the hot restart code.
+  std::vector<Stats::CounterSharedPtr> counters;
+  std::vector<Stats::GaugeSharedPtr> gauges;
+  store.takeChangedStats(counters, gauges);
+  MetricSnapshotImpl snapshot(store, std::move(counters), std::move(gauges));
+  for (const auto& sink : sinks) {
+    sink->flush(snapshot);
+  }
+}
+
 void InstanceImpl::flushStats() {
   ENVOY_LOG(debug, "flushing stats");
   // If Envoy is not fully initialized, workers will not be started and mergeHistograms
@@ -191,7 +209,12 @@ void InstanceImpl::flushStats() {
   if (initManager().state() == Init::Manager::State::Initialized) {
     // A shutdown initiated before this callback may prevent this from being called as per
     // the semantics documented in ThreadLocal's runOnAllThreads method.
-    stats_store_.mergeHistograms([this]() -> void { flushStatsInternal(); });
+    auto merge_timer = std::make_shared<Stats::HistogramCompletableTimespanImpl>(
+        server_stats_->histogram_merge_time_ms_, timeSource());
+    stats_store_.mergeHistograms([this, merge_timer]() -> void {
+      merge_timer->complete();
+      flushStatsInternal();
+    });
   } else {
     ENVOY_LOG(debug, "Envoy is not fully initialized, skipping histogram merge and flushing stats");
     flushStatsInternal();
@@ -219,8 +242,15 @@ void InstanceImpl::updateServerStats() {
 }
 
 void InstanceImpl::flushStatsInternal() {
+  Stats::HistogramCompletableTimespanImpl flush_timer(server_stats_->stats_flush_time_ms_,
+                                                      timeSource());
   updateServerStats();
-  InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
+  if (bootstrap_.stats_config().flush_changed_stats_only()) {
+    InstanceUtil::flushChangedMetricsToSinks(config_.statsSinks(), stats_store_);
+  } else {
+    InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
+  }
+  flush_timer.complete();
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
     stat_flush_timer_->enableTimer(config_.statsFlushInterval());
@@ -312,6 +342,11 @@ void InstanceImpl::initialize(const Options& options,
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  stats_store_.setHistogramMergeThreads(api_->threadFactory(),
+                                        bootstrap_.stats_config().histogram_merge_threads());
+  if (bootstrap_.stats_config().flush_changed_stats_only()) {
+    stats_store_.trackChangedStats();
+  }
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
@@ -416,6 +451,16 @@ void InstanceImpl::initialize(const Options& options,
     dispatcher_->initializeStats(stats_store_, "server.");
   }
 
+  // Every registered thread, including the workers, gets its own io_uring instance.
+  if (bootstrap_.has_io_uring()) {
+    if (Io::IoUringFactory::isSupported()) {
+      io_uring_singleton_ = std::make_unique<Io::ScopedIoUringFactorySingleton>(
+          std::make_unique<Io::IoUringFactory>(bootstrap_.io_uring(), thread_local_));
+    } else {
+      ENVOY_LOG(warn, "io_uring is not supported on this host, using the event loop instead");
+    }
+  }
+
   // Runtime gets initialized before the main configuration since during main configuration
   // load things may grab a reference to the loader for later use.
   runtime_singleton_ = std::make_unique<Runtime::ScopedLoaderSingleton>(
@@ -485,8 +530,9 @@ void InstanceImpl::startWorkers() {
   // Update server stats as soon as initialization is done.
   updateServerStats();
   workers_started_ = true;
-  // At this point we are ready to take traffic and all listening ports are up. Notify our parent
-  // if applicable that they can stop listening and drain.
+  // At this point we are ready to take traffic and all listening ports are up. Take over the TLS
+  // sessions of our parent, then notify it if applicable that it can stop listening and drain.
+  restarter_.mergeParentTlsSessionsIfAny(sslContextManager());
   restarter_.drainParentListeners();
   drain_manager_->startParentShutdownSequence();
 }
@@ -29,6 +29,7 @@
 #include "common/grpc/context_impl.h"
 #include "common/http/context_impl.h"
 #include "common/init/manager_impl.h"
+#include "common/io/io_uring_worker.h"
 #include "common/memory/heap_shrinker.h"
 #include "common/protobuf/message_validator_impl.h"
 #include "common/runtime/runtime_impl.h"
@@ -69,7 +70,9 @@ namespace Server {
   GAUGE(total_connections, Accumulate)                                                             \
   GAUGE(uptime, Accumulate)                                                                        \
   GAUGE(version, NeverImport)                                                                      \
-  HISTOGRAM(initialization_time_ms, Milliseconds)
+  HISTOGRAM(histogram_merge_time_ms, Milliseconds)                                                 \
+  HISTOGRAM(initialization_time_ms, Milliseconds)                                                  \
+  HISTOGRAM(stats_flush_time_ms, Milliseconds)
 
 struct ServerStats {
   ALL_SERVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
@@ -112,6 +115,15 @@ public:
    */
   static void flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store);
 
+  /**
+   * Helper for flushing the counters and gauges which changed since the previous flush, along with
+   * all the histograms, to sinks. The store must be tracking changed stats.
+   * @param sinks supplies the list of sinks.
+   * @param store provides the store being flushed.
+   */
+  static void flushChangedMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
+                                         Stats::StoreRoot& store);
+
   /**
    * Load a bootstrap config and perform validation.
    * @param bootstrap supplies the bootstrap to fill.
@@ -319,6 +331,7 @@ private:
   Network::ConnectionHandlerPtr handler_;
   Runtime::RandomGeneratorPtr random_generator_;
   std::unique_ptr<Runtime::ScopedLoaderSingleton> runtime_singleton_;
+  std::unique_ptr<Io::ScopedIoUringFactorySingleton> io_uring_singleton_;
   std::unique_ptr<Ssl::ContextManager> ssl_context_manager_;
   ProdListenerComponentFactory listener_component_factory_;
   ProdWorkerFactory worker_factory_;
@@ -373,6 +386,13 @@ class MetricSnapshotImpl : public Stats::MetricSnapshot {
 public:
   explicit MetricSnapshotImpl(Stats::Store& store);
 
+  /**
+   * Snapshot of the given counters and gauges of the store, and of all its histograms and text
+   * readouts.
+   */
+  MetricSnapshotImpl(Stats::Store& store, std::vector<Stats::CounterSharedPtr>&& counters,
+                     std::vector<Stats::GaugeSharedPtr>&& gauges);
+
   // Stats::MetricSnapshot
   const std::vector<CounterSnapshot>& counters() override { return counters_; }
   const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
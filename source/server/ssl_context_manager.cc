@@ -31,6 +31,10 @@ class SslContextManagerNoTlsStub final : public Envoy::Ssl::ContextManager {
 
   Ssl::PrivateKeyMethodManager& privateKeyMethodManager() override { throwException(); }
 
+  std::vector<CachedSession> exportSessions() const override { return {}; }
+
+  void importSessions(const std::vector<CachedSession>& /* sessions */) override {}
+
 private:
   [[noreturn]] void throwException() {
     throw EnvoyException("SSL is not supported in this configuration");
@@ -1,4 +1,6 @@
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "common/access_log/access_log_manager_impl.h"
 #include "common/filesystem/file_shared_impl.h"
@@ -8,9 +10,13 @@
 #include "test/mocks/api/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/filesystem/mocks.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -31,7 +37,7 @@ class AccessLogManagerImplTest : public testing::Test {
 protected:
   AccessLogManagerImplTest()
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(timeout_40ms_, 1, api_, dispatcher_, lock_, store_) {
     EXPECT_CALL(file_system_, createFile("foo"))
         .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file_))));
 
@@ -443,6 +449,174 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+// Writes which are buffered between two flushes are written to the file with a single call.
+TEST_F(AccessLogManagerImplTest, FlushWritesTogether) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("prime-it");
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("first,second,third"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("first,");
+  log_file->write("second,");
+  log_file->write("third");
+  timer->invokeCallback();
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 2) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+
+  waitForCounterEq("filesystem.write_completed", 2);
+  EXPECT_EQ(4UL, store_.counter("filesystem.write_buffered").value());
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Writes are dropped rather than buffered once too much data is waiting to be flushed.
+TEST_F(AccessLogManagerImplTest, DropWritesBeyondBufferLimit) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.access_log_write_limit", "true"}});
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  const std::string too_big(1024 * 1024 * 64 + 1, 'a');
+  log_file->write(too_big);
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_buffered").value());
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("test"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("test");
+  timer->invokeCallback();
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Unless the limit is enabled, writes are buffered however much data is waiting to be flushed.
+TEST_F(AccessLogManagerImplTest, BufferWritesBeyondBufferLimitByDefault) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  const std::string too_big(1024 * 1024 * 64 + 1, 'a');
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write(too_big);
+  log_file->write("test");
+  timer->invokeCallback();
+  log_file->flush();
+
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Writes from several threads are flushed in the order in which they arrived.
+TEST_F(AccessLogManagerImplTest, FlushWritesInArrivalOrder) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        written.append(data.data(), data.size());
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  // The writes are numbered in the order in which they are made, across all of the threads.
+  const uint32_t num_threads = 4;
+  const uint32_t num_writes = 100;
+  Thread::MutexBasicLockable sequence_lock;
+  uint32_t sequence = 0;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.push_back(thread_factory_.createThread([&]() -> void {
+      for (uint32_t j = 0; j < num_writes; j++) {
+        Thread::LockGuard lock(sequence_lock);
+        log_file->write(absl::StrCat(sequence++, "\n"));
+      }
+    }));
+  }
+  for (const Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  uint32_t next_write = 0;
+  for (absl::string_view line : absl::StrSplit(written, '\n', absl::SkipEmpty())) {
+    uint32_t write_index;
+    ASSERT_TRUE(absl::SimpleAtoi(line, &write_index));
+    EXPECT_EQ(next_write++, write_index);
+  }
+  EXPECT_EQ(num_threads * num_writes, next_write);
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// A file may outlive the manager which created it, and is still flushed.
+TEST_F(AccessLogManagerImplTest, FileOutlivesManager) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  auto access_log_manager = std::make_unique<AccessLogManagerImpl>(timeout_40ms_, 1, api_,
+                                                                   dispatcher_, lock_, store_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager->createAccessLog("foo");
+  access_log_manager.reset();
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("test"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("test");
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  log_file.reset();
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_completed").value());
+}
+
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
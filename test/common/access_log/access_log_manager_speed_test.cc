@@ -0,0 +1,151 @@
+// Compares writing to access log files through AccessLogFileImpl, which flushes on threads shared
+// by all files with a single writev() per flush, to the previous design, where every file has a
+// flush thread of its own which writes the buffered data slice by slice.
+
+#include "common/access_log/access_log_manager_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/common/lock_guard.h"
+#include "common/common/thread.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+const std::string& logLine() { CONSTRUCT_ON_FIRST_USE(std::string, std::string(200, 'a') + "\n"); }
+
+// The write path of the previous AccessLogFileImpl.
+class LockedBufferFile {
+public:
+  LockedBufferFile(Filesystem::FilePtr&& file, Thread::ThreadFactory& thread_factory)
+      : file_(std::move(file)) {
+    file_->open(1 << Filesystem::File::Operation::Write | 1 << Filesystem::File::Operation::Append);
+    flush_thread_ = thread_factory.createThread([this]() -> void { flushThreadFunc(); });
+  }
+
+  ~LockedBufferFile() {
+    {
+      Thread::LockGuard lock(write_lock_);
+      flush_thread_exit_ = true;
+      flush_event_.notifyOne();
+    }
+    flush_thread_->join();
+  }
+
+  void write(absl::string_view data) {
+    Thread::LockGuard lock(write_lock_);
+    flush_buffer_.add(data.data(), data.size());
+    if (flush_buffer_.length() > MinFlushSize) {
+      flush_event_.notifyOne();
+    }
+  }
+
+private:
+  void flushThreadFunc() {
+    while (true) {
+      Buffer::OwnedImpl about_to_write;
+      {
+        Thread::LockGuard lock(write_lock_);
+        while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
+          flush_event_.wait(write_lock_);
+        }
+        if (flush_thread_exit_) {
+          return;
+        }
+        about_to_write.move(flush_buffer_);
+      }
+
+      for (const Buffer::RawSlice& slice : about_to_write.getRawSlices()) {
+        file_->write(absl::string_view(static_cast<char*>(slice.mem_), slice.len_));
+      }
+    }
+  }
+
+  static constexpr uint64_t MinFlushSize = 1024 * 64;
+
+  Filesystem::FilePtr file_;
+  Thread::MutexBasicLockable write_lock_;
+  Thread::CondVar flush_event_;
+  Thread::ThreadPtr flush_thread_;
+  bool flush_thread_exit_ ABSL_GUARDED_BY(write_lock_){};
+  Buffer::OwnedImpl flush_buffer_ ABSL_GUARDED_BY(write_lock_);
+};
+
+struct SharedFlusherContext {
+  SharedFlusherContext(uint32_t num_files)
+      : api_(Api::createApiForTest(stats_store_)), dispatcher_(api_->allocateDispatcher("test")),
+        access_log_manager_(std::chrono::milliseconds(1000), 1, *api_, *dispatcher_, lock_,
+                            stats_store_) {
+    for (uint32_t i = 0; i < num_files; i++) {
+      // Every file gets a name of its own, which refers to the same file.
+      files_.push_back(access_log_manager_.createAccessLog(std::string(i + 1, '/') + "dev/null"));
+    }
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::MutexBasicLockable lock_;
+  AccessLog::AccessLogManagerImpl access_log_manager_;
+  std::vector<AccessLog::AccessLogFileSharedPtr> files_;
+};
+
+struct LockedBufferContext {
+  LockedBufferContext(uint32_t num_files) : api_(Api::createApiForTest()) {
+    for (uint32_t i = 0; i < num_files; i++) {
+      files_.push_back(std::make_unique<LockedBufferFile>(
+          api_->fileSystem().createFile("/dev/null"), api_->threadFactory()));
+    }
+  }
+
+  Api::ApiPtr api_;
+  std::vector<std::unique_ptr<LockedBufferFile>> files_;
+};
+
+std::unique_ptr<SharedFlusherContext> shared_flusher_context;
+std::unique_ptr<LockedBufferContext> locked_buffer_context;
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SharedFlusherWrite(benchmark::State& state) {
+  const uint32_t num_files = state.range(0);
+  if (state.thread_index == 0) {
+    shared_flusher_context = std::make_unique<SharedFlusherContext>(num_files);
+  }
+
+  uint32_t file_index = state.thread_index;
+  for (auto _ : state) {
+    shared_flusher_context->files_[file_index++ % num_files]->write(logLine());
+  }
+  state.SetBytesProcessed(state.iterations() * logLine().size());
+
+  if (state.thread_index == 0) {
+    shared_flusher_context.reset();
+  }
+}
+BENCHMARK(BM_SharedFlusherWrite)->Arg(1)->Arg(40)->ThreadRange(1, 32)->UseRealTime();
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LockedBufferWrite(benchmark::State& state) {
+  const uint32_t num_files = state.range(0);
+  if (state.thread_index == 0) {
+    locked_buffer_context = std::make_unique<LockedBufferContext>(num_files);
+  }
+
+  uint32_t file_index = state.thread_index;
+  for (auto _ : state) {
+    locked_buffer_context->files_[file_index++ % num_files]->write(logLine());
+  }
+  state.SetBytesProcessed(state.iterations() * logLine().size());
+
+  if (state.thread_index == 0) {
+    locked_buffer_context.reset();
+  }
+}
+BENCHMARK(BM_LockedBufferWrite)->Arg(1)->Arg(40)->ThreadRange(1, 32)->UseRealTime();
+
+} // namespace Envoy
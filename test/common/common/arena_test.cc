@@ -0,0 +1,79 @@
+#include <cstdint>
+
+#include "common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+struct Tracked {
+  Tracked(int& destroyed) : destroyed_(destroyed) {}
+  ~Tracked() { destroyed_++; }
+
+  int& destroyed_;
+};
+
+TEST(ArenaTest, AllocateFromBlock) {
+  Arena arena(256);
+  EXPECT_EQ(0, arena.blocks());
+
+  void* first = arena.allocate(10);
+  void* second = arena.allocate(10);
+  EXPECT_EQ(1, arena.blocks());
+  EXPECT_EQ(2, arena.allocations());
+  EXPECT_EQ(20, arena.bytesAllocated());
+  EXPECT_NE(first, second);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % alignof(std::max_align_t));
+}
+
+TEST(ArenaTest, Alignment) {
+  Arena arena(256);
+  arena.allocate(1, 1);
+  void* aligned = arena.allocate(8, 8);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 8);
+  EXPECT_EQ(1, arena.blocks());
+}
+
+TEST(ArenaTest, NewBlockWhenFull) {
+  Arena arena(64);
+  arena.allocate(48);
+  arena.allocate(48);
+  EXPECT_EQ(2, arena.blocks());
+}
+
+TEST(ArenaTest, OversizedAllocation) {
+  Arena arena(64);
+  void* small = arena.allocate(16);
+  void* large = arena.allocate(1024);
+  EXPECT_NE(nullptr, large);
+  EXPECT_EQ(2, arena.blocks());
+
+  // The oversized allocation does not use up the current block.
+  void* next = arena.allocate(16);
+  EXPECT_EQ(2, arena.blocks());
+  EXPECT_NE(small, next);
+}
+
+TEST(ArenaTest, MakeArenaPtr) {
+  int destroyed = 0;
+  Arena arena;
+  {
+    ArenaPtr<Tracked> object = makeArenaPtr<Tracked>(&arena, destroyed);
+    EXPECT_EQ(1, arena.allocations());
+    EXPECT_EQ(sizeof(Tracked), arena.bytesAllocated());
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+TEST(ArenaTest, MakeArenaPtrWithoutArena) {
+  int destroyed = 0;
+  {
+    ArenaPtr<Tracked> object = makeArenaPtr<Tracked>(nullptr, destroyed);
+    EXPECT_NE(nullptr, object);
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+} // namespace
+} // namespace Envoy
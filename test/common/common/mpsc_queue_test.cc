@@ -0,0 +1,99 @@
+#include <memory>
+#include <vector>
+
+#include "common/common/mpsc_queue.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(MpscQueueTest, Empty) {
+  MpscQueue<int> queue;
+  int value;
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(MpscQueueTest, Fifo) {
+  MpscQueue<int> queue;
+  int value;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      queue.push(i);
+    }
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(queue.pop(value));
+      EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.pop(value));
+  }
+}
+
+// A queue which reuses the nodes of a destroyed queue starts empty.
+TEST(MpscQueueTest, ReuseNodes) {
+  for (int round = 0; round < 3; ++round) {
+    MpscQueue<int> queue;
+    int value;
+    EXPECT_FALSE(queue.pop(value));
+    queue.push(1);
+    queue.push(2);
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(1, value);
+  }
+}
+
+// Values are released once popped, and the values left in the queue once it is destroyed.
+TEST(MpscQueueTest, ReleaseValues) {
+  auto first = std::make_shared<int>(1);
+  auto second = std::make_shared<int>(2);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.push(first);
+    queue.push(second);
+    EXPECT_EQ(2, first.use_count());
+    {
+      std::shared_ptr<int> value;
+      ASSERT_TRUE(queue.pop(value));
+      EXPECT_EQ(first, value);
+    }
+    EXPECT_EQ(1, first.use_count());
+    EXPECT_EQ(2, second.use_count());
+  }
+  EXPECT_EQ(1, second.use_count());
+}
+
+// Values pushed concurrently from several threads are all popped, in the order in which each
+// thread pushed them, while the consumer pops concurrently.
+TEST(MpscQueueTest, MultipleProducers) {
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t num_values = 100000;
+  MpscQueue<std::pair<uint32_t, uint32_t>> queue;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&queue, i]() {
+      for (uint32_t j = 0; j < num_values; ++j) {
+        queue.push({i, j});
+      }
+    }));
+  }
+
+  std::vector<uint32_t> next(num_threads);
+  std::pair<uint32_t, uint32_t> value;
+  for (uint32_t popped = 0; popped < num_threads * num_values;) {
+    if (queue.pop(value)) {
+      ASSERT_EQ(next[value.first]++, value.second);
+      ++popped;
+    }
+  }
+  EXPECT_FALSE(queue.pop(value));
+
+  for (auto& thread : threads) {
+    thread->join();
+  }
+}
+
+} // namespace
+} // namespace Envoy
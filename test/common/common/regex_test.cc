@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
 
@@ -73,6 +75,34 @@ TEST(Utility, ParseRegex) {
   }
 }
 
+TEST(Utility, ParseRegexSet) {
+  const auto make_matcher = [](const std::string& regex) {
+    envoy::type::matcher::v3::RegexMatcher matcher;
+    matcher.mutable_google_re2();
+    matcher.set_regex(regex);
+    return matcher;
+  };
+
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegexSet({make_matcher("/a"), make_matcher("(+invalid)")}),
+                          EnvoyException, "invalid regex '\\(\\+invalid\\)': .+");
+
+  const auto set = Utility::parseRegexSet(
+      {make_matcher("/users/[0-9]+"), make_matcher("/users/.*"), make_matcher("/static/.*")});
+  std::vector<int> matches;
+  EXPECT_TRUE(set->match("/users/123", matches));
+  std::sort(matches.begin(), matches.end());
+  EXPECT_EQ((std::vector<int>{0, 1}), matches);
+
+  // Expressions must match the entire value.
+  matches.clear();
+  EXPECT_TRUE(set->match("/prefix/static/app.js", matches));
+  EXPECT_TRUE(matches.empty());
+
+  matches.clear();
+  EXPECT_TRUE(set->match("/static/app.js", matches));
+  EXPECT_EQ((std::vector<int>{2}), matches);
+}
+
 } // namespace
 } // namespace Regex
 } // namespace Envoy
@@ -0,0 +1,55 @@
+// Measures the throughput of Dispatcher::post() with a number of threads posting callbacks
+// concurrently to a single dispatcher.
+
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/event/dispatcher_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DispatcherPost(benchmark::State& state) {
+  const uint64_t num_producers = state.range(0);
+  constexpr uint64_t num_posts = 10000;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  Thread::ThreadPtr dispatcher_thread = api->threadFactory().createThread(
+      [&dispatcher]() { dispatcher->run(Dispatcher::RunType::RunUntilExit); });
+
+  for (auto _ : state) {
+    // Only accessed from the dispatcher thread.
+    uint64_t num_run = 0;
+    absl::Notification done;
+    std::vector<Thread::ThreadPtr> producers;
+    for (uint64_t i = 0; i < num_producers; ++i) {
+      producers.push_back(api->threadFactory().createThread([&]() {
+        for (uint64_t j = 0; j < num_posts; ++j) {
+          dispatcher->post([&]() {
+            if (++num_run == num_producers * num_posts) {
+              done.Notify();
+            }
+          });
+        }
+      }));
+    }
+    for (auto& producer : producers) {
+      producer->join();
+    }
+    done.WaitForNotification();
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers * num_posts);
+
+  dispatcher->exit();
+  dispatcher_thread->join();
+}
+BENCHMARK(BM_DispatcherPost)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond);
+
+} // namespace Event
+} // namespace Envoy
@@ -86,6 +86,34 @@ TEST(DeferredTaskTest, DeferredTask) {
   dispatcher->clearDeferredDeleteList();
 }
 
+// Once stats are initialized, the deferred delete batch sizes and the time callbacks wait after
+// being posted are recorded.
+TEST(DispatcherStatsTest, DeferredDeleteAndPostWait) {
+  NiceMock<Stats::MockStore> store;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+  dispatcher->initializeStats(store, "test.");
+  // The stats are created by a posted callback.
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _)).Times(testing::AnyNumber());
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         testing::Property(&Stats::Metric::name,
+                                           "test.dispatcher.deferred_delete_batch_size"),
+                         2));
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(
+                  testing::Property(&Stats::Metric::name, "test.dispatcher.post_wait_us"), _));
+
+  ReadyWatcher watcher;
+  dispatcher->deferredDelete(DeferredDeletablePtr{new TestDeferredDeletable([]() -> void {})});
+  dispatcher->deferredDelete(DeferredDeletablePtr{new TestDeferredDeletable([]() -> void {})});
+  dispatcher->clearDeferredDeleteList();
+  dispatcher->post([&watcher]() -> void { watcher.ready(); });
+  EXPECT_CALL(watcher, ready());
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+}
+
 class DispatcherImplTest : public testing::Test {
 protected:
   DispatcherImplTest()
@@ -147,10 +175,16 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_batch_size",
+                                Stats::Histogram::Unit::Unspecified));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.poll_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.poll_ready_events", Stats::Histogram::Unit::Unspecified));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_wait_us", Stats::Histogram::Unit::Microseconds));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
@@ -169,6 +203,48 @@ TEST_F(DispatcherImplTest, Post) {
   }
 }
 
+// Callbacks posted concurrently from several threads are all run, in the order in which each
+// thread posted them.
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t num_posts = 10000;
+  // Only accessed from the dispatcher thread.
+  std::vector<std::vector<uint32_t>> posted(num_threads);
+  uint32_t num_run = 0;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(api_->threadFactory().createThread([&, i]() {
+      for (uint32_t j = 0; j < num_posts; ++j) {
+        dispatcher_->post([&, i, j]() {
+          posted[i].push_back(j);
+          if (++num_run == num_threads * num_posts) {
+            {
+              Thread::LockGuard lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notifyOne();
+          }
+        });
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  for (const auto& values : posted) {
+    ASSERT_EQ(num_posts, values.size());
+    for (uint32_t j = 0; j < num_posts; ++j) {
+      EXPECT_EQ(j, values[j]);
+    }
+  }
+}
+
 // Ensure that there is no deadlock related to calling a posted callback, or
 // destructing a closure when finished calling it.
 TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
@@ -186,8 +262,8 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
-    // or else this would deadlock.
+    // This also ensures that no lock is held while callbacks are called, or else this would
+    // deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
 
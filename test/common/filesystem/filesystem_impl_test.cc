@@ -1,11 +1,14 @@
 #include <chrono>
 #include <string>
+#include <vector>
 
 #include "common/common/assert.h"
 #include "common/filesystem/filesystem_impl.h"
 
 #include "test/test_common/environment.h"
 
+#include "absl/strings/str_cat.h"
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -293,6 +296,43 @@ TEST_F(FileSystemImplTest, NonExistingFile) {
   EXPECT_EQ(" new data", contents);
 }
 
+TEST_F(FileSystemImplTest, Writev) {
+  const std::string new_file_path = TestEnvironment::temporaryPath("envoy_this_not_exist");
+  ::unlink(new_file_path.c_str());
+
+  // More slices than a single writev() call accepts.
+  std::vector<std::string> lines;
+  std::string expected;
+  for (uint32_t i = 0; i < 2000; i++) {
+    lines.push_back(absl::StrCat("line ", i, "\n"));
+    expected += lines.back();
+  }
+  const std::vector<absl::string_view> slices(lines.begin(), lines.end());
+
+  {
+    FilePtr file = file_system_.createFile(new_file_path);
+    const Api::IoCallBoolResult open_result = file->open(DefaultFlags);
+    EXPECT_TRUE(open_result.rc_);
+    const Api::IoCallSizeResult result = file->writev(slices.data(), slices.size());
+    EXPECT_EQ(expected.length(), result.rc_);
+  }
+
+  EXPECT_EQ(expected, TestEnvironment::readFileToStringForTest(new_file_path));
+}
+
+TEST_F(FileSystemImplTest, WritevAfterClose) {
+  const std::string new_file_path = TestEnvironment::temporaryPath("envoy_this_not_exist");
+  ::unlink(new_file_path.c_str());
+
+  FilePtr file = file_system_.createFile(new_file_path);
+  EXPECT_TRUE(file->open(DefaultFlags).rc_);
+  EXPECT_TRUE(file->close().rc_);
+  const absl::string_view slices[] = {" new", " data"};
+  const Api::IoCallSizeResult result = file->writev(slices, 2);
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ("Bad file descriptor", result.err_->getErrorDetails());
+}
+
 TEST_F(FileSystemImplTest, Close) {
   const std::string new_file_path = TestEnvironment::temporaryPath("envoy_this_not_exist");
   ::unlink(new_file_path.c_str());
@@ -46,6 +46,7 @@
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
 
 #include "gmock/gmock.h"
@@ -297,6 +298,9 @@ public:
   uint32_t maxRequestHeadersKb() const override { return max_request_headers_kb_; }
   uint32_t maxRequestHeadersCount() const override { return max_request_headers_count_; }
   absl::optional<std::chrono::milliseconds> idleTimeout() const override { return idle_timeout_; }
+  std::chrono::milliseconds overloadMinIdleTimeout() const override {
+    return overload_min_idle_timeout_;
+  }
   bool isRoutable() const override { return true; }
   absl::optional<std::chrono::milliseconds> maxConnectionDuration() const override {
     return max_connection_duration_;
@@ -382,6 +386,7 @@ public:
   uint32_t max_request_headers_kb_{Http::DEFAULT_MAX_REQUEST_HEADERS_KB};
   uint32_t max_request_headers_count_{Http::DEFAULT_MAX_HEADERS_COUNT};
   absl::optional<std::chrono::milliseconds> idle_timeout_;
+  std::chrono::milliseconds overload_min_idle_timeout_{};
   absl::optional<std::chrono::milliseconds> max_connection_duration_;
   std::chrono::milliseconds stream_idle_timeout_{};
   std::chrono::milliseconds request_timeout_{};
@@ -485,6 +490,48 @@ TEST_F(HttpConnectionManagerImplTest, HeaderOnlyRequestAndResponse) {
   EXPECT_EQ(1U, listener_stats_.downstream_rq_completed_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, StreamArena) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http_stream_arena", "true"}});
+  setup(false, "envoy-custom-server", false);
+
+  std::shared_ptr<MockStreamDecoderFilter> decoder_filter(
+      new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamEncoderFilter> encoder_filter(
+      new NiceMock<MockStreamEncoderFilter>());
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*encoder_filter, encodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(decoder_filter);
+        callbacks.addStreamEncoderFilter(encoder_filter);
+      }));
+
+  NiceMock<MockResponseEncoder> encoder;
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance& data) -> void {
+    RequestDecoder* decoder = &conn_manager_->newStream(encoder);
+    RequestHeaderMapPtr headers{new TestRequestHeaderMapImpl{
+        {":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+
+    ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+    decoder_filter->callbacks_->encodeHeaders(std::move(response_headers), true);
+    data.drain(4);
+  }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+
+  // Both filter wrappers are placed in a single arena block.
+  EXPECT_EQ(2U, stats_.named_.downstream_rq_arena_allocations_.value());
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_arena_blocks_.value());
+  EXPECT_NE(0U, stats_.named_.downstream_rq_arena_bytes_.value());
+}
+
 TEST_F(HttpConnectionManagerImplTest, 100ContinueResponse) {
   proxy_100_continue_ = true;
   setup(false, "envoy-custom-server", false);
@@ -3064,6 +3111,59 @@ TEST_F(HttpConnectionManagerImplTest, IdleTimeout) {
   EXPECT_EQ(1U, stats_.named_.downstream_cx_idle_timeout_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, IdleTimeoutReducedWhenOverloaded) {
+  // Not used in the test.
+  delete codec_;
+
+  overload_manager_.overload_state_.setState(Server::OverloadActionNames::get().ReduceTimeouts,
+                                             Server::OverloadActionState(0.5));
+  idle_timeout_ = (std::chrono::milliseconds(10));
+  Event::MockTimer* idle_timer = setUpTimer();
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(5), _));
+  setup(false, "");
+
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(*idle_timer, disableTimer());
+  idle_timer->invokeCallback();
+
+  EXPECT_EQ(1U, stats_.named_.downstream_cx_idle_timeout_.value());
+}
+
+// A saturated reduce timeouts action shortens the idle timeout to the configured minimum rather
+// than to 0.
+TEST_F(HttpConnectionManagerImplTest, IdleTimeoutClampedWhenSaturated) {
+  // Not used in the test.
+  delete codec_;
+
+  overload_manager_.overload_state_.setState(Server::OverloadActionNames::get().ReduceTimeouts,
+                                             Server::OverloadActionState::saturated());
+  idle_timeout_ = (std::chrono::milliseconds(10000));
+  overload_min_idle_timeout_ = std::chrono::milliseconds(1000);
+  Event::MockTimer* idle_timer = setUpTimer();
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  setup(false, "");
+
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(*idle_timer, disableTimer());
+  idle_timer->invokeCallback();
+
+  EXPECT_EQ(1U, stats_.named_.downstream_cx_idle_timeout_.value());
+}
+
+// An idle timeout shorter than the minimum is not lengthened by the reduce timeouts action.
+TEST_F(HttpConnectionManagerImplTest, IdleTimeoutShorterThanMinimumWhenOverloaded) {
+  // Not used in the test.
+  delete codec_;
+
+  overload_manager_.overload_state_.setState(Server::OverloadActionNames::get().ReduceTimeouts,
+                                             Server::OverloadActionState::saturated());
+  idle_timeout_ = (std::chrono::milliseconds(10));
+  overload_min_idle_timeout_ = std::chrono::milliseconds(1000);
+  Event::MockTimer* idle_timer = setUpTimer();
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(10), _));
+  setup(false, "");
+}
+
 TEST_F(HttpConnectionManagerImplTest, ConnectionDurationNoCodec) {
   // Not used in the test.
   delete codec_;
@@ -4964,7 +5064,7 @@ TEST_F(HttpConnectionManagerImplTest, NoNewStreamWhenOverloaded) {
 
   overload_manager_.overload_state_.setState(
       Server::OverloadActionNames::get().StopAcceptingRequests,
-      Server::OverloadActionState::Active);
+      Server::OverloadActionState::saturated());
 
   EXPECT_CALL(*codec_, dispatch(_)).WillRepeatedly(Invoke([&](Buffer::Instance&) -> void {
     RequestDecoder* decoder = &conn_manager_->newStream(response_encoder_);
@@ -4992,7 +5092,8 @@ TEST_F(HttpConnectionManagerImplTest, DisableKeepAliveWhenOverloaded) {
   setup(false, "");
 
   overload_manager_.overload_state_.setState(
-      Server::OverloadActionNames::get().DisableHttpKeepAlive, Server::OverloadActionState::Active);
+      Server::OverloadActionNames::get().DisableHttpKeepAlive,
+      Server::OverloadActionState::saturated());
 
   std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
   EXPECT_CALL(filter_factory_, createFilterChain(_))
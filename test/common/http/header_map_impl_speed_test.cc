@@ -1,7 +1,21 @@
+#include "envoy/config/core/v3/protocol.pb.h"
+
+#include "common/buffer/buffer_impl.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http2/codec_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
 namespace Envoy {
 namespace Http {
 
@@ -220,5 +234,204 @@ static void HeaderMapImplPopulate(benchmark::State& state) {
 }
 BENCHMARK(HeaderMapImplPopulate);
 
+/**
+ * Build a request with a typical mix of pseudo, O(1) and custom headers.
+ * @param num_custom_headers the number of custom (non O(1)) headers to add in addition to the
+ *        fixed set of 12 headers.
+ */
+static std::vector<std::pair<std::string, std::string>>
+makeRequestHeaders(size_t num_custom_headers) {
+  std::vector<std::pair<std::string, std::string>> headers = {
+      {":method", "GET"},
+      {":path", "/api/v1/resources/12345?include=details&format=json"},
+      {":scheme", "http"},
+      {":authority", "www.example.com"},
+      {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 Chrome/81.0"},
+      {"accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"},
+      {"accept-encoding", "gzip, deflate, br"},
+      {"accept-language", "en-US,en;q=0.9"},
+      {"cache-control", "no-cache"},
+      {"cookie", "session=8f3c2a7be1d94e2c; theme=dark; tracking=off"},
+      {"x-forwarded-for", "10.0.0.1"},
+      {"x-request-id", "a9c5f5d2-4b8e-4f5e-9a5d-3c2b1a0f9e8d"},
+  };
+  for (size_t i = 0; i < num_custom_headers; i++) {
+    headers.emplace_back(absl::StrCat("x-custom-header-", i), absl::StrCat("custom value ", i));
+  }
+  return headers;
+}
+
+/**
+ * Measure populating a request header map the way the codecs do, then iterating over it once and
+ * destroying it. The numeric Arg is the total number of headers in the request.
+ */
+static void HeaderMapImplPopulateRequest(benchmark::State& state) {
+  const auto headers_to_add = makeRequestHeaders(state.range(0) - 12);
+  size_t total = 0;
+  for (auto _ : state) {
+    RequestHeaderMapImpl headers;
+    for (const auto& key_value : headers_to_add) {
+      HeaderString key;
+      key.setCopy(key_value.first);
+      HeaderString value;
+      value.setCopy(key_value.second);
+      headers.addViaMove(std::move(key), std::move(value));
+    }
+    headers.iterate(
+        [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+          *static_cast<size_t*>(context) += header.value().size();
+          return HeaderMap::Iterate::Continue;
+        },
+        &total);
+  }
+  benchmark::DoNotOptimize(total);
+}
+BENCHMARK(HeaderMapImplPopulateRequest)->Arg(20)->Arg(30)->Arg(40);
+
+/**
+ * Request decoder which answers every request with a fixed set of response headers, so that a
+ * benchmark iteration covers request header decoding and response header encoding.
+ */
+class ReplyingRequestDecoder : public RequestDecoder {
+public:
+  void setEncoder(ResponseEncoder& encoder) { encoder_ = &encoder; }
+
+  // RequestDecoder
+  void decodeHeaders(RequestHeaderMapPtr&& headers, bool end_stream) override {
+    ASSERT(end_stream);
+    header_count_ += headers->size();
+    auto response_headers = std::make_unique<ResponseHeaderMapImpl>();
+    response_headers->setStatus(200);
+    response_headers->setReferenceContentType("application/json");
+    response_headers->setReferenceServer("envoy");
+    response_headers->addReference(cache_control_, "private, max-age=0");
+    response_headers->addReference(vary_, "accept-encoding");
+    encoder_->encodeHeaders(*response_headers, true);
+  }
+  void decodeTrailers(RequestTrailerMapPtr&&) override {}
+  void decodeData(Buffer::Instance&, bool) override {}
+  void decodeMetadata(MetadataMapPtr&&) override {}
+
+  uint64_t header_count_{};
+
+private:
+  const LowerCaseString cache_control_{"cache-control"};
+  const LowerCaseString vary_{"vary"};
+  ResponseEncoder* encoder_{};
+};
+
+/**
+ * Measure decoding a request with a realistic number of headers through the HTTP/1 server codec
+ * and encoding the response headers. The numeric Arg is the number of request headers.
+ */
+static void HeaderMapImplHttp1CodecRoundTrip(benchmark::State& state) {
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  ReplyingRequestDecoder decoder;
+  ON_CALL(callbacks, newStream(_, _))
+      .WillByDefault(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        decoder.setEncoder(encoder);
+        return decoder;
+      }));
+  ON_CALL(connection, write(_, _)).WillByDefault(Invoke([](Buffer::Instance& data, bool) {
+    data.drain(data.length());
+  }));
+  Http1::ServerConnectionImpl codec(connection, stats_store, callbacks, Http1Settings(),
+                                    Http::DEFAULT_MAX_REQUEST_HEADERS_KB,
+                                    Http::DEFAULT_MAX_HEADERS_COUNT,
+                                    envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+
+  std::string request = "GET /api/v1/resources/12345?include=details&format=json HTTP/1.1\r\n";
+  for (const auto& header : makeRequestHeaders(state.range(0) - 3)) {
+    if (header.first[0] != ':') {
+      absl::StrAppend(&request, header.first, ": ", header.second, "\r\n");
+    }
+  }
+  absl::StrAppend(&request, "host: www.example.com\r\n\r\n");
+
+  for (auto _ : state) {
+    Buffer::OwnedImpl buffer(request);
+    codec.dispatch(buffer);
+  }
+  benchmark::DoNotOptimize(decoder.header_count_);
+}
+BENCHMARK(HeaderMapImplHttp1CodecRoundTrip)->Arg(20)->Arg(30)->Arg(40);
+
+/**
+ * Measure sending a request with a realistic number of headers from the HTTP/2 client codec to
+ * the HTTP/2 server codec and the response headers back. The numeric Arg is the number of request
+ * headers.
+ */
+static void HeaderMapImplHttp2CodecRoundTrip(benchmark::State& state) {
+  // Frames written by one codec are dispatched to its peer, deferring nested writes until the
+  // current dispatch returns as the codecs do not support re-entrant dispatch.
+  struct ConnectionWrapper {
+    void dispatch(const Buffer::Instance& data, Connection& connection) {
+      buffer_.add(data);
+      if (!dispatching_) {
+        while (buffer_.length() > 0) {
+          dispatching_ = true;
+          connection.dispatch(buffer_);
+          dispatching_ = false;
+        }
+      }
+    }
+
+    bool dispatching_{};
+    Buffer::OwnedImpl buffer_;
+  };
+
+  Stats::IsolatedStoreImpl stats_store;
+  envoy::config::core::v3::Http2ProtocolOptions http2_options;
+  NiceMock<Network::MockConnection> client_connection;
+  NiceMock<Network::MockConnection> server_connection;
+  NiceMock<MockConnectionCallbacks> client_callbacks;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks;
+  NiceMock<MockResponseDecoder> response_decoder;
+  ReplyingRequestDecoder request_decoder;
+
+  Http2::ClientConnectionImpl client(client_connection, client_callbacks, stats_store,
+                                     http2_options, Http::DEFAULT_MAX_REQUEST_HEADERS_KB,
+                                     Http::DEFAULT_MAX_HEADERS_COUNT,
+                                     Http2::ProdNghttp2SessionFactory::get());
+  Http2::ServerConnectionImpl server(server_connection, server_callbacks, stats_store,
+                                     http2_options, Http::DEFAULT_MAX_REQUEST_HEADERS_KB,
+                                     Http::DEFAULT_MAX_HEADERS_COUNT,
+                                     envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+  ConnectionWrapper client_wrapper;
+  ConnectionWrapper server_wrapper;
+  ON_CALL(client_connection, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        server_wrapper.dispatch(data, server);
+        data.drain(data.length());
+      }));
+  ON_CALL(server_connection, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+        client_wrapper.dispatch(data, client);
+        data.drain(data.length());
+      }));
+  ON_CALL(server_callbacks, newStream(_, _))
+      .WillByDefault(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        request_decoder.setEncoder(encoder);
+        return request_decoder;
+      }));
+
+  RequestHeaderMapImpl request_headers;
+  for (const auto& header : makeRequestHeaders(state.range(0) - 12)) {
+    request_headers.addCopy(LowerCaseString(header.first), header.second);
+  }
+
+  for (auto _ : state) {
+    RequestEncoder& request_encoder = client.newStream(response_decoder);
+    request_encoder.encodeHeaders(request_headers, true);
+    // Closed streams are handed to the (mock) dispatcher for deferred deletion.
+    client_connection.dispatcher_.to_delete_.clear();
+    server_connection.dispatcher_.to_delete_.clear();
+  }
+  benchmark::DoNotOptimize(request_decoder.header_count_);
+}
+BENCHMARK(HeaderMapImplHttp2CodecRoundTrip)->Arg(20)->Arg(30)->Arg(40);
+
 } // namespace Http
 } // namespace Envoy
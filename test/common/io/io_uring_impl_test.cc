@@ -0,0 +1,175 @@
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/io/io_uring_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+struct Completion {
+  uint64_t user_data_;
+  int32_t result_;
+};
+
+class IoUringImplTest : public testing::Test {
+public:
+  void SetUp() override {
+    supported_ = IoUringImpl::isSupported();
+    if (!supported_) {
+      return;
+    }
+    io_uring_ = std::make_unique<IoUringImpl>(8);
+    event_fd_ = io_uring_->registerEventfd();
+    ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds_).rc_);
+  }
+
+  void TearDown() override {
+    if (supported_) {
+      os_sys_calls_.close(fds_[0]);
+      os_sys_calls_.close(fds_[1]);
+    }
+  }
+
+  // Waits until at least the given number of requests completed.
+  std::vector<Completion> waitForCompletions(size_t count) {
+    std::vector<Completion> completions;
+    while (completions.size() < count) {
+      struct pollfd pfd = {event_fd_, POLLIN, 0};
+      EXPECT_EQ(1, ::poll(&pfd, 1, 5000));
+      io_uring_->clearEventfd();
+      io_uring_->forEveryCompletion([&completions](void* user_data, int32_t result) {
+        completions.push_back({reinterpret_cast<uint64_t>(user_data), result});
+      });
+    }
+    return completions;
+  }
+
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  bool supported_{};
+  std::unique_ptr<IoUringImpl> io_uring_;
+  os_fd_t event_fd_{INVALID_SOCKET};
+  os_fd_t fds_[2];
+};
+
+TEST_F(IoUringImplTest, WritevAndReadFixed) {
+  if (!supported_) {
+    return;
+  }
+  char buffer[64];
+  ASSERT_TRUE(io_uring_->registerBuffers({{buffer, sizeof(buffer)}}));
+
+  char data[] = "hello";
+  struct iovec iov = {data, 5};
+  EXPECT_EQ(IoUringResult::Ok,
+            io_uring_->prepareWritev(fds_[1], &iov, 1, reinterpret_cast<void*>(1)));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadFixed(fds_[0], buffer, sizeof(buffer), 0,
+                                                           reinterpret_cast<void*>(2)));
+  EXPECT_EQ(2, io_uring_->pendingSubmissions());
+  EXPECT_EQ(2, io_uring_->submit());
+  EXPECT_EQ(0, io_uring_->pendingSubmissions());
+
+  std::vector<Completion> completions = waitForCompletions(2);
+  ASSERT_EQ(2, completions.size());
+  for (const Completion& completion : completions) {
+    EXPECT_EQ(5, completion.result_);
+  }
+  EXPECT_EQ("hello", std::string(buffer, 5));
+}
+
+TEST_F(IoUringImplTest, PollAndCancel) {
+  if (!supported_) {
+    return;
+  }
+  EXPECT_EQ(IoUringResult::Ok,
+            io_uring_->preparePollAdd(fds_[0], POLLIN, reinterpret_cast<void*>(1)));
+  EXPECT_EQ(1, io_uring_->submit());
+  EXPECT_EQ(IoUringResult::Ok,
+            io_uring_->prepareCancel(reinterpret_cast<void*>(1), reinterpret_cast<void*>(2)));
+  EXPECT_EQ(1, io_uring_->submit());
+
+  std::vector<Completion> completions = waitForCompletions(2);
+  ASSERT_EQ(2, completions.size());
+  for (const Completion& completion : completions) {
+    if (completion.user_data_ == 1) {
+      EXPECT_EQ(-ECANCELED, completion.result_);
+    } else {
+      EXPECT_EQ(2, completion.user_data_);
+      EXPECT_EQ(0, completion.result_);
+    }
+  }
+
+  EXPECT_EQ(IoUringResult::Ok,
+            io_uring_->preparePollAdd(fds_[0], POLLIN, reinterpret_cast<void*>(3)));
+  EXPECT_EQ(1, io_uring_->submit());
+  EXPECT_EQ(1, os_sys_calls_.write(fds_[1], "a", 1).rc_);
+  completions = waitForCompletions(1);
+  ASSERT_EQ(1, completions.size());
+  EXPECT_EQ(3, completions[0].user_data_);
+  EXPECT_TRUE(completions[0].result_ & POLLIN);
+}
+
+TEST_F(IoUringImplTest, SubmissionQueueFull) {
+  if (!supported_) {
+    return;
+  }
+  uint32_t prepared = 0;
+  while (io_uring_->preparePollAdd(fds_[0], POLLIN, nullptr) == IoUringResult::Ok) {
+    prepared++;
+  }
+  EXPECT_EQ(8, prepared);
+  EXPECT_EQ(8, io_uring_->submit());
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->preparePollAdd(fds_[0], POLLIN, nullptr));
+}
+
+// Completions which do not fit in the completion queue are delivered once there is room for them.
+TEST_F(IoUringImplTest, CompletionQueueOverflow) {
+  if (!supported_) {
+    return;
+  }
+  // The completion queue has twice as many entries as the submission queue. Polls for a readable
+  // socket complete right away, so that the third batch overflows it.
+  EXPECT_EQ(1, os_sys_calls_.write(fds_[1], "a", 1).rc_);
+  for (uint32_t batch = 0; batch < 3; batch++) {
+    for (uint32_t i = 0; i < 8; i++) {
+      EXPECT_EQ(IoUringResult::Ok, io_uring_->preparePollAdd(fds_[0], POLLIN, nullptr));
+    }
+    EXPECT_EQ(8, io_uring_->submit());
+  }
+  EXPECT_TRUE(io_uring_->completionQueueOverflowed());
+
+  uint32_t completions = 0;
+  io_uring_->forEveryCompletion([&completions](void*, int32_t result) {
+    EXPECT_TRUE(result & POLLIN);
+    completions++;
+  });
+  EXPECT_EQ(24, completions);
+  EXPECT_FALSE(io_uring_->completionQueueOverflowed());
+}
+
+TEST_F(IoUringImplTest, ReadError) {
+  if (!supported_) {
+    return;
+  }
+  char buffer[64];
+  ASSERT_TRUE(io_uring_->registerBuffers({{buffer, sizeof(buffer)}}));
+  os_fd_t fd = ::dup(fds_[0]);
+  os_sys_calls_.close(fd);
+  EXPECT_EQ(IoUringResult::Ok,
+            io_uring_->prepareReadFixed(fd, buffer, sizeof(buffer), 0, reinterpret_cast<void*>(1)));
+  io_uring_->submit();
+  std::vector<Completion> completions = waitForCompletions(1);
+  ASSERT_EQ(1, completions.size());
+  EXPECT_EQ(-EBADF, completions[0].result_);
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
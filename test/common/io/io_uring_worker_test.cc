@@ -0,0 +1,88 @@
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/io/io_uring_worker.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringWorkerTest : public testing::Test, public IoUringRequestHandler {
+public:
+  IoUringWorkerTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void SetUp() override {
+    supported_ = IoUringFactory::isSupported();
+    if (supported_) {
+      ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds_).rc_);
+    }
+  }
+
+  void TearDown() override {
+    worker_.reset();
+    if (supported_) {
+      os_sys_calls_.close(fds_[0]);
+      os_sys_calls_.close(fds_[1]);
+    }
+  }
+
+  // IoUringRequestHandler
+  void onRequestCompleted(IoUringRequest& request, int32_t result) override {
+    EXPECT_EQ(IoUringRequest::Type::Poll, request.type_);
+    EXPECT_TRUE(result & POLLIN);
+    completed_.push_back(request.id_);
+    if (completed_.size() == expected_completions_) {
+      dispatcher_->exit();
+    }
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  bool supported_{};
+  os_fd_t fds_[2]{INVALID_SOCKET, INVALID_SOCKET};
+  std::unique_ptr<IoUringWorker> worker_;
+  std::vector<uint64_t> completed_;
+  size_t expected_completions_{};
+};
+
+// Requests which do not fit in the submission queue while the completion queue is full are kept
+// until the completions have been processed, and then submitted in order.
+TEST_F(IoUringWorkerTest, SubmissionQueueFullWhileCompletionQueueFull) {
+  if (!supported_) {
+    return;
+  }
+  envoy::config::bootstrap::v3::IoUring config;
+  config.mutable_entries()->set_value(2);
+  // Without registered buffers, reads wait for readability with polls, which complete as soon as
+  // they are submitted for a readable socket.
+  config.mutable_read_buffers()->set_value(0);
+  worker_ = std::make_unique<IoUringWorker>(config, *dispatcher_);
+  EXPECT_EQ(1, os_sys_calls_.write(fds_[1], "a", 1).rc_);
+
+  // The completion queue has 4 entries, which the first submissions fill and overflow, after
+  // which the submission queue fills up too.
+  expected_completions_ = 64;
+  std::vector<uint64_t> submitted;
+  for (size_t i = 0; i < expected_completions_; i++) {
+    submitted.push_back(worker_->submitRead(fds_[0], *this)->id_);
+  }
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(submitted, completed_);
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
@@ -0,0 +1,153 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/network/connection_balancer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestHandler : public BalancedConnectionHandler {
+public:
+  explicit TestHandler(os_fd_t fd) {
+    socket_.io_handle_ = std::make_unique<IoSocketHandleImpl>(fd);
+    ON_CALL(socket_, ioHandle()).WillByDefault(ReturnRef(*socket_.io_handle_));
+  }
+
+  // BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(ConnectionSocketPtr&&) override { FAIL() << "unexpected handoff"; }
+  Socket& listenSocket() override { return socket_; }
+
+  NiceMock<MockListenSocket> socket_;
+  uint64_t num_connections_{};
+};
+
+class ReusePortConnectionBalancerTest : public testing::Test {
+public:
+  void SetUp() override {
+    try {
+      ReusePortSteering steering(1);
+    } catch (EnvoyException& e) {
+      // The kernel is too old, or the test lacks the privileges to load eBPF programs.
+      GTEST_SKIP() << e.what();
+    }
+
+    memset(&address_, 0, sizeof(address_));
+    address_.sin_family = AF_INET;
+    address_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (uint32_t i = 0; i < 3; ++i) {
+      const os_fd_t fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+      ASSERT_TRUE(SOCKET_VALID(fd));
+      handlers_.push_back(std::make_unique<TestHandler>(fd));
+      const int on = 1;
+      ASSERT_EQ(0, ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)));
+      ASSERT_EQ(0, ::bind(fd, reinterpret_cast<sockaddr*>(&address_), sizeof(address_)));
+      ASSERT_EQ(0, ::listen(fd, 16));
+      if (i == 0) {
+        socklen_t length = sizeof(address_);
+        ASSERT_EQ(0, ::getsockname(fd, reinterpret_cast<sockaddr*>(&address_), &length));
+      }
+    }
+  }
+
+  // Connects to the listener, and returns the index of the handler whose socket accepted the
+  // connection.
+  int connectAndAccept() {
+    const os_fd_t client = ::socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT_EQ(0, ::connect(client, reinterpret_cast<sockaddr*>(&address_), sizeof(address_)));
+    int accepted_by = -1;
+    for (uint32_t i = 0; i < handlers_.size(); ++i) {
+      const os_fd_t fd = ::accept(handlers_[i]->socket_.io_handle_->fd(), nullptr, nullptr);
+      if (SOCKET_VALID(fd)) {
+        accepted_by = i;
+        ::close(fd);
+      }
+    }
+    ::close(client);
+    return accepted_by;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "connection_balancer." + name)->value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  std::vector<std::unique_ptr<TestHandler>> handlers_;
+  sockaddr_in address_;
+};
+
+// New connections are steered to the handler with the fewest connections, and stay on the handler
+// which accepted them.
+TEST_F(ReusePortConnectionBalancerTest, SteerToLeastLoaded) {
+  ReusePortConnectionBalancerImpl balancer(3, store_);
+  for (auto& handler : handlers_) {
+    balancer.registerHandler(*handler);
+  }
+  EXPECT_EQ(3UL, TestUtility::findGauge(store_, "connection_balancer.steering_handlers")->value());
+
+  handlers_[0]->num_connections_ = 5;
+  handlers_[1]->num_connections_ = 2;
+  handlers_[2]->num_connections_ = 7;
+  EXPECT_EQ(handlers_[0].get(), &balancer.pickTargetHandler(*handlers_[0]));
+  EXPECT_EQ(6UL, handlers_[0]->num_connections_);
+  EXPECT_EQ(1UL, counter("steering_update"));
+  EXPECT_EQ(1, connectAndAccept());
+  EXPECT_EQ(1, connectAndAccept());
+
+  // The least loaded handler does not change.
+  EXPECT_EQ(handlers_[1].get(), &balancer.pickTargetHandler(*handlers_[1]));
+  EXPECT_EQ(3UL, handlers_[1]->num_connections_);
+  EXPECT_EQ(1UL, counter("steering_update"));
+
+  balancer.unregisterHandler(*handlers_[1]);
+  EXPECT_EQ(2UL, TestUtility::findGauge(store_, "connection_balancer.steering_handlers")->value());
+  EXPECT_EQ(handlers_[2].get(), &balancer.pickTargetHandler(*handlers_[2]));
+  EXPECT_EQ(2UL, counter("steering_update"));
+  EXPECT_EQ(0, connectAndAccept());
+  EXPECT_EQ(0UL, counter("steering_error"));
+
+  // Unknown handlers are ignored.
+  balancer.unregisterHandler(*handlers_[1]);
+  EXPECT_EQ(2UL, TestUtility::findGauge(store_, "connection_balancer.steering_handlers")->value());
+}
+
+// Handlers beyond the number of slots, or whose socket cannot be steered, are left to the kernel
+// hashing.
+TEST_F(ReusePortConnectionBalancerTest, RegisterErrors) {
+  ReusePortConnectionBalancerImpl balancer(1, store_);
+  balancer.registerHandler(*handlers_[0]);
+  balancer.registerHandler(*handlers_[1]);
+  EXPECT_EQ(1UL, counter("steering_error"));
+
+  balancer.unregisterHandler(*handlers_[0]);
+  TestHandler not_listening(::socket(AF_INET, SOCK_STREAM, 0));
+  balancer.registerHandler(not_listening);
+  EXPECT_EQ(2UL, counter("steering_error"));
+  EXPECT_EQ(0UL, TestUtility::findGauge(store_, "connection_balancer.steering_handlers")->value());
+
+  EXPECT_EQ(&not_listening, &balancer.pickTargetHandler(not_listening));
+  EXPECT_EQ(1UL, not_listening.num_connections_);
+  EXPECT_EQ(0UL, counter("steering_update"));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,237 @@
+#include <sys/socket.h>
+
+#include <cstring>
+#include <string>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/io/io_uring_worker.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class IoUringSocketHandleImplTest : public testing::Test {
+public:
+  IoUringSocketHandleImplTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void SetUp() override { supported_ = Io::IoUringFactory::isSupported(); }
+
+  void TearDown() override {
+    file_event_.reset();
+    io_handle_.reset();
+    if (SOCKET_VALID(fds_[1])) {
+      os_sys_calls_.close(fds_[1]);
+    }
+  }
+
+  void initialize(uint32_t read_buffers, uint32_t read_buffer_size = 1024) {
+    envoy::config::bootstrap::v3::IoUring config;
+    config.mutable_read_buffers()->set_value(read_buffers);
+    config.mutable_read_buffer_size()->set_value(read_buffer_size);
+    worker_ = std::make_unique<Io::IoUringWorker>(config, *dispatcher_);
+    ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, fds_).rc_);
+    io_handle_ = std::make_unique<IoUringSocketHandleImpl>(fds_[0], *worker_);
+  }
+
+  void createFileEvent(uint32_t events) {
+    file_event_ = io_handle_->createFileEvent(
+        *dispatcher_,
+        [this](uint32_t events) {
+          ready_events_ |= events;
+          dispatcher_->exit();
+        },
+        Event::FileTriggerType::Edge, events);
+  }
+
+  // Runs the event loop until the file event fires.
+  uint32_t waitForEvents() {
+    ready_events_ = 0;
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    return ready_events_;
+  }
+
+  std::string read(uint64_t max_length) {
+    std::string data(max_length, 0);
+    Buffer::RawSlice slice{data.data(), data.size()};
+    Api::IoCallUint64Result result = io_handle_->readv(max_length, &slice, 1);
+    EXPECT_TRUE(result.ok());
+    data.resize(result.rc_);
+    return data;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  bool supported_{};
+  os_fd_t fds_[2]{INVALID_SOCKET, INVALID_SOCKET};
+  std::unique_ptr<Io::IoUringWorker> worker_;
+  std::unique_ptr<IoUringSocketHandleImpl> io_handle_;
+  Event::FileEventPtr file_event_;
+  uint32_t ready_events_{};
+};
+
+TEST_F(IoUringSocketHandleImplTest, Read) {
+  if (!supported_) {
+    return;
+  }
+  initialize(2);
+  createFileEvent(Event::FileReadyType::Read);
+  EXPECT_EQ(1, worker_->freeBuffers());
+
+  EXPECT_EQ(5, os_sys_calls_.write(fds_[1], "hello", 5).rc_);
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+
+  // The data is handed out from the registered buffer, which returns to the pool once consumed.
+  EXPECT_EQ("hel", read(3));
+  EXPECT_EQ(1, worker_->freeBuffers());
+  EXPECT_EQ("lo", read(1024));
+  EXPECT_EQ(2, worker_->freeBuffers());
+
+  Buffer::RawSlice slice{nullptr, 0};
+  Api::IoCallUint64Result result = io_handle_->readv(1024, &slice, 1);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(1, worker_->freeBuffers());
+
+  os_sys_calls_.close(fds_[1]);
+  fds_[1] = INVALID_SOCKET;
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  EXPECT_EQ("", read(1024));
+}
+
+TEST_F(IoUringSocketHandleImplTest, ReadIntoBuffer) {
+  if (!supported_) {
+    return;
+  }
+  initialize(2, 8192);
+  createFileEvent(Event::FileReadyType::Read);
+
+  // Short data is copied and the registered buffer returns to the pool right away.
+  EXPECT_EQ(5, os_sys_calls_.write(fds_[1], "hello", 5).rc_);
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(5, io_handle_->read(buffer, 16384).rc_);
+  EXPECT_EQ("hello", buffer.toString());
+  EXPECT_EQ(2, worker_->freeBuffers());
+  buffer.drain(buffer.length());
+
+  // Longer data is moved, and the registered buffer only returns to the pool once it is drained.
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again,
+            io_handle_->read(buffer, 16384).err_->getErrorCode());
+  const std::string data(5000, 'a');
+  EXPECT_EQ(5000, os_sys_calls_.write(fds_[1], data.data(), data.size()).rc_);
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  EXPECT_EQ(5000, io_handle_->read(buffer, 16384).rc_);
+  EXPECT_EQ(data, buffer.toString());
+  EXPECT_EQ(1, worker_->freeBuffers());
+  buffer.drain(buffer.length());
+  EXPECT_EQ(2, worker_->freeBuffers());
+}
+
+TEST_F(IoUringSocketHandleImplTest, ReadWithoutFreeBuffers) {
+  if (!supported_) {
+    return;
+  }
+  initialize(1);
+  // Another socket holds the only registered buffer.
+  os_fd_t other_fds[2];
+  ASSERT_EQ(0, os_sys_calls_.socketpair(AF_UNIX, SOCK_STREAM, 0, other_fds).rc_);
+  IoUringSocketHandleImpl other_handle(other_fds[0], *worker_);
+  Event::FileEventPtr other_event = other_handle.createFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+  EXPECT_EQ(0, worker_->freeBuffers());
+
+  createFileEvent(Event::FileReadyType::Read);
+
+  // The socket is polled instead and read directly.
+  EXPECT_EQ(5, os_sys_calls_.write(fds_[1], "hello", 5).rc_);
+  EXPECT_EQ(Event::FileReadyType::Read, waitForEvents());
+  EXPECT_EQ("hello", read(1024));
+  other_event.reset();
+  os_sys_calls_.close(other_fds[1]);
+}
+
+TEST_F(IoUringSocketHandleImplTest, Write) {
+  if (!supported_) {
+    return;
+  }
+  initialize(2);
+  createFileEvent(Event::FileReadyType::Write);
+  EXPECT_EQ(Event::FileReadyType::Write, waitForEvents());
+
+  std::string data = "hello";
+  Buffer::RawSlice slice{data.data(), data.size()};
+  Api::IoCallUint64Result result = io_handle_->writev(&slice, 1);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(5, result.rc_);
+
+  // Further writes wait for the pending one.
+  result = io_handle_->writev(&slice, 1);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  EXPECT_EQ(Event::FileReadyType::Write, waitForEvents());
+  char buffer[16];
+  EXPECT_EQ(5, os_sys_calls_.recv(fds_[1], buffer, sizeof(buffer), 0).rc_);
+  EXPECT_EQ("hello", std::string(buffer, 5));
+}
+
+TEST_F(IoUringSocketHandleImplTest, WriteBuffer) {
+  if (!supported_) {
+    return;
+  }
+  initialize(2);
+  createFileEvent(Event::FileReadyType::Write);
+  EXPECT_EQ(Event::FileReadyType::Write, waitForEvents());
+
+  // The data is moved into the write request.
+  Buffer::OwnedImpl buffer("hello");
+  Api::IoCallUint64Result result = io_handle_->write(buffer);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ(0, buffer.length());
+
+  EXPECT_EQ(Event::FileReadyType::Write, waitForEvents());
+  char data[16];
+  EXPECT_EQ(5, os_sys_calls_.recv(fds_[1], data, sizeof(data), 0).rc_);
+  EXPECT_EQ("hello", std::string(data, 5));
+}
+
+TEST_F(IoUringSocketHandleImplTest, CloseWithPendingWrite) {
+  if (!supported_) {
+    return;
+  }
+  initialize(2);
+  createFileEvent(Event::FileReadyType::Write);
+  std::string data = "hello";
+  Buffer::RawSlice slice{data.data(), data.size()};
+  EXPECT_EQ(5, io_handle_->writev(&slice, 1).rc_);
+  EXPECT_EQ(0, io_handle_->shutdown(ENVOY_SHUT_WR).rc_);
+  file_event_.reset();
+  io_handle_->close();
+
+  // The data reported as written still reaches the peer, followed by the end of the stream.
+  std::string received;
+  char buffer[16];
+  Api::SysCallSizeResult result;
+  do {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    result = os_sys_calls_.recv(fds_[1], buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (result.rc_ > 0) {
+      received.append(buffer, result.rc_);
+    }
+  } while (result.rc_ != 0);
+  EXPECT_EQ("hello", received);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
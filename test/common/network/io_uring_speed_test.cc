@@ -0,0 +1,156 @@
+// Compares receiving on many loopback connections through the libevent driven
+// IoSocketHandleImpl, which costs a readiness notification and a readv(2) per connection, with
+// IoUringSocketHandleImpl, which hands the reads of an event loop iteration to the kernel at once.
+// Data is read into a Buffer::Instance like RawBufferSocket does, which io_uring fills without
+// copying messages of at least 4KiB.
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+#include "common/io/io_uring_worker.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+using IoHandleFactory = std::function<Network::IoHandlePtr(os_fd_t)>;
+
+// Socket pairs whose server side is read through an IoHandle driven by the dispatcher.
+class Connections {
+public:
+  Connections(Event::Dispatcher& dispatcher, uint32_t count, const IoHandleFactory& factory)
+      : dispatcher_(dispatcher) {
+    connections_.resize(count);
+    for (Connection& connection : connections_) {
+      RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, connection.fds_) == 0,
+                     "");
+      connection.io_handle_ = factory(connection.fds_[1]);
+      connection.file_event_ = connection.io_handle_->createFileEvent(
+          dispatcher_, [this, &connection](uint32_t) { onRead(connection); },
+          Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+    }
+  }
+
+  ~Connections() {
+    for (Connection& connection : connections_) {
+      connection.file_event_.reset();
+      connection.io_handle_.reset();
+      ::close(connection.fds_[0]);
+    }
+  }
+
+  // Sends a message on every connection and waits until all of them have been received.
+  void exchange(const std::string& message) {
+    for (Connection& connection : connections_) {
+      RELEASE_ASSERT(::write(connection.fds_[0], message.data(), message.size()) ==
+                         static_cast<ssize_t>(message.size()),
+                     "");
+    }
+    expected_ += message.size() * connections_.size();
+    while (received_ < expected_) {
+      dispatcher_.run(Event::Dispatcher::RunType::Block);
+    }
+  }
+
+private:
+  struct Connection {
+    os_fd_t fds_[2];
+    Network::IoHandlePtr io_handle_;
+    Event::FileEventPtr file_event_;
+  };
+
+  void onRead(Connection& connection) {
+    Buffer::OwnedImpl buffer;
+    while (true) {
+      Api::IoCallUint64Result result = connection.io_handle_->read(buffer, 16384);
+      if (!result.ok() || result.rc_ == 0) {
+        break;
+      }
+      received_ += result.rc_;
+      buffer.drain(buffer.length());
+    }
+    if (received_ == expected_) {
+      dispatcher_.exit();
+    }
+  }
+
+  Event::Dispatcher& dispatcher_;
+  std::vector<Connection> connections_;
+  uint64_t expected_{};
+  uint64_t received_{};
+};
+
+void receive(benchmark::State& state, Event::Dispatcher& dispatcher,
+             const IoHandleFactory& factory) {
+  Connections connections(dispatcher, state.range(0), factory);
+  const std::string message(state.range(1), 'a');
+  for (auto _ : state) {
+    connections.exchange(message);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+void libeventReceive(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  receive(state, *dispatcher,
+          [](os_fd_t fd) { return std::make_unique<Network::IoSocketHandleImpl>(fd); });
+}
+BENCHMARK(libeventReceive)
+    ->Args({1, 128})
+    ->Args({64, 128})
+    ->Args({256, 128})
+    ->Args({1, 16384})
+    ->Args({64, 16384})
+    ->Args({256, 16384});
+
+void ioUringReceive(benchmark::State& state) {
+  if (!Io::IoUringFactory::isSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  envoy::config::bootstrap::v3::IoUring config;
+  Io::IoUringWorker worker(config, *dispatcher);
+  receive(state, *dispatcher, [&worker](os_fd_t fd) {
+    return std::make_unique<Network::IoUringSocketHandleImpl>(fd, worker);
+  });
+}
+BENCHMARK(ioUringReceive)
+    ->Args({1, 128})
+    ->Args({64, 128})
+    ->Args({256, 128})
+    ->Args({1, 16384})
+    ->Args({64, 16384})
+    ->Args({256, 16384});
+
+} // namespace
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  Envoy::Event::Libevent::Global::initialize();
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -170,6 +170,22 @@ TEST_P(ListenSocketImplTestTcp, BindPortZero) { testBindPortZero(); }
 
 TEST_P(ListenSocketImplTestUdp, BindPortZero) { testBindPortZero(); }
 
+// Accepted sockets are counted for as long as they are alive.
+TEST(AcceptedSocketImplTest, AcceptedSocketCount) {
+  const uint64_t initial_count = AcceptedSocketImpl::acceptedSocketCount();
+  Address::InstanceConstSharedPtr address = Network::Utility::parseInternetAddress("10.1.2.3");
+  auto first = std::make_unique<AcceptedSocketImpl>(
+      std::make_unique<Network::IoSocketHandleImpl>(), address, address);
+  auto second = std::make_unique<AcceptedSocketImpl>(
+      std::make_unique<Network::IoSocketHandleImpl>(), address, address);
+  EXPECT_EQ(initial_count + 2, AcceptedSocketImpl::acceptedSocketCount());
+
+  first.reset();
+  EXPECT_EQ(initial_count + 1, AcceptedSocketImpl::acceptedSocketCount());
+  second.reset();
+  EXPECT_EQ(initial_count, AcceptedSocketImpl::acceptedSocketCount());
+}
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
@@ -0,0 +1,116 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/network/reuse_port_steering.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+constexpr uint32_t NumSockets = 4;
+
+class ReusePortSteeringTest : public testing::Test {
+public:
+  void SetUp() override {
+    try {
+      steering_ = std::make_unique<ReusePortSteering>(NumSockets);
+    } catch (EnvoyException& e) {
+      // The kernel is too old, or the test lacks the privileges to load eBPF programs.
+      GTEST_SKIP() << e.what();
+    }
+
+    memset(&address_, 0, sizeof(address_));
+    address_.sin_family = AF_INET;
+    address_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (uint32_t i = 0; i < NumSockets; ++i) {
+      const os_fd_t fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+      ASSERT_TRUE(SOCKET_VALID(fd));
+      listeners_.push_back(fd);
+      const int on = 1;
+      ASSERT_EQ(0, ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)));
+      ASSERT_EQ(0, ::bind(fd, reinterpret_cast<sockaddr*>(&address_), sizeof(address_)));
+      ASSERT_EQ(0, ::listen(fd, 16));
+      if (i == 0) {
+        // The other sockets join the group of the first one on the port it was given.
+        socklen_t length = sizeof(address_);
+        ASSERT_EQ(0, ::getsockname(fd, reinterpret_cast<sockaddr*>(&address_), &length));
+      }
+    }
+  }
+
+  void TearDown() override {
+    for (const os_fd_t fd : listeners_) {
+      ::close(fd);
+    }
+  }
+
+  // Connects to the group, and returns the index of the socket which accepted the connection.
+  int connectAndAccept() {
+    const os_fd_t client = ::socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT_EQ(0, ::connect(client, reinterpret_cast<sockaddr*>(&address_), sizeof(address_)));
+    int accepted_by = -1;
+    for (uint32_t i = 0; i < listeners_.size(); ++i) {
+      const os_fd_t fd = ::accept(listeners_[i], nullptr, nullptr);
+      if (SOCKET_VALID(fd)) {
+        EXPECT_EQ(-1, accepted_by);
+        accepted_by = i;
+        ::close(fd);
+      }
+    }
+    ::close(client);
+    return accepted_by;
+  }
+
+  std::unique_ptr<ReusePortSteering> steering_;
+  std::vector<os_fd_t> listeners_;
+  sockaddr_in address_;
+};
+
+TEST_F(ReusePortSteeringTest, SteerToSlot) {
+  for (uint32_t i = 0; i < NumSockets; ++i) {
+    steering_->addSocket(i, listeners_[i]);
+  }
+  for (uint32_t i = 0; i < NumSockets; ++i) {
+    ASSERT_TRUE(steering_->steerTo(i));
+    for (int j = 0; j < 5; ++j) {
+      EXPECT_EQ(i, connectAndAccept());
+    }
+  }
+  ASSERT_TRUE(steering_->steerTo(1));
+  EXPECT_EQ(1, connectAndAccept());
+}
+
+// Connections still reach one of the sockets when the slot steered to is empty.
+TEST_F(ReusePortSteeringTest, EmptySlotFallsBackToHashing) {
+  for (uint32_t i = 0; i < NumSockets - 1; ++i) {
+    steering_->addSocket(i, listeners_[i]);
+  }
+  ASSERT_TRUE(steering_->steerTo(NumSockets - 1));
+  EXPECT_NE(-1, connectAndAccept());
+
+  steering_->removeSocket(0);
+  ASSERT_TRUE(steering_->steerTo(0));
+  EXPECT_NE(-1, connectAndAccept());
+  // Removing an empty slot is a no-op.
+  steering_->removeSocket(0);
+}
+
+TEST_F(ReusePortSteeringTest, AddSocketWithoutReusePort) {
+  const os_fd_t fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_TRUE(SOCKET_VALID(fd));
+  EXPECT_THROW(steering_->addSocket(0, fd), EnvoyException);
+  ::close(fd);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,256 @@
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_error_impl.h"
+#include "common/network/udp_batch_writer.h"
+
+#include "test/mocks/network/io_handle.h"
+
+#include "absl/types/optional.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ByMove;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+Api::IoCallUint64Result makeNoError(uint64_t rc) {
+  auto no_error = Api::ioCallUint64ResultNoError();
+  no_error.rc_ = rc;
+  return no_error;
+}
+
+Api::IoCallUint64Result makeError(int sys_errno) {
+  return Api::IoCallUint64Result(0, Api::IoErrorPtr(new IoSocketError(sys_errno),
+                                                    IoSocketError::deleteIoError));
+}
+
+// What a sendmmsg() call was asked to send.
+struct SentMessage {
+  std::string payload_;
+  const Address::Instance* peer_address_;
+  uint16_t gso_size_;
+};
+
+class UdpBatchWriterTest : public testing::Test {
+public:
+  void initialize(bool supports_gso) {
+    ON_CALL(io_handle_, supportsUdpGso()).WillByDefault(Return(supports_gso));
+    writer_ = std::make_unique<UdpBatchWriter>(io_handle_);
+  }
+
+  void write(const std::string& payload, const Address::Instance& peer) {
+    Buffer::OwnedImpl buffer(payload);
+    writer_->write(buffer, nullptr, peer);
+    EXPECT_EQ(0, buffer.length());
+  }
+
+  // Records the messages of the next sendmmsg() call and reports the first num_sent as sent.
+  void expectSendmmsg(std::vector<SentMessage>& sent, absl::optional<uint64_t> num_sent) {
+    EXPECT_CALL(io_handle_, sendmmsg(_, _, 0))
+        .WillOnce(Invoke([&sent, num_sent](const IoHandle::SendMsgInfo* messages,
+                                           uint64_t num_messages, int) {
+          for (uint64_t i = 0; i < num_messages; i++) {
+            std::string payload;
+            for (uint64_t j = 0; j < messages[i].num_slice_; j++) {
+              payload.append(static_cast<const char*>(messages[i].slices_[j].mem_),
+                             messages[i].slices_[j].len_);
+            }
+            sent.push_back({payload, messages[i].peer_address_, messages[i].gso_size_});
+          }
+          return makeNoError(num_sent.value_or(num_messages));
+        }));
+  }
+
+  NiceMock<MockIoHandle> io_handle_;
+  std::unique_ptr<UdpBatchWriter> writer_;
+  const Address::Ipv4Instance peer1_{"10.0.0.1", 10000};
+  const Address::Ipv4Instance peer2_{"10.0.0.2", 10000};
+};
+
+// Consecutive datagrams of the same size for the same peer form one message, which a shorter
+// datagram ends.
+TEST_F(UdpBatchWriterTest, CoalesceEqualSizedDatagrams) {
+  initialize(true);
+  write("aaaa", peer1_);
+  write("bbbb", peer1_);
+  write("cc", peer1_);
+  write("dddd", peer1_);
+  write("eeee", peer2_);
+  EXPECT_EQ(5, writer_->pendingDatagrams());
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent, absl::nullopt);
+  const UdpFlushResult result = writer_->flush();
+  EXPECT_EQ(5, result.datagrams_sent_);
+  EXPECT_EQ(18, result.bytes_sent_);
+  EXPECT_EQ(0, result.datagrams_dropped_);
+  EXPECT_EQ(1, result.send_calls_);
+  EXPECT_EQ(0, writer_->pendingDatagrams());
+
+  ASSERT_EQ(3, sent.size());
+  EXPECT_EQ("aaaabbbbcc", sent[0].payload_);
+  EXPECT_EQ(4, sent[0].gso_size_);
+  EXPECT_EQ(&peer1_, sent[0].peer_address_);
+  EXPECT_EQ("dddd", sent[1].payload_);
+  EXPECT_EQ(0, sent[1].gso_size_);
+  EXPECT_EQ("eeee", sent[2].payload_);
+  EXPECT_EQ(0, sent[2].gso_size_);
+  EXPECT_EQ(&peer2_, sent[2].peer_address_);
+}
+
+// Equal addresses coalesce even if they are different instances.
+TEST_F(UdpBatchWriterTest, CoalesceEqualPeers) {
+  initialize(true);
+  const Address::Ipv4Instance same_peer{"10.0.0.1", 10000};
+  write("aaaa", peer1_);
+  write("bbbb", same_peer);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent, absl::nullopt);
+  EXPECT_EQ(2, writer_->flush().datagrams_sent_);
+  ASSERT_EQ(1, sent.size());
+  EXPECT_EQ(4, sent[0].gso_size_);
+}
+
+// Without segmentation offload every datagram is a message of its own.
+TEST_F(UdpBatchWriterTest, NoCoalescingWithoutGso) {
+  initialize(false);
+  EXPECT_FALSE(writer_->gsoEnabled());
+  write("aaaa", peer1_);
+  write("bbbb", peer1_);
+  write("cccc", peer1_);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent, absl::nullopt);
+  const UdpFlushResult result = writer_->flush();
+  EXPECT_EQ(3, result.datagrams_sent_);
+  EXPECT_EQ(1, result.send_calls_);
+  ASSERT_EQ(3, sent.size());
+  for (const SentMessage& message : sent) {
+    EXPECT_EQ(0, message.gso_size_);
+  }
+}
+
+// Messages are limited in the number of segments and in the size of the datagrams.
+TEST_F(UdpBatchWriterTest, SegmentLimits) {
+  initialize(true);
+  for (uint32_t i = 0; i < UdpBatchWriter::MaxSegmentsPerMessage + 1; i++) {
+    write("a", peer1_);
+  }
+  const std::string large(UdpBatchWriter::MaxSegmentSize + 1, 'b');
+  write(large, peer1_);
+  write(large, peer1_);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent, absl::nullopt);
+  EXPECT_EQ(UdpBatchWriter::MaxSegmentsPerMessage + 3, writer_->flush().datagrams_sent_);
+  ASSERT_EQ(4, sent.size());
+  EXPECT_EQ(UdpBatchWriter::MaxSegmentsPerMessage, sent[0].payload_.size());
+  EXPECT_EQ(1, sent[0].gso_size_);
+  EXPECT_EQ("a", sent[1].payload_);
+  EXPECT_EQ(0, sent[2].gso_size_);
+  EXPECT_EQ(0, sent[3].gso_size_);
+}
+
+// The messages which a call did not send are sent by the next one.
+TEST_F(UdpBatchWriterTest, PartialSend) {
+  InSequence s;
+  initialize(false);
+  write("aaaa", peer1_);
+  write("bbbb", peer1_);
+  write("cccc", peer1_);
+
+  std::vector<SentMessage> first_call;
+  std::vector<SentMessage> second_call;
+  expectSendmmsg(first_call, 1);
+  expectSendmmsg(second_call, absl::nullopt);
+  const UdpFlushResult result = writer_->flush();
+  EXPECT_EQ(3, result.datagrams_sent_);
+  EXPECT_EQ(2, result.send_calls_);
+  EXPECT_EQ(3, first_call.size());
+  ASSERT_EQ(2, second_call.size());
+  EXPECT_EQ("bbbb", second_call[0].payload_);
+}
+
+// A full send buffer drops everything which is left.
+TEST_F(UdpBatchWriterTest, AgainDropsRemaining) {
+  InSequence s;
+  initialize(false);
+  write("aaaa", peer1_);
+  write("bbbb", peer1_);
+  write("cccc", peer1_);
+
+  std::vector<SentMessage> sent;
+  expectSendmmsg(sent, 1);
+  EXPECT_CALL(io_handle_, sendmmsg(_, 2, 0)).WillOnce(Return(ByMove(makeError(EAGAIN))));
+  const UdpFlushResult result = writer_->flush();
+  EXPECT_EQ(1, result.datagrams_sent_);
+  EXPECT_EQ(2, result.datagrams_dropped_);
+  EXPECT_EQ(2, result.send_calls_);
+  EXPECT_EQ(0, writer_->pendingDatagrams());
+}
+
+// Other errors drop the message which failed only.
+TEST_F(UdpBatchWriterTest, ErrorDropsFailedMessage) {
+  InSequence s;
+  initialize(false);
+  write("aaaa", peer1_);
+  write("bbbb", peer1_);
+
+  std::vector<SentMessage> sent;
+  EXPECT_CALL(io_handle_, sendmmsg(_, 2, 0)).WillOnce(Return(ByMove(makeError(EHOSTUNREACH))));
+  expectSendmmsg(sent, absl::nullopt);
+  const UdpFlushResult result = writer_->flush();
+  EXPECT_EQ(1, result.datagrams_sent_);
+  EXPECT_EQ(1, result.datagrams_dropped_);
+  ASSERT_EQ(1, sent.size());
+  EXPECT_EQ("bbbb", sent[0].payload_);
+}
+
+// A segmented message which cannot be sent is sent again as individual datagrams, and coalescing
+// stops.
+TEST_F(UdpBatchWriterTest, GsoFailureFallsBack) {
+  InSequence s;
+  initialize(true);
+  write("aaaa", peer1_);
+  write("bbbb", peer1_);
+  write("cc", peer1_);
+
+  std::vector<SentMessage> sent;
+  EXPECT_CALL(io_handle_, sendmmsg(_, 1, 0)).WillOnce(Return(ByMove(makeError(EIO))));
+  expectSendmmsg(sent, absl::nullopt);
+  const UdpFlushResult result = writer_->flush();
+  EXPECT_EQ(3, result.datagrams_sent_);
+  EXPECT_EQ(0, result.datagrams_dropped_);
+  EXPECT_EQ(2, result.send_calls_);
+  EXPECT_FALSE(writer_->gsoEnabled());
+  ASSERT_EQ(3, sent.size());
+  EXPECT_EQ("aaaa", sent[0].payload_);
+  EXPECT_EQ("bbbb", sent[1].payload_);
+  EXPECT_EQ("cc", sent[2].payload_);
+  for (const SentMessage& message : sent) {
+    EXPECT_EQ(0, message.gso_size_);
+  }
+
+  write("dddd", peer1_);
+  write("eeee", peer1_);
+  std::vector<SentMessage> sent_later;
+  expectSendmmsg(sent_later, absl::nullopt);
+  writer_->flush();
+  EXPECT_EQ(2, sent_later.size());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -8,6 +8,7 @@
 #include "common/network/address_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/socket_option_impl.h"
+#include "common/network/udp_batch_writer.h"
 #include "common/network/udp_listener_impl.h"
 #include "common/network/utility.h"
 
@@ -398,6 +399,86 @@ TEST_P(UdpListenerImplTest, SendDataError) {
   EXPECT_DEATH(listener_->send(send_data), "Invalid argument passed in");
 }
 
+/**
+ * Tests that queued datagrams are sent by flush(), coalesced into a single message if the platform
+ * supports UDP generic segmentation offload, and received one by one.
+ */
+TEST_P(UdpListenerImplTest, QueueSendAndFlush) {
+  const std::vector<std::string> payloads{"aaaa", "bbbb", "cccc", "dd"};
+  for (const std::string& payload : payloads) {
+    Buffer::OwnedImpl buffer(payload);
+    UdpSendData send_data{nullptr, *client_.localAddress(), buffer};
+    listener_->queueSend(send_data);
+    // The data is moved into the queue.
+    EXPECT_EQ(0, buffer.length());
+  }
+
+  const UdpFlushResult result = listener_->flush();
+  EXPECT_EQ(payloads.size(), result.datagrams_sent_);
+  EXPECT_EQ(14, result.bytes_sent_);
+  EXPECT_EQ(0, result.datagrams_dropped_);
+  if (server_socket_->ioHandle().supportsUdpGso()) {
+    EXPECT_EQ(1, result.send_calls_);
+  }
+
+  for (const std::string& payload : payloads) {
+    UdpRecvData data;
+    client_.recv(data);
+    EXPECT_EQ(payload, data.buffer_->toString());
+  }
+
+  // Nothing is left to send.
+  EXPECT_EQ(0, listener_->flush().send_calls_);
+}
+
+/**
+ * Tests that datagrams coalesced by UDP_GRO are passed to the callbacks one by one.
+ */
+TEST_P(UdpListenerImplTest, ReceiveCoalescedDatagrams) {
+  if (!Api::OsSysCallsSingleton::get().supportsUdpGro() ||
+      !Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+    return;
+  }
+  listener_.reset();
+  server_socket_ = createServerSocket(true);
+  server_socket_->addOptions(SocketOptionFactory::buildIpPacketInfoOptions());
+  server_socket_->addOptions(SocketOptionFactory::buildUdpGroOptions());
+  send_to_addr_.reset(getServerLoopbackAddress());
+  listener_ = std::make_unique<UdpListenerImpl>(dispatcherImpl(), server_socket_,
+                                                listener_callbacks_, dispatcherImpl().timeSource());
+  EXPECT_EQ(MAX_UDP_GRO_PACKET_SIZE, listener_->maxPacketSize());
+
+  // Send the datagrams as a single segmented message, which the receiving socket keeps coalesced.
+  auto sender = std::make_unique<UdpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  UdpBatchWriter writer(sender->ioHandle());
+  const std::vector<std::string> payloads{std::string(100, 'a'), std::string(100, 'b'),
+                                          std::string(100, 'c'), std::string(10, 'd')};
+  for (const std::string& payload : payloads) {
+    Buffer::OwnedImpl buffer(payload);
+    writer.write(buffer, nullptr, *send_to_addr_);
+  }
+  const UdpFlushResult result = writer.flush();
+  EXPECT_EQ(1, result.send_calls_);
+  EXPECT_EQ(payloads.size(), result.datagrams_sent_);
+
+  std::vector<std::string> received;
+  EXPECT_CALL(listener_callbacks_, onReadReady());
+  EXPECT_CALL(listener_callbacks_, onData(_))
+      .Times(payloads.size())
+      .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+        EXPECT_EQ(data.addresses_.peer_->asString(), sender->localAddress()->asString());
+        received.push_back(data.buffer_->toString());
+        if (received.size() == payloads.size()) {
+          dispatcher_->exit();
+        }
+      }));
+  EXPECT_CALL(listener_callbacks_, onWriteReady(_)).Times(testing::AnyNumber());
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(payloads, received);
+}
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
@@ -2,6 +2,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/config/core/v3/address.pb.h"
@@ -10,17 +11,23 @@
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 
+#include "test/mocks/network/io_handle.h"
 #include "test/mocks/network/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/utility.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
 namespace Network {
 namespace {
 
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+
 TEST(NetworkUtility, Url) {
   EXPECT_EQ("foo", Utility::hostFromTcpUrl("tcp://foo:1234"));
   EXPECT_EQ(1234U, Utility::portFromTcpUrl("tcp://foo:1234"));
@@ -443,6 +450,76 @@ TEST(PortRangeListTest, Normal) {
   }
 }
 
+class TestUdpPacketProcessor : public UdpPacketProcessor {
+public:
+  explicit TestUdpPacketProcessor(uint64_t max_packet_size) : max_packet_size_(max_packet_size) {}
+
+  // UdpPacketProcessor
+  void processPacket(Address::InstanceConstSharedPtr, Address::InstanceConstSharedPtr,
+                     Buffer::InstancePtr buffer, MonotonicTime) override {
+    packet_sizes_.push_back(buffer->length());
+  }
+  uint64_t maxPacketSize() const override { return max_packet_size_; }
+
+  const uint64_t max_packet_size_;
+  std::vector<uint64_t> packet_sizes_;
+};
+
+// Without UDP_GRO, a buffer of MAX_UDP_PACKET_SIZE is reserved for each of the datagrams read by a
+// recvmmsg() call.
+TEST(NetworkUtility, ReadFromSocketReservesBufferPerDatagram) {
+  MockIoHandle handle;
+  TestUdpPacketProcessor processor(MAX_UDP_PACKET_SIZE);
+  Address::Ipv4Instance local_address("127.0.0.1", 10000);
+  EXPECT_CALL(handle, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(handle, recvmsg(_, _, _, _)).Times(0);
+  EXPECT_CALL(handle, recvmmsg(_, 10000, _))
+      .WillOnce(Invoke([](RawSliceArrays& slices, uint32_t, IoHandle::RecvMsgOutput& output) {
+        EXPECT_EQ(NUM_DATAGRAMS_PER_MMSG_CALL, slices.size());
+        EXPECT_EQ(NUM_DATAGRAMS_PER_MMSG_CALL, output.msg_.size());
+        for (const auto& packet_slices : slices) {
+          EXPECT_EQ(1, packet_slices.size());
+          EXPECT_GE(packet_slices[0].len_, MAX_UDP_PACKET_SIZE);
+          EXPECT_LT(packet_slices[0].len_, MAX_UDP_GRO_PACKET_SIZE);
+        }
+        for (uint32_t i = 0; i < 2; i++) {
+          output.msg_[i].msg_len_ = 100;
+          output.msg_[i].local_address_ = std::make_shared<Address::Ipv4Instance>("127.0.0.1");
+          output.msg_[i].peer_address_ = std::make_shared<Address::Ipv4Instance>("127.0.0.2");
+        }
+        return Api::IoCallUint64Result(2, Api::IoErrorPtr(nullptr, [](Api::IoError*) {}));
+      }));
+
+  EXPECT_EQ(2, Utility::readFromSocket(handle, local_address, processor, MonotonicTime(), nullptr)
+                   .rc_);
+  EXPECT_EQ(std::vector<uint64_t>({100, 100}), processor.packet_sizes_);
+}
+
+// With UDP_GRO, a single buffer large enough for a coalesced payload is reserved per call, rather
+// than one for each of the datagrams a recvmmsg() call could read.
+TEST(NetworkUtility, ReadFromSocketReservesSingleGroBuffer) {
+  MockIoHandle handle;
+  TestUdpPacketProcessor processor(MAX_UDP_GRO_PACKET_SIZE);
+  Address::Ipv4Instance local_address("127.0.0.1", 10000);
+  EXPECT_CALL(handle, supportsMmsg()).WillRepeatedly(Return(true));
+  EXPECT_CALL(handle, recvmmsg(_, _, _)).Times(0);
+  EXPECT_CALL(handle, recvmsg(_, 1, 10000, _))
+      .WillOnce(Invoke([](Buffer::RawSlice* slices, uint64_t, uint32_t,
+                          IoHandle::RecvMsgOutput& output) {
+        EXPECT_GE(slices[0].len_, MAX_UDP_GRO_PACKET_SIZE);
+        EXPECT_LT(slices[0].len_, 2 * MAX_UDP_GRO_PACKET_SIZE);
+        output.msg_[0].gso_size_ = 1000;
+        output.msg_[0].local_address_ = std::make_shared<Address::Ipv4Instance>("127.0.0.1");
+        output.msg_[0].peer_address_ = std::make_shared<Address::Ipv4Instance>("127.0.0.2");
+        return Api::IoCallUint64Result(2500, Api::IoErrorPtr(nullptr, [](Api::IoError*) {}));
+      }));
+
+  EXPECT_EQ(2500,
+            Utility::readFromSocket(handle, local_address, processor, MonotonicTime(), nullptr)
+                .rc_);
+  EXPECT_EQ(std::vector<uint64_t>({1000, 1000, 500}), processor.packet_sizes_);
+}
+
 // TODO(ccaraman): Support big-endian. These tests operate under the assumption that the machine
 // byte order is little-endian.
 TEST(AbslUint128, TestByteOrder) {
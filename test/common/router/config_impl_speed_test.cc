@@ -0,0 +1,83 @@
+// Usage: bazel run //test/common/router:config_impl_speed_test
+
+#include "envoy/config/route/v3/route.pb.h"
+
+#include "common/common/assert.h"
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+// Builds a single virtual host with num_routes routes, alternating between prefix and exact path
+// routes, optionally followed by a regex route every regex_interval routes.
+envoy::config::route::v3::RouteConfiguration makeRouteConfig(uint64_t num_routes,
+                                                             uint64_t regex_interval) {
+  envoy::config::route::v3::RouteConfiguration config;
+  auto* vhost = config.add_virtual_hosts();
+  vhost->set_name("default");
+  vhost->add_domains("*");
+  for (uint64_t i = 0; i < num_routes; ++i) {
+    auto* route = vhost->add_routes();
+    if (regex_interval != 0 && i % regex_interval == regex_interval - 1) {
+      route->mutable_match()->mutable_safe_regex()->mutable_google_re2();
+      route->mutable_match()->mutable_safe_regex()->set_regex(fmt::format("/regex/{}/[a-z]+", i));
+    } else if (i % 2 == 0) {
+      route->mutable_match()->set_prefix(fmt::format("/shard/{}/", i));
+    } else {
+      route->mutable_match()->set_path(fmt::format("/shard/{}/resource", i));
+    }
+    route->mutable_route()->set_cluster(fmt::format("cluster_{}", i));
+  }
+  return config;
+}
+
+// Measures the lookup of the last prefix route in a virtual host. state.range(0) is the number of
+// routes and state.range(1) toggles the compiled route matcher.
+static void routeLookup(benchmark::State& state, uint64_t regex_interval) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.compiled_route_matcher", state.range(1) ? "true" : "false"}});
+
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  const uint64_t num_routes = state.range(0);
+  ConfigImpl config(makeRouteConfig(num_routes, regex_interval), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+
+  // Route num_routes - 2 or num_routes - 1 is the last prefix route, depending on the parity.
+  const uint64_t target = (num_routes - 1) - ((num_routes - 1) % 2);
+  Http::TestRequestHeaderMapImpl headers{{":authority", "www.example.com"},
+                                         {":path", fmt::format("/shard/{}/item?id=1", target)},
+                                         {":method", "GET"},
+                                         {"x-forwarded-proto", "http"}};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, 0);
+    RELEASE_ASSERT(route != nullptr, "");
+    benchmark::DoNotOptimize(route);
+  }
+}
+
+static void BM_PrefixAndPathRoutes(benchmark::State& state) { routeLookup(state, 0); }
+BENCHMARK(BM_PrefixAndPathRoutes)->RangeMultiplier(4)->Ranges({{16, 4096}, {0, 1}});
+
+// Every tenth route is a regex route. The compiled matcher matches all of them in one pass of a
+// regex set.
+static void BM_MixedRoutes(benchmark::State& state) { routeLookup(state, 10); }
+BENCHMARK(BM_MixedRoutes)->RangeMultiplier(4)->Ranges({{16, 4096}, {0, 1}});
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
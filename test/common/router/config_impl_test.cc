@@ -1132,6 +1132,72 @@ virtual_hosts:
   }
 }
 
+// Route selection through the path index must give the same first-match-wins result as the
+// linear scan when prefix, path, regex, header and case insensitive routes are mixed.
+TEST_F(RouteMatcherTest, CompiledRouteMatcher) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: www
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/api", headers: [{ name: x-canary, exact_match: "true" }] }
+        route: { cluster: "canary" }
+      - match: { path: "/api/v1/users" }
+        route: { cluster: "users_exact" }
+      - match: { safe_regex: { google_re2: {}, regex: "/api/v1/users/[0-9]+" } }
+        route: { cluster: "users_regex" }
+      - match: { prefix: "/api/v1" }
+        route: { cluster: "v1" }
+      - match: { prefix: "/API/V2", case_sensitive: false }
+        route: { cluster: "v2_insensitive" }
+      - match: { prefix: "/api/v2/" }
+        route: { cluster: "v2" }
+      - match: { prefix: "/api" }
+        route: { cluster: "api" }
+      - match: { path: "/api/v1/shadowed" }
+        route: { cluster: "shadowed" }
+      - match: { prefix: "/static/" }
+        route: { cluster: "static" }
+  )EOF";
+
+  const auto proto_config = parseRouteConfigurationFromV2Yaml(yaml);
+  for (const std::string enabled : {"false", "true"}) {
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.compiled_route_matcher", enabled}});
+    TestConfigImpl config(proto_config, factory_context_, true);
+
+    EXPECT_EQ("users_exact", config.route(genHeaders("www.lyft.com", "/api/v1/users?x=1", "GET"), 0)
+                                 ->routeEntry()
+                                 ->clusterName());
+    EXPECT_EQ("users_regex", config.route(genHeaders("www.lyft.com", "/api/v1/users/42", "GET"), 0)
+                                 ->routeEntry()
+                                 ->clusterName());
+    EXPECT_EQ("v1", config.route(genHeaders("www.lyft.com", "/api/v1/users/abc", "GET"), 0)
+                        ->routeEntry()
+                        ->clusterName());
+    EXPECT_EQ("v1", config.route(genHeaders("www.lyft.com", "/api/v1/shadowed", "GET"), 0)
+                        ->routeEntry()
+                        ->clusterName());
+    EXPECT_EQ("v2_insensitive", config.route(genHeaders("www.lyft.com", "/api/v2/foo", "GET"), 0)
+                                    ->routeEntry()
+                                    ->clusterName());
+    EXPECT_EQ("api", config.route(genHeaders("www.lyft.com", "/api", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+    EXPECT_EQ("static", config.route(genHeaders("www.lyft.com", "/static/app.js", "GET"), 0)
+                            ->routeEntry()
+                            ->clusterName());
+    EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/static", "GET"), 0));
+    EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/", "GET"), 0));
+
+    Http::TestRequestHeaderMapImpl canary_headers =
+        genHeaders("www.lyft.com", "/api/v1/users", "GET");
+    canary_headers.addCopy("x-canary", "true");
+    EXPECT_EQ("canary", config.route(canary_headers, 0)->routeEntry()->clusterName());
+  }
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithWildcardAndDefaultOnly) {
   const std::string yaml = R"EOF(
 virtual_hosts:
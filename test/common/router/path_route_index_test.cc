@@ -0,0 +1,120 @@
+#include "envoy/type/matcher/v3/regex.pb.h"
+
+#include "common/common/regex.h"
+#include "common/router/path_route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+PathRouteIndex::Candidates find(const PathRouteIndex& index, absl::string_view path) {
+  PathRouteIndex::Candidates candidates;
+  index.findCandidates(path, candidates);
+  return candidates;
+}
+
+TEST(PathRouteIndexTest, Empty) {
+  PathRouteIndex index;
+  EXPECT_EQ(0, index.size());
+  EXPECT_THAT(find(index, "/"), IsEmpty());
+}
+
+TEST(PathRouteIndexTest, PrefixAndExact) {
+  PathRouteIndex index;
+  index.addExact(0, "/foo/bar");
+  index.addPrefix(1, "/foo");
+  index.addPrefix(2, "/");
+  index.addExact(3, "/foo");
+  index.addPrefix(4, "/foo/baz");
+  index.addPrefix(5, "");
+  EXPECT_EQ(6, index.size());
+
+  EXPECT_THAT(find(index, "/foo/bar"), ElementsAre(0, 1, 2, 5));
+  EXPECT_THAT(find(index, "/foo/bar/"), ElementsAre(1, 2, 5));
+  EXPECT_THAT(find(index, "/foo"), ElementsAre(1, 2, 3, 5));
+  EXPECT_THAT(find(index, "/foo/baz/qux"), ElementsAre(1, 2, 4, 5));
+  EXPECT_THAT(find(index, "/fo"), ElementsAre(2, 5));
+  EXPECT_THAT(find(index, "/other"), ElementsAre(2, 5));
+  EXPECT_THAT(find(index, ""), ElementsAre(5));
+}
+
+// Inserting keys that diverge inside an existing edge splits the edge without losing routes.
+TEST(PathRouteIndexTest, EdgeSplit) {
+  PathRouteIndex index;
+  index.addPrefix(0, "/images/large");
+  index.addPrefix(1, "/images/small");
+  index.addExact(2, "/img");
+  index.addPrefix(3, "/images");
+
+  EXPECT_THAT(find(index, "/images/large/1.png"), ElementsAre(0, 3));
+  EXPECT_THAT(find(index, "/images/small/1.png"), ElementsAre(1, 3));
+  EXPECT_THAT(find(index, "/images/medium"), ElementsAre(3));
+  EXPECT_THAT(find(index, "/img"), ElementsAre(2));
+  EXPECT_THAT(find(index, "/imag"), IsEmpty());
+}
+
+TEST(PathRouteIndexTest, Unindexed) {
+  PathRouteIndex index;
+  index.addPrefix(0, "/a");
+  index.addUnindexed(1);
+  index.addExact(2, "/b");
+  index.addUnindexed(3);
+
+  EXPECT_THAT(find(index, "/a"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(find(index, "/b"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(find(index, "/c"), ElementsAre(1, 3));
+}
+
+class FailingMatcherSet : public Regex::CompiledMatcherSet {
+public:
+  bool match(absl::string_view, std::vector<int>&) const override { return false; }
+};
+
+TEST(PathRouteIndexTest, RegexSet) {
+  std::vector<envoy::type::matcher::v3::RegexMatcher> regexes(2);
+  regexes[0].mutable_google_re2();
+  regexes[0].set_regex("/users/[0-9]+");
+  regexes[1].mutable_google_re2();
+  regexes[1].set_regex("/[a-z]+/[0-9]+");
+
+  PathRouteIndex index;
+  index.addPrefix(0, "/users");
+  index.addPrefix(2, "/");
+  index.addRegexSet({3, 1}, Regex::Utility::parseRegexSet(regexes));
+  EXPECT_EQ(4, index.size());
+
+  EXPECT_THAT(find(index, "/users/42"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(find(index, "/groups/42"), ElementsAre(1, 2));
+  EXPECT_THAT(find(index, "/users/abc"), ElementsAre(0, 2));
+}
+
+// If the regex engine cannot complete a match, all regex routes are candidates.
+TEST(PathRouteIndexTest, RegexSetFailure) {
+  PathRouteIndex index;
+  index.addPrefix(0, "/a");
+  index.addRegexSet({1, 2}, std::make_unique<FailingMatcherSet>());
+
+  EXPECT_THAT(find(index, "/a"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(find(index, "/b"), ElementsAre(1, 2));
+}
+
+TEST(PathRouteIndexTest, DuplicateKeys) {
+  PathRouteIndex index;
+  index.addPrefix(0, "/a");
+  index.addPrefix(1, "/a");
+  index.addExact(2, "/a");
+  index.addExact(3, "/a");
+
+  EXPECT_THAT(find(index, "/a"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(find(index, "/ab"), ElementsAre(0, 1));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
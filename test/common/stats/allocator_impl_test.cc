@@ -128,6 +128,68 @@ TEST_F(AllocatorImplTest, RefCountDecAllocRaceSynchronized) {
   EXPECT_FALSE(alloc_.isMutexLockedForTest());
 }
 
+// Without tracking, changes are not queued.
+TEST_F(AllocatorImplTest, ChangedStatsNotTracked) {
+  CounterSharedPtr counter = alloc_.makeCounter(makeStat("counter"), StatName(), {});
+  counter->inc();
+  std::vector<CounterSharedPtr> counters;
+  std::vector<GaugeSharedPtr> gauges;
+  alloc_.takeChangedStats(counters, gauges);
+  EXPECT_TRUE(counters.empty());
+  EXPECT_TRUE(gauges.empty());
+}
+
+TEST_F(AllocatorImplTest, ChangedStats) {
+  CounterSharedPtr c1 = alloc_.makeCounter(makeStat("c1"), StatName(), {});
+  GaugeSharedPtr g1 =
+      alloc_.makeGauge(makeStat("g1"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  alloc_.trackChangedStats();
+  CounterSharedPtr c2 = alloc_.makeCounter(makeStat("c2"), StatName(), {});
+
+  // The stats which existed when tracking started, and those created since, are taken once.
+  std::vector<CounterSharedPtr> counters;
+  std::vector<GaugeSharedPtr> gauges;
+  c1->inc();
+  alloc_.takeChangedStats(counters, gauges);
+  EXPECT_EQ((std::vector<CounterSharedPtr>{c1, c2}), counters);
+  EXPECT_EQ((std::vector<GaugeSharedPtr>{g1}), gauges);
+  counters.clear();
+  gauges.clear();
+  alloc_.takeChangedStats(counters, gauges);
+  EXPECT_TRUE(counters.empty());
+  EXPECT_TRUE(gauges.empty());
+
+  // Each change queues the stat again, but only once until it is taken.
+  c2->add(2);
+  c2->inc();
+  c1->reset();
+  g1->set(3);
+  g1->sub(1);
+  alloc_.takeChangedStats(counters, gauges);
+  EXPECT_EQ((std::vector<CounterSharedPtr>{c2, c1}), counters);
+  EXPECT_EQ((std::vector<GaugeSharedPtr>{g1}), gauges);
+  counters.clear();
+  gauges.clear();
+  g1->sub(1);
+  alloc_.takeChangedStats(counters, gauges);
+  EXPECT_TRUE(counters.empty());
+  EXPECT_EQ((std::vector<GaugeSharedPtr>{g1}), gauges);
+}
+
+// Queued stats are kept alive until they are taken, or until the allocator is destroyed.
+TEST_F(AllocatorImplTest, ChangedStatsReleased) {
+  alloc_.trackChangedStats();
+  alloc_.makeCounter(makeStat("c1"), StatName(), {});
+  std::vector<CounterSharedPtr> counters;
+  std::vector<GaugeSharedPtr> gauges;
+  alloc_.takeChangedStats(counters, gauges);
+  ASSERT_EQ(1, counters.size());
+  EXPECT_EQ(1, counters[0]->use_count());
+  counters.clear();
+
+  alloc_.makeGauge(makeStat("g1"), StatName(), {}, Gauge::ImportMode::Accumulate);
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
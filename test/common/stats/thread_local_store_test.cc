@@ -1,4 +1,5 @@
 #include <chrono>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -21,8 +22,10 @@
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/notification.h"
@@ -31,6 +34,7 @@
 
 using testing::_;
 using testing::InSequence;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Ref;
 using testing::Return;
@@ -113,6 +117,7 @@ public:
   uint64_t validateMerge() {
     bool merge_called = false;
     store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+    runPostedCallbacks(merge_called);
 
     EXPECT_TRUE(merge_called);
 
@@ -158,6 +163,33 @@ public:
     return histogram_list.size();
   }
 
+  // Posts to the main thread dispatcher are queued, rather than run inline, and are run by
+  // runPostedCallbacks(). This lets histograms be merged on threads while publishing them on the
+  // test thread.
+  void queuePostedCallbacks() {
+    ON_CALL(main_thread_dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      Thread::LockGuard lock(posted_lock_);
+      posted_.push_back(cb);
+      posted_cv_.notifyOne();
+    }));
+  }
+
+  // Runs the callbacks posted to the main thread dispatcher until done is set.
+  void runPostedCallbacks(const bool& done) {
+    while (!done) {
+      Event::PostCb cb;
+      {
+        Thread::LockGuard lock(posted_lock_);
+        while (posted_.empty()) {
+          posted_cv_.wait(posted_lock_);
+        }
+        cb = posted_.front();
+        posted_.pop_front();
+      }
+      cb();
+    }
+  }
+
   void expectCallAndAccumulate(Histogram& histogram, uint64_t record_value) {
     EXPECT_CALL(sink_, onHistogramComplete(Ref(histogram), record_value));
     histogram.recordValue(record_value);
@@ -180,6 +212,21 @@ public:
   InSequence s;
   std::vector<uint64_t> h1_cumulative_values_, h2_cumulative_values_, h1_interval_values_,
       h2_interval_values_;
+  Thread::MutexBasicLockable posted_lock_;
+  Thread::CondVar posted_cv_;
+  std::list<Event::PostCb> posted_ ABSL_GUARDED_BY(posted_lock_);
+};
+
+// Histograms are merged on a pool of threads, and published on the main thread.
+class HistogramMergeThreadsTest : public HistogramTest {
+public:
+  void SetUp() override {
+    queuePostedCallbacks();
+    store_ = std::make_unique<ThreadLocalStoreImpl>(alloc_);
+    store_->addSink(sink_);
+    store_->setHistogramMergeThreads(Thread::threadFactoryForTest(), 4);
+    store_->initializeThreading(main_thread_dispatcher_, tls_);
+  }
 };
 
 TEST_F(StatsThreadLocalStoreTest, NoTls) {
@@ -1234,6 +1281,59 @@ TEST_F(HistogramTest, MultiHistogramMultipleMerges) {
   EXPECT_EQ(2, validateMerge());
 }
 
+TEST_F(HistogramMergeThreadsTest, MultiHistogramMultipleMerges) {
+  Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
+  Histogram& h2 = store_->histogramFromString("h2", Stats::Histogram::Unit::Unspecified);
+
+  expectCallAndAccumulate(h1, 1);
+  EXPECT_EQ(2, validateMerge());
+
+  expectCallAndAccumulate(h2, 1);
+  expectCallAndAccumulate(h1, 2);
+  EXPECT_EQ(2, validateMerge());
+
+  expectCallAndAccumulate(h2, 3);
+  EXPECT_EQ(2, validateMerge());
+
+  EXPECT_EQ(2, validateMerge());
+}
+
+// The statistics of a merge in progress are not visible until the merge is published.
+TEST_F(HistogramMergeThreadsTest, PublishOnMainThread) {
+  Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
+  expectCallAndAccumulate(h1, 1);
+  std::vector<ParentHistogramSharedPtr> histograms = store_->histograms();
+  ASSERT_EQ(1, histograms.size());
+
+  bool merge_called = false;
+  store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+  EXPECT_FALSE(merge_called);
+  EXPECT_FALSE(histograms[0]->used());
+  EXPECT_EQ(0, histograms[0]->intervalStatistics().sampleCount());
+  runPostedCallbacks(merge_called);
+  EXPECT_TRUE(histograms[0]->used());
+  EXPECT_EQ(1, histograms[0]->intervalStatistics().sampleCount());
+}
+
+// A large number of histograms is split among the threads.
+TEST_F(HistogramMergeThreadsTest, ManyHistograms) {
+  for (uint64_t i = 0; i < 1000; ++i) {
+    Histogram& histogram = store_->histogramFromString(absl::StrCat("histogram_", i),
+                                                       Stats::Histogram::Unit::Unspecified);
+    EXPECT_CALL(sink_, onHistogramComplete(Ref(histogram), i));
+    histogram.recordValue(i);
+  }
+
+  bool merge_called = false;
+  store_->mergeHistograms([&merge_called]() -> void { merge_called = true; });
+  runPostedCallbacks(merge_called);
+  for (const ParentHistogramSharedPtr& histogram : store_->histograms()) {
+    EXPECT_TRUE(histogram->used());
+    EXPECT_EQ(1, histogram->intervalStatistics().sampleCount());
+    EXPECT_EQ(1, histogram->cumulativeStatistics().sampleCount());
+  }
+}
+
 TEST_F(HistogramTest, BasicScopeHistogramMerge) {
   ScopePtr scope1 = store_->createScope("scope1.");
 
@@ -0,0 +1,141 @@
+// Compares moving bulk data between two sockets through a user space buffer, which is how the TCP
+// proxy forwards data by default, with moving it through a kernel pipe with splice(2).
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+constexpr int SocketBufferSize = 1024 * 1024;
+constexpr int PipeSize = 1024 * 1024;
+
+// Socket pairs standing in for the downstream and upstream connections of a proxy. The client
+// writes to the downstream pair and the server reads from the upstream pair.
+class SocketPairs {
+public:
+  SocketPairs() {
+    createPair(downstream_);
+    createPair(upstream_);
+  }
+
+  ~SocketPairs() {
+    for (int fd : {downstream_[0], downstream_[1], upstream_[0], upstream_[1]}) {
+      ::close(fd);
+    }
+  }
+
+  int client() const { return downstream_[0]; }
+  int downstreamProxy() const { return downstream_[1]; }
+  int upstreamProxy() const { return upstream_[0]; }
+  int server() const { return upstream_[1]; }
+
+  // Sends `length` bytes from the client to the server, calling `forward` to move data from the
+  // downstream to the upstream socket whenever the client cannot write more.
+  template <class Forward>
+  void transfer(const std::string& data, uint64_t length, Forward forward) {
+    uint64_t written = 0;
+    uint64_t received = 0;
+    char scratch[65536];
+    while (received < length) {
+      while (written < length) {
+        const ssize_t rc =
+            ::write(client(), data.data(), std::min<uint64_t>(data.size(), length - written));
+        if (rc <= 0) {
+          break;
+        }
+        written += rc;
+      }
+      forward();
+      ssize_t rc;
+      while ((rc = ::read(server(), scratch, sizeof(scratch))) > 0) {
+        received += rc;
+      }
+    }
+  }
+
+private:
+  static void createPair(int fds[2]) {
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    for (int i = 0; i < 2; i++) {
+      ::setsockopt(fds[i], SOL_SOCKET, SO_SNDBUF, &SocketBufferSize, sizeof(SocketBufferSize));
+      ::setsockopt(fds[i], SOL_SOCKET, SO_RCVBUF, &SocketBufferSize, sizeof(SocketBufferSize));
+    }
+  }
+
+  int downstream_[2];
+  int upstream_[2];
+};
+
+// Forward through a Buffer::OwnedImpl, as ConnectionImpl and the TCP proxy filter do.
+static void bufferCopy(benchmark::State& state) {
+  const uint64_t length = state.range(0);
+  const std::string data(65536, 'a');
+  SocketPairs sockets;
+  // The handles close their descriptors, so give them their own.
+  Network::IoSocketHandleImpl downstream(::dup(sockets.downstreamProxy()));
+  Network::IoSocketHandleImpl upstream(::dup(sockets.upstreamProxy()));
+  Buffer::OwnedImpl buffer;
+
+  for (auto _ : state) {
+    sockets.transfer(data, length, [&]() {
+      while (buffer.read(downstream, 16384).rc_ > 0) {
+      }
+      while (buffer.length() > 0 && buffer.write(upstream).rc_ > 0) {
+      }
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(bufferCopy)->Arg(16 * 1024)->Arg(256 * 1024)->Arg(4 * 1024 * 1024);
+
+// Forward through a pipe with splice(2), as TcpProxy::SpliceForwarder does.
+static void splicePipe(benchmark::State& state) {
+  const uint64_t length = state.range(0);
+  const std::string data(65536, 'a');
+  SocketPairs sockets;
+  int pipe[2];
+  RELEASE_ASSERT(::pipe2(pipe, O_NONBLOCK | O_CLOEXEC) == 0, "");
+  ::fcntl(pipe[1], F_SETPIPE_SZ, PipeSize);
+  uint64_t buffered = 0;
+
+  for (auto _ : state) {
+    sockets.transfer(data, length, [&]() {
+      bool progress = true;
+      while (progress) {
+        progress = false;
+        ssize_t rc = ::splice(sockets.downstreamProxy(), nullptr, pipe[1], nullptr, PipeSize,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (rc > 0) {
+          buffered += rc;
+          progress = true;
+        }
+        if (buffered > 0) {
+          rc = ::splice(pipe[0], nullptr, sockets.upstreamProxy(), nullptr, buffered,
+                        SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+          if (rc > 0) {
+            buffered -= rc;
+            progress = true;
+          }
+        }
+      }
+    });
+  }
+  ::close(pipe[0]);
+  ::close(pipe[1]);
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(splicePipe)->Arg(16 * 1024)->Arg(256 * 1024)->Arg(4 * 1024 * 1024);
+
+} // namespace
+} // namespace Envoy
@@ -13,6 +13,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/application_protocol.h"
+#include "common/network/io_socket_handle_impl.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -1015,6 +1016,91 @@ TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(HalfCloseProxy)) {
   upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+#if defined(__linux__)
+// Data and half closes are moved between the downstream and upstream sockets with splice(2) when
+// both connections use a passthrough transport socket.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(Splice)) {
+  os_fd_t downstream_fds[2];
+  os_fd_t upstream_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, downstream_fds));
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, upstream_fds));
+  Network::IoSocketHandleImpl downstream_handle(downstream_fds[0]);
+  Network::IoSocketHandleImpl upstream_handle(upstream_fds[0]);
+  Network::IoSocketHandleImpl downstream_peer(downstream_fds[1]);
+  Network::IoSocketHandleImpl upstream_peer(upstream_fds[1]);
+
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+  ON_CALL(filter_callbacks_.connection_, passthroughIoHandle())
+      .WillByDefault(Return(&downstream_handle));
+  ON_CALL(*upstream_connections_.at(0), passthroughIoHandle())
+      .WillByDefault(Return(&upstream_handle));
+
+  // The forwarder watches the downstream socket first, then the upstream socket.
+  std::vector<Event::FileReadyCb> file_event_cbs;
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_,
+              createFileEvent_(_, _, Event::FileTriggerType::Edge, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](os_fd_t, Event::FileReadyCb cb, Event::FileTriggerType,
+                                 uint32_t) -> Event::FileEvent* {
+        file_event_cbs.push_back(cb);
+        return new NiceMock<Event::MockFileEvent>();
+      }));
+
+  // Downstream reads stay disabled and upstream reads get disabled.
+  EXPECT_CALL(filter_callbacks_.connection_, readDisable(false)).Times(0);
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true));
+  EXPECT_CALL(*upstream_connection_data_.at(0), addUpstreamCallbacks(_))
+      .WillOnce(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& cb) -> void {
+        upstream_callbacks_ = &cb;
+        upstream_connections_.at(0)->addConnectionCallbacks(cb);
+      }));
+  conn_pool_callbacks_.at(0)->onPoolReady(std::move(upstream_connection_data_.at(0)),
+                                          upstream_hosts_.at(0));
+  ASSERT_EQ(2, file_event_cbs.size());
+
+  char data[16];
+  ASSERT_EQ(5, ::write(downstream_fds[1], "hello", 5));
+  file_event_cbs[0](Event::FileReadyType::Read);
+  EXPECT_EQ(5, ::read(upstream_fds[1], data, sizeof(data)));
+  EXPECT_EQ("hello", absl::string_view(data, 5));
+  EXPECT_EQ(5, config_->stats().downstream_cx_rx_bytes_total_.value());
+
+  ASSERT_EQ(5, ::write(upstream_fds[1], "world", 5));
+  file_event_cbs[1](Event::FileReadyType::Read);
+  EXPECT_EQ(5, ::read(downstream_fds[1], data, sizeof(data)));
+  EXPECT_EQ("world", absl::string_view(data, 5));
+  EXPECT_EQ(5, config_->stats().downstream_cx_tx_bytes_total_.value());
+
+  // Half closes are forwarded through the connections.
+  ASSERT_EQ(0, ::shutdown(downstream_fds[1], SHUT_WR));
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferStringEqual(""), true));
+  file_event_cbs[0](Event::FileReadyType::Read);
+
+  // Once both sides are done the downstream connection is closed, which releases the forwarder.
+  ASSERT_EQ(0, ::shutdown(upstream_fds[1], SHUT_WR));
+  EXPECT_CALL(filter_callbacks_.connection_, write(BufferStringEqual(""), true));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(false));
+  file_event_cbs[1](Event::FileReadyType::Read);
+}
+
+// The filter falls back to proxying through the connection buffers when a transport socket does
+// not allow direct access to the socket.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(SpliceNotPassthrough)) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  raiseEventUpstreamConnected(0);
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+#endif
+
 // Test that downstream is closed after an upstream LocalClose.
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamLocalDisconnect)) {
   setup(1);
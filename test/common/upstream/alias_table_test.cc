@@ -0,0 +1,58 @@
+#include <vector>
+
+#include "common/upstream/alias_table.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Returns the random value which selects column index and compares fraction of 2^32 against the
+// threshold of the column.
+uint64_t randomFor(uint32_t index, double fraction) {
+  return (static_cast<uint64_t>(fraction * (1ULL << 32)) << 32) | index;
+}
+
+TEST(AliasTableTest, SingleIndex) {
+  AliasTable table({5});
+  EXPECT_EQ(1UL, table.size());
+  EXPECT_EQ(0, table.pick(0));
+  EXPECT_EQ(0, table.pick(~0ULL));
+}
+
+// A column is split between its own index and its alias in proportion to the weights.
+TEST(AliasTableTest, Columns) {
+  AliasTable table({1, 3});
+  EXPECT_EQ(2UL, table.size());
+  EXPECT_EQ(0, table.pick(randomFor(0, 0)));
+  EXPECT_EQ(0, table.pick(randomFor(0, 0.49)));
+  EXPECT_EQ(1, table.pick(randomFor(0, 0.5)));
+  EXPECT_EQ(1, table.pick(randomFor(0, 0.99)));
+  EXPECT_EQ(1, table.pick(randomFor(1, 0)));
+  EXPECT_EQ(1, table.pick(randomFor(1, 0.99)));
+}
+
+// Spreading random values evenly over all columns picks every index in proportion to its weight.
+// Indices with a weight of 0 are never picked.
+TEST(AliasTableTest, Weighted) {
+  const std::vector<double> weights{1, 2, 3, 4, 0, 10};
+  AliasTable table(weights);
+  constexpr uint32_t steps = 1000;
+  std::vector<uint32_t> pick_count(weights.size());
+  for (uint32_t index = 0; index < weights.size(); ++index) {
+    for (uint32_t step = 0; step < steps; ++step) {
+      ++pick_count[table.pick(randomFor(index, (step + 0.5) / steps))];
+    }
+  }
+
+  for (uint32_t index = 0; index < weights.size(); ++index) {
+    EXPECT_NEAR(weights[index] / 20 * weights.size() * steps, pick_count[index], weights.size())
+        << "index " << index;
+  }
+  EXPECT_EQ(0, pick_count[4]);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
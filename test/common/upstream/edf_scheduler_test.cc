@@ -71,6 +71,56 @@ TEST(EdfSchedulerTest, Expired) {
   EXPECT_EQ(nullptr, sched.pick());
 }
 
+// Removed entries are skipped by pick().
+TEST(EdfSchedulerTest, Remove) {
+  EdfScheduler<uint32_t> sched;
+  auto first_entry = std::make_shared<uint32_t>(37);
+  auto second_entry = std::make_shared<uint32_t>(42);
+  sched.add(1, first_entry);
+  sched.add(1, second_entry);
+  sched.remove(first_entry);
+
+  for (int i = 0; i < 3; ++i) {
+    auto p = sched.pick();
+    EXPECT_EQ(second_entry, p);
+    sched.add(1, p);
+  }
+}
+
+// Adding an entry back before it is picked cancels its removal and keeps its deadline.
+TEST(EdfSchedulerTest, RemoveThenAdd) {
+  EdfScheduler<uint32_t> sched;
+  auto first_entry = std::make_shared<uint32_t>(37);
+  auto second_entry = std::make_shared<uint32_t>(42);
+  sched.add(2, first_entry);
+  sched.add(1, second_entry);
+  sched.remove(first_entry);
+  sched.add(2, first_entry);
+
+  // The entry was queued only once.
+  EXPECT_EQ(first_entry, sched.pick());
+  EXPECT_EQ(second_entry, sched.pick());
+  EXPECT_EQ(nullptr, sched.pick());
+}
+
+// A removed entry which is destroyed is not kept alive by the scheduler.
+TEST(EdfSchedulerTest, RemoveExpired) {
+  EdfScheduler<uint32_t> sched;
+  auto second_entry = std::make_shared<uint32_t>(42);
+  std::weak_ptr<uint32_t> first_weak;
+  {
+    auto first_entry = std::make_shared<uint32_t>(37);
+    first_weak = first_entry;
+    sched.add(2, first_entry);
+    sched.add(1, second_entry);
+    sched.remove(first_entry);
+  }
+  EXPECT_TRUE(first_weak.expired());
+
+  EXPECT_EQ(second_entry, sched.pick());
+  EXPECT_EQ(nullptr, sched.pick());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
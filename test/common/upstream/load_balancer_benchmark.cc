@@ -1,5 +1,6 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
+#include <deque>
 #include <memory>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -12,6 +13,7 @@
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "benchmark/benchmark.h"
 
@@ -40,6 +42,14 @@ public:
                                     {}, hosts, {}, absl::nullopt);
   }
 
+  void setHashBalanceFactor(uint32_t hash_balance_factor) {
+    if (hash_balance_factor > 0) {
+      common_config_.mutable_consistent_hashing_lb_config()
+          ->mutable_hash_balance_factor()
+          ->set_value(hash_balance_factor);
+    }
+  }
+
   Envoy::Thread::MutexBasicLockable lock_;
   // Reduce default log level to warn while running this benchmark to avoid problems due to
   // excessive debug logging in upstream_impl.cc
@@ -69,6 +79,23 @@ public:
   std::unique_ptr<RoundRobinLoadBalancer> lb_;
 };
 
+class RandomTester : public BaseTester {
+public:
+  RandomTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+      : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.weighted_random_lb", "true"}});
+  }
+
+  void initialize() {
+    lb_ = std::make_unique<RandomLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                               runtime_, random_, common_config_);
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  std::unique_ptr<RandomLoadBalancer> lb_;
+};
+
 class LeastRequestTester : public BaseTester {
 public:
   LeastRequestTester(uint64_t num_hosts, uint32_t choice_count) : BaseTester(num_hosts) {
@@ -124,9 +151,113 @@ BENCHMARK(BM_RoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(benchmark::kMillisecond);
 
+void BM_RandomLoadBalancerBuild(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t weighted_subset_percent = state.range(1);
+    const uint64_t weight = state.range(2);
+
+    RandomTester tester(num_hosts, weighted_subset_percent, weight);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    // We are only interested in timing the initial build.
+    state.ResumeTiming();
+    tester.initialize();
+    state.PauseTiming();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_host"] = (end_mem - start_mem) / num_hosts;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_RandomLoadBalancerBuild)
+    ->Args({500, 0, 1})
+    ->Args({500, 50, 50})
+    ->Args({10000, 0, 1})
+    ->Args({10000, 50, 50})
+    ->Args({50000, 0, 1})
+    ->Args({50000, 50, 50})
+    ->Unit(benchmark::kMillisecond);
+
+// Weighted picks take O(log n) time with the EDF scheduler of the round robin load balancer, and
+// O(1) time with the alias table of the random load balancer.
+void BM_RoundRobinLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  RoundRobinTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.initialize();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(BM_RoundRobinLoadBalancerChooseHost)
+    ->Args({500, 0, 1})
+    ->Args({500, 50, 50})
+    ->Args({10000, 0, 1})
+    ->Args({10000, 50, 50})
+    ->Args({50000, 0, 1})
+    ->Args({50000, 50, 50});
+
+void BM_RandomLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  RandomTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.initialize();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+}
+BENCHMARK(BM_RandomLoadBalancerChooseHost)
+    ->Args({500, 0, 1})
+    ->Args({500, 50, 50})
+    ->Args({10000, 0, 1})
+    ->Args({10000, 50, 50})
+    ->Args({50000, 0, 1})
+    ->Args({50000, 50, 50});
+
+// Times the update of the schedules of a weighted round robin load balancer when a host is removed
+// and added back, with the schedules either updated incrementally or rebuilt.
+void BM_RoundRobinLoadBalancerUpdate(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.incremental_edf_update", state.range(3) ? "true" : "false"}});
+  RoundRobinTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.initialize();
+
+  const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  const HostVector removed{hosts.back()};
+  const HostVector remaining(hosts.begin(), hosts.end() - 1);
+  const PrioritySet::UpdateHostsParams with_host = HostSetImpl::partitionHosts(
+      std::make_shared<HostVector>(hosts), makeHostsPerLocality({hosts}));
+  const PrioritySet::UpdateHostsParams without_host = HostSetImpl::partitionHosts(
+      std::make_shared<HostVector>(remaining), makeHostsPerLocality({remaining}));
+  for (auto _ : state) {
+    tester.priority_set_.updateHosts(0, PrioritySet::UpdateHostsParams(without_host), {}, {},
+                                     removed, absl::nullopt);
+    tester.priority_set_.updateHosts(0, PrioritySet::UpdateHostsParams(with_host), {}, removed, {},
+                                     absl::nullopt);
+  }
+}
+BENCHMARK(BM_RoundRobinLoadBalancerUpdate)
+    ->Args({500, 50, 50, 0})
+    ->Args({500, 50, 50, 1})
+    ->Args({10000, 50, 50, 0})
+    ->Args({10000, 50, 50, 1})
+    ->Args({50000, 50, 50, 0})
+    ->Args({50000, 50, 50, 1})
+    ->Unit(benchmark::kMicrosecond);
+
 class RingHashTester : public BaseTester {
 public:
-  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
+  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size, uint32_t hash_balance_factor = 0)
+      : BaseTester(num_hosts) {
+    setHashBalanceFactor(hash_balance_factor);
     config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
     config_.value().mutable_minimum_ring_size()->set_value(min_ring_size);
     ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
@@ -139,8 +270,10 @@ public:
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               uint32_t hash_balance_factor = 0)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    setHashBalanceFactor(hash_balance_factor);
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
                                                       random_, common_config_);
   }
@@ -335,6 +468,84 @@ BENCHMARK(BM_MaglevLoadBalancerChooseHost)
     ->Args({500, 100000})
     ->Unit(benchmark::kMillisecond);
 
+// Sends keys_to_simulate requests, every other one of which is for one of 4 hot keys, while the
+// last active_requests of them remain active. Reports the highest number of active requests of a
+// host relative to the mean.
+void simulateSkewedLoad(benchmark::State& state, LoadBalancer& lb, ClusterStats& stats,
+                        uint64_t num_hosts, uint64_t active_requests, uint64_t keys_to_simulate) {
+  std::unordered_map<std::string, uint64_t> hit_counter;
+  std::deque<HostConstSharedPtr> active_hosts;
+  uint64_t max_active = 0;
+  TestLoadBalancerContext context;
+  for (uint64_t i = 0; i < keys_to_simulate; i++) {
+    context.hash_key_ = hashInt(i % 2 == 0 ? i % 8 : i);
+    HostConstSharedPtr host = lb.chooseHost(&context);
+    host->stats().rq_active_.inc();
+    stats.upstream_rq_active_.inc();
+    max_active = std::max(max_active, host->stats().rq_active_.value());
+    hit_counter[host->address()->asString()] += 1;
+    active_hosts.push_back(std::move(host));
+    if (active_hosts.size() > active_requests) {
+      active_hosts.front()->stats().rq_active_.dec();
+      stats.upstream_rq_active_.dec();
+      active_hosts.pop_front();
+    }
+  }
+
+  // Do not time computation of the load statistics.
+  state.PauseTiming();
+  state.counters["max_over_mean_active"] =
+      max_active / (static_cast<double>(active_requests) / num_hosts);
+  computeHitStats(state, hit_counter);
+  state.ResumeTiming();
+}
+
+void BM_RingHashLoadBalancerBoundedLoad(benchmark::State& state) {
+  for (auto _ : state) {
+    // Do not time the creation of the ring.
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t hash_balance_factor = state.range(1);
+    const uint64_t active_requests = state.range(2);
+    const uint64_t keys_to_simulate = state.range(3);
+    RingHashTester tester(num_hosts, 65536, hash_balance_factor);
+    tester.ring_hash_lb_->initialize();
+    LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create();
+    state.ResumeTiming();
+
+    simulateSkewedLoad(state, *lb, tester.stats_, num_hosts, active_requests, keys_to_simulate);
+  }
+}
+BENCHMARK(BM_RingHashLoadBalancerBoundedLoad)
+    ->Args({100, 0, 1000, 100000})
+    ->Args({100, 125, 1000, 100000})
+    ->Args({100, 150, 1000, 100000})
+    ->Args({100, 200, 1000, 100000})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MaglevLoadBalancerBoundedLoad(benchmark::State& state) {
+  for (auto _ : state) {
+    // Do not time the creation of the table.
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t hash_balance_factor = state.range(1);
+    const uint64_t active_requests = state.range(2);
+    const uint64_t keys_to_simulate = state.range(3);
+    MaglevTester tester(num_hosts, 0, 0, hash_balance_factor);
+    tester.maglev_lb_->initialize();
+    LoadBalancerPtr lb = tester.maglev_lb_->factory()->create();
+    state.ResumeTiming();
+
+    simulateSkewedLoad(state, *lb, tester.stats_, num_hosts, active_requests, keys_to_simulate);
+  }
+}
+BENCHMARK(BM_MaglevLoadBalancerBoundedLoad)
+    ->Args({100, 0, 1000, 100000})
+    ->Args({100, 125, 1000, 100000})
+    ->Args({100, 150, 1000, 100000})
+    ->Args({100, 200, 1000, 100000})
+    ->Unit(benchmark::kMillisecond);
+
 void BM_RingHashLoadBalancerHostLoss(benchmark::State& state) {
   for (auto _ : state) {
     const uint64_t num_hosts = state.range(0);
@@ -13,6 +13,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -900,6 +901,49 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Host set updates are applied to the existing schedule: hosts which remain keep their position,
+// new hosts are scheduled from the current time, and hosts which are gone are no longer picked.
+TEST_P(RoundRobinLoadBalancerTest, WeightedIncrementalUpdate) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.incremental_edf_update", "true"}});
+  HostSharedPtr host_80 = makeTestHost(info_, "tcp://127.0.0.1:80", 1);
+  HostSharedPtr host_81 = makeTestHost(info_, "tcp://127.0.0.1:81", 2);
+  HostSharedPtr host_82 = makeTestHost(info_, "tcp://127.0.0.1:82", 3);
+  HostSharedPtr host_83 = makeTestHost(info_, "tcp://127.0.0.1:83", 4);
+  const auto expect_picks = [this](const HostVector& hosts) {
+    for (const auto& host : hosts) {
+      EXPECT_EQ(host, lb_->chooseHost(nullptr));
+    }
+  };
+
+  hostSet().healthy_hosts_ = {host_80, host_81};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  expect_picks({host_81, host_80, host_81, host_81, host_80, host_81});
+
+  hostSet().healthy_hosts_.push_back(host_82);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({host_82}, {});
+  expect_picks({host_82, host_81, host_82, host_80, host_81, host_82, host_82, host_81, host_82,
+                host_80, host_81, host_82});
+
+  hostSet().healthy_hosts_ = {host_80, host_82, host_83};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({host_83}, {host_81});
+  expect_picks({host_83, host_82, host_83, host_82, host_83, host_80, host_82, host_83, host_83,
+                host_82});
+
+  // A host which becomes unhealthy is removed from the schedule of the healthy hosts, and keeps
+  // its position if it becomes healthy again before it would have been picked.
+  hostSet().healthy_hosts_ = {host_82, host_83};
+  hostSet().runCallbacks({}, {});
+  expect_picks({host_83, host_82, host_83, host_82, host_83, host_83});
+  hostSet().healthy_hosts_ = {host_80, host_82, host_83};
+  hostSet().runCallbacks({}, {});
+  expect_picks({host_82, host_83, host_82, host_83, host_82, host_83, host_80, host_83});
+}
+
 // Validate that the RNG seed influences pick order when weighted RR.
 TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
@@ -1586,6 +1630,46 @@ TEST_P(RandomLoadBalancerTest, Normal) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Host weights are ignored unless envoy.reloadable_features.weighted_random_lb is enabled.
+TEST_P(RandomLoadBalancerTest, WeightedDisabled) {
+  init();
+
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {});
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1ULL << 63));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
+TEST_P(RandomLoadBalancerTest, Weighted) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.weighted_random_lb", "true"}});
+  init();
+
+  // The low 32 bits of the random value choose a column of the alias table. Host :80 takes half
+  // of its own column, and :81 the rest of it and all of its own column.
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {});
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1ULL << 63));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // A weight change without a host set update is noticed once the host is picked, after which
+  // hosts with equal weights are picked uniformly.
+  hostSet().healthy_hosts_[0]->weight(3);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1ULL << 63));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
 TEST_P(RandomLoadBalancerTest, FailClusterOnPanic) {
   common_config_.mutable_zone_aware_lb_config()->set_fail_traffic_on_panic(true);
   init();
@@ -94,6 +94,35 @@ TEST_F(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// With a hash balance factor, hosts at their load bound are skipped for other entries of the
+// table.
+TEST_F(MaglevLoadBalancerTest, BoundedLoad) {
+  host_set_.hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      200);
+  init(7);
+
+  // The table is the one of the Basic test. With 5 active requests in the cluster, the bound of
+  // every host is ceil((5 + 1) / 6 * 2) = 2. The hash 0 maps to :92, then :94, :92 and :93 as the
+  // following attempts.
+  stats_.upstream_rq_active_.set(5);
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(host_set_.hosts_[2], lb->chooseHost(&context));
+
+  host_set_.hosts_[2]->stats().rq_active_.set(2);
+  host_set_.hosts_[4]->stats().rq_active_.set(2);
+  EXPECT_EQ(host_set_.hosts_[3], lb->chooseHost(&context));
+
+  host_set_.hosts_[4]->stats().rq_active_.set(1);
+  EXPECT_EQ(host_set_.hosts_[4], lb->chooseHost(&context));
+}
+
 // Basic with hostname.
 TEST_F(MaglevLoadBalancerTest, BasicWithHostName) {
   host_set_.hosts_ = {makeTestHost(info_, "90", "tcp://127.0.0.1:90"),
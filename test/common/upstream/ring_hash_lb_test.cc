@@ -165,6 +165,44 @@ TEST_P(RingHashLoadBalancerTest, Basic) {
   EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
 }
 
+// With a hash balance factor, hosts at their load bound are skipped for the next ones of the ring.
+TEST_P(RingHashLoadBalancerTest, BoundedLoad) {
+  hostSet().hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+  init();
+
+  // The ring is the one of the Basic test. With 9 active requests in the cluster, the bound of
+  // every host is ceil((9 + 1) / 6 * 1.5) = 3.
+  stats_.upstream_rq_active_.set(9);
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(3551244743356806947);
+  EXPECT_EQ(hostSet().hosts_[5], lb->chooseHost(&context));
+
+  // :95 and :93, which follow it on the ring, are at their bound.
+  hostSet().hosts_[5]->stats().rq_active_.set(3);
+  hostSet().hosts_[3]->stats().rq_active_.set(3);
+  EXPECT_EQ(hostSet().hosts_[1], lb->chooseHost(&context));
+
+  hostSet().hosts_[5]->stats().rq_active_.set(2);
+  EXPECT_EQ(hostSet().hosts_[5], lb->chooseHost(&context));
+
+  // When every host is at its bound the least loaded one is chosen.
+  for (const auto& host : hostSet().hosts_) {
+    host->stats().rq_active_.set(5);
+  }
+  hostSet().hosts_[0]->stats().rq_active_.set(4);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+}
+
 // Ensure if all the hosts with priority 0 unhealthy, the next priority hosts are used.
 TEST_P(RingHashFailoverTest, BasicFailover) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
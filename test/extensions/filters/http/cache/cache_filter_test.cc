@@ -1,3 +1,5 @@
+#include "common/stats/isolated_store_impl.h"
+
 #include "extensions/filters/http/cache/cache_filter.h"
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
@@ -18,10 +20,13 @@ namespace {
 // getHeaders and decodeHeaders return.
 class DelayedCache : public SimpleHttpCache {
 public:
+  using SimpleHttpCache::SimpleHttpCache;
+
   // HttpCache
-  LookupContextPtr makeLookupContext(LookupRequest&& request) override {
+  LookupContextPtr makeLookupContext(LookupRequest&& request,
+                                     Event::Dispatcher& dispatcher) override {
     return std::make_unique<DelayedLookupContext>(
-        SimpleHttpCache::makeLookupContext(std::move(request)), delayed_cb_);
+        SimpleHttpCache::makeLookupContext(std::move(request), dispatcher), delayed_cb_);
   }
   InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override {
     return SimpleHttpCache::makeInsertContext(
@@ -58,8 +63,9 @@ protected:
     return filter;
   }
 
-  SimpleHttpCache simple_cache_;
-  DelayedCache delayed_cache_;
+  Stats::IsolatedStoreImpl stats_store_;
+  SimpleHttpCache simple_cache_{{}, stats_store_};
+  DelayedCache delayed_cache_{{}, stats_store_};
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config_;
   NiceMock<Server::Configuration::MockFactoryContext> context_;
   Event::SimulatedTimeSystem time_source_;
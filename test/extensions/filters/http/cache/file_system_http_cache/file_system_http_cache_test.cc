@@ -0,0 +1,407 @@
+#include <unistd.h>
+
+#include "envoy/registry/registry.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/filesystem/directory.h"
+#include "common/http/header_map_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class FileSystemHttpCacheTest : public testing::Test {
+protected:
+  FileSystemHttpCacheTest() {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCacheControl("max-age=3600");
+    TestEnvironment::removePath(cache_path_);
+    TestEnvironment::createPath(cache_path_);
+  }
+
+  ~FileSystemHttpCacheTest() override {
+    cache_.reset();
+    TestEnvironment::removePath(cache_path_);
+  }
+
+  void initialize(uint64_t max_cache_size_bytes = 0) {
+    envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig config;
+    config.set_cache_path(cache_path_);
+    config.set_max_cache_size_bytes(max_cache_size_bytes);
+    cache_.reset();
+    cache_ = std::make_unique<FileSystemHttpCache>(config, *api_, stats_store_);
+    cache_->waitForWritesForTest();
+  }
+
+  // Starts a cache lookup. Returns whether it completed before returning.
+  bool startLookup(absl::string_view request_path, LookupContextPtr& context) {
+    request_headers_.setPath(request_path);
+    context =
+        cache_->makeLookupContext(LookupRequest(request_headers_, current_time_), *dispatcher_);
+    lookup_done_ = false;
+    waiting_ = false;
+    context->getHeaders([this](LookupResult&& result) {
+      lookup_result_ = std::move(result);
+      lookup_done_ = true;
+      if (waiting_) {
+        dispatcher_->exit();
+      }
+    });
+    return lookup_done_;
+  }
+
+  // Runs the dispatcher until the lookup started by startLookup() completes.
+  void waitForLookup() {
+    if (!lookup_done_) {
+      waiting_ = true;
+      dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+      waiting_ = false;
+    }
+  }
+
+  // Performs a cache lookup.
+  LookupContextPtr lookup(absl::string_view request_path) {
+    LookupContextPtr context;
+    startLookup(request_path, context);
+    waitForLookup();
+    return context;
+  }
+
+  // Inserts a value into the cache, and waits for it to be written.
+  void insert(absl::string_view request_path, absl::string_view response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(lookup(request_path));
+    inserter->insertHeaders(response_headers_, false);
+    inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
+    cache_->waitForWritesForTest();
+  }
+
+  std::string getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    std::string body;
+    context.getBody(AdjustedByteRange(start, end), [&body](Buffer::InstancePtr&& data) {
+      ASSERT_NE(data, nullptr);
+      body = data->toString();
+    });
+    return body;
+  }
+
+  // The size of the file of the entry for request_path with a body of body_size bytes.
+  uint64_t fileSize(absl::string_view request_path, uint64_t body_size) {
+    request_headers_.setPath(request_path);
+    const LookupRequest request(request_headers_, current_time_);
+    return CacheFile::serializePrefix(request.key(), response_headers_, nullptr, 0).size() +
+           body_size;
+  }
+
+  const std::string cache_path_{TestEnvironment::temporaryPath("file_system_http_cache_test")};
+  Stats::IsolatedStoreImpl stats_store_;
+  Api::ApiPtr api_{Api::createApiForTest()};
+  Event::DispatcherPtr dispatcher_{api_->allocateDispatcher("test_thread")};
+  std::unique_ptr<FileSystemHttpCache> cache_;
+  LookupResult lookup_result_;
+  bool lookup_done_{};
+  bool waiting_{};
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Event::SimulatedTimeSystem time_source_;
+  SystemTime current_time_ = time_source_.systemTime();
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  const Http::TestResponseHeaderMapImpl response_headers_{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+};
+
+TEST_F(FileSystemHttpCacheTest, PutGet) {
+  initialize();
+  lookup("/name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  insert("/name", "Value");
+  LookupContextPtr context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_EQ(5, lookup_result_.content_length_);
+  EXPECT_THAT(lookup_result_.headers_.get(), HeaderMapEqualIgnoreOrder(&response_headers_));
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+  EXPECT_EQ("alu", getBody(*context, 1, 4));
+
+  insert("/name", "NewValue");
+  context = lookup("/name");
+  EXPECT_EQ("NewValue", getBody(*context, 0, 8));
+
+  EXPECT_EQ(2, cache_->stats().insert_.value());
+  EXPECT_EQ(1, cache_->stats().entries_.value());
+  EXPECT_EQ(fileSize("/name", 8), cache_->stats().size_bytes_.value());
+}
+
+// Entries which are on disk at startup are served again.
+TEST_F(FileSystemHttpCacheTest, Restart) {
+  initialize();
+  insert("/a", "Value");
+  insert("/b", "Other");
+
+  initialize();
+  EXPECT_EQ(2, cache_->stats().entries_.value());
+  LookupContextPtr context = lookup("/b");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_EQ("Other", getBody(*context, 0, 5));
+}
+
+// Files which have not been mapped yet are mapped by the loader thread, and the lookup completes on
+// the dispatcher. Later lookups of the entry find the mapped file right away.
+TEST_F(FileSystemHttpCacheTest, LookupMapsFileOffWorker) {
+  initialize();
+  insert("/name", "Value");
+
+  initialize();
+  LookupContextPtr context;
+  EXPECT_FALSE(startLookup("/name", context));
+  waitForLookup();
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+
+  EXPECT_TRUE(startLookup("/name", context));
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_EQ(2, cache_->stats().hit_.value());
+
+  // Lookups of missing entries complete right away.
+  EXPECT_TRUE(startLookup("/other", context));
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+// The callback of a pending lookup is not called once its context is gone.
+TEST_F(FileSystemHttpCacheTest, DestroyPendingLookup) {
+  initialize();
+  insert("/a", "Value");
+  insert("/b", "Other");
+
+  initialize();
+  request_headers_.setPath("/a");
+  LookupContextPtr context =
+      cache_->makeLookupContext(LookupRequest(request_headers_, current_time_), *dispatcher_);
+  bool called = false;
+  context->getHeaders([&called](LookupResult&&) { called = true; });
+  context.reset();
+
+  // The lookup of the other entry is served after the first one.
+  lookup("/b");
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_FALSE(called);
+  EXPECT_EQ(2, cache_->stats().hit_.value());
+}
+
+// Leftovers of interrupted writes are removed, and damaged files are not served.
+TEST_F(FileSystemHttpCacheTest, DamagedFiles) {
+  initialize();
+  insert("/name", "Value");
+  cache_.reset();
+
+  std::string file_name;
+  for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(cache_path_)) {
+    if (entry.type_ == Filesystem::FileType::Regular) {
+      file_name = entry.name_;
+    }
+  }
+  ASSERT_FALSE(file_name.empty());
+  const std::string path = absl::StrCat(cache_path_, "/", file_name);
+  ::truncate(path.c_str(), fileSize("/name", 5) - 1);
+  TestEnvironment::writeStringToFileForTest(absl::StrCat(path, ".tmp"), "partial", true);
+
+  initialize();
+  EXPECT_FALSE(api_->fileSystem().fileExists(absl::StrCat(path, ".tmp")));
+  EXPECT_EQ(1, cache_->stats().entries_.value());
+  const uint64_t misses = cache_->stats().miss_.value();
+  lookup("/name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_EQ(misses + 1, cache_->stats().miss_.value());
+}
+
+// The least recently used entries are evicted once the size limit is exceeded.
+TEST_F(FileSystemHttpCacheTest, EvictLeastRecentlyUsed) {
+  initialize(2 * fileSize("/a", 5));
+  insert("/a", "Value");
+  insert("/b", "Value");
+  lookup("/a");
+  insert("/c", "Value");
+
+  EXPECT_EQ(1, cache_->stats().eviction_.value());
+  EXPECT_EQ(2, cache_->stats().entries_.value());
+  EXPECT_EQ(2 * fileSize("/a", 5), cache_->stats().size_bytes_.value());
+  lookup("/b");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  lookup("/a");
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  lookup("/c");
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+}
+
+// A body which is being served remains valid after its entry has been evicted.
+TEST_F(FileSystemHttpCacheTest, BodyOutlivesEviction) {
+  initialize(fileSize("/a", 5));
+  insert("/a", "Value");
+  LookupContextPtr context = lookup("/a");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  Buffer::InstancePtr body;
+  context->getBody(AdjustedByteRange(0, 5),
+                   [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+
+  insert("/b", "Other");
+  EXPECT_EQ(1, cache_->stats().eviction_.value());
+  context.reset();
+  ASSERT_NE(nullptr, body);
+  EXPECT_EQ("Value", body->toString());
+}
+
+// Entries larger than the cache are not written.
+TEST_F(FileSystemHttpCacheTest, DropLargerThanCache) {
+  initialize(fileSize("/a", 5));
+  insert("/a", "LargerValue");
+  EXPECT_EQ(1, cache_->stats().insert_dropped_.value());
+  EXPECT_EQ(0, cache_->stats().entries_.value());
+}
+
+TEST_F(FileSystemHttpCacheTest, Trailers) {
+  initialize();
+  const Http::TestResponseTrailerMapImpl response_trailers{{"grpc-status", "0"}};
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("/name"));
+  inserter->insertHeaders(response_headers_, false);
+  inserter->insertBody(Buffer::OwnedImpl("Value"), [](bool) {}, false);
+  inserter->insertTrailers(response_trailers);
+  cache_->waitForWritesForTest();
+
+  LookupContextPtr context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(lookup_result_.has_trailers_);
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+  Http::ResponseTrailerMapPtr trailers;
+  context->getTrailers(
+      [&trailers](Http::ResponseTrailerMapPtr&& data) { trailers = std::move(data); });
+  ASSERT_NE(nullptr, trailers);
+  EXPECT_THAT(trailers.get(), HeaderMapEqualIgnoreOrder(&response_trailers));
+
+  // Trailers are stored on disk too.
+  initialize();
+  context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(lookup_result_.has_trailers_);
+
+  insert("/other", "Value");
+  lookup("/other");
+  EXPECT_FALSE(lookup_result_.has_trailers_);
+}
+
+// Updating the headers of an entry keeps its body.
+TEST_F(FileSystemHttpCacheTest, UpdateHeaders) {
+  initialize();
+  insert("/name", "Value");
+  LookupContextPtr context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+
+  auto new_headers = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers_);
+  new_headers->addCopy(Http::LowerCaseString("etag"), "\"v2\"");
+  const Http::TestResponseHeaderMapImpl expected_headers(*new_headers);
+  cache_->updateHeaders(std::move(context), std::move(new_headers));
+  cache_->waitForWritesForTest();
+
+  context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_THAT(lookup_result_.headers_.get(), HeaderMapEqualIgnoreOrder(&expected_headers));
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+  EXPECT_EQ(1, cache_->stats().entries_.value());
+}
+
+TEST_F(FileSystemHttpCacheTest, MissingDirectory) {
+  envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig config;
+  config.set_cache_path(absl::StrCat(cache_path_, "/missing"));
+  EXPECT_THROW_WITH_REGEX(std::make_unique<FileSystemHttpCache>(config, *api_, stats_store_),
+                          EnvoyException, "does not exist");
+}
+
+TEST_F(FileSystemHttpCacheTest, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.FileSystemHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig cache_config;
+  cache_config.set_cache_path(cache_path_);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(cache_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_CALL(context, api()).WillRepeatedly(ReturnRef(*api_));
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.file_system");
+  EXPECT_EQ(cache, factory->getCache(config, context));
+}
+
+// Filters using different directories get different caches, and the configuration of a directory
+// must be the same for all filters using it.
+TEST_F(FileSystemHttpCacheTest, CachePerDirectory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.FileSystemHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  const std::string other_path = absl::StrCat(cache_path_, "/other");
+  TestEnvironment::createPath(other_path);
+  envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig cache_config;
+  cache_config.set_cache_path(cache_path_);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(cache_config);
+  cache_config.set_cache_path(other_path);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig other_config;
+  other_config.mutable_typed_config()->PackFrom(cache_config);
+  cache_config.set_cache_path(cache_path_);
+  cache_config.set_max_cache_size_bytes(1024);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig conflicting_config;
+  conflicting_config.mutable_typed_config()->PackFrom(cache_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_CALL(context, api()).WillRepeatedly(ReturnRef(*api_));
+
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  HttpCacheSharedPtr other_cache = factory->getCache(other_config, context);
+  EXPECT_NE(cache, other_cache);
+  EXPECT_EQ(other_cache, factory->getCache(other_config, context));
+  EXPECT_THROW_WITH_REGEX(factory->getCache(conflicting_config, context), EnvoyException,
+                          "different configuration");
+
+  // The directory can be configured differently once no filter uses its cache.
+  cache.reset();
+  cache = factory->getCache(conflicting_config, context);
+  EXPECT_NE(nullptr, cache);
+}
+
+// The stats are created in the server's scope, which outlives the listener whose filter created
+// the cache.
+TEST_F(FileSystemHttpCacheTest, StatsInServerScope) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.FileSystemHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig cache_config;
+  cache_config.set_cache_path(cache_path_);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(cache_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  EXPECT_CALL(context, api()).WillRepeatedly(ReturnRef(*api_));
+  auto cache = std::dynamic_pointer_cast<FileSystemHttpCache>(factory->getCache(config, context));
+  ASSERT_NE(nullptr, cache);
+  Stats::Scope& server_scope = context.server_factory_context_.scope_;
+  EXPECT_EQ(&cache->stats().miss_,
+            &server_scope.counterFromString("cache.file_system_http_cache.miss"));
+  EXPECT_EQ(nullptr,
+            TestUtility::findCounter(context.scope_, "cache.file_system_http_cache.miss"));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
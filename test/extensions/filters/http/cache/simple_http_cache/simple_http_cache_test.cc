@@ -2,9 +2,12 @@
 #include "envoy/registry/registry.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -30,7 +33,7 @@ protected:
   // Performs a cache lookup.
   LookupContextPtr lookup(absl::string_view request_path) {
     LookupRequest request = makeLookupRequest(request_path);
-    LookupContextPtr context = cache_.makeLookupContext(std::move(request));
+    LookupContextPtr context = cache_->makeLookupContext(std::move(request), dispatcher_);
     context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
     return context;
   }
@@ -38,7 +41,7 @@ protected:
   // Inserts a value into the cache.
   void insert(LookupContextPtr lookup, const Http::TestResponseHeaderMapImpl& response_headers,
               const absl::string_view response_body) {
-    InsertContextPtr inserter = cache_.makeInsertContext(move(lookup));
+    InsertContextPtr inserter = cache_->makeInsertContext(move(lookup));
     inserter->insertHeaders(response_headers, false);
     inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
   }
@@ -86,7 +89,18 @@ protected:
     return AssertionSuccess();
   }
 
-  SimpleHttpCache cache_;
+  // Replaces the cache with one of the given shape.
+  void initialize(uint32_t shards, uint64_t max_total_bytes) {
+    envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig config;
+    config.set_shards(shards);
+    config.set_max_total_bytes(max_total_bytes);
+    cache_ = std::make_unique<SimpleHttpCache>(config, stats_store_);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  std::unique_ptr<SimpleHttpCache> cache_ = std::make_unique<SimpleHttpCache>(
+      envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig(), stats_store_);
+  Event::MockDispatcher dispatcher_;
   LookupResult lookup_result_;
   Http::TestRequestHeaderMapImpl request_headers_;
   Event::SimulatedTimeSystem time_source_;
@@ -193,7 +207,7 @@ TEST_F(SimpleHttpCacheTest, StreamingPut) {
   Http::TestResponseHeaderMapImpl response_headers{{"date", formatter_.fromTime(current_time_)},
                                                    {"age", "2"},
                                                    {"cache-control", "public, max-age=3600"}};
-  InsertContextPtr inserter = cache_.makeInsertContext(lookup("request_path"));
+  InsertContextPtr inserter = cache_->makeInsertContext(lookup("request_path"));
   inserter->insertHeaders(response_headers, false);
   inserter->insertBody(
       Buffer::OwnedImpl("Hello, "), [](bool ready) { EXPECT_TRUE(ready); }, false);
@@ -205,13 +219,148 @@ TEST_F(SimpleHttpCacheTest, StreamingPut) {
   EXPECT_EQ("Hello, World!", getBody(*name_lookup_context, 0, 13));
 }
 
+// Entries are evicted in least recently used order once the budget is exceeded.
+TEST_F(SimpleHttpCacheTest, EvictLeastRecentlyUsed) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  const uint64_t entry_size = response_headers.byteSize() + 5;
+  initialize(1, 2 * entry_size);
+
+  insert("/a", response_headers, "Value");
+  insert("/b", response_headers, "Value");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/a").get(), "Value"));
+  insert("/c", response_headers, "Value");
+
+  EXPECT_EQ(1, cache_->stats().eviction_.value());
+  EXPECT_EQ(2, cache_->stats().entries_.value());
+  EXPECT_EQ(2 * entry_size, cache_->stats().size_bytes_.value());
+  lookup("/b");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/a").get(), "Value"));
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/c").get(), "Value"));
+}
+
+// Replacing an entry is not an eviction.
+TEST_F(SimpleHttpCacheTest, ReplaceEntry) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  initialize(4, 1024 * 1024);
+
+  insert("/a", response_headers, "Value");
+  insert("/a", response_headers, "NewValue");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/a").get(), "NewValue"));
+
+  EXPECT_EQ(2, cache_->stats().insert_.value());
+  EXPECT_EQ(0, cache_->stats().eviction_.value());
+  EXPECT_EQ(1, cache_->stats().entries_.value());
+  EXPECT_EQ(response_headers.byteSize() + 8, cache_->stats().size_bytes_.value());
+  EXPECT_EQ(2, cache_->stats().hit_.value());
+  EXPECT_EQ(1, cache_->stats().miss_.value());
+}
+
+// Responses which do not fit into a shard are not cached.
+TEST_F(SimpleHttpCacheTest, RejectLargerThanShard) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  initialize(2, 2 * (response_headers.byteSize() + 5));
+
+  insert("/a", response_headers, "Value");
+  insert("/b", response_headers, "LargerValue");
+  EXPECT_EQ(1, cache_->stats().insert_.value());
+  EXPECT_EQ(1, cache_->stats().insert_rejected_.value());
+  lookup("/b");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/a").get(), "Value"));
+}
+
+// A body which is being served remains valid after its entry has been evicted.
+TEST_F(SimpleHttpCacheTest, BodyOutlivesEviction) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  initialize(1, response_headers.byteSize() + 5);
+
+  insert("/a", response_headers, "Value");
+  LookupContextPtr a_lookup_context = lookup("/a");
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  Buffer::InstancePtr body;
+  a_lookup_context->getBody(AdjustedByteRange(1, 4),
+                            [&body](Buffer::InstancePtr&& data) { body = std::move(data); });
+
+  insert("/b", response_headers, "Other");
+  EXPECT_EQ(1, cache_->stats().eviction_.value());
+  a_lookup_context.reset();
+  ASSERT_NE(nullptr, body);
+  EXPECT_EQ("alu", body->toString());
+}
+
+// The caches of a scope share their gauges, which a cache leaves once it is destroyed.
+TEST_F(SimpleHttpCacheTest, GaugesAfterDestruction) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  SimpleHttpCache other_cache(
+      envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig(), stats_store_);
+  insert("/a", response_headers, "Value");
+  EXPECT_EQ(1, other_cache.stats().entries_.value());
+  EXPECT_EQ(response_headers.byteSize() + 5, other_cache.stats().size_bytes_.value());
+
+  cache_.reset();
+  EXPECT_EQ(0, other_cache.stats().entries_.value());
+  EXPECT_EQ(0, other_cache.stats().size_bytes_.value());
+}
+
 TEST(Registration, GetFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.source.extensions.filters.http.cache.SimpleHttpCacheConfig");
   ASSERT_NE(factory, nullptr);
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
   config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
-  EXPECT_EQ(factory->getCache(config).cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  EXPECT_EQ(cache->cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  // All filters share the cache.
+  EXPECT_EQ(cache, factory->getCache(config, context));
+}
+
+TEST(Registration, CachePerConfig) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.SimpleHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig simple_config;
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(simple_config);
+  simple_config.set_max_total_bytes(1024);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig other_config;
+  other_config.mutable_typed_config()->PackFrom(simple_config);
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  HttpCacheSharedPtr cache = factory->getCache(config, context);
+  HttpCacheSharedPtr other_cache = factory->getCache(other_config, context);
+  EXPECT_NE(cache, other_cache);
+  EXPECT_EQ(other_cache, factory->getCache(other_config, context));
+
+  // A cache is recreated once no filter uses it, even while the other one is still used.
+  std::weak_ptr<HttpCache> weak_cache = cache;
+  cache.reset();
+  EXPECT_TRUE(weak_cache.expired());
+  cache = factory->getCache(config, context);
+  EXPECT_NE(nullptr, cache);
+  EXPECT_EQ(cache, factory->getCache(config, context));
+}
+
+// The stats are created in the server's scope, which outlives the listener whose filter created
+// the cache.
+TEST(Registration, StatsInServerScope) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.SimpleHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  auto cache = std::dynamic_pointer_cast<SimpleHttpCache>(factory->getCache(config, context));
+  ASSERT_NE(nullptr, cache);
+  Stats::Scope& server_scope = context.server_factory_context_.scope_;
+  EXPECT_EQ(&cache->stats().miss_, &server_scope.counterFromString("cache.simple_http_cache.miss"));
+  EXPECT_EQ(nullptr, TestUtility::findCounter(context.scope_, "cache.simple_http_cache.miss"));
 }
 
 } // namespace
@@ -751,6 +751,28 @@ TEST_F(HttpConnectionManagerConfigTest, CommonHttpProtocolIdleTimeoutOff) {
   EXPECT_FALSE(config.idleTimeout().has_value());
 }
 
+// Validate that overload_min_idle_timeout defaults to 1s and can be configured.
+TEST_F(HttpConnectionManagerConfigTest, OverloadMinIdleTimeout) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_);
+  EXPECT_EQ(std::chrono::seconds(1), config.overloadMinIdleTimeout());
+
+  HttpConnectionManagerConfig configured_config(
+      parseHttpConnectionManagerFromV2Yaml(yaml_string + "overload_min_idle_timeout: 5s"),
+      context_, date_provider_, route_config_provider_manager_,
+      scoped_routes_config_provider_manager_, http_tracer_manager_);
+  EXPECT_EQ(std::chrono::seconds(5), configured_config.overloadMinIdleTimeout());
+}
+
 // Check that the default max request header count is 100.
 TEST_F(HttpConnectionManagerConfigTest, DefaultMaxRequestHeaderCount) {
   const std::string yaml_string = R"EOF(
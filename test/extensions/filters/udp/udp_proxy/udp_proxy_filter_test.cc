@@ -472,6 +472,84 @@ cluster: fake_cluster
   EXPECT_EQ(1, config_->stats().downstream_sess_active_.value());
 }
 
+// Batched writes in both directions.
+TEST_F(UdpProxyFilterTest, BatchWrites) {
+  InSequence s;
+
+  Event::MockTimer* flush_timer = new Event::MockTimer(&callbacks_.udp_listener_.dispatcher_);
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+batch_writes: true
+  )EOF");
+
+  expectSessionCreate(upstream_address_);
+  TestSession& session = test_sessions_[0];
+  EXPECT_CALL(*session.io_handle_, supportsUdpGso()).WillOnce(Return(true));
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(0), nullptr));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  checkTransferStats(10 /*rx_bytes*/, 2 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+
+  // Both datagrams are sent upstream as a single segmented message.
+  EXPECT_CALL(*session.io_handle_, sendmmsg(_, 1, 0))
+      .WillOnce(Invoke([this](const Network::IoHandle::SendMsgInfo* messages, uint64_t,
+                              int) -> Api::IoCallUint64Result {
+        std::string payload;
+        for (uint64_t i = 0; i < messages[0].num_slice_; i++) {
+          payload.append(static_cast<const char*>(messages[0].slices_[i].mem_),
+                         messages[0].slices_[i].len_);
+        }
+        EXPECT_EQ("helloworld", payload);
+        EXPECT_EQ(5, messages[0].gso_size_);
+        EXPECT_EQ(*messages[0].peer_address_, *upstream_address_);
+        return makeNoError(1);
+      }));
+  flush_timer->invokeCallback();
+  EXPECT_EQ(10, cluster_manager_.thread_local_cluster_.cluster_.info_->stats_
+                    .upstream_cx_tx_bytes_total_.value());
+  EXPECT_EQ(2, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_datagrams")
+                   ->value());
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_syscalls")
+                   ->value());
+
+  // The datagrams received from upstream are queued and sent downstream once the socket has been
+  // drained.
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  const std::vector<std::string> datagrams{"world1", "world2"};
+  for (const std::string& data : datagrams) {
+    EXPECT_CALL(*session.io_handle_, supportsMmsg());
+    EXPECT_CALL(*session.io_handle_, recvmsg(_, 1, _, _))
+        .WillOnce(Invoke([&session, data](Buffer::RawSlice* slices, const uint64_t, uint32_t,
+                                          Network::IoHandle::RecvMsgOutput& output) {
+          memcpy(slices[0].mem_, data.data(), data.size());
+          output.msg_[0].peer_address_ = session.upstream_address_;
+          return makeNoError(data.size());
+        }));
+    EXPECT_CALL(callbacks_.udp_listener_, queueSend(_))
+        .WillOnce(Invoke([data](const Network::UdpSendData& send_data) {
+          EXPECT_EQ(data, send_data.buffer_.toString());
+        }));
+  }
+  EXPECT_CALL(*session.io_handle_, supportsMmsg());
+  EXPECT_CALL(*session.io_handle_, recvmsg(_, 1, _, _))
+      .WillOnce(Return(ByMove(makeError(EAGAIN))));
+  Network::UdpFlushResult flush_result;
+  flush_result.datagrams_sent_ = 2;
+  flush_result.bytes_sent_ = 12;
+  flush_result.send_calls_ = 1;
+  EXPECT_CALL(callbacks_.udp_listener_, flush()).WillOnce(Return(flush_result));
+  session.file_event_cb_(Event::FileReadyType::Read);
+  checkTransferStats(10 /*rx_bytes*/, 2 /*rx_datagrams*/, 12 /*tx_bytes*/, 2 /*tx_datagrams*/);
+  EXPECT_EQ(1, config_->stats().downstream_sess_tx_syscalls_.value());
+}
+
 } // namespace
 } // namespace UdpProxy
 } // namespace UdpFilters
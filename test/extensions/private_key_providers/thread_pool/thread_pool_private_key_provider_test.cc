@@ -0,0 +1,338 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+
+#include "extensions/private_key_providers/thread_pool/config.h"
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/ssl/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Property;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+using envoy::extensions::private_key_providers::thread_pool::v3alpha::
+    ThreadPoolPrivateKeyMethodConfig;
+
+bssl::UniquePtr<EVP_PKEY> generateKey(int type) {
+  if (type == EVP_PKEY_EC) {
+    bssl::UniquePtr<EC_KEY> ec_key(EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+    RELEASE_ASSERT(EC_KEY_generate_key(ec_key.get()) == 1, "");
+    bssl::UniquePtr<EVP_PKEY> pkey(EVP_PKEY_new());
+    RELEASE_ASSERT(EVP_PKEY_assign_EC_KEY(pkey.get(), ec_key.release()) == 1, "");
+    return pkey;
+  }
+  bssl::UniquePtr<EVP_PKEY_CTX> ctx(EVP_PKEY_CTX_new_id(type, nullptr));
+  EVP_PKEY* pkey = nullptr;
+  RELEASE_ASSERT(EVP_PKEY_keygen_init(ctx.get()) == 1, "");
+  if (type == EVP_PKEY_RSA) {
+    RELEASE_ASSERT(EVP_PKEY_CTX_set_rsa_keygen_bits(ctx.get(), 2048) == 1, "");
+  }
+  RELEASE_ASSERT(EVP_PKEY_keygen(ctx.get(), &pkey) == 1, "");
+  return bssl::UniquePtr<EVP_PKEY>(pkey);
+}
+
+std::string toPem(EVP_PKEY* pkey) {
+  bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+  RELEASE_ASSERT(PEM_write_bio_PrivateKey(bio.get(), pkey, nullptr, nullptr, 0, nullptr, nullptr),
+                 "");
+  const uint8_t* data;
+  size_t length;
+  RELEASE_ASSERT(BIO_mem_contents(bio.get(), &data, &length), "");
+  return std::string(reinterpret_cast<const char*>(data), length);
+}
+
+bool verify(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::string& in,
+            const std::vector<uint8_t>& signature) {
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  if (!EVP_DigestVerifyInit(ctx.get(), &pkey_ctx,
+                            SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                            pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+    return false;
+  }
+  return EVP_DigestVerify(ctx.get(), signature.data(), signature.size(),
+                          reinterpret_cast<const uint8_t*>(in.data()), in.size()) == 1;
+}
+
+class ThreadPoolPrivateKeyProviderTest : public testing::Test {
+protected:
+  ThreadPoolPrivateKeyProviderTest()
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher("test_thread")),
+        ssl_ctx_(SSL_CTX_new(TLS_method())), ssl_(SSL_new(ssl_ctx_.get())) {
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(factory_context_, scope()).WillByDefault(ReturnRef(store_));
+  }
+
+  std::shared_ptr<ThreadPoolPrivateKeyMethodProvider> createProvider(EVP_PKEY* pkey,
+                                                                     uint32_t num_threads = 2) {
+    ThreadPoolPrivateKeyMethodConfig config;
+    config.mutable_private_key()->set_inline_string(toPem(pkey));
+    config.mutable_num_threads()->set_value(num_threads);
+    return std::make_shared<ThreadPoolPrivateKeyMethodProvider>(config, factory_context_);
+  }
+
+  // Waits for the operation started on the pool to complete, and returns its output.
+  ssl_private_key_result_t complete(ThreadPoolPrivateKeyMethodProvider& provider,
+                                    std::vector<uint8_t>& out) {
+    EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).WillOnce(Invoke([this]() -> void {
+      dispatcher_->exit();
+    }));
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    size_t out_len;
+    out.resize(1024);
+    const ssl_private_key_result_t result =
+        provider.getBoringSslPrivateKeyMethod()->complete(ssl_.get(), out.data(), &out_len,
+                                                          out.size());
+    out.resize(result == ssl_private_key_success ? out_len : 0);
+    return result;
+  }
+
+  ssl_private_key_result_t sign(ThreadPoolPrivateKeyMethodProvider& provider,
+                                uint16_t signature_algorithm, const std::string& in,
+                                std::vector<uint8_t>& out) {
+    uint8_t data[1024];
+    size_t out_len;
+    const ssl_private_key_result_t result = provider.getBoringSslPrivateKeyMethod()->sign(
+        ssl_.get(), data, &out_len, sizeof(data), signature_algorithm,
+        reinterpret_cast<const uint8_t*>(in.data()), in.size());
+    if (result != ssl_private_key_retry) {
+      return result;
+    }
+    // The handshake is not resumed until the worker has run the completion.
+    EXPECT_EQ(ssl_private_key_retry, provider.getBoringSslPrivateKeyMethod()->complete(
+                                         ssl_.get(), data, &out_len, sizeof(data)));
+    return complete(provider, out);
+  }
+
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  NiceMock<Ssl::MockPrivateKeyConnectionCallbacks> callbacks_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  bssl::UniquePtr<SSL> ssl_;
+};
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, SignRsa) {
+  bssl::UniquePtr<EVP_PKEY> pkey = generateKey(EVP_PKEY_RSA);
+  auto provider = createProvider(pkey.get());
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "thread_pool_private_key.queue_time_us"),
+                          _))
+      .Times(2);
+  EXPECT_CALL(store_,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name, "thread_pool_private_key.operation_time_us"), _))
+      .Times(2);
+  for (uint16_t signature_algorithm : {SSL_SIGN_RSA_PSS_RSAE_SHA256, SSL_SIGN_RSA_PKCS1_SHA384}) {
+    std::vector<uint8_t> signature;
+    EXPECT_EQ(ssl_private_key_success,
+              sign(*provider, signature_algorithm, "handshake", signature));
+    EXPECT_TRUE(verify(pkey.get(), signature_algorithm, "handshake", signature));
+  }
+  EXPECT_EQ(2, store_.counter("thread_pool_private_key.sign").value());
+  EXPECT_EQ(0, store_.counter("thread_pool_private_key.failed").value());
+  EXPECT_EQ(0, store_.gauge("thread_pool_private_key.queue_depth",
+                            Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, SignEcdsaAndEd25519) {
+  const std::vector<std::pair<int, uint16_t>> keys = {
+      {EVP_PKEY_EC, SSL_SIGN_ECDSA_SECP256R1_SHA256}, {EVP_PKEY_ED25519, SSL_SIGN_ED25519}};
+  for (const auto& key : keys) {
+    bssl::UniquePtr<EVP_PKEY> pkey = generateKey(key.first);
+    auto provider = createProvider(pkey.get());
+    provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+    std::vector<uint8_t> signature;
+    EXPECT_EQ(ssl_private_key_success, sign(*provider, key.second, "handshake", signature));
+    EXPECT_TRUE(verify(pkey.get(), key.second, "handshake", signature));
+    provider->unregisterPrivateKeyMethod(ssl_.get());
+  }
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, DecryptRsa) {
+  bssl::UniquePtr<EVP_PKEY> pkey = generateKey(EVP_PKEY_RSA);
+  auto provider = createProvider(pkey.get());
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey.get());
+  const std::string secret = "premaster secret";
+  std::vector<uint8_t> encrypted(RSA_size(rsa));
+  size_t encrypted_len;
+  ASSERT_TRUE(RSA_encrypt(rsa, &encrypted_len, encrypted.data(), encrypted.size(),
+                          reinterpret_cast<const uint8_t*>(secret.data()), secret.size(),
+                          RSA_PKCS1_PADDING));
+
+  uint8_t out[1024];
+  size_t out_len;
+  EXPECT_EQ(ssl_private_key_retry,
+            provider->getBoringSslPrivateKeyMethod()->decrypt(
+                ssl_.get(), out, &out_len, sizeof(out), encrypted.data(), encrypted_len));
+  std::vector<uint8_t> decrypted;
+  EXPECT_EQ(ssl_private_key_success, complete(*provider, decrypted));
+  // The padding is left for BoringSSL to check.
+  ASSERT_EQ(RSA_size(rsa), decrypted.size());
+  EXPECT_EQ(secret, std::string(decrypted.end() - secret.size(), decrypted.end()));
+  EXPECT_EQ(1, store_.counter("thread_pool_private_key.decrypt").value());
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, SignatureAlgorithmOfOtherKeyType) {
+  bssl::UniquePtr<EVP_PKEY> pkey = generateKey(EVP_PKEY_EC);
+  auto provider = createProvider(pkey.get());
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  std::vector<uint8_t> signature;
+  EXPECT_EQ(ssl_private_key_failure,
+            sign(*provider, SSL_SIGN_RSA_PSS_RSAE_SHA256, "handshake", signature));
+  uint8_t out[1024];
+  size_t out_len;
+  EXPECT_EQ(ssl_private_key_failure,
+            provider->getBoringSslPrivateKeyMethod()->decrypt(ssl_.get(), out, &out_len,
+                                                              sizeof(out), out, 16));
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+// A connection with an RSA and an ECDSA certificate signs with the key of the signature
+// algorithm.
+TEST_F(ThreadPoolPrivateKeyProviderTest, MultipleCertificates) {
+  bssl::UniquePtr<EVP_PKEY> rsa_pkey = generateKey(EVP_PKEY_RSA);
+  bssl::UniquePtr<EVP_PKEY> ecdsa_pkey = generateKey(EVP_PKEY_EC);
+  auto rsa_provider = createProvider(rsa_pkey.get());
+  auto ecdsa_provider = createProvider(ecdsa_pkey.get());
+  rsa_provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  ecdsa_provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  // All providers share the same methods, which look the provider up from the connection.
+  std::vector<uint8_t> signature;
+  EXPECT_EQ(ssl_private_key_success,
+            sign(*rsa_provider, SSL_SIGN_ECDSA_SECP256R1_SHA256, "handshake", signature));
+  EXPECT_TRUE(verify(ecdsa_pkey.get(), SSL_SIGN_ECDSA_SECP256R1_SHA256, "handshake", signature));
+
+  // Another provider of the same key type could not be told apart.
+  auto other_rsa_provider = createProvider(rsa_pkey.get());
+  EXPECT_THROW_WITH_MESSAGE(
+      other_rsa_provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_),
+      EnvoyException,
+      "Can't distinguish between two thread pool private key providers of the same key type for "
+      "the same SSL object.");
+
+  rsa_provider->unregisterPrivateKeyMethod(ssl_.get());
+  ecdsa_provider->unregisterPrivateKeyMethod(ssl_.get());
+  EXPECT_EQ(nullptr,
+            SSL_get_ex_data(ssl_.get(), ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+// The completion of an operation whose connection was closed is dropped.
+TEST_F(ThreadPoolPrivateKeyProviderTest, ConnectionClosedDuringOperation) {
+  bssl::UniquePtr<EVP_PKEY> pkey = generateKey(EVP_PKEY_RSA);
+  auto provider = createProvider(pkey.get());
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  uint8_t out[1024];
+  size_t out_len;
+  const std::string in = "handshake";
+  EXPECT_EQ(ssl_private_key_retry,
+            provider->getBoringSslPrivateKeyMethod()->sign(
+                ssl_.get(), out, &out_len, sizeof(out), SSL_SIGN_RSA_PSS_RSAE_SHA256,
+                reinterpret_cast<const uint8_t*>(in.data()), in.size()));
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+
+  // Releasing the provider joins the threads of the pool, which are done with the operation.
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  provider.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, CheckFips) {
+  bssl::UniquePtr<EVP_PKEY> rsa_pkey = generateKey(EVP_PKEY_RSA);
+  EXPECT_TRUE(createProvider(rsa_pkey.get())->checkFips());
+  bssl::UniquePtr<EVP_PKEY> ecdsa_pkey = generateKey(EVP_PKEY_EC);
+  EXPECT_TRUE(createProvider(ecdsa_pkey.get())->checkFips());
+  bssl::UniquePtr<EVP_PKEY> ed25519_pkey = generateKey(EVP_PKEY_ED25519);
+  EXPECT_FALSE(createProvider(ed25519_pkey.get())->checkFips());
+}
+
+TEST_F(ThreadPoolPrivateKeyProviderTest, InvalidPrivateKey) {
+  ThreadPoolPrivateKeyMethodConfig config;
+  config.mutable_private_key()->set_inline_string("not a key");
+  EXPECT_THROW_WITH_MESSAGE(
+      ThreadPoolPrivateKeyMethodProvider(config, factory_context_), EnvoyException,
+      "Failed to load the private key of the thread pool private key provider");
+}
+
+TEST(CryptoThreadPoolTest, QueueFull) {
+  NiceMock<Stats::MockIsolatedStatsStore> store;
+  Stats::Gauge& queue_depth = store.gauge("queue_depth", Stats::Gauge::ImportMode::Accumulate);
+  Api::ApiPtr api = Api::createApiForTest(store);
+  {
+    // Without threads, operations stay queued.
+    CryptoThreadPool pool(api->threadFactory(), 0, 2, queue_depth);
+    EXPECT_TRUE(pool.enqueue(nullptr));
+    EXPECT_TRUE(pool.enqueue(nullptr));
+    EXPECT_FALSE(pool.enqueue(nullptr));
+    EXPECT_EQ(2, queue_depth.value());
+  }
+  EXPECT_EQ(0, queue_depth.value());
+}
+
+TEST(ThreadPoolPrivateKeyMethodFactoryTest, CreateProvider) {
+  auto factory =
+      Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::getFactory(
+          "envoy.tls.key_providers.thread_pool");
+  ASSERT_NE(nullptr, factory);
+
+  NiceMock<Stats::MockIsolatedStatsStore> store;
+  Api::ApiPtr api = Api::createApiForTest(store);
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ON_CALL(factory_context, scope()).WillByDefault(ReturnRef(store));
+
+  bssl::UniquePtr<EVP_PKEY> pkey = generateKey(EVP_PKEY_EC);
+  ThreadPoolPrivateKeyMethodConfig provider_config;
+  provider_config.mutable_private_key()->set_inline_string(toPem(pkey.get()));
+  envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider config;
+  config.set_provider_name("envoy.tls.key_providers.thread_pool");
+  config.mutable_typed_config()->PackFrom(provider_config);
+  EXPECT_NE(nullptr, factory->createPrivateKeyMethodProviderInstance(config, factory_context));
+
+  // The private key is required.
+  config.mutable_typed_config()->PackFrom(ThreadPoolPrivateKeyMethodConfig());
+  EXPECT_THROW(factory->createPrivateKeyMethodProviderInstance(config, factory_context),
+               EnvoyException);
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,110 @@
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "test/mocks/filesystem/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Return;
+using testing::Throw;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD(void, onSuccess, (const Server::ResourceUsage&));
+  MOCK_METHOD(void, onFailure, (const EnvoyException&));
+};
+
+MATCHER_P(PressureEq, pressure, "") { return arg.resource_pressure_ == pressure; }
+
+class CgroupMemoryMonitorTest : public testing::Test {
+protected:
+  void expectCgroupV2(const std::string& usage, const std::string& limit) {
+    EXPECT_CALL(file_system_, fileExists("/cgroup/memory.current")).WillOnce(Return(true));
+    EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory.current")).WillOnce(Return(usage));
+    EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory.max")).WillOnce(Return(limit));
+  }
+
+  void expectCgroupV1(const std::string& usage, const std::string& limit) {
+    EXPECT_CALL(file_system_, fileExists("/cgroup/memory.current")).WillOnce(Return(false));
+    EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory/memory.usage_in_bytes"))
+        .WillOnce(Return(usage));
+    EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory/memory.limit_in_bytes"))
+        .WillOnce(Return(limit));
+  }
+
+  std::unique_ptr<CgroupMemoryMonitor> createMonitor(uint64_t max_memory_bytes = 0) {
+    envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config;
+    config.set_max_memory_bytes(max_memory_bytes);
+    return std::make_unique<CgroupMemoryMonitor>(config, file_system_, "/cgroup");
+  }
+
+  testing::NiceMock<Filesystem::MockInstance> file_system_;
+  MockedCallbacks cb_;
+};
+
+TEST_F(CgroupMemoryMonitorTest, CgroupV2) {
+  expectCgroupV2("700\n", "1000\n");
+  EXPECT_CALL(cb_, onSuccess(PressureEq(0.7)));
+  createMonitor()->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, CgroupV1) {
+  expectCgroupV1("300\n", "1000\n");
+  EXPECT_CALL(cb_, onSuccess(PressureEq(0.3)));
+  createMonitor()->updateResourceUsage(cb_);
+}
+
+// The configured maximum is used when it is below the limit of the cgroup.
+TEST_F(CgroupMemoryMonitorTest, ConfiguredMaximum) {
+  expectCgroupV2("200", "1000");
+  EXPECT_CALL(cb_, onSuccess(PressureEq(0.5)));
+  createMonitor(400)->updateResourceUsage(cb_);
+
+  expectCgroupV2("200", "250");
+  EXPECT_CALL(cb_, onSuccess(PressureEq(0.8)));
+  createMonitor(400)->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, NoLimit) {
+  expectCgroupV2("200", "max\n");
+  EXPECT_CALL(cb_, onFailure(_));
+  createMonitor()->updateResourceUsage(cb_);
+
+  expectCgroupV1("200", "9223372036854771712\n");
+  EXPECT_CALL(cb_, onFailure(_));
+  createMonitor()->updateResourceUsage(cb_);
+
+  expectCgroupV2("200", "max\n");
+  EXPECT_CALL(cb_, onSuccess(PressureEq(0.5)));
+  createMonitor(400)->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, InvalidContents) {
+  EXPECT_CALL(file_system_, fileExists("/cgroup/memory.current")).WillOnce(Return(true));
+  EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory.current")).WillOnce(Return("lots"));
+  EXPECT_CALL(cb_, onFailure(_));
+  createMonitor()->updateResourceUsage(cb_);
+}
+
+TEST_F(CgroupMemoryMonitorTest, MissingFiles) {
+  EXPECT_CALL(file_system_, fileExists("/cgroup/memory.current")).WillOnce(Return(false));
+  EXPECT_CALL(file_system_, fileReadToEnd("/cgroup/memory/memory.usage_in_bytes"))
+      .WillOnce(Throw(EnvoyException("unable to read file")));
+  EXPECT_CALL(cb_, onFailure(_));
+  createMonitor()->updateResourceUsage(cb_);
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
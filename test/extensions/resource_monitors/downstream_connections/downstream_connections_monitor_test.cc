@@ -0,0 +1,74 @@
+#include "envoy/extensions/resource_monitors/downstream_connections/v3/downstream_connections.pb.h"
+
+#include "extensions/resource_monitors/downstream_connections/downstream_connections_monitor.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace DownstreamConnectionsMonitor {
+namespace {
+
+class MockConnectionStatsReader : public ConnectionStatsReader {
+public:
+  MockConnectionStatsReader() = default;
+
+  MOCK_METHOD(uint64_t, activeConnections, ());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+TEST(DownstreamConnectionsMonitorTest, ComputesCorrectUsage) {
+  envoy::extensions::resource_monitors::downstream_connections::v3::DownstreamConnectionsConfig
+      config;
+  config.set_max_active_downstream_connections(1000);
+  auto stats_reader = std::make_unique<MockConnectionStatsReader>();
+  EXPECT_CALL(*stats_reader, activeConnections()).WillOnce(testing::Return(700));
+  auto monitor = std::make_unique<DownstreamConnectionsMonitor>(config, std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_FALSE(resource.hasError());
+  EXPECT_EQ(resource.pressure(), 0.7);
+}
+
+// The pressure is not capped, so that triggers see by how much the maximum is exceeded.
+TEST(DownstreamConnectionsMonitorTest, ExceedsMaximum) {
+  envoy::extensions::resource_monitors::downstream_connections::v3::DownstreamConnectionsConfig
+      config;
+  config.set_max_active_downstream_connections(100);
+  auto stats_reader = std::make_unique<MockConnectionStatsReader>();
+  EXPECT_CALL(*stats_reader, activeConnections()).WillOnce(testing::Return(150));
+  auto monitor = std::make_unique<DownstreamConnectionsMonitor>(config, std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_EQ(resource.pressure(), 1.5);
+}
+
+} // namespace
+} // namespace DownstreamConnectionsMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
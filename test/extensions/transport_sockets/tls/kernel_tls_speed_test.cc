@@ -0,0 +1,93 @@
+// Measures the throughput of a TLS 1.3 connection over loopback TCP, with the record layers of both
+// ends in BoringSSL, and offloaded to the kernel. Each iteration writes a chunk of the given size
+// on the server end and reads it on the client end. The kernel TLS benchmark is skipped if the
+// kernel does not support TLS offload.
+
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <string>
+
+#include "common/common/assert.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/extensions/transport_sockets/tls/kernel_tls_test_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// The chunks fit in the socket buffers, so that a chunk can be written on a blocking socket before
+// it is read.
+void setBlocking(os_fd_t fd) {
+  RELEASE_ASSERT(::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK) == 0, "");
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_BoringSslThroughput(benchmark::State& state) {
+  TlsConnectionPair connection(TLS1_3_VERSION, "");
+  RELEASE_ASSERT(connection.handshake(), "");
+  setBlocking(connection.serverFd());
+  setBlocking(connection.clientFd());
+
+  const std::string chunk(state.range(0), 'a');
+  std::string received(chunk.size(), 0);
+  for (auto _ : state) {
+    RELEASE_ASSERT(SSL_write(connection.server(), chunk.data(), chunk.size()) ==
+                       static_cast<int>(chunk.size()),
+                   "");
+    for (size_t read = 0; read < chunk.size();) {
+      const int rc = SSL_read(connection.client(), &received[read], chunk.size() - read);
+      RELEASE_ASSERT(rc > 0, "");
+      read += rc;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * chunk.size());
+}
+BENCHMARK(BM_BoringSslThroughput)->Arg(1024)->Arg(16384)->Arg(65536);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_KernelTlsThroughput(benchmark::State& state) {
+  TlsConnectionPair connection(TLS1_3_VERSION, "");
+  RELEASE_ASSERT(connection.handshake(), "");
+  std::string failure_reason;
+  KernelTlsPtr server =
+      KernelTls::install(connection.server(), connection.serverFd(), failure_reason);
+  KernelTlsPtr client =
+      KernelTls::install(connection.client(), connection.clientFd(), failure_reason);
+  if (server == nullptr || client == nullptr) {
+    state.SkipWithError("kernel TLS is not supported");
+    return;
+  }
+  setBlocking(connection.serverFd());
+  setBlocking(connection.clientFd());
+
+  // Application data moves through the sockets as plaintext, as with KernelTls::doRead() and
+  // KernelTls::doWrite().
+  const std::string chunk(state.range(0), 'a');
+  std::string received(chunk.size(), 0);
+  for (auto _ : state) {
+    RELEASE_ASSERT(::send(connection.serverFd(), chunk.data(), chunk.size(), 0) ==
+                       static_cast<ssize_t>(chunk.size()),
+                   "");
+    for (size_t read = 0; read < chunk.size();) {
+      const ssize_t rc = ::recv(connection.clientFd(), &received[read], chunk.size() - read, 0);
+      RELEASE_ASSERT(rc > 0, "");
+      read += rc;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * chunk.size());
+}
+BENCHMARK(BM_KernelTlsThroughput)->Arg(1024)->Arg(16384)->Arg(65536);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
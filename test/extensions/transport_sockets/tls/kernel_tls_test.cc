@@ -0,0 +1,253 @@
+#include <linux/tls.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/extensions/transport_sockets/tls/kernel_tls_test_utility.h"
+#include "test/mocks/network/mocks.h"
+
+#include "absl/strings/escaping.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::vector<uint8_t> fromHex(absl::string_view hex) {
+  const std::string bytes = absl::HexStringToBytes(hex);
+  return {bytes.begin(), bytes.end()};
+}
+
+std::string toHex(absl::Span<const uint8_t> bytes) {
+  return absl::BytesToHexString(
+      absl::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+}
+
+// Traffic keys from the RFC 8448 simple 1-RTT handshake, whose cipher suite is
+// TLS_AES_128_GCM_SHA256.
+TEST(KernelTlsKeysTest, DeriveTrafficKeys) {
+  uint8_t key[16];
+  uint8_t iv[12];
+
+  // Server handshake traffic secret.
+  ASSERT_TRUE(KernelTls::deriveTrafficKeys(
+      EVP_sha256(), fromHex("b67b7d690cc16c4e75e54213cb2d37b4e9c912bcded9105d42befd59d391ad38"),
+      absl::MakeSpan(key), absl::MakeSpan(iv)));
+  EXPECT_EQ("3fce516009c21727d0f2e4e86ee403bc", toHex(key));
+  EXPECT_EQ("5d313eb2671276ee13000b30", toHex(iv));
+
+  // Server application traffic secret.
+  ASSERT_TRUE(KernelTls::deriveTrafficKeys(
+      EVP_sha256(), fromHex("a11af9f05531f856ad47116b45a950328204b4f44bfb6b3a4b4f1f3fcb631643"),
+      absl::MakeSpan(key), absl::MakeSpan(iv)));
+  EXPECT_EQ("9f02283b6c9c07efc26bb9f2ac92e356", toHex(key));
+  EXPECT_EQ("cf782b88dd83549aadf1e984", toHex(iv));
+}
+
+TEST(KernelTlsKeysTest, NextTrafficSecret) {
+  const std::vector<uint8_t> secret =
+      fromHex("a11af9f05531f856ad47116b45a950328204b4f44bfb6b3a4b4f1f3fcb631643");
+  std::vector<uint8_t> next = secret;
+  ASSERT_TRUE(KernelTls::nextTrafficSecret(EVP_sha256(), next));
+  EXPECT_EQ(secret.size(), next.size());
+  EXPECT_NE(secret, next);
+
+  // The update only depends on the previous secret.
+  std::vector<uint8_t> again = secret;
+  ASSERT_TRUE(KernelTls::nextTrafficSecret(EVP_sha256(), again));
+  EXPECT_EQ(next, again);
+}
+
+TEST(KernelTlsKeysTest, KeylogCallback) {
+  bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_method()));
+  bssl::UniquePtr<SSL> ssl(SSL_new(ctx.get()));
+
+  // Connections without secrets are ignored.
+  KernelTls::keylogCallback(ssl.get(), "CLIENT_TRAFFIC_SECRET_0 00 0102");
+
+  KernelTls::Secrets secrets;
+  SSL_set_ex_data(ssl.get(), KernelTls::secretsIndex(), &secrets);
+  KernelTls::keylogCallback(ssl.get(), "CLIENT_HANDSHAKE_TRAFFIC_SECRET 00 0a0b");
+  KernelTls::keylogCallback(ssl.get(), "CLIENT_TRAFFIC_SECRET_0 00 0102");
+  KernelTls::keylogCallback(ssl.get(), "SERVER_TRAFFIC_SECRET_0 00 030405");
+  KernelTls::keylogCallback(ssl.get(), "SERVER_TRAFFIC_SECRET_0 00");
+  EXPECT_EQ(std::vector<uint8_t>({1, 2}), secrets.client_traffic_secret_);
+  EXPECT_EQ(std::vector<uint8_t>({3, 4, 5}), secrets.server_traffic_secret_);
+  SSL_set_ex_data(ssl.get(), KernelTls::secretsIndex(), nullptr);
+}
+
+// The TLS version and the TLS 1.2 cipher suites of the connection.
+using KernelTlsTestParams = std::tuple<uint16_t, std::string>;
+
+// Offloads the server end of a connection to the kernel, and exchanges records with a client which
+// keeps using BoringSSL. The tests are skipped if the kernel does not support TLS offload.
+class KernelTlsTest : public testing::TestWithParam<KernelTlsTestParams> {
+protected:
+  KernelTlsTest() : connection_(std::get<0>(GetParam()), std::get<1>(GetParam())) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(connection_.handshake());
+    std::string failure_reason;
+    server_ = KernelTls::install(connection_.server(), connection_.serverFd(), failure_reason);
+    EXPECT_EQ("", failure_reason);
+    if (server_ == nullptr) {
+      GTEST_SKIP() << "kernel TLS is not supported";
+    }
+    io_handle_ = std::make_unique<Network::IoSocketHandleImpl>(connection_.releaseServerFd());
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*io_handle_));
+  }
+
+  // Reads from the server until size bytes, the end of the stream, or an error.
+  Network::IoResult serverRead(Buffer::Instance& buffer, uint64_t size) {
+    Network::IoResult result{Network::PostIoAction::KeepOpen, 0, false};
+    while (buffer.length() < size && result.action_ == Network::PostIoAction::KeepOpen &&
+           !result.end_stream_read_ &&
+           TlsConnectionPair::waitForReadable(io_handle_->fd(), 1000)) {
+      result = server_->doRead(buffer, callbacks_);
+    }
+    return result;
+  }
+
+  // Reads from the client until size bytes, or an error.
+  std::string clientRead(uint64_t size) {
+    std::string data(size, 0);
+    uint64_t read = 0;
+    while (read < size && TlsConnectionPair::waitForReadable(connection_.clientFd(), 1000)) {
+      const int rc = SSL_read(connection_.client(), &data[read], size - read);
+      if (rc <= 0) {
+        if (SSL_get_error(connection_.client(), rc) != SSL_ERROR_WANT_READ) {
+          break;
+        }
+        continue;
+      }
+      read += rc;
+    }
+    data.resize(read);
+    return data;
+  }
+
+  TlsConnectionPair connection_;
+  KernelTlsPtr server_;
+  std::unique_ptr<Network::IoSocketHandleImpl> io_handle_;
+  NiceMock<Network::MockTransportSocketCallbacks> callbacks_;
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    Versions, KernelTlsTest,
+    testing::Values(KernelTlsTestParams{TLS1_2_VERSION, "ECDHE-ECDSA-AES128-GCM-SHA256"},
+                    KernelTlsTestParams{TLS1_2_VERSION, "ECDHE-ECDSA-AES256-GCM-SHA384"},
+                    KernelTlsTestParams{TLS1_3_VERSION, ""}));
+
+TEST_P(KernelTlsTest, ReadWrite) {
+  const std::string request(40000, 'a');
+  ASSERT_EQ(static_cast<int>(request.size()),
+            SSL_write(connection_.client(), request.data(), request.size()));
+  Buffer::OwnedImpl read_buffer;
+  Network::IoResult result = serverRead(read_buffer, request.size());
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(request, read_buffer.toString());
+
+  const std::string response(40000, 'b');
+  Buffer::OwnedImpl write_buffer(response);
+  result = server_->doWrite(write_buffer, callbacks_);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(response.size(), result.bytes_processed_);
+  EXPECT_EQ(0UL, write_buffer.length());
+  EXPECT_EQ(response, clientRead(response.size()));
+}
+
+TEST_P(KernelTlsTest, CloseNotify) {
+  EXPECT_EQ(0, SSL_shutdown(connection_.client()));
+  Buffer::OwnedImpl read_buffer;
+  Network::IoResult result = serverRead(read_buffer, 1);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_TRUE(result.end_stream_read_);
+
+  server_->shutdown();
+  EXPECT_EQ(1, SSL_shutdown(connection_.client()));
+}
+
+TEST_P(KernelTlsTest, Alert) {
+  // A handshake message of an unknown type makes the client fail with an unexpected_message alert.
+  const uint8_t message[] = {99, 0, 0, 0};
+  iovec iov{const_cast<uint8_t*>(message), sizeof(message)};
+  alignas(cmsghdr) uint8_t control[CMSG_SPACE(sizeof(uint8_t))] = {};
+  msghdr header{};
+  header.msg_iov = &iov;
+  header.msg_iovlen = 1;
+  header.msg_control = control;
+  header.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = 22;
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(message)), ::sendmsg(io_handle_->fd(), &header, 0));
+  EXPECT_EQ("", clientRead(1));
+
+  Buffer::OwnedImpl read_buffer;
+  Network::IoResult result = serverRead(read_buffer, 1);
+  EXPECT_EQ(Network::PostIoAction::Close, result.action_);
+  EXPECT_THAT(server_->failureReason(), testing::StartsWith("kernel TLS: received alert"));
+}
+
+TEST_P(KernelTlsTest, BadRecord) {
+  // An application data record of 32 bytes which fails to decrypt.
+  std::vector<uint8_t> record = {23, 3, 3, 0, 32};
+  record.resize(record.size() + 32);
+  ASSERT_EQ(static_cast<ssize_t>(record.size()),
+            ::send(connection_.clientFd(), record.data(), record.size(), 0));
+  Buffer::OwnedImpl read_buffer;
+  Network::IoResult result = serverRead(read_buffer, 1);
+  EXPECT_EQ(Network::PostIoAction::Close, result.action_);
+  EXPECT_THAT(server_->failureReason(), testing::StartsWith("kernel TLS: read error"));
+}
+
+TEST_P(KernelTlsTest, KeyUpdate) {
+  if (SSL_version(connection_.client()) != TLS1_3_VERSION) {
+    GTEST_SKIP() << "key updates are specific to TLS 1.3";
+  }
+
+  ASSERT_EQ(1, SSL_key_update(connection_.client(), SSL_KEY_UPDATE_REQUESTED));
+  const std::string request = "after key update";
+  ASSERT_EQ(static_cast<int>(request.size()),
+            SSL_write(connection_.client(), request.data(), request.size()));
+  Buffer::OwnedImpl read_buffer;
+  Network::IoResult result = serverRead(read_buffer, request.size());
+  if (result.action_ == Network::PostIoAction::Close) {
+    // The kernel does not support replacing the keys of a connection.
+    EXPECT_THAT(server_->failureReason(), testing::StartsWith("kernel TLS: unable to update"));
+    return;
+  }
+  EXPECT_EQ(request, read_buffer.toString());
+
+  // The server updated its own keys as requested, which the client expects.
+  const std::string response = "response";
+  Buffer::OwnedImpl write_buffer(response);
+  result = server_->doWrite(write_buffer, callbacks_);
+  EXPECT_EQ(Network::PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(response, clientRead(response.size()));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
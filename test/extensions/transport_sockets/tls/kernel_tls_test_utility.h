@@ -0,0 +1,172 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/common/assert.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "openssl/ec_key.h"
+#include "openssl/evp.h"
+#include "openssl/ssl.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A TLS connection between two non-blocking sockets over loopback TCP, whose handshake is run by
+ * BoringSSL in the calling thread. The server uses a self-signed ECDSA certificate, which the
+ * client does not verify. The TLS 1.3 traffic secrets are captured as with a ContextImpl whose
+ * config enables kernel TLS.
+ */
+class TlsConnectionPair {
+public:
+  /**
+   * @param version the TLS version of the connection.
+   * @param cipher_list the TLS 1.2 cipher suites offered by the client. BoringSSL does not allow
+   *        configuring the TLS 1.3 cipher suites.
+   */
+  TlsConnectionPair(uint16_t version, const std::string& cipher_list) {
+    createSockets();
+
+    bssl::UniquePtr<EVP_PKEY> key(EVP_PKEY_new());
+    bssl::UniquePtr<EC_KEY> ec_key(EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+    RELEASE_ASSERT(EC_KEY_generate_key(ec_key.get()) == 1, "");
+    RELEASE_ASSERT(EVP_PKEY_assign_EC_KEY(key.get(), ec_key.release()) == 1, "");
+    bssl::UniquePtr<X509> cert(X509_new());
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_get_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_get_notAfter(cert.get()), 3600);
+    X509_set_pubkey(cert.get(), key.get());
+    RELEASE_ASSERT(X509_sign(cert.get(), key.get(), EVP_sha256()) > 0, "");
+
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    RELEASE_ASSERT(SSL_CTX_use_certificate(server_ctx_.get(), cert.get()) == 1, "");
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey(server_ctx_.get(), key.get()) == 1, "");
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    if (!cipher_list.empty()) {
+      RELEASE_ASSERT(SSL_CTX_set_strict_cipher_list(client_ctx_.get(), cipher_list.c_str()) == 1,
+                     "");
+    }
+    for (SSL_CTX* ctx : {server_ctx_.get(), client_ctx_.get()}) {
+      SSL_CTX_set_min_proto_version(ctx, version);
+      SSL_CTX_set_max_proto_version(ctx, version);
+      SSL_CTX_set_keylog_callback(ctx, KernelTls::keylogCallback);
+    }
+
+    server_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_accept_state(server_.get());
+    SSL_set_fd(server_.get(), server_fd_);
+    SSL_set_ex_data(server_.get(), KernelTls::secretsIndex(), &server_secrets_);
+    client_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_connect_state(client_.get());
+    SSL_set_fd(client_.get(), client_fd_);
+    SSL_set_ex_data(client_.get(), KernelTls::secretsIndex(), &client_secrets_);
+  }
+
+  ~TlsConnectionPair() {
+    // The sockets may have been handed over to I/O handles.
+    if (client_fd_ != -1) {
+      ::close(client_fd_);
+    }
+    if (server_fd_ != -1) {
+      ::close(server_fd_);
+    }
+  }
+
+  /**
+   * Run the handshake on both ends. What is written to a loopback socket can be read from its peer
+   * as soon as the write returns, so that no waiting is needed.
+   * @return bool whether the handshake completed.
+   */
+  bool handshake() {
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 100 && !(client_done && server_done); i++) {
+      client_done = client_done || step(client_.get());
+      server_done = server_done || step(server_.get());
+    }
+    return client_done && server_done;
+  }
+
+  /**
+   * Wait for a socket to become readable.
+   * @return bool whether the socket is readable.
+   */
+  static bool waitForReadable(os_fd_t fd, int timeout_ms) {
+    pollfd poll_fd{fd, POLLIN, 0};
+    return ::poll(&poll_fd, 1, timeout_ms) == 1;
+  }
+
+  /**
+   * @return os_fd_t the socket, whose ownership moves to the caller.
+   */
+  os_fd_t releaseClientFd() { return release(client_fd_); }
+  os_fd_t releaseServerFd() { return release(server_fd_); }
+
+  SSL* client() { return client_.get(); }
+  SSL* server() { return server_.get(); }
+  os_fd_t clientFd() const { return client_fd_; }
+  os_fd_t serverFd() const { return server_fd_; }
+
+private:
+  void createSockets() {
+    const os_fd_t listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(listen_fd != -1, "");
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_len = sizeof(address);
+    RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_len) == 0, "");
+    RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "");
+    RELEASE_ASSERT(
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_len) == 0, "");
+
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    RELEASE_ASSERT(client_fd_ != -1, "");
+    const int rc = ::connect(client_fd_, reinterpret_cast<sockaddr*>(&address), address_len);
+    RELEASE_ASSERT(rc == 0 || errno == EINPROGRESS, "");
+    server_fd_ = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+    RELEASE_ASSERT(server_fd_ != -1, "");
+    ::close(listen_fd);
+  }
+
+  static bool step(SSL* ssl) {
+    const int rc = SSL_do_handshake(ssl);
+    if (rc == 1) {
+      return true;
+    }
+    const int err = SSL_get_error(ssl, rc);
+    RELEASE_ASSERT(err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE, "");
+    return false;
+  }
+
+  static os_fd_t release(os_fd_t& fd) {
+    const os_fd_t released = fd;
+    fd = -1;
+    return released;
+  }
+
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  KernelTls::Secrets server_secrets_;
+  KernelTls::Secrets client_secrets_;
+  bssl::UniquePtr<SSL> server_;
+  bssl::UniquePtr<SSL> client_;
+  os_fd_t client_fd_{-1};
+  os_fd_t server_fd_{-1};
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
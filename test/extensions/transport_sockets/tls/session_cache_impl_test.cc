@@ -0,0 +1,111 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "extensions/transport_sockets/tls/session_cache_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class ServerSessionCacheTest : public testing::Test {
+protected:
+  ServerSessionCacheTest() : cache_({32, true}, time_system_) {}
+
+  Event::SimulatedTimeSystem time_system_;
+  ServerSessionCache cache_;
+};
+
+TEST_F(ServerSessionCacheTest, InsertLookupRemove) {
+  EXPECT_FALSE(cache_.lookup("id").has_value());
+  EXPECT_FALSE(cache_.insert("id", "session", std::chrono::seconds(10)));
+  EXPECT_EQ("session", cache_.lookup("id").value());
+  EXPECT_EQ(1, cache_.size());
+
+  // Inserting a session with the same ID replaces it.
+  EXPECT_FALSE(cache_.insert("id", "session2", std::chrono::seconds(10)));
+  EXPECT_EQ("session2", cache_.lookup("id").value());
+  EXPECT_EQ(1, cache_.size());
+
+  cache_.remove("id");
+  cache_.remove("unknown");
+  EXPECT_FALSE(cache_.lookup("id").has_value());
+  EXPECT_EQ(0, cache_.size());
+}
+
+TEST_F(ServerSessionCacheTest, Expiry) {
+  cache_.insert("short", "session", std::chrono::seconds(10));
+  cache_.insert("long", "session", std::chrono::seconds(100));
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_FALSE(cache_.lookup("short").has_value());
+  EXPECT_TRUE(cache_.lookup("long").has_value());
+  EXPECT_EQ(1, cache_.size());
+}
+
+// Each shard holds 2 of the 32 sessions, and evicts the least recently used one when full.
+TEST_F(ServerSessionCacheTest, Eviction) {
+  uint64_t evictions = 0;
+  for (int i = 0; i < 1000; i++) {
+    evictions += cache_.insert(std::to_string(i), "session", std::chrono::seconds(10));
+    // The first session is looked up after each insertion, so that it is never evicted.
+    EXPECT_TRUE(cache_.lookup("0").has_value());
+  }
+  EXPECT_LE(cache_.size(), 32);
+  EXPECT_EQ(1000 - cache_.size(), evictions);
+  EXPECT_TRUE(cache_.lookup("999").has_value());
+}
+
+TEST(ServerSessionCacheRegistryTest, SharedBySessionIdContext) {
+  Event::SimulatedTimeSystem time_system;
+  ServerSessionCacheRegistry registry(time_system);
+  ServerSessionCacheSharedPtr a = registry.getOrCreate("a", {10, true});
+  EXPECT_EQ(a, registry.getOrCreate("a", {20, false}));
+  EXPECT_NE(a, registry.getOrCreate("b", {10, true}));
+
+  // The cache of "b" is not used anymore, while the one of "a" is.
+  a->insert("id", "session", std::chrono::seconds(10));
+  registry.removeUnused();
+  EXPECT_EQ(a, registry.getOrCreate("a", {10, true}));
+  EXPECT_EQ(0, registry.getOrCreate("b", {10, true})->size());
+}
+
+TEST(ServerSessionCacheRegistryTest, ExportImport) {
+  Event::SimulatedTimeSystem time_system;
+  ServerSessionCacheRegistry parent(time_system);
+  ServerSessionCacheSharedPtr preserved = parent.getOrCreate("preserved", {10, true});
+  ServerSessionCacheSharedPtr not_preserved = parent.getOrCreate("not_preserved", {10, false});
+  preserved->insert("id1", "session1", std::chrono::seconds(100));
+  preserved->insert("id2", "session2", std::chrono::seconds(10));
+  not_preserved->insert("id3", "session3", std::chrono::seconds(100));
+  time_system.advanceTimeWait(std::chrono::seconds(40));
+
+  // Expired sessions, and sessions of caches which are not preserved, are not exported.
+  const std::vector<Envoy::Ssl::ContextManager::CachedSession> sessions = parent.exportSessions();
+  ASSERT_EQ(1, sessions.size());
+  EXPECT_EQ("preserved", sessions[0].session_id_context_);
+  EXPECT_EQ("id1", sessions[0].session_id_);
+  EXPECT_EQ("session1", sessions[0].session_);
+  EXPECT_EQ(std::chrono::seconds(60), sessions[0].ttl_);
+
+  // Sessions are only imported into the caches of the contexts which the child has.
+  ServerSessionCacheRegistry child(time_system);
+  ServerSessionCacheSharedPtr child_cache = child.getOrCreate("preserved", {10, true});
+  child.importSessions(sessions);
+  child.importSessions({{"unknown", "id4", "session4", std::chrono::seconds(100)}});
+  EXPECT_EQ("session1", child_cache->lookup("id1").value());
+  EXPECT_EQ(1, child_cache->size());
+  time_system.advanceTimeWait(std::chrono::seconds(60));
+  EXPECT_FALSE(child_cache->lookup("id1").has_value());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
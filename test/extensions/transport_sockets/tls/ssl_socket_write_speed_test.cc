@@ -0,0 +1,88 @@
+// Measures the cost of writing a multi-slice buffer to a TLS connection: a short slice, as HTTP
+// headers would be, followed by body slices of the given size. SslSocket encrypts the slices in
+// place, while the linearized benchmark copies each 16KiB record into a single slice with
+// Buffer::Instance::linearize() before encrypting it. The server end discards the records.
+
+#include <sys/socket.h>
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+
+#include "test/extensions/transport_sockets/tls/kernel_tls_test_utility.h"
+#include "test/extensions/transport_sockets/tls/ssl_socket_write_test_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+constexpr uint64_t BodySize = 256 * 1024;
+
+void fillBuffer(Buffer::OwnedImpl& buffer, uint64_t slice_size) {
+  buffer.appendSliceForTest(std::string(200, 'h'));
+  for (uint64_t size = 0; size < BodySize; size += slice_size) {
+    buffer.appendSliceForTest(std::string(slice_size, 'b'));
+  }
+}
+
+void discard(os_fd_t fd) {
+  char data[65536];
+  while (::recv(fd, data, sizeof(data), MSG_DONTWAIT) > 0) {
+  }
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_SslSocketWrite(benchmark::State& state) {
+  ClientSslSocketConnection connection;
+  RELEASE_ASSERT(connection.handshake(), "");
+
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fillBuffer(buffer, state.range(0));
+    state.ResumeTiming();
+    while (buffer.length() > 0) {
+      RELEASE_ASSERT(connection.socket().doWrite(buffer, false).action_ ==
+                         Network::PostIoAction::KeepOpen,
+                     "");
+      discard(connection.serverFd());
+    }
+  }
+}
+BENCHMARK(BM_SslSocketWrite)->Arg(256)->Arg(4096)->Arg(16384)->Arg(65536);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LinearizedWrite(benchmark::State& state) {
+  TlsConnectionPair connection(TLS1_3_VERSION, "");
+  RELEASE_ASSERT(connection.handshake(), "");
+
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    state.PauseTiming();
+    fillBuffer(buffer, state.range(0));
+    state.ResumeTiming();
+    while (buffer.length() > 0) {
+      const uint64_t size = std::min<uint64_t>(buffer.length(), 16384);
+      const int rc = SSL_write(connection.client(), buffer.linearize(size), size);
+      if (rc > 0) {
+        buffer.drain(rc);
+      } else {
+        RELEASE_ASSERT(SSL_get_error(connection.client(), rc) == SSL_ERROR_WANT_WRITE, "");
+      }
+      discard(connection.serverFd());
+    }
+  }
+}
+BENCHMARK(BM_LinearizedWrite)->Arg(256)->Arg(4096)->Arg(16384)->Arg(65536);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
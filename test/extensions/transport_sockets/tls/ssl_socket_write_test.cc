@@ -0,0 +1,153 @@
+#include <sys/socket.h>
+
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "test/extensions/transport_sockets/tls/ssl_socket_write_test_utility.h"
+#include "test/test_common/test_runtime.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// A TLS 1.3 record carries its content type and a 16 byte AEAD tag along with its plaintext.
+constexpr uint64_t RecordOverhead = 17;
+
+// Writes the whole buffer, and returns the plaintext size of each record the server received.
+std::vector<uint64_t> writeRecords(ClientSslSocketConnection& connection,
+                                   Buffer::Instance& buffer) {
+  const uint64_t expected = buffer.length();
+  uint64_t received = 0;
+  std::vector<uint64_t> record_sizes;
+  std::string pending;
+  for (int i = 0; i < 1000 && received < expected; i++) {
+    if (buffer.length() > 0) {
+      EXPECT_EQ(Network::PostIoAction::KeepOpen,
+                connection.socket().doWrite(buffer, false).action_);
+    }
+    char data[16384];
+    const ssize_t rc = ::recv(connection.serverFd(), data, sizeof(data), MSG_DONTWAIT);
+    if (rc > 0) {
+      pending.append(data, rc);
+    }
+    // Records are parsed from their headers, without decrypting them.
+    while (pending.size() >= 5) {
+      const uint64_t length =
+          (static_cast<uint64_t>(static_cast<uint8_t>(pending[3])) << 8) |
+          static_cast<uint8_t>(pending[4]);
+      if (pending.size() < 5 + length) {
+        break;
+      }
+      record_sizes.push_back(length - RecordOverhead);
+      received += length - RecordOverhead;
+      pending.erase(0, 5 + length);
+    }
+  }
+  EXPECT_EQ(expected, received);
+  return record_sizes;
+}
+
+class SslSocketWriteTest : public testing::Test {
+protected:
+  void SetUp() override { ASSERT_TRUE(connection_.handshake()); }
+
+  ClientSslSocketConnection connection_;
+};
+
+// Slices which are large enough are written as records of their own.
+TEST_F(SslSocketWriteTest, SlicesWrittenInPlace) {
+  Buffer::OwnedImpl buffer;
+  for (int i = 0; i < 4; i++) {
+    buffer.appendSliceForTest(std::string(4096, 'a'));
+  }
+  EXPECT_EQ(std::vector<uint64_t>({4096, 4096, 4096, 4096}), writeRecords(connection_, buffer));
+}
+
+TEST_F(SslSocketWriteTest, LargeSliceSplit) {
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(std::string(40000, 'a'));
+  EXPECT_EQ(std::vector<uint64_t>({16384, 16384, 7232}), writeRecords(connection_, buffer));
+}
+
+// Short slices are coalesced, up to the next slice which is large enough.
+TEST_F(SslSocketWriteTest, ShortSlicesCoalesced) {
+  Buffer::OwnedImpl buffer;
+  for (int i = 0; i < 10; i++) {
+    buffer.appendSliceForTest(std::string(100, 'a'));
+  }
+  buffer.appendSliceForTest(std::string(8000, 'b'));
+  for (int i = 0; i < 3; i++) {
+    buffer.appendSliceForTest(std::string(10, 'c'));
+  }
+  EXPECT_EQ(std::vector<uint64_t>({1000, 8000, 30}), writeRecords(connection_, buffer));
+}
+
+// The peer receives the data of the slices in order.
+TEST_F(SslSocketWriteTest, Data) {
+  Buffer::OwnedImpl buffer;
+  std::string expected;
+  for (size_t size : {10, 2000, 100, 30000, 5, 5, 1500}) {
+    const std::string slice(size, 'a' + expected.size() % 26);
+    buffer.appendSliceForTest(slice);
+    expected += slice;
+  }
+
+  std::string received(expected.size(), 0);
+  size_t read = 0;
+  for (int i = 0; i < 1000 && read < expected.size(); i++) {
+    if (buffer.length() > 0) {
+      EXPECT_EQ(Network::PostIoAction::KeepOpen,
+                connection_.socket().doWrite(buffer, false).action_);
+    }
+    const int rc = SSL_read(connection_.server(), &received[read], expected.size() - read);
+    if (rc > 0) {
+      read += rc;
+    }
+  }
+  EXPECT_EQ(expected, received);
+}
+
+// Records start small enough for a TCP segment, double in size every 16KiB, and start small again
+// once the connection has been idle.
+TEST(SslSocketDynamicRecordSizingTest, RecordSizes) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.tls_dynamic_record_sizing", "true"}});
+  ClientSslSocketConnection connection;
+  ASSERT_TRUE(connection.handshake());
+
+  std::vector<uint64_t> expected;
+  uint64_t remaining = 131072;
+  for (uint64_t size : {1400, 2800, 5600, 11200}) {
+    for (uint64_t bytes = 0; bytes < 16384; bytes += size) {
+      expected.push_back(size);
+      remaining -= size;
+    }
+  }
+  for (; remaining > 0; remaining -= expected.back()) {
+    expected.push_back(std::min<uint64_t>(remaining, 16384));
+  }
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(std::string(131072, 'a'));
+  EXPECT_EQ(expected, writeRecords(connection, buffer));
+
+  connection.timeSystem().advanceTimeWait(std::chrono::milliseconds(500));
+  buffer.appendSliceForTest(std::string(20000, 'a'));
+  EXPECT_EQ(std::vector<uint64_t>({16384, 3616}), writeRecords(connection, buffer));
+
+  connection.timeSystem().advanceTimeWait(std::chrono::seconds(2));
+  buffer.appendSliceForTest(std::string(2000, 'a'));
+  EXPECT_EQ(std::vector<uint64_t>({1400, 600}), writeRecords(connection, buffer));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/transport_sockets/tls/context_config_impl.h"
+#include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/ssl_socket.h"
+
+#include "test/extensions/transport_sockets/tls/kernel_tls_test_utility.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A TLS 1.3 connection over loopback TCP whose client end is an SslSocket, and whose server end is
+ * a BoringSSL connection driven by the calling thread. The SslSocket runs with mocked callbacks, so
+ * that its writes can be driven one doWrite() at a time.
+ */
+class ClientSslSocketConnection {
+public:
+  ClientSslSocketConnection() : pair_(TLS1_3_VERSION, "") {
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+    tls_context.mutable_common_tls_context()->mutable_tls_params()->set_tls_maximum_protocol_version(
+        envoy::extensions::transport_sockets::tls::v3::TlsParameters::TLSv1_3);
+    config_ = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+    context_ = std::make_shared<ClientContextImpl>(store_, *config_, time_system_);
+    socket_ = std::make_unique<SslSocket>(context_, InitialState::Client, nullptr);
+
+    io_handle_ = std::make_unique<Network::IoSocketHandleImpl>(pair_.releaseClientFd());
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(testing::ReturnRef(*io_handle_));
+    ON_CALL(callbacks_.connection_.dispatcher_, approximateMonotonicTime())
+        .WillByDefault(testing::Invoke([this]() { return time_system_.monotonicTime(); }));
+    socket_->setTransportSocketCallbacks(callbacks_);
+  }
+
+  /**
+   * Run the handshake on both ends.
+   * @return bool whether the handshake completed.
+   */
+  bool handshake() {
+    Buffer::OwnedImpl empty;
+    for (int i = 0; i < 100; i++) {
+      if (socket_->doWrite(empty, false).action_ != Network::PostIoAction::KeepOpen) {
+        return false;
+      }
+      const int rc = SSL_do_handshake(pair_.server());
+      if (rc == 1 && SSL_is_init_finished(socket_->rawSslForTest())) {
+        return true;
+      }
+      if (rc != 1 && SSL_get_error(pair_.server(), rc) != SSL_ERROR_WANT_READ) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  SslSocket& socket() { return *socket_; }
+  SSL* server() { return pair_.server(); }
+  os_fd_t serverFd() const { return pair_.serverFd(); }
+  Event::SimulatedTimeSystem& timeSystem() { return time_system_; }
+
+private:
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  std::unique_ptr<ClientContextConfigImpl> config_;
+  Envoy::Ssl::ClientContextSharedPtr context_;
+  TlsConnectionPair pair_;
+  std::unique_ptr<Network::IoSocketHandleImpl> io_handle_;
+  testing::NiceMock<Network::MockTransportSocketCallbacks> callbacks_;
+  std::unique_ptr<SslSocket> socket_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
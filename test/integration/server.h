@@ -246,6 +246,15 @@ public:
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
   void mergeHistograms(PostMergeCb) override {}
+  void setHistogramMergeThreads(Thread::ThreadFactory&, uint32_t) override {}
+  void trackChangedStats() override {}
+  // Changes are not tracked, so every counter and gauge is reported as changed.
+  void takeChangedStats(std::vector<CounterSharedPtr>& counters,
+                        std::vector<GaugeSharedPtr>& gauges) override {
+    Thread::LockGuard lock(lock_);
+    counters = store_.counters();
+    gauges = store_.gauges();
+  }
 
 private:
   mutable Thread::MutexBasicLockable lock_;
@@ -390,6 +390,101 @@ TEST_P(TcpProxyIntegrationTest, TestIdletimeoutWithLargeOutstandingData) {
   ASSERT_TRUE(fake_upstream_connection->waitForDisconnect(true));
 }
 
+// Switch the tcp_proxy filter to the v3 config with splicing enabled.
+void enableSplice(ConfigHelper& config_helper) {
+  config_helper.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+    auto* config_blob =
+        listener->mutable_filter_chains(0)->mutable_filters(0)->mutable_typed_config();
+
+    ASSERT_TRUE(
+        config_blob->Is<API_NO_BOOST(envoy::config::filter::network::tcp_proxy::v2::TcpProxy)>());
+    auto v2_config = MessageUtil::anyConvert<API_NO_BOOST(
+        envoy::config::filter::network::tcp_proxy::v2::TcpProxy)>(*config_blob);
+    envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy tcp_proxy_config;
+    tcp_proxy_config.set_stat_prefix(v2_config.stat_prefix());
+    tcp_proxy_config.set_cluster(v2_config.cluster());
+    tcp_proxy_config.set_use_splice(true);
+    config_blob->PackFrom(tcp_proxy_config);
+  });
+}
+
+TEST_P(TcpProxyIntegrationTest, TcpProxySpliceLargeWrite) {
+  config_helper_.setBufferLimits(1024, 1024);
+  enableSplice(config_helper_);
+  initialize();
+
+  std::string data(1024 * 256, 'a');
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  tcp_client->write(data);
+  ASSERT_TRUE(fake_upstream_connection->waitForData(data.size()));
+  ASSERT_TRUE(fake_upstream_connection->write(data));
+  tcp_client->waitForData(data);
+
+  // Half close in both directions is forwarded.
+  tcp_client->write("", true);
+  ASSERT_TRUE(fake_upstream_connection->waitForHalfClose());
+  ASSERT_TRUE(fake_upstream_connection->write("", true));
+  tcp_client->waitForHalfClose();
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForDisconnect();
+
+  EXPECT_EQ(data.size(),
+            test_server_->counter("tcp.tcp_stats.downstream_cx_rx_bytes_total")->value());
+  EXPECT_EQ(data.size(),
+            test_server_->counter("tcp.tcp_stats.downstream_cx_tx_bytes_total")->value());
+  EXPECT_EQ(data.size(),
+            test_server_->counter("cluster.cluster_0.upstream_cx_tx_bytes_total")->value());
+  EXPECT_EQ(data.size(),
+            test_server_->counter("cluster.cluster_0.upstream_cx_rx_bytes_total")->value());
+}
+
+TEST_P(TcpProxyIntegrationTest, TcpProxySpliceUpstreamDisconnect) {
+  enableSplice(config_helper_);
+  initialize();
+
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  tcp_client->write("hello");
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+  ASSERT_TRUE(fake_upstream_connection->write("world"));
+  ASSERT_TRUE(fake_upstream_connection->close());
+  tcp_client->waitForData("world");
+  tcp_client->waitForHalfClose();
+  tcp_client->close();
+}
+
+TEST_P(TcpProxyIntegrationTest, TcpProxySpliceIdleTimeout) {
+  enable_half_close_ = false;
+  enableSplice(config_helper_);
+  config_helper_.addConfigModifier([&](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+    auto* config_blob =
+        listener->mutable_filter_chains(0)->mutable_filters(0)->mutable_typed_config();
+    auto tcp_proxy_config =
+        MessageUtil::anyConvert<envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy>(
+            *config_blob);
+    tcp_proxy_config.mutable_idle_timeout()->set_nanos(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(100))
+            .count());
+    config_blob->PackFrom(tcp_proxy_config);
+  });
+  initialize();
+
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  tcp_client->write("hello");
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+
+  tcp_client->waitForDisconnect(true);
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect(true));
+  EXPECT_EQ(1, test_server_->counter("tcp.tcp_stats.idle_timeout")->value());
+}
+
 class TcpProxyMetadataMatchIntegrationTest : public TcpProxyIntegrationTest {
 public:
   void initialize() override;
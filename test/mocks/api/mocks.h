@@ -70,10 +70,17 @@ public:
   MOCK_METHOD(SysCallIntResult, recvmmsg,
               (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                struct timespec* timeout));
+  MOCK_METHOD(SysCallIntResult, sendmmsg,
+              (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags));
   MOCK_METHOD(SysCallIntResult, ftruncate, (int fd, off_t length));
   MOCK_METHOD(SysCallPtrResult, mmap,
               (void* addr, size_t length, int prot, int flags, int fd, off_t offset));
+  MOCK_METHOD(SysCallIntResult, munmap, (void* addr, size_t length));
   MOCK_METHOD(SysCallIntResult, stat, (const char* name, struct stat* stat));
+  MOCK_METHOD(SysCallIntResult, fstat, (int fd, struct stat* stat));
+  MOCK_METHOD(SysCallIntResult, open, (const char* pathname, int flags));
+  MOCK_METHOD(SysCallIntResult, rename, (const char* oldpath, const char* newpath));
+  MOCK_METHOD(SysCallIntResult, unlink, (const char* pathname));
   MOCK_METHOD(SysCallIntResult, chmod, (const std::string& name, mode_t mode));
   MOCK_METHOD(int, setsockopt_,
               (os_fd_t sockfd, int level, int optname, const void* optval, socklen_t optlen));
@@ -90,6 +97,8 @@ public:
   MOCK_METHOD(SysCallIntResult, listen, (os_fd_t sockfd, int backlog));
   MOCK_METHOD(SysCallSizeResult, write, (os_fd_t sockfd, const void* buffer, size_t length));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+  MOCK_METHOD(bool, supportsUdpGro, (), (const));
 
   // Map from (sockfd,level,optname) to boolean socket option.
   using SockOptKey = std::tuple<os_fd_t, int, int>;
@@ -101,6 +110,9 @@ class MockLinuxOsSysCalls : public LinuxOsSysCallsImpl {
 public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD(SysCallIntResult, sched_getaffinity, (pid_t pid, size_t cpusetsize, cpu_set_t* mask));
+  MOCK_METHOD(SysCallIntResult, pipe2, (int pipefd[2], int flags));
+  MOCK_METHOD(SysCallSizeResult, splice, (int fd_in, int fd_out, size_t len, unsigned int flags));
+  MOCK_METHOD(SysCallIntResult, setPipeSize, (int fd, int size));
 };
 #endif
 
@@ -33,6 +33,14 @@ Api::IoCallSizeResult MockFile::write(absl::string_view buffer) {
   return result;
 }
 
+Api::IoCallSizeResult MockFile::writev(const absl::string_view* slices, uint64_t num_slices) {
+  std::string buffer;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    buffer.append(slices[i].data(), slices[i].size());
+  }
+  return write(buffer);
+}
+
 Api::IoCallBoolResult MockFile::close() {
   Api::IoCallBoolResult result = close_();
   is_open_ = !result.rc_;
@@ -20,15 +20,24 @@ public:
               (uint64_t max_length, Buffer::RawSlice* slices, uint64_t num_slice));
   MOCK_METHOD(Api::IoCallUint64Result, writev,
               (const Buffer::RawSlice* slices, uint64_t num_slice));
+  MOCK_METHOD(Api::IoCallUint64Result, read, (Buffer::Instance & buffer, uint64_t max_length));
+  MOCK_METHOD(Api::IoCallUint64Result, write, (Buffer::Instance & buffer));
   MOCK_METHOD(Api::IoCallUint64Result, sendmsg,
               (const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                const Address::Ip* self_ip, const Address::Instance& peer_address));
+  MOCK_METHOD(Api::IoCallUint64Result, sendmmsg,
+              (const SendMsgInfo* messages, uint64_t num_messages, int flags));
   MOCK_METHOD(Api::IoCallUint64Result, recvmsg,
               (Buffer::RawSlice * slices, const uint64_t num_slice, uint32_t self_port,
                RecvMsgOutput& output));
   MOCK_METHOD(Api::IoCallUint64Result, recvmmsg,
               (RawSliceArrays & slices, uint32_t self_port, RecvMsgOutput& output));
   MOCK_METHOD(bool, supportsMmsg, (), (const));
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+  MOCK_METHOD(Api::SysCallIntResult, shutdown, (int how));
+  MOCK_METHOD(Event::FileEventPtr, createFileEvent,
+              (Event::Dispatcher & dispatcher, Event::FileReadyCb cb,
+               Event::FileTriggerType trigger, uint32_t events));
 };
 
 } // namespace Network
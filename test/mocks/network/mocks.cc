@@ -192,6 +192,9 @@ MockUdpListenerReadFilter::~MockUdpListenerReadFilter() = default;
 MockUdpListenerFilterManager::MockUdpListenerFilterManager() = default;
 MockUdpListenerFilterManager::~MockUdpListenerFilterManager() = default;
 
+MockBalancedConnectionHandler::MockBalancedConnectionHandler() = default;
+MockBalancedConnectionHandler::~MockBalancedConnectionHandler() = default;
+
 MockConnectionBalancer::MockConnectionBalancer() = default;
 MockConnectionBalancer::~MockConnectionBalancer() = default;
 
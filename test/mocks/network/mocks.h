@@ -365,6 +365,7 @@ public:
   MOCK_METHOD(void, stopListeners, ());
   MOCK_METHOD(void, disableListeners, ());
   MOCK_METHOD(void, enableListeners, ());
+  MOCK_METHOD(void, setListenerRejectFraction, (float));
   MOCK_METHOD(const std::string&, statPrefix, (), (const));
 };
 
@@ -435,6 +436,8 @@ public:
   MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
   MOCK_METHOD(Address::InstanceConstSharedPtr&, localAddress, (), (const));
   MOCK_METHOD(Api::IoCallUint64Result, send, (const UdpSendData&));
+  MOCK_METHOD(void, queueSend, (const UdpSendData&));
+  MOCK_METHOD(UdpFlushResult, flush, ());
 
   Event::MockDispatcher dispatcher_;
 };
@@ -467,6 +470,17 @@ public:
   MOCK_METHOD(void, addReadFilter_, (Network::UdpListenerReadFilterPtr&));
 };
 
+class MockBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  MockBalancedConnectionHandler();
+  ~MockBalancedConnectionHandler() override;
+
+  MOCK_METHOD(uint64_t, numConnections, (), (const));
+  MOCK_METHOD(void, incNumConnections, ());
+  MOCK_METHOD(void, post, (ConnectionSocketPtr && socket));
+  MOCK_METHOD(Socket&, listenSocket, ());
+};
+
 class MockConnectionBalancer : public ConnectionBalancer {
 public:
   MockConnectionBalancer();
@@ -21,6 +21,7 @@ public:
   MOCK_METHOD(std::string, protocol, (), (const));
   MOCK_METHOD(absl::string_view, failureReason, (), (const));
   MOCK_METHOD(bool, canFlushClose, ());
+  MOCK_METHOD(bool, passthrough, (), (const));
   MOCK_METHOD(void, closeSocket, (Network::ConnectionEvent event));
   MOCK_METHOD(IoResult, doRead, (Buffer::Instance & buffer));
   MOCK_METHOD(IoResult, doWrite, (Buffer::Instance & buffer, bool end_stream));
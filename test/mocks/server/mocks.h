@@ -89,6 +89,7 @@ public:
   MOCK_METHOD(std::chrono::seconds, parentShutdownTime, (), (const));
   MOCK_METHOD(uint64_t, restartEpoch, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, fileFlushIntervalMsec, (), (const));
+  MOCK_METHOD(uint32_t, fileFlushThreads, (), (const));
   MOCK_METHOD(Mode, mode, (), (const));
   MOCK_METHOD(const std::string&, serviceClusterName, (), (const));
   MOCK_METHOD(const std::string&, serviceNodeName, (), (const));
@@ -176,6 +177,7 @@ public:
   MOCK_METHOD(Http::RequestHeaderMap&, getRequestHeaders, (), (const));
   MOCK_METHOD(NiceMock<Http::MockStreamDecoderFilterCallbacks>&, getDecoderFilterCallbacks, (),
               (const));
+  MOCK_METHOD(bool, streamingSupported, (), (const));
   MOCK_METHOD(Http::Http1StreamEncoderOptionsOptRef, http1StreamEncoderOptions, ());
 };
 
@@ -230,6 +232,7 @@ public:
   MOCK_METHOD(void, sendParentAdminShutdownRequest, (time_t & original_start_time));
   MOCK_METHOD(void, sendParentTerminateRequest, ());
   MOCK_METHOD(ServerStatsFromParent, mergeParentStatsIfAny, (Stats::StoreRoot & stats_store));
+  MOCK_METHOD(void, mergeParentTlsSessionsIfAny, (Ssl::ContextManager & context_manager));
   MOCK_METHOD(void, shutdown, ());
   MOCK_METHOD(std::string, version, ());
   MOCK_METHOD(Thread::BasicLockable&, logLock, ());
@@ -24,5 +24,8 @@ MockPrivateKeyMethodManager::~MockPrivateKeyMethodManager() = default;
 MockPrivateKeyMethodProvider::MockPrivateKeyMethodProvider() = default;
 MockPrivateKeyMethodProvider::~MockPrivateKeyMethodProvider() = default;
 
+MockPrivateKeyConnectionCallbacks::MockPrivateKeyConnectionCallbacks() = default;
+MockPrivateKeyConnectionCallbacks::~MockPrivateKeyConnectionCallbacks() = default;
+
 } // namespace Ssl
 } // namespace Envoy
@@ -31,6 +31,8 @@ public:
   MOCK_METHOD(size_t, daysUntilFirstCertExpires, (), (const));
   MOCK_METHOD(void, iterateContexts, (std::function<void(const Context&)> callback));
   MOCK_METHOD(Ssl::PrivateKeyMethodManager&, privateKeyMethodManager, ());
+  MOCK_METHOD(std::vector<CachedSession>, exportSessions, (), (const));
+  MOCK_METHOD(void, importSessions, (const std::vector<CachedSession>& sessions));
 };
 
 class MockConnectionInfo : public ConnectionInfo {
@@ -83,6 +85,7 @@ public:
   MOCK_METHOD(const CertificateValidationContextConfig*, certificateValidationContext, (), (const));
   MOCK_METHOD(unsigned, minProtocolVersion, (), (const));
   MOCK_METHOD(unsigned, maxProtocolVersion, (), (const));
+  MOCK_METHOD(bool, enableKernelTls, (), (const));
   MOCK_METHOD(bool, isReady, (), (const));
   MOCK_METHOD(void, setSecretUpdateCallback, (std::function<void()> callback));
 
@@ -105,6 +108,7 @@ public:
   MOCK_METHOD(const CertificateValidationContextConfig*, certificateValidationContext, (), (const));
   MOCK_METHOD(unsigned, minProtocolVersion, (), (const));
   MOCK_METHOD(unsigned, maxProtocolVersion, (), (const));
+  MOCK_METHOD(bool, enableKernelTls, (), (const));
   MOCK_METHOD(bool, isReady, (), (const));
   MOCK_METHOD(absl::optional<std::chrono::seconds>, sessionTimeout, (), (const));
   MOCK_METHOD(void, setSecretUpdateCallback, (std::function<void()> callback));
@@ -112,6 +116,7 @@ public:
   MOCK_METHOD(bool, requireClientCertificate, (), (const));
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
+  MOCK_METHOD(const absl::optional<SessionCacheConfig>&, sessionCache, (), (const));
 };
 
 class MockPrivateKeyMethodManager : public PrivateKeyMethodManager {
@@ -139,5 +144,13 @@ public:
 #endif
 };
 
+class MockPrivateKeyConnectionCallbacks : public PrivateKeyConnectionCallbacks {
+public:
+  MockPrivateKeyConnectionCallbacks();
+  ~MockPrivateKeyConnectionCallbacks() override;
+
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
 } // namespace Ssl
 } // namespace Envoy
@@ -230,6 +230,31 @@ TEST_F(ConnectionHandlerTest, RemoveListenerDuringRebalance) {
 #endif
 }
 
+// Verify that connections which the balancer hands off to another handler are counted by the
+// handler which accepted them.
+TEST_F(ConnectionHandlerTest, RebalanceConnection) {
+  Network::ListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  Network::MockConnectionBalancer* connection_balancer = new Network::MockConnectionBalancer();
+  Network::BalancedConnectionHandler* current_handler;
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks,
+                  connection_balancer, &current_handler);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+  EXPECT_EQ(test_listener->socket_.get(), &current_handler->listenSocket());
+
+  Network::MockBalancedConnectionHandler target_handler;
+  EXPECT_CALL(*connection_balancer, pickTargetHandler(_)).WillOnce(ReturnRef(target_handler));
+  EXPECT_CALL(target_handler, post(_));
+  listener_callbacks->onAccept(std::make_unique<NiceMock<Network::MockConnectionSocket>>());
+  EXPECT_EQ(1UL, TestUtility::findCounter(stats_store_, "test.downstream_cx_rebalanced")->value());
+  EXPECT_EQ(0UL, TestUtility::findCounter(stats_store_, "test.downstream_cx_total")->value());
+
+  EXPECT_CALL(*connection_balancer, unregisterHandler(_));
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, RemoveListener) {
   InSequence s;
 
@@ -291,6 +316,33 @@ TEST_F(ConnectionHandlerTest, AddDisabledListener) {
   handler_->addListener(absl::nullopt, *test_listener);
 }
 
+TEST_F(ConnectionHandlerTest, RejectConnections) {
+  InSequence s;
+
+  Network::ListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  handler_->setListenerRejectFraction(1);
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  EXPECT_CALL(*accepted_socket, close());
+  EXPECT_CALL(manager_, findFilterChain(_)).Times(0);
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket});
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_overload_reject").value());
+
+  // Connections are accepted again once the fraction is reset.
+  handler_->setListenerRejectFraction(0);
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(nullptr));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_overload_reject").value());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   InSequence s;
 
@@ -5,10 +5,13 @@
 
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
+#include "test/mocks/ssl/mocks.h"
 
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::InSequence;
+using testing::Invoke;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -149,6 +152,33 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportTlsSessionsToChild) {
+  Ssl::MockContextManager parent_context_manager;
+  EXPECT_CALL(server_, sslContextManager()).WillOnce(ReturnRef(parent_context_manager));
+  EXPECT_CALL(parent_context_manager, exportSessions())
+      .WillOnce(Return(std::vector<Ssl::ContextManager::CachedSession>{
+          {"ctx", "id1", "session1", std::chrono::seconds(10)},
+          {"ctx", "id2", "session2", std::chrono::seconds(20)}}));
+  HotRestartMessage::Reply::TlsSessions sessions_proto;
+  hot_restarting_parent_.exportTlsSessionsToChild(&sessions_proto);
+  ASSERT_EQ(2, sessions_proto.sessions_size());
+  EXPECT_EQ("id1", sessions_proto.sessions(0).session_id());
+  EXPECT_EQ(20, sessions_proto.sessions(1).ttl_seconds());
+
+  Ssl::MockContextManager child_context_manager;
+  EXPECT_CALL(child_context_manager, importSessions(_))
+      .WillOnce(Invoke([](const std::vector<Ssl::ContextManager::CachedSession>& sessions) {
+        ASSERT_EQ(2, sessions.size());
+        EXPECT_EQ("ctx", sessions[0].session_id_context_);
+        EXPECT_EQ("id1", sessions[0].session_id_);
+        EXPECT_EQ("session1", sessions[0].session_);
+        EXPECT_EQ(std::chrono::seconds(10), sessions[0].ttl_);
+        EXPECT_EQ("id2", sessions[1].session_id_);
+      }));
+  HotRestartingChild hot_restarting_child(0, 0);
+  hot_restarting_child.mergeParentTlsSessions(child_context_manager, sessions_proto);
+}
+
 TEST_F(HotRestartingParentTest, DrainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
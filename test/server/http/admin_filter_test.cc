@@ -75,5 +75,12 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_trailers));
 }
 
+// Only filters which are part of a stream can stream their response.
+TEST_P(AdminFilterTest, StreamingSupported) {
+  EXPECT_TRUE(filter_.streamingSupported());
+  AdminFilter filter(adminServerCallback);
+  EXPECT_FALSE(filter.streamingSupported());
+}
+
 } // namespace Server
 } // namespace Envoy
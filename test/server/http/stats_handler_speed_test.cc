@@ -0,0 +1,129 @@
+// Measures rendering the stats of a store with a large number of stats for /stats, in each of its
+// formats, in chunks of bounded size and all at once. Besides the time taken, the largest amount of
+// output which is buffered at a time is reported as peak_buffered_bytes.
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "server/http/prometheus_stats.h"
+#include "server/http/stats_handler.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// Stats for num_clusters clusters, with 100 counters and 10 gauges each.
+class StatsStore {
+public:
+  explicit StatsStore(uint64_t num_clusters) {
+    for (uint64_t i = 0; i < num_clusters; ++i) {
+      const std::string prefix = absl::StrCat("cluster.cluster_", i, ".");
+      for (uint64_t j = 0; j < 100; ++j) {
+        store_.counterFromString(absl::StrCat(prefix, "upstream_rq_", j)).add(j);
+      }
+      for (uint64_t j = 0; j < 10; ++j) {
+        store_.gaugeFromString(absl::StrCat(prefix, "upstream_cx_", j),
+                               Stats::Gauge::ImportMode::Accumulate)
+            .set(j);
+      }
+    }
+  }
+
+  Stats::IsolatedStoreImpl store_;
+};
+
+StatsStore& statsStore(uint64_t num_clusters) {
+  static auto* stores = new std::map<uint64_t, std::unique_ptr<StatsStore>>();
+  std::unique_ptr<StatsStore>& store = (*stores)[num_clusters];
+  if (store == nullptr) {
+    store = std::make_unique<StatsStore>(num_clusters);
+  }
+  return *store;
+}
+
+// Renders every chunk into a buffer which is drained before the next chunk, as the chunks are
+// written out by the connection. Returns the size of the output.
+template <class Renderer> uint64_t renderChunks(Renderer& renderer, benchmark::State& state) {
+  Buffer::OwnedImpl response;
+  uint64_t total_bytes = 0;
+  uint64_t peak_buffered_bytes = 0;
+  bool more = true;
+  while (more) {
+    more = renderer.nextChunk(response);
+    total_bytes += response.length();
+    peak_buffered_bytes = std::max<uint64_t>(peak_buffered_bytes, response.length());
+    response.drain(response.length());
+  }
+  state.counters["peak_buffered_bytes"] = peak_buffered_bytes;
+  return total_bytes;
+}
+
+uint64_t chunkSize(int64_t arg) {
+  return arg == 0 ? std::numeric_limits<uint64_t>::max() : static_cast<uint64_t>(arg);
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StatsText(benchmark::State& state) {
+  Stats::Store& store = statsStore(state.range(0)).store_;
+  uint64_t total_bytes = 0;
+  for (auto _ : state) {
+    StatsRenderer renderer(store, StatsRenderer::Format::Text, false, absl::nullopt,
+                           chunkSize(state.range(1)));
+    total_bytes += renderChunks(renderer, state);
+  }
+  state.SetBytesProcessed(total_bytes);
+}
+BENCHMARK(BM_StatsText)
+    ->Args({100, 0})
+    ->Args({100, StatsHandler::ChunkSize})
+    ->Args({10000, 0})
+    ->Args({10000, StatsHandler::ChunkSize})
+    ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StatsJson(benchmark::State& state) {
+  Stats::Store& store = statsStore(state.range(0)).store_;
+  uint64_t total_bytes = 0;
+  for (auto _ : state) {
+    StatsRenderer renderer(store, StatsRenderer::Format::Json, false, absl::nullopt,
+                           chunkSize(state.range(1)));
+    total_bytes += renderChunks(renderer, state);
+  }
+  state.SetBytesProcessed(total_bytes);
+}
+BENCHMARK(BM_StatsJson)
+    ->Args({100, 0})
+    ->Args({100, StatsHandler::ChunkSize})
+    ->Args({10000, 0})
+    ->Args({10000, StatsHandler::ChunkSize})
+    ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StatsPrometheus(benchmark::State& state) {
+  Stats::Store& store = statsStore(state.range(0)).store_;
+  uint64_t total_bytes = 0;
+  for (auto _ : state) {
+    PrometheusStatsRenderer renderer(store.counters(), store.gauges(), store.histograms(), false,
+                                     absl::nullopt, chunkSize(state.range(1)));
+    total_bytes += renderChunks(renderer, state);
+  }
+  state.SetBytesProcessed(total_bytes);
+}
+BENCHMARK(BM_StatsPrometheus)
+    ->Args({100, 0})
+    ->Args({100, StatsHandler::ChunkSize})
+    ->Args({10000, 0})
+    ->Args({10000, StatsHandler::ChunkSize})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace Server
+} // namespace Envoy
@@ -8,9 +8,11 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/utility.h"
 
+using testing::_;
 using testing::EndsWith;
 using testing::HasSubstr;
 using testing::InSequence;
+using testing::Invoke;
 using testing::Ref;
 using testing::StartsWith;
 
@@ -25,13 +27,21 @@ public:
     store_->addSink(sink_);
   }
 
-  static std::string
-  statsAsJsonHandler(std::map<std::string, uint64_t>& all_stats,
-                     std::map<std::string, std::string>& all_text_readouts,
-                     const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                     const bool used_only, const absl::optional<std::regex> regex = absl::nullopt) {
-    return StatsHandler::statsAsJson(all_stats, all_text_readouts, all_histograms, used_only, regex,
-                                     true /*pretty_print*/);
+  // Renders the stats of store_ in chunks of chunk_size bytes, and returns all of the output.
+  std::string render(StatsRenderer::Format format, const bool used_only,
+                     const absl::optional<std::regex> regex = absl::nullopt,
+                     uint64_t chunk_size = StatsHandler::ChunkSize) {
+    StatsRenderer renderer(*store_, format, used_only, regex, chunk_size);
+    Buffer::OwnedImpl response;
+    while (renderer.nextChunk(response)) {
+      ++chunks_;
+    }
+    return response.toString();
+  }
+
+  std::string statsAsJsonHandler(const bool used_only,
+                                 const absl::optional<std::regex> regex = absl::nullopt) {
+    return render(StatsRenderer::Format::Json, used_only, regex);
   }
 
   Stats::SymbolTablePtr symbol_table_;
@@ -40,6 +50,8 @@ public:
   Stats::AllocatorImpl alloc_;
   Stats::MockSink sink_;
   std::unique_ptr<Stats::ThreadLocalStoreImpl> store_;
+  // The number of chunks rendered by render(), not counting the last one.
+  uint32_t chunks_{};
 };
 
 INSTANTIATE_TEST_SUITE_P(IpVersions, AdminStatsTest,
@@ -68,13 +80,7 @@ TEST_P(AdminStatsTest, StatsAsJson) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::vector<Stats::ParentHistogramSharedPtr> histograms = store_->histograms();
-  std::sort(histograms.begin(), histograms.end(),
-            [](const Stats::ParentHistogramSharedPtr& a,
-               const Stats::ParentHistogramSharedPtr& b) -> bool { return a->name() < b->name(); });
-  std::map<std::string, uint64_t> all_stats;
-  std::map<std::string, std::string> all_text_readouts;
-  std::string actual_json = statsAsJsonHandler(all_stats, all_text_readouts, histograms, false);
+  std::string actual_json = statsAsJsonHandler(false);
 
   const std::string expected_json = R"EOF({
     "stats": [
@@ -215,10 +221,7 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJson) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::map<std::string, uint64_t> all_stats;
-  std::map<std::string, std::string> all_text_readouts;
-  std::string actual_json =
-      statsAsJsonHandler(all_stats, all_text_readouts, store_->histograms(), true);
+  std::string actual_json = statsAsJsonHandler(true);
 
   // Expected JSON should not have h2 values as it is not used.
   const std::string expected_json = R"EOF({
@@ -315,11 +318,8 @@ TEST_P(AdminStatsTest, StatsAsJsonFilterString) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::map<std::string, uint64_t> all_stats;
-  std::map<std::string, std::string> all_text_readouts;
   std::string actual_json =
-      statsAsJsonHandler(all_stats, all_text_readouts, store_->histograms(), false,
-                         absl::optional<std::regex>{std::regex("[a-z]1")});
+      statsAsJsonHandler(false, absl::optional<std::regex>{std::regex("[a-z]1")});
 
   // Because this is a filter case, we don't expect to see any stats except for those containing
   // "h1" in their name.
@@ -426,11 +426,8 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJsonFilterString) {
 
   store_->mergeHistograms([]() -> void {});
 
-  std::map<std::string, uint64_t> all_stats;
-  std::map<std::string, std::string> all_text_readouts;
   std::string actual_json =
-      statsAsJsonHandler(all_stats, all_text_readouts, store_->histograms(), true,
-                         absl::optional<std::regex>{std::regex("h[12]")});
+      statsAsJsonHandler(true, absl::optional<std::regex>{std::regex("h[12]")});
 
   // Expected JSON should not have h2 values as it is not used, and should not have h3 values as
   // they are used but do not match.
@@ -506,6 +503,51 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJsonFilterString) {
   store_->shutdownThreading();
 }
 
+// Counters and gauges are rendered together in the order of their names, one stat per chunk if
+// the chunks are small enough.
+TEST_P(AdminStatsTest, RenderTextInChunks) {
+  store_->counterFromString("c").add(3);
+  store_->gaugeFromString("b", Stats::Gauge::ImportMode::Accumulate).set(2);
+  store_->counterFromString("a").add(1);
+  store_->textReadoutFromString("t").set("text");
+
+  EXPECT_EQ("t: \"text\"\na: 1\nb: 2\nc: 3\n",
+            render(StatsRenderer::Format::Text, false, absl::nullopt, 1));
+  EXPECT_EQ(4, chunks_);
+
+  chunks_ = 0;
+  EXPECT_EQ("a: 1\nb: 2\nc: 3\n", render(StatsRenderer::Format::Text, false, std::regex("^[a-c]")));
+  EXPECT_EQ(0, chunks_);
+}
+
+// The JSON output is the same however it is split into chunks, and strings are escaped.
+TEST_P(AdminStatsTest, RenderJsonInChunks) {
+  store_->counterFromString("a").add(1);
+  store_->gaugeFromString("b", Stats::Gauge::ImportMode::Accumulate).set(2);
+  store_->textReadoutFromString("t").set("\"quoted\"\n\\");
+
+  const std::string expected_json = R"EOF({
+    "stats": [
+        {
+            "name": "t",
+            "value": "\"quoted\"\n\\"
+        },
+        {
+            "name": "a",
+            "value": 1
+        },
+        {
+            "name": "b",
+            "value": 2
+        }
+    ]
+})EOF";
+  EXPECT_THAT(expected_json, JsonStringEq(render(StatsRenderer::Format::Json, false)));
+  EXPECT_EQ(render(StatsRenderer::Format::Json, false),
+            render(StatsRenderer::Format::Json, false, absl::nullopt, 1));
+  EXPECT_EQ("{\"stats\":[]}", render(StatsRenderer::Format::Json, false, std::regex("none")));
+}
+
 INSTANTIATE_TEST_SUITE_P(IpVersions, AdminInstanceTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
                          TestUtility::ipTestParamsToString);
@@ -541,6 +583,82 @@ TEST_P(AdminInstanceTest, PrometheusStatsInvalidRegex) {
   EXPECT_THAT(data.toString(), EndsWith("\"\n"));
 }
 
+// Output which does not fit into a chunk is sent in further chunks once the first one has been
+// sent, pausing while the downstream connection is backed up.
+TEST_P(AdminInstanceTest, StatsStreamedInChunks) {
+  for (uint32_t i = 0; i < 10000; ++i) {
+    server_.stats_store_.counterFromString(absl::StrCat("streamed.counter_", i)).inc();
+  }
+  Http::ResponseHeaderMapImpl expected_headers;
+  std::string expected_body;
+  EXPECT_EQ(Http::Code::OK,
+            admin_.request("/stats?filter=^streamed", "GET", expected_headers, expected_body));
+  EXPECT_GT(expected_body.size(), 2 * StatsHandler::ChunkSize);
+
+  std::list<Event::PostCb> posted;
+  EXPECT_CALL(callbacks_.dispatcher_, post(_)).WillRepeatedly(Invoke([&posted](Event::PostCb cb) {
+    posted.push_back(cb);
+  }));
+  std::string body;
+  bool end_stream = false;
+  EXPECT_CALL(callbacks_, encodeData(_, _))
+      .WillRepeatedly(Invoke([&body, &end_stream](Buffer::Instance& data, bool end) {
+        EXPECT_FALSE(end_stream);
+        EXPECT_LT(data.length(), 2 * StatsHandler::ChunkSize);
+        body += data.toString();
+        end_stream = end;
+      }));
+  auto runPosted = [&posted]() {
+    std::list<Event::PostCb> callbacks;
+    callbacks.swap(posted);
+    for (const Event::PostCb& cb : callbacks) {
+      cb();
+    }
+  };
+
+  Http::ResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats?filter=^streamed", header_map, response));
+  EXPECT_LT(response.length(), 2 * StatsHandler::ChunkSize);
+  body = response.toString();
+  ASSERT_EQ(1, posted.size());
+  ASSERT_EQ(1, callbacks_.callbacks_.size());
+
+  // Nothing is sent while the connection is backed up.
+  callbacks_.callbacks_.front()->onAboveWriteBufferHighWatermark();
+  runPosted();
+  EXPECT_EQ(response.length(), body.size());
+  EXPECT_TRUE(posted.empty());
+
+  callbacks_.callbacks_.front()->onBelowWriteBufferLowWatermark();
+  ASSERT_EQ(1, posted.size());
+  while (!posted.empty()) {
+    runPosted();
+  }
+  EXPECT_TRUE(end_stream);
+  EXPECT_EQ(expected_body, body);
+}
+
+// Streaming stops once the stream has been destroyed.
+TEST_P(AdminInstanceTest, StatsStreamingStopsOnDestroy) {
+  for (uint32_t i = 0; i < 10000; ++i) {
+    server_.stats_store_.counterFromString(absl::StrCat("streamed.counter_", i)).inc();
+  }
+  std::list<Event::PostCb> posted;
+  EXPECT_CALL(callbacks_.dispatcher_, post(_)).WillRepeatedly(Invoke([&posted](Event::PostCb cb) {
+    posted.push_back(cb);
+  }));
+  EXPECT_CALL(callbacks_, encodeData(_, _)).Times(0);
+
+  Http::ResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats?filter=^streamed", header_map, response));
+  ASSERT_EQ(1, posted.size());
+  admin_filter_.onDestroy();
+  EXPECT_TRUE(callbacks_.callbacks_.empty());
+  posted.front()();
+}
+
 TEST_P(AdminInstanceTest, TracingStatsDisabled) {
   const std::string& name = admin_.tracingStats().service_forced_.name();
   for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
@@ -1413,6 +1413,25 @@ filter_chains:
   EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
 }
 
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortBalanceWithoutReusePort) {
+  const std::string yaml = R"EOF(
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+connection_balance_config:
+  reuse_port_balance: {}
+filter_chains:
+- filters: []
+  )EOF";
+
+  envoy::config::listener::v3::Listener listener;
+  TestUtility::loadFromYaml(yaml, listener);
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error adding listener '127.0.0.1:1234': reuse_port_balance requires "
+                            "reuse_port to be set");
+}
+
 TEST_F(ListenerManagerImplTest, NotSupportedDatagramUds) {
   ProdListenerComponentFactory real_listener_factory(server_);
   EXPECT_THROW_WITH_MESSAGE(real_listener_factory.createListenSocket(
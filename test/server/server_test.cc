@@ -7,6 +7,7 @@
 #include "common/network/address_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/socket_option_impl.h"
+#include "common/stats/thread_local_store.h"
 #include "common/thread_local/thread_local_impl.h"
 
 #include "server/process_context_impl.h"
@@ -87,6 +88,57 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store);
 }
 
+// Only the counters and gauges which changed since the previous flush are flushed.
+TEST(ServerInstanceUtil, flushChangedHelper) {
+  InSequence s;
+
+  Stats::SymbolTablePtr symbol_table = Stats::SymbolTableCreator::makeSymbolTable();
+  Stats::AllocatorImpl alloc(*symbol_table);
+  Stats::ThreadLocalStoreImpl store(alloc);
+  Stats::Counter& c1 = store.counterFromString("c1");
+  Stats::Counter& c2 = store.counterFromString("c2");
+  store.gaugeFromString("g1", Stats::Gauge::ImportMode::Accumulate).set(5);
+  Stats::Gauge& g2 = store.gaugeFromString("g2", Stats::Gauge::ImportMode::Accumulate);
+  store.trackChangedStats();
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+
+  // All the stats are reported at the first flush.
+  c1.inc();
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+  }));
+  InstanceUtil::flushChangedMetricsToSinks(sinks, store);
+
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.counters().empty());
+    EXPECT_TRUE(snapshot.gauges().empty());
+  }));
+  InstanceUtil::flushChangedMetricsToSinks(sinks, store);
+
+  c2.add(3);
+  c2.add(4);
+  g2.set(7);
+  Stats::Counter& c3 = store.counterFromString("c3");
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 2);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "c2");
+    EXPECT_EQ(snapshot.counters()[0].delta_, 7);
+    EXPECT_EQ(snapshot.counters()[1].counter_.get().name(), "c3");
+    EXPECT_EQ(snapshot.counters()[1].delta_, 0);
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "g2");
+    EXPECT_EQ(snapshot.gauges()[0].get().value(), 7);
+  }));
+  InstanceUtil::flushChangedMetricsToSinks(sinks, store);
+  EXPECT_EQ(0, c3.value());
+
+  store.shutdownThreading();
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {